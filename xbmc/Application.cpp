@@ -25,6 +25,8 @@
 #include "interfaces/Builtins.h"
 #include "utils/Variant.h"
 #include "utils/Splash.h"
+#include "utils/InitGraph.h"
+#include "utils/StartupProfiler.h"
 #include "LangInfo.h"
 #include "utils/Screenshot.h"
 #include "Util.h"
@@ -59,6 +61,7 @@
 #include "SectionLoader.h"
 #include "cores/DllLoader/DllLoaderContainer.h"
 #include "GUIUserMessages.h"
+#include "filesystem/ChangeJournal.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
 #include "filesystem/StackDirectory.h"
@@ -206,6 +209,7 @@
 #include "music/dialogs/GUIDialogMusicOverlay.h"
 #include "video/dialogs/GUIDialogVideoOverlay.h"
 #include "video/VideoInfoScanner.h"
+#include "video/StreamDetailsExtractor.h"
 #include "video/PlayerController.h"
 
 // Dialog includes
@@ -610,6 +614,8 @@ bool CApplication::SetupNetwork()
 
 bool CApplication::Create()
 {
+  CStartupProfiler::Get().Begin("create");
+
   SetupNetwork();
   Preflight();
 
@@ -787,18 +793,21 @@ bool CApplication::Create()
 
   // Initialize default Settings - don't move
   CLog::Log(LOGNOTICE, "load settings...");
-  if (!CSettings::Get().Initialize())
-    return false;
+  {
+    CStartupPhase phase("settings");
+    if (!CSettings::Get().Initialize())
+      return false;
 
-  g_powerManager.SetDefaults();
+    g_powerManager.SetDefaults();
 
-  // load the actual values
-  if (!CSettings::Get().Load())
-  {
-    CLog::Log(LOGFATAL, "unable to load settings");
-    return false;
+    // load the actual values
+    if (!CSettings::Get().Load())
+    {
+      CLog::Log(LOGFATAL, "unable to load settings");
+      return false;
+    }
+    CSettings::Get().SetLoaded();
   }
-  CSettings::Get().SetLoaded();
 
   CLog::Log(LOGINFO, "creating subdirectories");
   CLog::Log(LOGINFO, "userdata folder: %s", CProfilesManager::Get().GetProfileUserDataFolder().c_str());
@@ -810,6 +819,57 @@ bool CApplication::Create()
 
   update_emu_environ();//apply the GUI settings
 
+  // the add-on scan doesn't depend on the language or the AudioEngine so it
+  // runs in the background while those are loaded on this thread
+  CInitGraph init("CApplication::Create");
+  init.AddTask("language", this, &CApplication::InitializeLanguage, "", true);
+  init.AddTask("audioengine", this, &CApplication::StartAudioEngine, "", true);
+  init.AddTask("addons", this, &CApplication::InitializeAddons);
+  if (!init.Run())
+    return false;
+
+  // restore AE's previous volume state
+  SetHardwareVolume(m_volumeLevel);
+  CAEFactory::SetMute     (m_muted);
+  CAEFactory::SetSoundMode(CSettings::Get().GetInt("audiooutput.guisoundmode"));
+
+  // initialize m_replayGainSettings
+  m_replayGainSettings.iType = CSettings::Get().GetInt("musicplayer.replaygaintype");
+  m_replayGainSettings.iPreAmp = CSettings::Get().GetInt("musicplayer.replaygainpreamp");
+  m_replayGainSettings.iNoGainPreAmp = CSettings::Get().GetInt("musicplayer.replaygainnogainpreamp");
+  m_replayGainSettings.bAvoidClipping = CSettings::Get().GetBool("musicplayer.replaygainavoidclipping");
+
+#if defined(HAS_LIRC) || defined(HAS_IRSERVERSUITE)
+  g_RemoteControl.Initialize();
+#endif
+
+  g_peripherals.Initialise();
+
+  // Create the Mouse, Keyboard, Remote, and Joystick devices
+  // Initialize after loading settings to get joystick deadzone setting
+  g_Mouse.Initialize();
+  g_Mouse.SetEnabled(CSettings::Get().GetBool("input.enablemouse"));
+
+  g_Keyboard.Initialize();
+
+#if defined(TARGET_DARWIN_OSX)
+  // Configure and possible manually start the helper.
+  XBMCHelper::GetInstance().Configure();
+#endif
+
+  CUtil::InitRandomSeed();
+
+  g_mediaManager.Initialize();
+
+  m_lastFrameTime = XbmcThreads::SystemClockMillis();
+  m_lastRenderTime = m_lastFrameTime;
+
+  CStartupProfiler::Get().End("create");
+  return true;
+}
+
+bool CApplication::InitializeLanguage()
+{
   // Load the langinfo to have user charset <-> utf-8 conversion
   std::string strLanguage = CSettings::Get().GetString("locale.language");
   strLanguage[0] = toupper(strLanguage[0]);
@@ -830,24 +890,22 @@ bool CApplication::Create()
     return false;
   }
 
-  // start the AudioEngine
+  return true;
+}
+
+bool CApplication::StartAudioEngine()
+{
   if (!CAEFactory::StartEngine())
   {
     CLog::Log(LOGFATAL, "CApplication::Create: Failed to start the AudioEngine");
     return false;
   }
 
-  // restore AE's previous volume state
-  SetHardwareVolume(m_volumeLevel);
-  CAEFactory::SetMute     (m_muted);
-  CAEFactory::SetSoundMode(CSettings::Get().GetInt("audiooutput.guisoundmode"));
-
-  // initialize m_replayGainSettings
-  m_replayGainSettings.iType = CSettings::Get().GetInt("musicplayer.replaygaintype");
-  m_replayGainSettings.iPreAmp = CSettings::Get().GetInt("musicplayer.replaygainpreamp");
-  m_replayGainSettings.iNoGainPreAmp = CSettings::Get().GetInt("musicplayer.replaygainnogainpreamp");
-  m_replayGainSettings.bAvoidClipping = CSettings::Get().GetBool("musicplayer.replaygainavoidclipping");
+  return true;
+}
 
+bool CApplication::InitializeAddons()
+{
   // initialize the addon database (must be before the addon manager is init'd)
   CDatabaseManager::Get().Initialize(true);
 
@@ -862,30 +920,154 @@ bool CApplication::Create()
     CLog::Log(LOGFATAL, "CApplication::Create: Unable to start CAddonMgr");
     return false;
   }
-#if defined(HAS_LIRC) || defined(HAS_IRSERVERSUITE)
-  g_RemoteControl.Initialize();
-#endif
 
-  g_peripherals.Initialise();
+  return true;
+}
 
-  // Create the Mouse, Keyboard, Remote, and Joystick devices
-  // Initialize after loading settings to get joystick deadzone setting
-  g_Mouse.Initialize();
-  g_Mouse.SetEnabled(CSettings::Get().GetBool("input.enablemouse"));
+bool CApplication::InitializeDatabases()
+{
+  // initialize (and update as needed) our databases
+  CDatabaseManager::Get().Initialize();
+  return true;
+}
 
-  g_Keyboard.Initialize();
+bool CApplication::InitializeGUI()
+{
+  CSettings::Get().GetSetting("powermanagement.displaysoff")->SetRequirementsMet(m_dpms->IsSupported());
 
-#if defined(TARGET_DARWIN_OSX)
-  // Configure and possible manually start the helper.
-  XBMCHelper::GetInstance().Configure();
+  g_windowManager.Add(new CGUIWindowHome);
+  g_windowManager.Add(new CGUIWindowPrograms);
+  g_windowManager.Add(new CGUIWindowPictures);
+  g_windowManager.Add(new CGUIWindowFileManager);
+  g_windowManager.Add(new CGUIWindowSettings);
+  g_windowManager.Add(new CGUIWindowSystemInfo);
+#ifdef HAS_GL
+  g_windowManager.Add(new CGUIWindowTestPatternGL);
+#endif
+#ifdef HAS_DX
+  g_windowManager.Add(new CGUIWindowTestPatternDX);
+#endif
+  g_windowManager.Add(new CGUIWindowSettingsScreenCalibration);
+  g_windowManager.Add(new CGUIWindowSettingsCategory);
+  g_windowManager.Add(new CGUIWindowVideoNav);
+  g_windowManager.Add(new CGUIWindowVideoPlaylist);
+  g_windowManager.Add(new CGUIWindowLoginScreen);
+  g_windowManager.Add(new CGUIWindowSettingsProfile);
+  g_windowManager.Add(new CGUIWindow(WINDOW_SKIN_SETTINGS, "SkinSettings.xml"));
+  g_windowManager.Add(new CGUIWindowAddonBrowser);
+  g_windowManager.Add(new CGUIWindowScreensaverDim);
+  g_windowManager.Add(new CGUIWindowDebugInfo);
+  g_windowManager.Add(new CGUIWindowPointer);
+  g_windowManager.Add(new CGUIDialogYesNo);
+  g_windowManager.Add(new CGUIDialogProgress);
+  g_windowManager.Add(new CGUIDialogExtendedProgressBar);
+  g_windowManager.Add(new CGUIDialogKeyboardGeneric);
+  g_windowManager.Add(new CGUIDialogVolumeBar);
+  g_windowManager.Add(new CGUIDialogSeekBar);
+  g_windowManager.Add(new CGUIDialogSubMenu);
+  g_windowManager.Add(new CGUIDialogContextMenu);
+  g_windowManager.Add(new CGUIDialogKaiToast);
+  g_windowManager.Add(new CGUIDialogNumeric);
+  g_windowManager.Add(new CGUIDialogGamepad);
+  g_windowManager.Add(new CGUIDialogButtonMenu);
+  g_windowManager.Add(new CGUIDialogMuteBug);
+  g_windowManager.Add(new CGUIDialogPlayerControls);
+#ifdef HAS_KARAOKE
+  g_windowManager.Add(new CGUIDialogKaraokeSongSelectorSmall);
+  g_windowManager.Add(new CGUIDialogKaraokeSongSelectorLarge);
+#endif
+  g_windowManager.Add(new CGUIDialogSlider);
+  g_windowManager.Add(new CGUIDialogMusicOSD);
+  g_windowManager.Add(new CGUIDialogVisualisationPresetList);
+  g_windowManager.Add(new CGUIDialogVideoSettings);
+  g_windowManager.Add(new CGUIDialogAudioSubtitleSettings);
+  g_windowManager.Add(new CGUIDialogVideoBookmarks);
+  // Don't add the filebrowser dialog - it's created and added when it's needed
+  g_windowManager.Add(new CGUIDialogNetworkSetup);
+  g_windowManager.Add(new CGUIDialogMediaSource);
+  g_windowManager.Add(new CGUIDialogProfileSettings);
+  g_windowManager.Add(new CGUIDialogFavourites);
+  g_windowManager.Add(new CGUIDialogSongInfo);
+  g_windowManager.Add(new CGUIDialogSmartPlaylistEditor);
+  g_windowManager.Add(new CGUIDialogSmartPlaylistRule);
+  g_windowManager.Add(new CGUIDialogBusy);
+  g_windowManager.Add(new CGUIDialogPictureInfo);
+  g_windowManager.Add(new CGUIDialogAddonInfo);
+  g_windowManager.Add(new CGUIDialogAddonSettings);
+#ifdef HAS_LINUX_NETWORK
+  g_windowManager.Add(new CGUIDialogAccessPoints);
+#endif
+
+  g_windowManager.Add(new CGUIDialogLockSettings);
+
+  g_windowManager.Add(new CGUIDialogContentSettings);
+
+  g_windowManager.Add(new CGUIDialogPlayEject);
+
+  g_windowManager.Add(new CGUIDialogPeripheralManager);
+  g_windowManager.Add(new CGUIDialogPeripheralSettings);
+
+  g_windowManager.Add(new CGUIDialogMediaFilter);
+  g_windowManager.Add(new CGUIDialogSubtitles);
+
+  g_windowManager.Add(new CGUIWindowMusicPlayList);
+  g_windowManager.Add(new CGUIWindowMusicSongs);
+  g_windowManager.Add(new CGUIWindowMusicNav);
+  g_windowManager.Add(new CGUIWindowMusicPlaylistEditor);
+
+  /* Load PVR related Windows and Dialogs */
+  g_windowManager.Add(new CGUIDialogTeletext);
+  g_windowManager.Add(new CGUIWindowPVRChannels(false));
+  g_windowManager.Add(new CGUIWindowPVRRecordings(false));
+  g_windowManager.Add(new CGUIWindowPVRGuide(false));
+  g_windowManager.Add(new CGUIWindowPVRTimers(false));
+  g_windowManager.Add(new CGUIWindowPVRSearch(false));
+  g_windowManager.Add(new CGUIWindowPVRChannels(true));
+  g_windowManager.Add(new CGUIWindowPVRRecordings(true));
+  g_windowManager.Add(new CGUIWindowPVRGuide(true));
+  g_windowManager.Add(new CGUIWindowPVRTimers(true));
+  g_windowManager.Add(new CGUIWindowPVRSearch(true));
+  g_windowManager.Add(new CGUIDialogPVRGuideInfo);
+  g_windowManager.Add(new CGUIDialogPVRRecordingInfo);
+  g_windowManager.Add(new CGUIDialogPVRTimerSettings);
+  g_windowManager.Add(new CGUIDialogPVRGroupManager);
+  g_windowManager.Add(new CGUIDialogPVRChannelManager);
+  g_windowManager.Add(new CGUIDialogPVRGuideSearch);
+  g_windowManager.Add(new CGUIDialogPVRChannelsOSD);
+  g_windowManager.Add(new CGUIDialogPVRGuideOSD);
+  g_windowManager.Add(new CGUIDialogPVRDirectorOSD);
+  g_windowManager.Add(new CGUIDialogPVRCutterOSD);
+
+  g_windowManager.Add(new CGUIDialogSelect);
+  g_windowManager.Add(new CGUIDialogMusicInfo);
+  g_windowManager.Add(new CGUIDialogOK);
+  g_windowManager.Add(new CGUIDialogVideoInfo);
+  g_windowManager.Add(new CGUIDialogTextViewer);
+  g_windowManager.Add(new CGUIWindowFullScreen);
+  g_windowManager.Add(new CGUIWindowVisualisation);
+  g_windowManager.Add(new CGUIWindowSlideShow);
+  g_windowManager.Add(new CGUIDialogFileStacking);
+#ifdef HAS_KARAOKE
+  g_windowManager.Add(new CGUIWindowKaraokeLyrics);
 #endif
 
-  CUtil::InitRandomSeed();
+  g_windowManager.Add(new CGUIDialogVideoOSD);
+  g_windowManager.Add(new CGUIDialogMusicOverlay);
+  g_windowManager.Add(new CGUIDialogVideoOverlay);
+  g_windowManager.Add(new CGUIWindowScreensaver);
+  g_windowManager.Add(new CGUIWindowWeather);
+  g_windowManager.Add(new CGUIWindowStartup);
 
-  g_mediaManager.Initialize();
+  /* window id's 3000 - 3100 are reserved for python */
+
+  // Make sure we have at least the default skin
+  string defaultSkin = ((const CSettingString*)CSettings::Get().GetSetting("lookandfeel.skin"))->GetDefault();
+  if (!LoadSkin(CSettings::Get().GetString("lookandfeel.skin")) && !LoadSkin(defaultSkin))
+  {
+    CLog::Log(LOGERROR, "Default skin '%s' not found! Terminating..", defaultSkin.c_str());
+    return false;
+  }
 
-  m_lastFrameTime = XbmcThreads::SystemClockMillis();
-  m_lastRenderTime = m_lastFrameTime;
   return true;
 }
 
@@ -1320,6 +1502,8 @@ bool CApplication::Initialize()
     CDirectory::Create("special://xbmc/sounds");
   }
 
+  CStartupProfiler::Get().Begin("initialize");
+
   // Load curl so curl_global_init gets called before any service threads
   // are started. Unloading will have no effect as curl is never fully unloaded.
   // To quote man curl_global_init:
@@ -1332,150 +1516,26 @@ bool CApplication::Initialize()
   g_curlInterface.Load();
   g_curlInterface.Unload();
 
-  // initialize (and update as needed) our databases
-  CDatabaseManager::Get().Initialize();
-
   StartServices();
 
   // Init DPMS, before creating the corresponding setting control.
   m_dpms = new DPMSSupport();
-  if (g_windowManager.Initialized())
-  {
-    CSettings::Get().GetSetting("powermanagement.displaysoff")->SetRequirementsMet(m_dpms->IsSupported());
 
-    g_windowManager.Add(new CGUIWindowHome);
-    g_windowManager.Add(new CGUIWindowPrograms);
-    g_windowManager.Add(new CGUIWindowPictures);
-    g_windowManager.Add(new CGUIWindowFileManager);
-    g_windowManager.Add(new CGUIWindowSettings);
-    g_windowManager.Add(new CGUIWindowSystemInfo);
-#ifdef HAS_GL
-    g_windowManager.Add(new CGUIWindowTestPatternGL);
-#endif
-#ifdef HAS_DX
-    g_windowManager.Add(new CGUIWindowTestPatternDX);
-#endif
-    g_windowManager.Add(new CGUIWindowSettingsScreenCalibration);
-    g_windowManager.Add(new CGUIWindowSettingsCategory);
-    g_windowManager.Add(new CGUIWindowVideoNav);
-    g_windowManager.Add(new CGUIWindowVideoPlaylist);
-    g_windowManager.Add(new CGUIWindowLoginScreen);
-    g_windowManager.Add(new CGUIWindowSettingsProfile);
-    g_windowManager.Add(new CGUIWindow(WINDOW_SKIN_SETTINGS, "SkinSettings.xml"));
-    g_windowManager.Add(new CGUIWindowAddonBrowser);
-    g_windowManager.Add(new CGUIWindowScreensaverDim);
-    g_windowManager.Add(new CGUIWindowDebugInfo);
-    g_windowManager.Add(new CGUIWindowPointer);
-    g_windowManager.Add(new CGUIDialogYesNo);
-    g_windowManager.Add(new CGUIDialogProgress);
-    g_windowManager.Add(new CGUIDialogExtendedProgressBar);
-    g_windowManager.Add(new CGUIDialogKeyboardGeneric);
-    g_windowManager.Add(new CGUIDialogVolumeBar);
-    g_windowManager.Add(new CGUIDialogSeekBar);
-    g_windowManager.Add(new CGUIDialogSubMenu);
-    g_windowManager.Add(new CGUIDialogContextMenu);
-    g_windowManager.Add(new CGUIDialogKaiToast);
-    g_windowManager.Add(new CGUIDialogNumeric);
-    g_windowManager.Add(new CGUIDialogGamepad);
-    g_windowManager.Add(new CGUIDialogButtonMenu);
-    g_windowManager.Add(new CGUIDialogMuteBug);
-    g_windowManager.Add(new CGUIDialogPlayerControls);
-#ifdef HAS_KARAOKE
-    g_windowManager.Add(new CGUIDialogKaraokeSongSelectorSmall);
-    g_windowManager.Add(new CGUIDialogKaraokeSongSelectorLarge);
-#endif
-    g_windowManager.Add(new CGUIDialogSlider);
-    g_windowManager.Add(new CGUIDialogMusicOSD);
-    g_windowManager.Add(new CGUIDialogVisualisationPresetList);
-    g_windowManager.Add(new CGUIDialogVideoSettings);
-    g_windowManager.Add(new CGUIDialogAudioSubtitleSettings);
-    g_windowManager.Add(new CGUIDialogVideoBookmarks);
-    // Don't add the filebrowser dialog - it's created and added when it's needed
-    g_windowManager.Add(new CGUIDialogNetworkSetup);
-    g_windowManager.Add(new CGUIDialogMediaSource);
-    g_windowManager.Add(new CGUIDialogProfileSettings);
-    g_windowManager.Add(new CGUIDialogFavourites);
-    g_windowManager.Add(new CGUIDialogSongInfo);
-    g_windowManager.Add(new CGUIDialogSmartPlaylistEditor);
-    g_windowManager.Add(new CGUIDialogSmartPlaylistRule);
-    g_windowManager.Add(new CGUIDialogBusy);
-    g_windowManager.Add(new CGUIDialogPictureInfo);
-    g_windowManager.Add(new CGUIDialogAddonInfo);
-    g_windowManager.Add(new CGUIDialogAddonSettings);
-#ifdef HAS_LINUX_NETWORK
-    g_windowManager.Add(new CGUIDialogAccessPoints);
-#endif
-
-    g_windowManager.Add(new CGUIDialogLockSettings);
-
-    g_windowManager.Add(new CGUIDialogContentSettings);
-
-    g_windowManager.Add(new CGUIDialogPlayEject);
-
-    g_windowManager.Add(new CGUIDialogPeripheralManager);
-    g_windowManager.Add(new CGUIDialogPeripheralSettings);
-
-    g_windowManager.Add(new CGUIDialogMediaFilter);
-    g_windowManager.Add(new CGUIDialogSubtitles);
-
-    g_windowManager.Add(new CGUIWindowMusicPlayList);
-    g_windowManager.Add(new CGUIWindowMusicSongs);
-    g_windowManager.Add(new CGUIWindowMusicNav);
-    g_windowManager.Add(new CGUIWindowMusicPlaylistEditor);
-
-    /* Load PVR related Windows and Dialogs */
-    g_windowManager.Add(new CGUIDialogTeletext);
-    g_windowManager.Add(new CGUIWindowPVRChannels(false));
-    g_windowManager.Add(new CGUIWindowPVRRecordings(false));
-    g_windowManager.Add(new CGUIWindowPVRGuide(false));
-    g_windowManager.Add(new CGUIWindowPVRTimers(false));
-    g_windowManager.Add(new CGUIWindowPVRSearch(false));
-    g_windowManager.Add(new CGUIWindowPVRChannels(true));
-    g_windowManager.Add(new CGUIWindowPVRRecordings(true));
-    g_windowManager.Add(new CGUIWindowPVRGuide(true));
-    g_windowManager.Add(new CGUIWindowPVRTimers(true));
-    g_windowManager.Add(new CGUIWindowPVRSearch(true));
-    g_windowManager.Add(new CGUIDialogPVRGuideInfo);
-    g_windowManager.Add(new CGUIDialogPVRRecordingInfo);
-    g_windowManager.Add(new CGUIDialogPVRTimerSettings);
-    g_windowManager.Add(new CGUIDialogPVRGroupManager);
-    g_windowManager.Add(new CGUIDialogPVRChannelManager);
-    g_windowManager.Add(new CGUIDialogPVRGuideSearch);
-    g_windowManager.Add(new CGUIDialogPVRChannelsOSD);
-    g_windowManager.Add(new CGUIDialogPVRGuideOSD);
-    g_windowManager.Add(new CGUIDialogPVRDirectorOSD);
-    g_windowManager.Add(new CGUIDialogPVRCutterOSD);
-
-    g_windowManager.Add(new CGUIDialogSelect);
-    g_windowManager.Add(new CGUIDialogMusicInfo);
-    g_windowManager.Add(new CGUIDialogOK);
-    g_windowManager.Add(new CGUIDialogVideoInfo);
-    g_windowManager.Add(new CGUIDialogTextViewer);
-    g_windowManager.Add(new CGUIWindowFullScreen);
-    g_windowManager.Add(new CGUIWindowVisualisation);
-    g_windowManager.Add(new CGUIWindowSlideShow);
-    g_windowManager.Add(new CGUIDialogFileStacking);
-#ifdef HAS_KARAOKE
-    g_windowManager.Add(new CGUIWindowKaraokeLyrics);
-#endif
-
-    g_windowManager.Add(new CGUIDialogVideoOSD);
-    g_windowManager.Add(new CGUIDialogMusicOverlay);
-    g_windowManager.Add(new CGUIDialogVideoOverlay);
-    g_windowManager.Add(new CGUIWindowScreensaver);
-    g_windowManager.Add(new CGUIWindowWeather);
-    g_windowManager.Add(new CGUIWindowStartup);
+  // initialize (and update as needed) our databases before the windows are
+  // created and the skin is loaded, as both open the view, texture and add-on
+  // databases. the databases themselves are updated concurrently.
+  CInitGraph init("CApplication::Initialize");
+  init.AddTask("databases", this, &CApplication::InitializeDatabases);
+  if (g_windowManager.Initialized())
+    init.AddTask("gui", this, &CApplication::InitializeGUI, "databases", true);
+  if (!init.Run())
+    return false;
 
-    /* window id's 3000 - 3100 are reserved for python */
-
-    // Make sure we have at least the default skin
-    string defaultSkin = ((const CSettingString*)CSettings::Get().GetSetting("lookandfeel.skin"))->GetDefault();
-    if (!LoadSkin(CSettings::Get().GetString("lookandfeel.skin")) && !LoadSkin(defaultSkin))
-    {
-      CLog::Log(LOGERROR, "Default skin '%s' not found! Terminating..", defaultSkin.c_str());
-      return false;
-    }
+  // watch the local library sources for changes
+  CChangeJournal::Get().Start();
 
+  if (g_windowManager.Initialized())
+  {
     if (g_advancedSettings.m_splashImage)
       SAFE_DELETE(m_splash);
 
@@ -1529,6 +1589,10 @@ bool CApplication::Initialize()
 
   CLog::Log(LOGNOTICE, "initialize done");
 
+  CStartupProfiler::Get().End("initialize");
+  CStartupProfiler::Get().Log();
+  CStartupProfiler::Get().Write("special://temp/startup-trace.json");
+
   m_bInitializing = false;
 
   // reset our screensaver (starts timers etc.)
@@ -3512,6 +3576,9 @@ void CApplication::Stop(int exitCode)
     m_ExitCode = exitCode;
     CLog::Log(LOGNOTICE, "stop all");
 
+    // store the probed stream details while the video database is still available
+    CStreamDetailsExtractor::Get().Stop();
+
     // cancel any jobs from the jobmanager
     CJobManager::GetInstance().CancelJobs();
 
@@ -3522,6 +3589,8 @@ void CApplication::Stop(int exitCode)
     if (m_videoInfoScanner->IsScanning())
       m_videoInfoScanner->Stop();
 
+    CChangeJournal::Get().Stop();
+
     CApplicationMessenger::Get().Cleanup();
 
     CLog::Log(LOGNOTICE, "stop player");
@@ -485,6 +485,12 @@ protected:
   bool InitDirectoriesWin32();
   void CreateUserDirs();
 
+  bool InitializeLanguage();
+  bool StartAudioEngine();
+  bool InitializeAddons();
+  bool InitializeDatabases();
+  bool InitializeGUI();
+
   CSeekHandler *m_seekHandler;
   CPlayerController *m_playerController;
   CInertialScrollingHandler *m_pInertialScrollingHandler;
@@ -389,6 +389,12 @@ float CApplicationPlayer::GetCachePercentage() const
     return 0.0;
 }
 
+bool CApplicationPlayer::GetCacheRanges(std::vector<std::pair<float, float> > &ranges) const
+{
+  boost::shared_ptr<IPlayer> player = GetInternal();
+  return player && player->GetCacheRanges(ranges);
+}
+
 void CApplicationPlayer::ToFFRW(int iSpeed)
 {
   boost::shared_ptr<IPlayer> player = GetInternal();
@@ -92,6 +92,7 @@ public:
   void  GetAudioStreamInfo(int index, SPlayerAudioStreamInfo &info);
   int   GetCacheLevel() const;
   float GetCachePercentage() const;
+  bool  GetCacheRanges(std::vector<std::pair<float, float> > &ranges) const;
   int   GetChapterCount();
   int   GetChapter();  
   void  GetChapterName(std::string& strChapterName);
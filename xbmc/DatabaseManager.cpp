@@ -28,6 +28,7 @@
 #include "pvr/PVRDatabase.h"
 #include "epg/EpgDatabase.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/InitGraph.h"
 
 using namespace std;
 using namespace EPG;
@@ -49,20 +50,49 @@ CDatabaseManager::~CDatabaseManager()
 
 void CDatabaseManager::Initialize(bool addonsOnly)
 {
-  Deinitialize();
+  // the status map isn't reset, each database is marked as updating while it is
+  // updated so the ones that are ready can still be opened in the meantime
   { CAddonDatabase db; UpdateDatabase(db); }
   if (addonsOnly)
     return;
   CLog::Log(LOGDEBUG, "%s, updating databases...", __FUNCTION__);
 
-  // NOTE: Order here is important. In particular, CTextureDatabase has to be updated
-  //       before CVideoDatabase.
-  { CViewDatabase db; UpdateDatabase(db); }
-  { CTextureDatabase db; UpdateDatabase(db); }
-  { CMusicDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseMusic); }
-  { CVideoDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseVideo); }
-  { CPVRDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseTV); }
-  { CEpgDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseEpg); }
+  // NOTE: The databases are independent of each other and are updated
+  //       concurrently. The only exception is CTextureDatabase which has to be
+  //       updated before CVideoDatabase.
+  CViewDatabase viewDb;
+  CTextureDatabase textureDb;
+  CMusicDatabase musicDb;
+  CVideoDatabase videoDb;
+  CPVRDatabase tvDb;
+  CEpgDatabase epgDb;
+  DatabaseUpdate updates[] = {
+    { this, &viewDb,    NULL,                               "viewdb",    "" },
+    { this, &textureDb, NULL,                               "texturedb", "" },
+    { this, &musicDb,   &g_advancedSettings.m_databaseMusic, "musicdb",   "" },
+    { this, &videoDb,   &g_advancedSettings.m_databaseVideo, "videodb",   "texturedb" },
+    { this, &tvDb,      &g_advancedSettings.m_databaseTV,    "tvdb",      "" },
+    { this, &epgDb,     &g_advancedSettings.m_databaseEpg,   "epgdb",     "" }
+  };
+
+  CInitGraph graph("databases");
+  std::string lastMySQL;
+  for (size_t i = 0; i < sizeof(updates) / sizeof(updates[0]); i++)
+  {
+    std::string dependencies = updates[i].dependencies;
+
+    // the MySQL client library doesn't like being initialized from several
+    // threads at once so MySQL databases are updated one after the other
+    if (updates[i].settings != NULL && updates[i].settings->type == "mysql")
+    {
+      if (!lastMySQL.empty())
+        dependencies += (dependencies.empty() ? "" : ",") + lastMySQL;
+      lastMySQL = updates[i].name;
+    }
+
+    graph.AddTask(updates[i].name, UpdateDatabaseTask, &updates[i], dependencies);
+  }
+  graph.Run();
   CLog::Log(LOGDEBUG, "%s, updating databases... DONE", __FUNCTION__);
 }
 
@@ -91,6 +121,16 @@ void CDatabaseManager::UpdateDatabase(CDatabase &db, DatabaseSettings *settings)
     UpdateStatus(name, DB_FAILED);
 }
 
+bool CDatabaseManager::UpdateDatabaseTask(void *data)
+{
+  DatabaseUpdate *update = (DatabaseUpdate*)data;
+  update->manager->UpdateDatabase(*update->db, update->settings);
+
+  // the outcome is tracked in m_dbStatus, a failed database must not keep
+  // the others from being updated
+  return true;
+}
+
 void CDatabaseManager::UpdateStatus(const std::string &name, DB_STATUS status)
 {
   CSingleLock lock(m_section);
@@ -76,6 +76,16 @@ private:
   void UpdateStatus(const std::string &name, DB_STATUS status);
   void UpdateDatabase(CDatabase &db, DatabaseSettings *settings = NULL);
 
+  typedef struct
+  {
+    CDatabaseManager *manager;
+    CDatabase *db;
+    DatabaseSettings *settings;
+    const char *name;
+    const char *dependencies;
+  } DatabaseUpdate;
+  static bool UpdateDatabaseTask(void *data);
+
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
 };
@@ -599,24 +599,42 @@ void CFileItem::Archive(CArchive& ar)
 
 void CFileItem::Serialize(CVariant& value) const
 {
-  //CGUIListItem::Serialize(value["CGUIListItem"]);
+  serialize(value, NULL);
+}
 
-  value["strPath"] = m_strPath;
-  value["dateTime"] = (m_dateTime.IsValid()) ? m_dateTime.GetAsRFC1123DateTime() : "";
-  value["lastmodified"] = m_dateTime.IsValid() ? m_dateTime.GetAsDBDateTime() : "";
-  value["size"] = m_dwSize;
-  value["DVDLabel"] = m_strDVDLabel;
-  value["title"] = m_strTitle;
-  value["mimetype"] = m_mimetype;
-  value["extrainfo"] = m_extrainfo;
+void CFileItem::SerializeFields(CVariant& value, const std::set<std::string>& fields) const
+{
+  serialize(value, &fields);
+}
+
+void CFileItem::serialize(CVariant& value, const std::set<std::string> *fields) const
+{
+  //CGUIListItem::Serialize(value["CGUIListItem"]);
 
-  if (m_musicInfoTag)
+  if (IsRequested(fields, "strPath"))
+    value["strPath"] = m_strPath;
+  if (IsRequested(fields, "dateTime"))
+    value["dateTime"] = (m_dateTime.IsValid()) ? m_dateTime.GetAsRFC1123DateTime() : "";
+  if (IsRequested(fields, "lastmodified"))
+    value["lastmodified"] = m_dateTime.IsValid() ? m_dateTime.GetAsDBDateTime() : "";
+  if (IsRequested(fields, "size"))
+    value["size"] = m_dwSize;
+  if (IsRequested(fields, "DVDLabel"))
+    value["DVDLabel"] = m_strDVDLabel;
+  if (IsRequested(fields, "title"))
+    value["title"] = m_strTitle;
+  if (IsRequested(fields, "mimetype"))
+    value["mimetype"] = m_mimetype;
+  if (IsRequested(fields, "extrainfo"))
+    value["extrainfo"] = m_extrainfo;
+
+  if (m_musicInfoTag && IsRequested(fields, "musicInfoTag"))
     (*m_musicInfoTag).Serialize(value["musicInfoTag"]);
 
-  if (m_videoInfoTag)
+  if (m_videoInfoTag && IsRequested(fields, "videoInfoTag"))
     (*m_videoInfoTag).Serialize(value["videoInfoTag"]);
 
-  if (m_pictureInfoTag)
+  if (m_pictureInfoTag && IsRequested(fields, "pictureInfoTag"))
     (*m_pictureInfoTag).Serialize(value["pictureInfoTag"]);
 }
 
@@ -124,6 +124,7 @@ public:
   const CFileItem& operator=(const CFileItem& item);
   virtual void Archive(CArchive& ar);
   virtual void Serialize(CVariant& value) const;
+  virtual void SerializeFields(CVariant& value, const std::set<std::string>& fields) const;
   virtual void ToSortable(SortItem &sortable, Field field) const;
   void ToSortable(SortItem &sortable, const Fields &fields) const;
   virtual bool IsFileItem() const { return true; };
@@ -467,6 +468,8 @@ public:
   int m_iBadPwdCount;
 
 private:
+  void serialize(CVariant& value, const std::set<std::string> *fields) const;
+
   /*! \brief initialize all members of this class (not CGUIListItem members) to default values.
    Called from constructors, and from Reset()
    \sa Reset, CGUIListItem
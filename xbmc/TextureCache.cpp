@@ -23,7 +23,9 @@
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/Crc32.h"
+#include "utils/CPUInfo.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -31,6 +33,9 @@
 #include "URL.h"
 #include "utils/StringUtils.h"
 
+// number of queued images at which we start caching several images at once
+#define BULK_CACHING_THRESHOLD 20
+
 using namespace XFILE;
 
 CTextureCache &CTextureCache::Get()
@@ -41,6 +46,11 @@ CTextureCache &CTextureCache::Get()
 
 CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
 {
+  m_bulkCaching = false;
+  m_bulkStart = 0;
+  m_bulkImages = 0;
+  m_bulkFailed = 0;
+  m_bulkCacheTime = 0;
 }
 
 CTextureCache::~CTextureCache()
@@ -131,6 +141,9 @@ void CTextureCache::BackgroundCacheImage(const std::string &url)
 
   // needs (re)caching
   AddJob(new CTextureCacheJob(CTextureUtils::UnwrapImageURL(url), details.hash));
+
+  if (QueueSize() >= BULK_CACHING_THRESHOLD)
+    StartBulkCaching();
 }
 
 bool CTextureCache::CacheImage(const std::string &image, CTextureDetails &details)
@@ -282,6 +295,17 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
 
   m_completeEvent.Set();
 
+  {
+    CSingleLock lock(m_bulkSection);
+    if (m_bulkCaching)
+    {
+      m_bulkImages++;
+      if (!success)
+        m_bulkFailed++;
+      m_bulkCacheTime += job->m_duration;
+    }
+  }
+
   // TODO: call back to the UI indicating that it can update it's image...
   if (success && g_advancedSettings.m_useDDSFanart && !job->m_details.file.empty())
     AddJob(new CTextureDDSJob(GetCachedPath(job->m_details.file)));
@@ -291,7 +315,43 @@ void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
     OnCachingComplete(success, (CTextureCacheJob *)job);
-  return CJobQueue::OnJobComplete(jobID, success, job);
+  CJobQueue::OnJobComplete(jobID, success, job);
+
+  if (!IsProcessing())
+    EndBulkCaching();
+}
+
+void CTextureCache::StartBulkCaching()
+{
+  CSingleLock lock(m_bulkSection);
+  if (m_bulkCaching)
+    return;
+
+  m_bulkCaching = true;
+  m_bulkStart = XbmcThreads::SystemClockMillis();
+  m_bulkImages = 0;
+  m_bulkFailed = 0;
+  m_bulkCacheTime = 0;
+
+  // the job manager limits how many of those actually run at the same time
+  unsigned int jobs = std::max(g_cpuInfo.getCPUCount(), 2);
+  CLog::Log(LOGDEBUG, "CTextureCache: %u images queued, caching up to %u at once", (unsigned int)QueueSize(), jobs);
+  SetJobsAtOnce(jobs);
+}
+
+void CTextureCache::EndBulkCaching()
+{
+  CSingleLock lock(m_bulkSection);
+  if (!m_bulkCaching)
+    return;
+
+  m_bulkCaching = false;
+  SetJobsAtOnce(1);
+
+  float duration = (XbmcThreads::SystemClockMillis() - m_bulkStart) / 1000.0f;
+  CLog::Log(LOGNOTICE, "CTextureCache: cached %u images (%u failed) in %.1f s, %.1f images/s, %u ms per image",
+            m_bulkImages, m_bulkFailed, duration, duration > 0.0f ? m_bulkImages / duration : 0.0f,
+            m_bulkImages ? (unsigned int)(m_bulkCacheTime / m_bulkImages) : 0);
 }
 
 void CTextureCache::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
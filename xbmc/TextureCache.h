@@ -221,6 +221,13 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Cache several images at once while a large backlog of images is queued.
+   Happens e.g. after a library import. The throughput is logged once the backlog is done.
+   \sa EndBulkCaching
+   */
+  void StartBulkCaching();
+  void EndBulkCaching();
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
@@ -228,5 +235,12 @@ private:
   CEvent               m_completeEvent; ///< Set whenever a job has finished
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
   CCriticalSection             m_useCountSection;
+
+  bool               m_bulkCaching;   ///< whether we're caching several images at once
+  unsigned int       m_bulkStart;     ///< time bulk caching was started
+  unsigned int       m_bulkImages;    ///< number of images cached since bulk caching was started
+  unsigned int       m_bulkFailed;    ///< number of images that failed to cache
+  uint64_t           m_bulkCacheTime; ///< total time in ms spent in the caching jobs
+  CCriticalSection   m_bulkSection;
 };
 
@@ -18,12 +18,15 @@
  *
  */
 
+#include <algorithm>
+
 #include "TextureCacheJob.h"
 #include "TextureCache.h"
 #include "guilib/Texture.h"
 #include "guilib/DDSImage.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "filesystem/File.h"
 #include "pictures/Picture.h"
@@ -42,6 +45,7 @@ CTextureCacheJob::CTextureCacheJob(const std::string &url, const std::string &ol
   m_url = url;
   m_oldHash = oldHash;
   m_cachePath = CTextureCache::GetCacheFile(m_url);
+  m_duration = 0;
 }
 
 CTextureCacheJob::~CTextureCacheJob()
@@ -71,7 +75,11 @@ bool CTextureCacheJob::DoWork()
   std::string path(CTextureCache::Get().CheckCachedImage(m_url, false, needsRecaching));
   if (!path.empty() && !needsRecaching)
     return false;
-  return CacheTexture();
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  bool success = CacheTexture();
+  m_duration = XbmcThreads::SystemClockMillis() - start;
+  return success;
 }
 
 bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
@@ -102,7 +110,17 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  // unless a specific size is requested we cache at most at the image/fanart resolution,
+  // so let the loader scale the image down while decoding (e.g. jpegs in the DCT domain)
+  // rather than decoding the full image only to scale it down afterwards.
+  unsigned int loadWidth = width, loadHeight = height;
+  if (!loadWidth || !loadHeight)
+  {
+    loadHeight = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+    loadWidth = loadHeight * 16/9;
+  }
+
+  CBaseTexture *texture = LoadImage(image, loadWidth, loadHeight, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
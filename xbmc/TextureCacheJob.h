@@ -79,6 +79,7 @@ public:
   std::string m_url;
   std::string m_oldHash;
   CTextureDetails m_details;
+  unsigned int m_duration; ///< time in ms it took to cache the image
 private:
   friend class CEdenVideoArtUpdater;
 
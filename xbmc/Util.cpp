@@ -256,10 +256,10 @@ void CUtil::CleanString(const std::string& strFileName,
 
   const vector<string> &regexps = g_advancedSettings.m_videoCleanStringRegExps;
 
-  CRegExp reTags(true, CRegExp::autoUtf8);
+  CRegExpList reTags(true, CRegExp::autoUtf8);
   CRegExp reYear(false, CRegExp::autoUtf8);
 
-  if (!reYear.RegComp(g_advancedSettings.m_videoCleanDateTimeRegExp))
+  if (!reYear.RegComp(g_advancedSettings.m_videoCleanDateTimeRegExp, CRegExp::StudyWithJitComp))
   {
     CLog::Log(LOGERROR, "%s: Invalid datetime clean RegExp:'%s'", __FUNCTION__, g_advancedSettings.m_videoCleanDateTimeRegExp.c_str());
   }
@@ -276,13 +276,17 @@ void CUtil::CleanString(const std::string& strFileName,
 
   for (unsigned int i = 0; i < regexps.size(); i++)
   {
-    if (!reTags.RegComp(regexps[i].c_str()))
+    if (!reTags.Add(regexps[i]))
     { // invalid regexp - complain in logs
       CLog::Log(LOGERROR, "%s: Invalid string clean RegExp:'%s'", __FUNCTION__, regexps[i].c_str());
-      continue;
     }
-    int j=0;
-    if ((j=reTags.RegFind(strTitleAndYear.c_str())) > 0)
+  }
+
+  int tag = -1;
+  while ((tag = reTags.Find(strTitleAndYear, tag + 1)) >= 0)
+  {
+    int j = reTags.Get(tag).GetSubStart(0);
+    if (j > 0)
       strTitleAndYear = strTitleAndYear.substr(0, j);
   }
 
@@ -538,21 +542,22 @@ bool CUtil::ExcludeFileOrFolder(const std::string& strFileOrFolder, const vector
   if (strFileOrFolder.empty())
     return false;
 
-  CRegExp regExExcludes(true, CRegExp::autoUtf8);  // case insensitive regex
+  CRegExpList regExExcludes(true, CRegExp::autoUtf8);  // case insensitive regex
 
   for (unsigned int i = 0; i < regexps.size(); i++)
   {
-    if (!regExExcludes.RegComp(regexps[i].c_str()))
+    if (!regExExcludes.Add(regexps[i]))
     { // invalid regexp - complain in logs
       CLog::Log(LOGERROR, "%s: Invalid exclude RegExp:'%s'", __FUNCTION__, regexps[i].c_str());
-      continue;
-    }
-    if (regExExcludes.RegFind(strFileOrFolder) > -1)
-    {
-      CLog::Log(LOGDEBUG, "%s: File '%s' excluded. (Matches exclude rule RegExp:'%s')", __FUNCTION__, strFileOrFolder.c_str(), regexps[i].c_str());
-      return true;
     }
   }
+
+  int i = regExExcludes.Find(strFileOrFolder);
+  if (i >= 0)
+  {
+    CLog::Log(LOGDEBUG, "%s: File '%s' excluded. (Matches exclude rule RegExp:'%s')", __FUNCTION__, strFileOrFolder.c_str(), regexps[i].c_str());
+    return true;
+  }
   return false;
 }
 
@@ -45,6 +45,11 @@ CPluginSource::CPluginSource(const cp_extension_t *ext)
     provides = CAddonMgr::Get().GetExtValue(ext->configuration, "provides");
     if (!provides.empty())
       Props().extrainfo.insert(make_pair("provides", provides));
+
+    // allow the python interpreter to be reused between invocations
+    std::string reuse = CAddonMgr::Get().GetExtValue(ext->configuration, "reuselanguageinvoker");
+    if (!reuse.empty())
+      Props().extrainfo.insert(make_pair("reuselanguageinvoker", reuse));
   }
   SetProvides(provides);
 }
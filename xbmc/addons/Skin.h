@@ -96,6 +96,11 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief Retrieve the include files that have been loaded so far
+   \return list of paths of the loaded include files
+   */
+  const std::vector<std::string>& GetIncludeFiles() const { return m_includes.GetFiles(); };
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
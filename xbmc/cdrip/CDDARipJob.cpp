@@ -19,6 +19,7 @@
  */
 
 #include "CDDARipJob.h"
+#include "CDDARipper.h"
 #include "Encoder.h"
 #include "EncoderFFmpeg.h"
 #include "FileItem.h"
@@ -41,6 +42,9 @@ using namespace ADDON;
 using namespace MUSIC_INFO;
 using namespace XFILE;
 
+// read 16 raw CD frames at once
+#define READ_CHUNK_SIZE (2352 * 16)
+
 CCDDARipJob::CCDDARipJob(const std::string& input,
                          const std::string& output,
                          const CMusicInfoTag& tag, 
@@ -50,12 +54,15 @@ CCDDARipJob::CCDDARipJob(const std::string& input,
                          unsigned int channels, unsigned int bps) : 
   m_rate(rate), m_channels(channels), m_bps(bps), m_tag(tag),
   m_input(input), m_output(CUtil::MakeLegalPath(output)), m_eject(eject),
-  m_encoder(encoder)
+  m_encoder(encoder), m_ticket(CCDDARipper::GetInstance().GetDriveTicket())
 {
 }
 
 CCDDARipJob::~CCDDARipJob()
 {
+  // let the jobs queued after us have the drive if we never got to read
+  if (m_ticket != NO_TICKET)
+    CCDDARipper::GetInstance().CancelDriveTicket(m_ticket);
 }
 
 bool CCDDARipJob::DoWork()
@@ -74,15 +81,6 @@ bool CCDDARipJob::DoWork()
     return false;
   }
 
-  // init ripper
-  CFile reader;
-  CEncoder* encoder;
-  if (!reader.Open(m_input,READ_CACHED) || !(encoder=SetupEncoder(reader)))
-  {
-    CLog::Log(LOGERROR, "Error: CCDDARipper::Init failed");
-    return false;
-  }
-
   // setup the progress dialog
   CGUIDialogExtendedProgressBar* pDlgProgress = 
       (CGUIDialogExtendedProgressBar*)g_windowManager.GetWindow(WINDOW_DIALOG_EXT_PROGRESS);
@@ -94,25 +92,72 @@ bool CCDDARipJob::DoWork()
                                             m_tag.GetTitle().c_str());
   handle->SetText(strLine0);
 
-  // start ripping
-  int percent=0;
-  int oldpercent=0;
+  // read the track as fast as the drive allows into a temporary file, the
+  // tracks read before are encoded by the other rip jobs in the meantime
+  std::string spillFile = SetupTempFile();
   bool cancelled(false);
-  int result;
-  while (!cancelled && (result=RipChunk(reader, encoder, percent)) == 0)
+  int result = 1;
+  if (spillFile.empty())
+    CLog::Log(LOGERROR, "CDDARipper: Error creating temporary file for %s", m_input.c_str());
+  else if (CCDDARipper::GetInstance().AcquireDrive(m_ticket, this))
+  {
+    // don't open the reader before we own the drive, and read it uncached
+    // so nothing is read from the drive after we released it
+    CFile reader;
+    CFile writer;
+    if (reader.Open(m_input) && writer.OpenForWrite(spillFile, true))
+      result = ReadTrack(reader, writer, handle, cancelled);
+    writer.Close();
+    reader.Close();
+    CCDDARipper::GetInstance().ReleaseDrive();
+    m_ticket = NO_TICKET;
+  }
+  else
+  {
+    cancelled = true;
+    m_ticket = NO_TICKET;
+  }
+
+  if (!cancelled && result == 2 && m_eject)
+  {
+    CLog::Log(LOGINFO, "Ejecting CD");
+    g_mediaManager.EjectTray();
+  }
+
+  // init encoder
+  CFile spill;
+  CEncoder* encoder = NULL;
+  if (!cancelled && result == 2 &&
+      (!spill.Open(spillFile) || !(encoder=SetupEncoder(spill))))
+  {
+    CLog::Log(LOGERROR, "Error: CCDDARipper::Init failed");
+    result = 1;
+  }
+
+  // start encoding
+  int percent=50;
+  int oldpercent=50;
+  while (!cancelled && result == 2 && (result=EncodeChunk(spill, encoder, percent)) == 0)
   {
     cancelled = ShouldCancel(percent,100);
     if (percent > oldpercent)
     {
       oldpercent = percent;
       handle->SetPercentage(static_cast<float>(percent));
+      handle->SetTitle(StringUtils::Format("%s (%.1fx)", g_localizeStrings.Get(605).c_str(),
+                                           CCDDARipper::GetInstance().GetRipSpeed()));
     }
   }
 
-  // close encoder ripper
-  encoder->CloseEncode();
-  delete encoder;
-  reader.Close();
+  // close encoder
+  if (encoder)
+  {
+    encoder->CloseEncode();
+    delete encoder;
+  }
+  spill.Close();
+  if (!spillFile.empty())
+    CFile::Delete(spillFile);
 
   if (file.IsRemote() && !cancelled && result == 2)
   {
@@ -138,43 +183,68 @@ bool CCDDARipJob::DoWork()
   else if (result < 0)
     CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
   else
-  {
     CLog::Log(LOGINFO, "Finished ripping %s", m_input.c_str());
-    if (m_eject)
-    {
-      CLog::Log(LOGINFO, "Ejecting CD");
-      g_mediaManager.EjectTray();
-    }
-  }
 
   handle->MarkFinished();
 
   return !cancelled && result == 2;
 }
 
-int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
+int CCDDARipJob::ReadTrack(CFile& reader, CFile& writer,
+                           CGUIDialogProgressBarHandle* handle, bool& cancelled)
 {
-  percent = 0;
+  int64_t length = reader.GetLength();
+  if (length <= 0)
+    return 1;
 
+  uint8_t stream[READ_CHUNK_SIZE];
+
+  int oldpercent = 0;
+  int64_t pos = 0;
+  while (pos < length)
+  {
+    ssize_t result = reader.Read(stream, static_cast<size_t>(std::min(length - pos, (int64_t)READ_CHUNK_SIZE)));
+    if (result <= 0 || writer.Write(stream, result) != result)
+      return 1;
+    pos += result;
+
+    // reading is the first half of the progress
+    int percent = static_cast<int>(pos * 50 / length);
+    if ((cancelled = ShouldCancel(percent, 100)))
+      return 1;
+    if (percent > oldpercent)
+    {
+      oldpercent = percent;
+      handle->SetPercentage(static_cast<float>(percent));
+    }
+  }
+
+  return 2;
+}
+
+int CCDDARipJob::EncodeChunk(CFile& reader, CEncoder* encoder, int& percent)
+{
   uint8_t stream[1024];
 
   // get data
-  int result = reader.Read(stream, 1024);
-
-  // return if rip is done or on some kind of error
+  ssize_t result = reader.Read(stream, 1024);
   if (result <= 0)
     return 1;
 
   // encode data
   int encres=encoder->Encode(result, stream);
 
-  // Get progress indication
-  percent = static_cast<int>(reader.GetPosition()*100/reader.GetLength());
+  // encoding is the second half of the progress
+  percent = 50 + static_cast<int>(reader.GetPosition() * 50 / reader.GetLength());
+  CCDDARipper::GetInstance().AddRippedAudio(static_cast<double>(result) / (m_rate * m_channels * m_bps / 8));
+
+  if (encres != 1)
+    return -1;
 
   if (reader.GetPosition() == reader.GetLength())
     return 2;
 
-  return -(1-encres);
+  return 0;
 }
 
 CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
@@ -23,6 +23,7 @@
 #include "music/tags/MusicInfoTag.h"
 
 class CEncoder;
+class CGUIDialogProgressBarHandle;
 
 namespace XFILE
 {
@@ -59,15 +60,27 @@ protected:
   //! \brief Helper used if output is a remote url
   std::string SetupTempFile();
 
-  //! \brief Rip a chunk of audio
+  //! \brief Read the whole track into a temporary file
   //! \param reader The input reader
+  //! \param writer The temporary file receiving the audio of the track
+  //! \param handle The progress bar of the track
+  //! \param cancelled Whether the job has been cancelled on return
+  //! \return 2 if the track has been read, or
+  //!         1 if the reader failed
+  //! \sa CCDDARipper::AcquireDrive
+  int ReadTrack(XFILE::CFile& reader, XFILE::CFile& writer,
+                CGUIDialogProgressBarHandle* handle, bool& cancelled);
+
+  //! \brief Encode a chunk of audio read before
+  //! \param reader The temporary file holding the audio of the track
   //! \param encoder The audio encoder
   //! \param percent The percentage completed on return
-  //! \return 0 (CDDARIP_OK) if everything went okay, or
-  //!         a positive error code from the reader, or
+  //! \return 0 if everything went okay, or
+  //!         2 if the whole track has been encoded, or
+  //!         1 if reading the temporary file failed, or
   //!         -1 if the encoder failed
-  //! \sa CCDDARipper::GetData, CEncoder::Encode
-  int RipChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
+  //! \sa CEncoder::Encode
+  int EncodeChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
 
   unsigned int m_rate; //< The sample rate of the input file 
   unsigned int m_channels; //< The number of channels in input file
@@ -77,5 +90,8 @@ protected:
   std::string m_output; //< The output url
   bool m_eject; //< Should we eject tray when we are finished?
   int m_encoder; //< The audio encoder
+  unsigned int m_ticket; //< Our place in the queue for the drive, NO_TICKET once served
+
+  static const unsigned int NO_TICKET = static_cast<unsigned int>(-1);
 };
 
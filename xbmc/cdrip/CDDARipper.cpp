@@ -18,6 +18,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "threads/SystemClock.h"
 #include "system.h"
 
@@ -41,6 +43,8 @@
 #include "filesystem/SpecialProtocol.h"
 #include "storage/MediaManager.h"
 #include "guilib/LocalizeStrings.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
@@ -61,9 +65,19 @@ CCDDARipper& CCDDARipper::GetInstance()
   return sRipper;
 }
 
+// tracks being ripped at once, limited by the workers of the job manager for low priority jobs
+#define MAX_PARALLEL_RIPS 3
+
 CCDDARipper::CCDDARipper()
-  : CJobQueue(false, 1) //enforce fifo and non-parallel processing
+  : CJobQueue(false, 1), //enforce fifo processing
+    m_driveFree(true),
+    m_nextTicket(0),
+    m_servingTicket(0),
+    m_ripStart(0),
+    m_rippedSeconds(0.0)
 {
+  // the drive is read by one job at a time, the encoding is done in parallel
+  SetJobsAtOnce(std::min(std::max(g_cpuInfo.getCPUCount(), 1), MAX_PARALLEL_RIPS));
 }
 
 CCDDARipper::~CCDDARipper()
@@ -143,6 +157,7 @@ bool CCDDARipper::RipCD()
     if (item->GetPath().find(".cdda") == std::string::npos)
       continue;
 
+    // the tracks are read in order, so the tray is ejected once the last track has been read
     bool eject = CSettings::Get().GetBool("audiocds.ejectonrip") && 
                  i == vecItems.Size()-1;
     AddJob(new CCDDARipJob(item->GetPath(),strFile,
@@ -308,8 +323,20 @@ void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
   if (success)
   {
-    if(CJobQueue::QueueEmpty())
+    CJobQueue::OnJobComplete(jobID, success, job);
+
+    // other tracks may still be encoding
+    if (!IsProcessing())
     {
+      {
+        CSingleLock lock(m_driveSection);
+        if (m_ripStart != 0)
+          CLog::Log(LOGINFO, "CDDARipper: ripped %.0f seconds of audio at %.1fx realtime",
+                    m_rippedSeconds, m_rippedSeconds * 1000.0 / std::max(XbmcThreads::SystemClockMillis() - m_ripStart, 1U));
+        m_ripStart = 0;
+        m_rippedSeconds = 0.0;
+      }
+
       std::string dir = URIUtils::GetDirectory(((CCDDARipJob*)job)->GetOutput());
       bool unimportant;
       int source = CUtil::GetMatchingSource(dir, *CMediaSourceSettings::Get().CMediaSourceSettings::GetSources("music"), unimportant);
@@ -320,10 +347,86 @@ void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
         g_application.StartMusicScan(dir, false);
       database.Close();
     }
-    return CJobQueue::OnJobComplete(jobID, success, job);
+    return;
   }
 
   CancelJobs();
+
+  CSingleLock lock(m_driveSection);
+  m_ripStart = 0;
+  m_rippedSeconds = 0.0;
+}
+
+unsigned int CCDDARipper::GetDriveTicket()
+{
+  CSingleLock lock(m_driveSection);
+  return m_nextTicket++;
+}
+
+bool CCDDARipper::AcquireDrive(unsigned int ticket, const CJob* job)
+{
+  CSingleLock lock(m_driveSection);
+  while (m_servingTicket != ticket)
+  {
+    lock.Leave();
+    bool cancelled = job->ShouldCancel(0, 100);
+    if (!cancelled)
+      m_driveFree.WaitMSec(100);
+    lock.Enter();
+
+    if (cancelled)
+    {
+      CancelDriveTicket(ticket);
+      return false;
+    }
+  }
+
+  m_driveFree.Reset();
+  if (m_ripStart == 0)
+    m_ripStart = XbmcThreads::SystemClockMillis();
+  return true;
+}
+
+void CCDDARipper::ReleaseDrive()
+{
+  CSingleLock lock(m_driveSection);
+  NextDriveTicket();
+}
+
+void CCDDARipper::CancelDriveTicket(unsigned int ticket)
+{
+  CSingleLock lock(m_driveSection);
+  if (ticket == m_servingTicket)
+    NextDriveTicket();
+  else if (ticket - m_servingTicket < m_nextTicket - m_servingTicket)
+    m_cancelledTickets.insert(ticket);
+}
+
+void CCDDARipper::NextDriveTicket()
+{
+  // skip the jobs that gave up while waiting for their turn
+  ++m_servingTicket;
+  while (m_cancelledTickets.erase(m_servingTicket))
+    ++m_servingTicket;
+  m_driveFree.Set();
+}
+
+void CCDDARipper::AddRippedAudio(double seconds)
+{
+  CSingleLock lock(m_driveSection);
+  m_rippedSeconds += seconds;
+}
+
+double CCDDARipper::GetRipSpeed()
+{
+  CSingleLock lock(m_driveSection);
+  if (m_ripStart == 0)
+    return 0.0;
+
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_ripStart;
+  if (elapsed == 0)
+    return 0.0;
+  return m_rippedSeconds * 1000.0 / elapsed;
 }
 
 #endif
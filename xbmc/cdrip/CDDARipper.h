@@ -21,7 +21,10 @@
  *
  */
 
+#include <set>
 #include <string>
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "utils/JobManager.h"
 
 class CFileItem;
@@ -40,6 +43,8 @@ namespace MUSIC_INFO
  for the track file name.
  Format used to encode ripped tracks is defined by the audiocds.encoder user setting, and 
  there are several choices: wav, ogg vorbis and mp3.
+ Tracks are read from the drive one at a time, in the order they were queued, while the tracks
+ read before are encoded in parallel.
  */
 class CCDDARipper : public CJobQueue
 {
@@ -63,6 +68,39 @@ public:
 
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob* job);
 
+  /*! \brief Get a ticket defining the order the drive is handed out to the rip jobs
+   \return the ticket of the job
+   */
+  unsigned int GetDriveTicket();
+
+  /*! \brief Wait until all jobs with an earlier ticket are done with the drive
+   \param[in] ticket the ticket of the job
+   \param[in] job the job waiting, used to check whether it has been cancelled
+   \return true if the job may read from the drive, false if it has been cancelled
+   \sa ReleaseDrive
+   */
+  bool AcquireDrive(unsigned int ticket, const CJob* job);
+
+  /*! \brief Hand the drive to the next job after reading a track
+   \sa AcquireDrive
+   */
+  void ReleaseDrive();
+
+  /*! \brief Give up a ticket that won't be used to read from the drive
+   \param[in] ticket the ticket of the job
+   */
+  void CancelDriveTicket(unsigned int ticket);
+
+  /*! \brief Account audio that has been encoded to the overall ripping speed
+   \param[in] seconds duration of the encoded audio
+   */
+  void AddRippedAudio(double seconds);
+
+  /*! \brief Return the overall ripping speed since ripping started
+   \return the speed relative to realtime playback
+   */
+  double GetRipSpeed();
+
 private:
   // private construction and no assignments
   CCDDARipper();
@@ -95,6 +133,18 @@ private:
    \return track file name
    */
   std::string GetTrackName(CFileItem *item);
+
+  /*! \brief Serve the next ticket that hasn't been given up, called with m_driveSection held
+   */
+  void NextDriveTicket();
+
+  CCriticalSection m_driveSection;
+  CEvent m_driveFree;
+  unsigned int m_nextTicket;              ///< the ticket handed out to the next job
+  unsigned int m_servingTicket;           ///< the ticket of the job allowed to read from the drive
+  std::set<unsigned int> m_cancelledTickets; ///< tickets given up before they were served
+  unsigned int m_ripStart;                ///< time ripping started, 0 if not ripping
+  double m_rippedSeconds;                 ///< duration of the audio encoded since ripping started
 };
 
 #endif // _CCDDARIPPERMP3_H
@@ -30,6 +30,7 @@
 CAESinkNULL::CAESinkNULL()
   : CThread("AESinkNull"),
     m_draining(false),
+    m_realtime(true),
     m_sink_frameSize(0),
     m_sinkbuffer_size(0),
     m_sinkbuffer_level(0),
@@ -50,6 +51,10 @@ bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
   format.m_frameSize     = format.m_frameSamples * (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
   m_format = format;
 
+  // "NULL:unthrottled" swallows the audio as fast as it is delivered, which
+  // is used for benchmarking decoding throughput
+  m_realtime = device != "unthrottled";
+
   // setup a pretend 500ms internal buffer
   m_sink_frameSize = format.m_channelLayout.Count() * CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3;
   m_sinkbuffer_size = m_sink_frameSize * format.m_sampleRate / 2;
@@ -142,6 +147,9 @@ void CAESinkNULL::Process()
       // drain it
       m_sinkbuffer_level -= read_bytes;
 
+      if (!m_realtime)
+        continue;
+
       // we MUST drain at the correct audio sample rate
       // or the NULL sink will not work right. So calc
       // an approximate sleep time.
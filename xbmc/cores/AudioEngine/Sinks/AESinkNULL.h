@@ -46,6 +46,7 @@ private:
   CEvent               m_wake;
   CEvent               m_inited;
   volatile bool        m_draining;
+  bool                 m_realtime;         ///< drain at the sample rate of the stream
   AEAudioFormat        m_format;
   unsigned int         m_sink_frameSize;
   unsigned int         m_sinkbuffer_size;  ///< total size of the buffer
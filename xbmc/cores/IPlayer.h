@@ -25,6 +25,8 @@
 #include "IPlayerCallback.h"
 #include "guilib/Geometry.h"
 #include <string>
+#include <utility>
+#include <vector>
 
 struct TextCacheStruct_t;
 class TiXmlElement;
@@ -145,6 +147,12 @@ public:
   virtual void SeekPercentage(float fPercent = 0){}
   virtual float GetPercentage(){ return 0;}
   virtual float GetCachePercentage(){ return 0;}
+  /*!
+   \brief Get the parts of the file held by the cache, e.g. to show them on the seek bar
+   \param ranges receives the start and end of each cached part, in percent of the file
+   \return false if the player has no cache ranges
+   */
+  virtual bool GetCacheRanges(std::vector<std::pair<float, float> > &ranges) { return false; }
   virtual void SetMute(bool bOnOff){}
   virtual void SetVolume(float volume){}
   virtual bool ControlsVolume(){ return false;}
@@ -34,10 +34,12 @@
 #include "settings/DisplaySettings.h"
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
+#include "settings/SettingHandle.h"
 #include "VideoShaders/YUV2RGBShader.h"
 #include "VideoShaders/VideoFilterShader.h"
 #include "windowing/WindowingFactory.h"
 #include "guilib/Texture.h"
+#include "guilib/GUITextureGL.h"
 #include "guilib/LocalizeStrings.h"
 #include "guilib/MatrixGLES.h"
 #include "threads/SingleLock.h"
@@ -77,6 +79,9 @@ extern "C" {
 
 using namespace Shaders;
 
+static CSettingHandle<bool> s_limitedRange("videoscreen.limitedrange");
+static CSettingHandle<int> s_hqScalers("videoplayer.hqscalers");
+
 static const GLubyte stipple_weave[] = {
   0x00, 0x00, 0x00, 0x00,
   0xFF, 0xFF, 0xFF, 0xFF,
@@ -576,6 +581,9 @@ void CLinuxRendererGL::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
 {
   int index = m_iYV12RenderBuffer;
 
+  // the video is drawn on top of the GUI textures collected so far
+  CGUITextureGL::Flush();
+
   if (!ValidateRenderer())
   {
     if (clear) //if clear is set, we're expected to overwrite all backbuffer pixels, even if we have nothing to render
@@ -3240,7 +3248,7 @@ bool CLinuxRendererGL::Supports(ERENDERFEATURE feature)
 {
   if(feature == RENDERFEATURE_BRIGHTNESS)
   {
-    if ((m_renderMethod & RENDER_VDPAU) && !CSettings::Get().GetBool("videoscreen.limitedrange"))
+    if ((m_renderMethod & RENDER_VDPAU) && !s_limitedRange)
       return true;
 
     if (m_renderMethod & RENDER_VAAPI)
@@ -3253,7 +3261,7 @@ bool CLinuxRendererGL::Supports(ERENDERFEATURE feature)
   
   if(feature == RENDERFEATURE_CONTRAST)
   {
-    if ((m_renderMethod & RENDER_VDPAU) && !CSettings::Get().GetBool("videoscreen.limitedrange"))
+    if ((m_renderMethod & RENDER_VDPAU) && !s_limitedRange)
       return true;
 
     if (m_renderMethod & RENDER_VAAPI)
@@ -3389,7 +3397,7 @@ bool CLinuxRendererGL::Supports(ESCALINGMETHOD method)
     // if scaling is below level, avoid hq scaling
     float scaleX = fabs(((float)m_sourceWidth - m_destRect.Width())/m_sourceWidth)*100;
     float scaleY = fabs(((float)m_sourceHeight - m_destRect.Height())/m_sourceHeight)*100;
-    int minScale = CSettings::Get().GetInt("videoplayer.hqscalers");
+    int minScale = s_hqScalers.Get();
     if (scaleX < minScale && scaleY < minScale)
       return false;
 
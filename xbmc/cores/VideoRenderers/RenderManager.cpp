@@ -37,6 +37,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
+#include "settings/SettingHandle.h"
 #include "guilib/GUIFontManager.h"
 #include "cores/DataCacheCore.h"
 
@@ -65,6 +66,8 @@
 
 #define MAXPRESENTDELAY 0.500
 
+static CSettingHandle<int> s_vsync("videoscreen.vsync");
+
 /* at any point we want an exclusive lock on rendermanager */
 /* we must make sure we don't have a graphiccontext lock */
 /* these two functions allow us to step out from that lock */
@@ -748,7 +751,7 @@ float CXBMCRenderManager::GetMaximumFPS()
 {
   float fps;
 
-  if (CSettings::Get().GetInt("videoscreen.vsync") != VSYNC_DISABLED)
+  if (s_vsync.Get() != VSYNC_DISABLED)
   {
     fps = (float)g_VideoReferenceClock.GetRefreshRate();
     if (fps <= 0) fps = g_graphicsContext.GetFPS();
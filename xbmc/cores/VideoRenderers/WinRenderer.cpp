@@ -31,6 +31,7 @@
 #include "settings/DisplaySettings.h"
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
+#include "settings/SettingHandle.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
@@ -40,6 +41,8 @@
 #include "windowing/WindowingFactory.h"
 #include "cores/FFmpeg.h"
 
+static CSettingHandle<int> s_hqScalers("videoplayer.hqscalers");
+
 typedef struct {
   RenderMethod  method;
   const char   *name;
@@ -1305,7 +1308,7 @@ bool CWinRenderer::Supports(ESCALINGMETHOD method)
         // if scaling is below level, avoid hq scaling
         float scaleX = fabs(((float)m_sourceWidth - m_destRect.Width())/m_sourceWidth)*100;
         float scaleY = fabs(((float)m_sourceHeight - m_destRect.Height())/m_sourceHeight)*100;
-        int minScale = CSettings::Get().GetInt("videoplayer.hqscalers");
+        int minScale = s_hqScalers.Get();
         if (scaleX < minScale && scaleY < minScale)
           return false;
         return true;
@@ -38,6 +38,7 @@
 #include "utils/log.h"
 #include "boost/shared_ptr.hpp"
 #include "threads/Atomics.h"
+#include "utils/TimeUtils.h"
 
 #ifndef TARGET_POSIX
 #define RINT(x) ((x) >= 0 ? ((int)((x) + 0.5)) : ((int)((x) - 0.5)))
@@ -72,6 +73,25 @@ extern "C" {
 
 using namespace boost;
 
+// pictures to average the decoding time over before adapting the decoder
+#define DECODE_LOAD_WINDOW 30
+// share of the frame duration spent decoding above which we speed up decoding
+// and below which we go back to full quality
+#define DECODE_LOAD_HIGH   0.9
+#define DECODE_LOAD_LOW    0.6
+
+// steps of loop filter skipping, from full quality to fastest
+static const AVDiscard SkipLoopFilterSteps[] =
+{
+  AVDISCARD_DEFAULT,
+  AVDISCARD_NONREF,
+  AVDISCARD_BIDIR,
+  AVDISCARD_NONINTRA,
+  AVDISCARD_NONKEY,
+  AVDISCARD_ALL
+};
+static const int SkipLoopFilterStepCount = sizeof(SkipLoopFilterSteps) / sizeof(SkipLoopFilterSteps[0]);
+
 enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
                                                 , const PixelFormat * fmt )
 {
@@ -186,6 +206,15 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_decoderPts = DVD_NOPTS_VALUE;
   m_codecControlFlags = 0;
   m_requestSkipDeint = false;
+  m_frameDuration = 0.0;
+  m_decodeTime = 0;
+  m_decodeFrames = 0;
+  m_skipLoopFilter = 0;
+  m_skipLoopFilterMin = -1;
+  m_dropState = false;
+  m_threadCount = 0;
+  m_frameThreadingPending = false;
+  m_options = NULL;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -294,13 +323,33 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     m_pCodecContext->skip_loop_filter = (AVDiscard)g_advancedSettings.m_iSkipLoopFilter;
   }
 
+  // software decoding skips more of the loop filter when it can't keep up,
+  // starting from the configured value. Thumbnail extraction doesn't care
+  // and a negative value means the loop filter must never be skipped.
+  m_skipLoopFilterMin = -1;
+  if (g_advancedSettings.m_iSkipLoopFilter >= 0 && !hints.software)
+  {
+    m_skipLoopFilterMin = 0;
+    while (m_skipLoopFilterMin + 1 < SkipLoopFilterStepCount
+        && SkipLoopFilterSteps[m_skipLoopFilterMin + 1] <= g_advancedSettings.m_iSkipLoopFilter)
+      m_skipLoopFilterMin++;
+  }
+  m_skipLoopFilter = std::max(m_skipLoopFilterMin, 0);
+
+  if (hints.fpsrate > 0 && hints.fpsscale > 0)
+    m_frameDuration = DVD_TIME_BASE * (double)hints.fpsscale / hints.fpsrate;
+
   // set any special options
   for(std::vector<CDVDCodecOption>::iterator it = options.m_keys.begin(); it != options.m_keys.end(); ++it)
   {
     if (it->m_name == "surfaces")
       m_uSurfacesCount = std::atoi(it->m_value.c_str());
     else
+    {
       av_opt_set(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0);
+      // kept to set them again when the decoder is reopened
+      av_dict_set(&m_options, it->m_name.c_str(), it->m_value.c_str(), 0);
+    }
   }
 
   int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
@@ -309,7 +358,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     || pCodec->id == AV_CODEC_ID_MPEG4
     || pCodec->id == AV_CODEC_ID_HEVC
     || pCodec->id == AV_CODEC_ID_VP9))
+  {
     m_pCodecContext->thread_count = num_threads;
+    m_threadCount = num_threads;
+  }
 
   if (avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
   {
@@ -350,6 +402,7 @@ void CDVDVideoCodecFFmpeg::Dispose()
   DisposeHWDecoders();
 
   FilterClose();
+  av_dict_free(&m_options);
 }
 
 void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
@@ -373,17 +426,103 @@ void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_NONREF;
     }
     else
     {
       m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
       m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
     }
+    m_dropState = bDrop;
+    ApplySkipLoopFilter(bDrop);
   }
 }
 
+void CDVDVideoCodecFFmpeg::ApplySkipLoopFilter(bool drop)
+{
+  AVDiscard discard;
+  if (m_skipLoopFilterMin < 0)
+    discard = drop ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+  else
+    discard = SkipLoopFilterSteps[m_skipLoopFilter];
+
+  if (drop && discard < AVDISCARD_NONREF)
+    discard = AVDISCARD_NONREF;
+
+  m_pCodecContext->skip_loop_filter = discard;
+}
+
+void CDVDVideoCodecFFmpeg::UpdateDecodeLoad(int64_t decodeTime)
+{
+  m_decodeTime += decodeTime;
+  if (++m_decodeFrames < DECODE_LOAD_WINDOW)
+    return;
+
+  double load = (double)m_decodeTime * DVD_TIME_BASE / CurrentHostFrequency() / m_decodeFrames / m_frameDuration;
+  m_decodeTime = 0;
+  m_decodeFrames = 0;
+
+  if (load > DECODE_LOAD_HIGH)
+  {
+    // frame threading is the cheaper way to catch up, but it needs the
+    // decoder to be reopened, which is only done when it is flushed anyway
+    if (!m_frameThreadingPending && m_threadCount > 1
+    && !(m_pCodecContext->active_thread_type & FF_THREAD_FRAME)
+    && (m_pCodecContext->codec->capabilities & CODEC_CAP_FRAME_THREADS))
+    {
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::UpdateDecodeLoad - decoding takes %d%% of the frame duration, switching to frame threading on next reset",
+                (int)(load * 100));
+      m_frameThreadingPending = true;
+    }
+
+    if (m_skipLoopFilter + 1 < SkipLoopFilterStepCount)
+    {
+      m_skipLoopFilter++;
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::UpdateDecodeLoad - decoding takes %d%% of the frame duration, skip loop filter %d",
+                (int)(load * 100), SkipLoopFilterSteps[m_skipLoopFilter]);
+      ApplySkipLoopFilter(m_dropState);
+    }
+  }
+  else if (load < DECODE_LOAD_LOW && m_skipLoopFilter > m_skipLoopFilterMin)
+  {
+    m_skipLoopFilter--;
+    CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::UpdateDecodeLoad - decoding takes %d%% of the frame duration, skip loop filter %d",
+              (int)(load * 100), SkipLoopFilterSteps[m_skipLoopFilter]);
+    ApplySkipLoopFilter(m_dropState);
+  }
+}
+
+bool CDVDVideoCodecFFmpeg::ReopenFrameThreaded()
+{
+  const AVCodec *codec = m_pCodecContext->codec;
+  avcodec_close(m_pCodecContext);
+
+  // hardware decoding doesn't work with frame threading
+  m_bSoftware = true;
+  m_pCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+  m_pCodecContext->thread_count = m_threadCount;
+  if (OpenCodec(codec))
+  {
+    CLog::Log(LOGNOTICE, "CDVDVideoCodecFFmpeg::ReopenFrameThreaded - using frame threading with %d threads", m_threadCount);
+    return true;
+  }
+
+  CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::ReopenFrameThreaded - unable to reopen codec, keeping slice threading");
+  m_pCodecContext->thread_type = FF_THREAD_SLICE;
+  if (!OpenCodec(codec))
+    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::ReopenFrameThreaded - unable to reopen codec");
+  return false;
+}
+
+bool CDVDVideoCodecFFmpeg::OpenCodec(const AVCodec *codec)
+{
+  // avcodec_open2 takes out the options it used, so hand it a copy
+  AVDictionary *options = NULL;
+  av_dict_copy(&options, m_options, 0);
+  bool result = avcodec_open2(m_pCodecContext, codec, &options) >= 0;
+  av_dict_free(&options);
+  return result;
+}
+
 unsigned int CDVDVideoCodecFFmpeg::SetFilters(unsigned int flags)
 {
   m_filters_next.clear();
@@ -492,7 +631,10 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
+  int64_t decodeStart = CurrentHostCounter();
   len = avcodec_decode_video2(m_pCodecContext, m_pFrame, &iGotPicture, &avpkt);
+  if (iGotPicture && m_pHardware == NULL && m_skipLoopFilterMin >= 0 && m_frameDuration > 0.0)
+    UpdateDecodeLoad(CurrentHostCounter() - decodeStart);
 
   if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
@@ -570,6 +712,13 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_started = false;
   m_decoderPts = DVD_NOPTS_VALUE;
   m_iLastKeyframe = m_pCodecContext->has_b_frames;
+
+  if (m_frameThreadingPending)
+  {
+    m_frameThreadingPending = false;
+    if (m_pHardware == NULL)
+      ReopenFrameThreaded();
+  }
   avcodec_flush_buffers(m_pCodecContext);
 
   if (m_pHardware)
@@ -78,6 +78,11 @@ public:
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
 
+  void UpdateDecodeLoad(int64_t decodeTime);
+  void ApplySkipLoopFilter(bool drop);
+  bool ReopenFrameThreaded();
+  bool OpenCodec(const AVCodec *codec);
+
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
   int  FilterProcess(AVFrame* frame);
@@ -126,4 +131,15 @@ protected:
   int    m_skippedDeint;
   bool   m_requestSkipDeint;
   int    m_codecControlFlags;
+
+  // adaptive software decoding
+  double  m_frameDuration;      // from the stream info, 0 if unknown
+  int64_t m_decodeTime;         // host counter ticks spent decoding in the current window
+  int     m_decodeFrames;       // pictures decoded in the current window
+  int     m_skipLoopFilter;     // index into the loop filter skipping steps
+  int     m_skipLoopFilterMin;  // lowest step, from advancedsettings, -1 to never adapt
+  bool    m_dropState;
+  int     m_threadCount;
+  bool    m_frameThreadingPending;
+  AVDictionary *m_options;      // codec options, to reopen the decoder with
 };
@@ -21,6 +21,7 @@
  */
 
 #include <string>
+#include <vector>
 #include "utils/BitstreamStats.h"
 #include "filesystem/IFileTypes.h"
 
@@ -174,6 +175,11 @@ public:
    */
   virtual bool GetCacheStatus(XFILE::SCacheStatus *status) { return false; }
 
+  /*! \brief Get the byte ranges of the stream held by the cache
+   \return true when the cache ranges were succesfully obtained
+   */
+  virtual bool GetCacheRanges(std::vector<XFILE::SCacheRange> &ranges) { return false; }
+
   bool IsStreamType(DVDStreamType type) const { return m_streamType == type; }
   virtual bool IsEOF() = 0;
   virtual BitstreamStats GetBitstreamStats() const { return m_stats; }
@@ -159,6 +159,11 @@ bool CDVDInputStreamFile::GetCacheStatus(XFILE::SCacheStatus *status)
     return false;
 }
 
+bool CDVDInputStreamFile::GetCacheRanges(std::vector<XFILE::SCacheRange> &ranges)
+{
+  return m_pFile && m_pFile->IoControl(IOCTRL_CACHE_RANGES, &ranges) >= 0;
+}
+
 BitstreamStats CDVDInputStreamFile::GetBitstreamStats() const
 {
   if (!m_pFile)
@@ -38,6 +38,7 @@ public:
   virtual int GetBlockSize();
   virtual void SetReadRate(unsigned rate);
   virtual bool GetCacheStatus(XFILE::SCacheStatus *status);
+  virtual bool GetCacheRanges(std::vector<XFILE::SCacheRange> &ranges);
 
 protected:
   XFILE::CFile* m_pFile;
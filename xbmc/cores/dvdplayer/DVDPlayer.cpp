@@ -66,6 +66,7 @@
 #include "FileItem.h"
 #include "GUIUserMessages.h"
 #include "settings/Settings.h"
+#include "settings/SettingHandle.h"
 #include "settings/MediaSettings.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
@@ -96,6 +97,8 @@
 using namespace std;
 using namespace PVR;
 
+static CSettingHandle<bool> s_parseCaptions("subtitles.parsecaptions");
+
 void CSelectionStreams::Clear(StreamType type, StreamSource source)
 {
   CSingleLock lock(m_section);
@@ -1439,7 +1442,7 @@ void CDVDPlayer::Process()
     CheckBetterStream(m_CurrentTeletext, pStream);
 
     // demux video stream
-    if (CSettings::Get().GetBool("subtitles.parsecaptions") && CheckIsCurrent(m_CurrentVideo, pStream, pPacket))
+    if (s_parseCaptions && CheckIsCurrent(m_CurrentVideo, pStream, pPacket))
     {
       if (m_pCCDemuxer)
       {
@@ -2985,6 +2988,13 @@ float CDVDPlayer::GetCachePercentage()
   return (float) (m_StateInput.cache_offset * 100); // NOTE: Percentage returned is relative
 }
 
+bool CDVDPlayer::GetCacheRanges(std::vector<std::pair<float, float> > &ranges)
+{
+  CSingleLock lock(m_StateSection);
+  ranges = m_StateInput.cache_ranges;
+  return !ranges.empty();
+}
+
 void CDVDPlayer::SetAVDelay(float fValue)
 {
   m_dvdPlayerVideo->SetDelay( (fValue * DVD_TIME_BASE) ) ;
@@ -4357,6 +4367,15 @@ void CDVDPlayer::UpdatePlayState(double timeout)
   else
     state.cache_bytes = 0;
 
+  state.cache_ranges.clear();
+  std::vector<XFILE::SCacheRange> ranges;
+  int64_t length = m_pInputStream ? m_pInputStream->GetLength() : 0;
+  if (length > 0 && m_pInputStream->GetCacheRanges(ranges))
+  {
+    for (std::vector<XFILE::SCacheRange>::const_iterator it = ranges.begin(); it != ranges.end(); ++it)
+      state.cache_ranges.push_back(std::make_pair((float)(it->start * 100.0 / length), (float)(it->end * 100.0 / length)));
+  }
+
   UpdateClockMaster();
 
   state.timestamp = CDVDClock::GetAbsoluteClock();
@@ -233,6 +233,7 @@ public:
   virtual void SeekPercentage(float iPercent);
   virtual float GetPercentage();
   virtual float GetCachePercentage();
+  virtual bool GetCacheRanges(std::vector<std::pair<float, float> > &ranges);
 
   virtual void SetVolume(float nVolume)                         { m_dvdPlayerAudio->SetVolume(nVolume); }
   virtual void SetMute(bool bOnOff)                             { m_dvdPlayerAudio->SetMute(bOnOff); }
@@ -490,6 +491,7 @@ protected:
       cache_level   = 0.0;
       cache_delay   = 0.0;
       cache_offset  = 0.0;
+      cache_ranges.clear();
     }
 
     int    player;            // source of this data
@@ -521,6 +523,7 @@ protected:
     double  cache_level;   // current estimated required cache level
     double  cache_delay;   // time until cache is expected to reach estimated level
     double  cache_offset;  // percentage of file ahead of current position
+    std::vector<std::pair<float, float> > cache_ranges; // cached parts of the file, in percent
   } m_State, m_StateInput;
   CCriticalSection m_StateSection;
 
@@ -24,6 +24,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
+#include "settings/SettingHandle.h"
 #include "video/VideoReferenceClock.h"
 #include "utils/MathUtils.h"
 #include "DVDPlayer.h"
@@ -48,6 +49,8 @@
 using namespace std;
 using namespace RenderManager;
 
+static CSettingHandle<int> s_adjustRefreshRate("videoplayer.adjustrefreshrate");
+
 class CPulldownCorrection
 {
 public:
@@ -983,7 +986,7 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
 #ifdef HAS_VIDEO_PLAYBACK
   double config_framerate = m_bFpsInvalid ? 0.0 : m_fFrameRate;
   double render_framerate = g_graphicsContext.GetFPS();
-  if (CSettings::Get().GetInt("videoplayer.adjustrefreshrate") == ADJUST_REFRESHRATE_OFF)
+  if (s_adjustRefreshRate.Get() == ADJUST_REFRESHRATE_OFF)
     render_framerate = config_framerate;
   /* check so that our format or aspect has changed. if it has, reconfigure renderer */
   if (!g_renderManager.IsConfigured()
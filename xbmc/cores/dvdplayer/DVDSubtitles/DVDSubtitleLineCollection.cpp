@@ -18,17 +18,20 @@
  *
  */
 
+#include <algorithm>
+
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
 
+static bool CompareStartTime(const CDVDOverlay *left, const CDVDOverlay *right)
+{
+  return left->iPTSStartTime < right->iPTSStartTime;
+}
 
 CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
+  m_current = 0;
+  m_indexed = false;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +41,82 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
-
-  m_iSize++;
+  m_overlays.push_back(pOverlay);
+  m_indexed = false;
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
-  {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
-  }
+  std::stable_sort(m_overlays.begin(), m_overlays.end(), CompareStartTime);
+  m_indexed = false;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  if (m_current >= m_overlays.size())
+    return NULL;
+
+  if (!m_indexed)
+    BuildIndex();
 
-  if (m_pCurrent)
+  // find the first line from the current position on that hasn't ended yet
+  int next = FindNext(1, 0, m_stopIndex.size() / 2 - 1, iPts);
+  if (next < 0)
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
+    m_current = m_overlays.size();
+    return NULL;
   }
-  return pOverlay;
+
+  // advance to the next overlay
+  m_current = next + 1;
+  return m_overlays[next];
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
+  for (std::vector<CDVDOverlay*>::iterator it = m_overlays.begin(); it != m_overlays.end(); ++it)
+    (*it)->Release();
 
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
+  m_overlays.clear();
+  m_stopIndex.clear();
+  m_current = 0;
+  m_indexed = false;
+}
 
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
+void CDVDSubtitleLineCollection::BuildIndex()
+{
+  unsigned int leaves = 1;
+  while (leaves < m_overlays.size())
+    leaves <<= 1;
+
+  // the leaves start at index "leaves", unused ones never match
+  m_stopIndex.assign(2 * leaves, DVD_NOPTS_VALUE);
+  for (unsigned int i = 0; i < m_overlays.size(); i++)
+    m_stopIndex[leaves + i] = m_overlays[i]->iPTSStopTime;
+  for (unsigned int node = leaves - 1; node > 0; node--)
+    m_stopIndex[node] = std::max(m_stopIndex[2 * node], m_stopIndex[2 * node + 1]);
+
+  m_indexed = true;
+}
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+int CDVDSubtitleLineCollection::FindNext(unsigned int node, unsigned int first, unsigned int last, double iPts) const
+{
+  // first/last are the lines covered by the node, which may extend beyond
+  // the actual lines for the unused leaves of the tree
+  if (last < m_current || m_stopIndex[node] < iPts)
+    return -1;
+
+  if (first == last)
+    return first < m_overlays.size() ? (int)first : -1;
+
+  unsigned int middle = first + (last - first) / 2;
+  int result = FindNext(2 * node, first, middle, iPts);
+  if (result < 0)
+    result = FindNext(2 * node + 1, middle + 1, last, iPts);
+  return result;
 }
@@ -20,41 +20,43 @@
  *
  */
 
-#include "../DVDCodecs/Overlay/DVDOverlay.h"
+#include <vector>
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
+#include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-} ListElement;
+/*!
+ \brief The parsed lines of a subtitle file.
 
+ The lines are kept sorted by their start time. Lines may overlap, so to find
+ the next line that is still visible at a given pts an index of the maximum
+ stop time of each range of lines is kept, which allows seeking anywhere in
+ the file in O(log n) instead of walking all lines from the beginning.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
   void Sort();
 
-  CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
+  CDVDOverlay* Get(double iPts = 0LL); // get the next overlay that hasn't ended before iPts
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return (int)m_overlays.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  void BuildIndex();
+  int FindNext(unsigned int node, unsigned int first, unsigned int last, double iPts) const;
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
-};
+  std::vector<CDVDOverlay*> m_overlays;
+  unsigned int m_current;
 
+  // segment tree over the stop times, m_stopIndex[node] is the maximum stop
+  // time of all lines covered by that node
+  std::vector<double> m_stopIndex;
+  bool m_indexed;
+};
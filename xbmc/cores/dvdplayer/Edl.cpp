@@ -18,6 +18,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "Edl.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -45,6 +47,21 @@ using namespace std;
 
 using namespace XFILE;
 
+/*
+ * Comparators for upper_bound() over the sorted cuts.
+ */
+template<class T>
+static bool StartsAfter(const int iTime, const T& cut)
+{
+  return iTime < cut.start;
+}
+
+template<class T>
+static bool StartsAfterClock(const int iClock, const T& cut)
+{
+  return iClock < cut.start - cut.cutTimeBefore;
+}
+
 CEdl::CEdl()
 {
   Clear();
@@ -59,6 +76,7 @@ void CEdl::Clear()
 {
   m_vecCuts.clear();
   m_vecSceneMarkers.clear();
+  m_vecCutTimes.clear();
   m_iTotalCutTime = 0;
 }
 
@@ -164,6 +182,8 @@ bool CEdl::ReadEditDecisionLists(const std::string& strMovie, const float fFrame
   if (bFound)
     MergeShortCommBreaks();
 
+  UpdateIndex();
+
   return bFound;
 }
 
@@ -729,18 +749,10 @@ bool CEdl::AddCut(Cut& cut)
   }
   else
   {
-    vector<Cut>::iterator pCurrentCut;
-    for (pCurrentCut = m_vecCuts.begin(); pCurrentCut != m_vecCuts.end(); ++pCurrentCut)
-    {
-      if (cut.start < pCurrentCut->start)
-      {
-        CLog::Log(LOGDEBUG, "%s - Inserting new cut [%s - %s], %d", __FUNCTION__,
-                  MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
-                  cut.action);
-        m_vecCuts.insert(pCurrentCut, cut);
-        break;
-      }
-    }
+    CLog::Log(LOGDEBUG, "%s - Inserting new cut [%s - %s], %d", __FUNCTION__,
+              MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
+              cut.action);
+    m_vecCuts.insert(upper_bound(m_vecCuts.begin(), m_vecCuts.end(), cut.start, StartsAfter<Cut>), cut);
   }
 
   if (cut.action == CUT)
@@ -758,7 +770,7 @@ bool CEdl::AddSceneMarker(const int iSceneMarker)
 
   CLog::Log(LOGDEBUG, "%s - Inserting new scene marker: %s", __FUNCTION__,
             MillisecondsToTimeString(iSceneMarker).c_str());
-  m_vecSceneMarkers.push_back(iSceneMarker); // Unsorted
+  m_vecSceneMarkers.push_back(iSceneMarker); // Sorted in UpdateIndex()
 
   return true;
 }
@@ -775,41 +787,30 @@ int CEdl::GetTotalCutTime() const
 
 int CEdl::RemoveCutTime(int iSeek) const
 {
-  if (!HasCut())
+  // find the last cut starting at or before the seek time, all cuts before it have been passed over
+  vector<CutTime>::const_iterator cut = upper_bound(m_vecCutTimes.begin(), m_vecCutTimes.end(), iSeek, StartsAfter<CutTime>);
+  if (cut == m_vecCutTimes.begin())
     return iSeek;
+  --cut;
+
+  int iCutTime = cut->cutTimeBefore;
+  if (iSeek <= cut->end) // Inside cut
+    iCutTime += iSeek - cut->start - 1; // Decrease cut length by 1ms to jump over end boundary.
+  else // Cut has already been passed over.
+    iCutTime += cut->end - cut->start;
 
-  /*
-   * TODO: Consider an optimisation of using the (now unused) total cut time if the seek time
-   * requested is later than the end of the last recorded cut. For example, when calculating the
-   * total duration for display.
-   */
-  int iCutTime = 0;
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
-  {
-    if (m_vecCuts[i].action == CUT)
-    {
-      if (iSeek >= m_vecCuts[i].start && iSeek <= m_vecCuts[i].end) // Inside cut
-        iCutTime += iSeek - m_vecCuts[i].start - 1; // Decrease cut length by 1ms to jump over end boundary.
-      else if (iSeek >= m_vecCuts[i].start) // Cut has already been passed over.
-        iCutTime += m_vecCuts[i].end - m_vecCuts[i].start;
-    }
-  }
   return iSeek - iCutTime;
 }
 
 int CEdl::RestoreCutTime(int iClock) const
 {
-  if (!HasCut())
+  // find the last cut starting at or before the clock once the cuts before it have been removed
+  vector<CutTime>::const_iterator cut = upper_bound(m_vecCutTimes.begin(), m_vecCutTimes.end(), iClock, StartsAfterClock<CutTime>);
+  if (cut == m_vecCutTimes.begin())
     return iClock;
+  --cut;
 
-  int iSeek = iClock;
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
-  {
-    if (m_vecCuts[i].action == CUT && iSeek >= m_vecCuts[i].start)
-      iSeek += m_vecCuts[i].end - m_vecCuts[i].start;
-  }
-
-  return iSeek;
+  return iClock + cut->cutTimeBefore + cut->end - cut->start;
 }
 
 bool CEdl::HasSceneMarker() const
@@ -853,20 +854,18 @@ std::string CEdl::GetInfo() const
 
 bool CEdl::InCut(const int iSeek, Cut *pCut) const
 {
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
-  {
-    if (iSeek < m_vecCuts[i].start) // Early exit if not even up to the cut start time.
-      return false;
+  // the cuts don't overlap so only the last cut starting at or before the seek time can contain it
+  vector<Cut>::const_iterator cut = upper_bound(m_vecCuts.begin(), m_vecCuts.end(), iSeek, StartsAfter<Cut>);
+  if (cut == m_vecCuts.begin())
+    return false;
+  --cut;
 
-    if (iSeek >= m_vecCuts[i].start && iSeek <= m_vecCuts[i].end) // Inside cut.
-    {
-      if (pCut)
-        *pCut = m_vecCuts[i];
-      return true;
-    }
-  }
+  if (iSeek > cut->end)
+    return false;
 
-  return false;
+  if (pCut)
+    *pCut = *cut;
+  return true;
 }
 
 bool CEdl::GetNextSceneMarker(bool bPlus, const int iClock, int *iSceneMarker) const
@@ -881,26 +880,20 @@ bool CEdl::GetNextSceneMarker(bool bPlus, const int iClock, int *iSceneMarker) c
 
   if (bPlus) // Find closest scene forwards
   {
-    for (int i = 0; i < (int)m_vecSceneMarkers.size(); i++)
+    vector<int>::const_iterator marker = upper_bound(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end(), iSeek);
+    if (marker != m_vecSceneMarkers.end() && *marker - iSeek < iDiff)
     {
-      if ((m_vecSceneMarkers[i] > iSeek) && ((m_vecSceneMarkers[i] - iSeek) < iDiff))
-      {
-        iDiff = m_vecSceneMarkers[i] - iSeek;
-        *iSceneMarker = m_vecSceneMarkers[i];
-        bFound = true;
-      }
+      *iSceneMarker = *marker;
+      bFound = true;
     }
   }
   else // Find closest scene backwards
   {
-    for (int i = 0; i < (int)m_vecSceneMarkers.size(); i++)
+    vector<int>::const_iterator marker = lower_bound(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end(), iSeek);
+    if (marker != m_vecSceneMarkers.begin() && iSeek - *(marker - 1) < iDiff)
     {
-      if ((m_vecSceneMarkers[i] < iSeek) && ((iSeek - m_vecSceneMarkers[i]) < iDiff))
-      {
-        iDiff = iSeek - m_vecSceneMarkers[i];
-        *iSceneMarker = m_vecSceneMarkers[i];
-        bFound = true;
-      }
+      *iSceneMarker = *(marker - 1);
+      bFound = true;
     }
   }
 
@@ -1118,3 +1111,20 @@ void CEdl::MergeShortCommBreaks()
   }
   return;
 }
+
+void CEdl::UpdateIndex()
+{
+  sort(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end());
+
+  m_vecCutTimes.clear();
+  int iCutTime = 0;
+  for (vector<Cut>::const_iterator it = m_vecCuts.begin(); it != m_vecCuts.end(); ++it)
+  {
+    if (it->action != CUT)
+      continue;
+
+    CutTime cut = { it->start, it->end, iCutTime };
+    m_vecCutTimes.push_back(cut);
+    iCutTime += it->end - it->start;
+  }
+}
@@ -63,9 +63,21 @@ public:
 
 protected:
 private:
+  /*
+   * A cut of type CUT together with the total length of all cuts of type CUT before it, which allows
+   * to map between the time of the file and the time shown to the user without looking at every cut.
+   */
+  struct CutTime
+  {
+    int start;         // ms
+    int end;           // ms
+    int cutTimeBefore; // ms
+  };
+
   int m_iTotalCutTime; // ms
-  std::vector<Cut> m_vecCuts;
-  std::vector<int> m_vecSceneMarkers;
+  std::vector<Cut> m_vecCuts;         // sorted by start time, not overlapping
+  std::vector<int> m_vecSceneMarkers; // sorted
+  std::vector<CutTime> m_vecCutTimes; // sorted by start time
 
   bool ReadEdl(const std::string& strMovie, const float fFramesPerSecond);
   bool ReadComskip(const std::string& strMovie, const float fFramesPerSecond);
@@ -79,4 +91,5 @@ private:
   bool AddSceneMarker(const int sceneMarker);
 
   void MergeShortCommBreaks();
+  void UpdateIndex();
 };
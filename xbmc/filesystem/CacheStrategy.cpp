@@ -36,6 +36,10 @@
 #define CacheLocalFile CWin32File
 #endif // TARGET_WINDOWS
 
+#include <algorithm>
+
+#define SPARSE_CACHE_BLOCK_SIZE (256 * 1024)
+
 using namespace XFILE;
 
 CCacheStrategy::CCacheStrategy() : m_bEndOfInput(false)
@@ -278,6 +282,405 @@ CCacheStrategy *CSimpleFileCache::CreateNew()
 }
 
 
+CSparseFileCache::CSparseFileCache(size_t maxSize)
+  : m_maxSize(maxSize)
+  , m_slotCount(std::max<size_t>(maxSize / SPARSE_CACHE_BLOCK_SIZE, 4))
+  , m_cacheFile(new CacheLocalFile())
+  , m_hDataAvailEvent(NULL)
+  , m_useCounter(0)
+  , m_nWritePosition(0)
+  , m_nReadPosition(0) {
+}
+
+CSparseFileCache::~CSparseFileCache()
+{
+  Close();
+  delete m_cacheFile;
+}
+
+int CSparseFileCache::Open()
+{
+  Close();
+
+  CSingleLock lock(m_sync);
+
+  m_hDataAvailEvent = new CEvent;
+
+  m_filename = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+  if (m_filename.empty())
+  {
+    CLog::Log(LOGERROR, "%s - Unable to generate a new filename", __FUNCTION__);
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  // the file is opened for reading and writing
+  if (!m_cacheFile->OpenForWrite(CURL(m_filename), false))
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\"", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_freeSlots.reserve(m_slotCount);
+  for (unsigned int slot = m_slotCount; slot > 0; slot--)
+    m_freeSlots.push_back(slot - 1);
+
+  return CACHE_RC_OK;
+}
+
+void CSparseFileCache::Close()
+{
+  CSingleLock lock(m_sync);
+
+  delete m_hDataAvailEvent;
+  m_hDataAvailEvent = NULL;
+
+  m_cacheFile->Close();
+
+  if (!m_filename.empty() && !m_cacheFile->Delete(CURL(m_filename)))
+    CLog::LogF(LOGWARNING, "failed to delete temporary file \"%s\"", m_filename.c_str());
+
+  m_filename.clear();
+  m_blocks.clear();
+  m_freeSlots.clear();
+  m_nWritePosition = 0;
+  m_nReadPosition = 0;
+}
+
+int64_t CSparseFileCache::GetRangeEnd(int64_t iFilePosition) const
+{
+  int64_t index = iFilePosition / SPARSE_CACHE_BLOCK_SIZE;
+  unsigned int offset = (unsigned int)(iFilePosition % SPARSE_CACHE_BLOCK_SIZE);
+
+  BlockMap::const_iterator it = m_blocks.find(index);
+  if (it == m_blocks.end() || offset < it->second.begin || offset >= it->second.end)
+  {
+    // the write position is always cached, data for it is on its way
+    return iFilePosition == m_nWritePosition ? iFilePosition : -1;
+  }
+
+  // follow the range over all adjacent blocks
+  while (it->second.end == SPARSE_CACHE_BLOCK_SIZE)
+  {
+    BlockMap::const_iterator next = it;
+    ++next;
+    if (next == m_blocks.end() || next->first != it->first + 1 || next->second.begin != 0)
+      break;
+    it = next;
+  }
+
+  return it->first * SPARSE_CACHE_BLOCK_SIZE + it->second.end;
+}
+
+int64_t CSparseFileCache::GetAvailableRead() const
+{
+  int64_t end = GetRangeEnd(m_nReadPosition);
+  return end < 0 ? 0 : end - m_nReadPosition;
+}
+
+bool CSparseFileCache::IsProtected(int64_t block) const
+{
+  // blocks between the read and the write position are still to be read
+  return block >= m_nReadPosition / SPARSE_CACHE_BLOCK_SIZE &&
+         block <= m_nWritePosition / SPARSE_CACHE_BLOCK_SIZE;
+}
+
+unsigned int CSparseFileCache::GetFreeSlots() const
+{
+  unsigned int count = m_freeSlots.size();
+  for (BlockMap::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (!IsProtected(it->first))
+      count++;
+  }
+  return count;
+}
+
+CSparseFileCache::Block* CSparseFileCache::GetWriteBlock()
+{
+  int64_t index = m_nWritePosition / SPARSE_CACHE_BLOCK_SIZE;
+  BlockMap::iterator it = m_blocks.find(index);
+  if (it != m_blocks.end())
+    return &it->second;
+
+  unsigned int slot;
+  if (!m_freeSlots.empty())
+  {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+  else
+  {
+    // reuse the least recently used block
+    BlockMap::iterator lru = m_blocks.end();
+    for (it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    {
+      if (!IsProtected(it->first) && (lru == m_blocks.end() || it->second.lastUse < lru->second.lastUse))
+        lru = it;
+    }
+    if (lru == m_blocks.end())
+      return NULL;
+
+    slot = lru->second.slot;
+    m_blocks.erase(lru);
+  }
+
+  unsigned int offset = (unsigned int)(m_nWritePosition % SPARSE_CACHE_BLOCK_SIZE);
+  Block block = { slot, offset, offset, ++m_useCounter };
+  return &m_blocks.insert(std::make_pair(index, block)).first->second;
+}
+
+size_t CSparseFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t space = (int64_t)GetFreeSlots() * SPARSE_CACHE_BLOCK_SIZE;
+  unsigned int offset = (unsigned int)(m_nWritePosition % SPARSE_CACHE_BLOCK_SIZE);
+  if (m_blocks.find(m_nWritePosition / SPARSE_CACHE_BLOCK_SIZE) != m_blocks.end())
+    space += SPARSE_CACHE_BLOCK_SIZE - offset;
+  else if (space > 0)
+    space -= offset;
+
+  return (int64_t)iRequestSize > space ? (size_t)space : iRequestSize;
+}
+
+int CSparseFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  CSingleLock lock(m_sync);
+
+  size_t written = 0;
+  while (iSize > 0)
+  {
+    Block *block = GetWriteBlock();
+    if (!block)
+      break;
+
+    unsigned int offset = (unsigned int)(m_nWritePosition % SPARSE_CACHE_BLOCK_SIZE);
+    size_t toWrite = std::min<size_t>(iSize, SPARSE_CACHE_BLOCK_SIZE - offset);
+    int64_t filePosition = (int64_t)block->slot * SPARSE_CACHE_BLOCK_SIZE + offset;
+    if (m_cacheFile->Seek(filePosition, SEEK_SET) != filePosition)
+    {
+      CLog::LogF(LOGERROR, "can't seek file");
+      return CACHE_RC_ERROR;
+    }
+
+    const ssize_t lastWritten = m_cacheFile->Write(pBuffer + written, toWrite);
+    if (lastWritten <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file");
+      return CACHE_RC_ERROR;
+    }
+
+    // extend the valid data of the block, or replace it if the new data isn't adjacent
+    unsigned int end = offset + (unsigned int)lastWritten;
+    if (end < block->begin || offset > block->end)
+    {
+      block->begin = offset;
+      block->end = end;
+    }
+    else
+    {
+      block->begin = std::min(block->begin, offset);
+      block->end = std::max(block->end, end);
+    }
+    block->lastUse = ++m_useCounter;
+
+    m_nWritePosition += lastWritten;
+    iSize -= lastWritten;
+    written += lastWritten;
+  }
+
+  // when reader waits for data it will wait on the event.
+  if (written > 0)
+    m_hDataAvailEvent->Set();
+
+  return written;
+}
+
+int CSparseFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t iAvailable = GetAvailableRead();
+  if ( iAvailable <= 0 )
+    return m_bEndOfInput? 0 : CACHE_RC_WOULD_BLOCK;
+
+  size_t toRead = ((int64_t)iMaxSize > iAvailable) ? (size_t)iAvailable : iMaxSize;
+
+  size_t readBytes = 0;
+  while (toRead > 0)
+  {
+    BlockMap::iterator it = m_blocks.find(m_nReadPosition / SPARSE_CACHE_BLOCK_SIZE);
+    if (it == m_blocks.end())
+      break;
+
+    unsigned int offset = (unsigned int)(m_nReadPosition % SPARSE_CACHE_BLOCK_SIZE);
+    size_t chunk = std::min<size_t>(toRead, SPARSE_CACHE_BLOCK_SIZE - offset);
+    int64_t filePosition = (int64_t)it->second.slot * SPARSE_CACHE_BLOCK_SIZE + offset;
+    if (m_cacheFile->Seek(filePosition, SEEK_SET) != filePosition)
+    {
+      CLog::LogF(LOGERROR, "can't seek file");
+      return CACHE_RC_ERROR;
+    }
+
+    const ssize_t lastRead = m_cacheFile->Read(pBuffer + readBytes, chunk);
+    if (lastRead <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to read from file");
+      return CACHE_RC_ERROR;
+    }
+    it->second.lastUse = ++m_useCounter;
+
+    m_nReadPosition += lastRead;
+    toRead -= lastRead;
+    readBytes += lastRead;
+  }
+
+  if (readBytes > 0)
+    m_space.Set();
+
+  return readBytes;
+}
+
+int64_t CSparseFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  if( iMillis == 0 || IsEndOfInput() )
+    return GetAvailableRead();
+
+  XbmcThreads::EndTime endTime(iMillis);
+  while (!IsEndOfInput())
+  {
+    int64_t iAvail = GetAvailableRead();
+    if (iAvail >= iMinAvail)
+      return iAvail;
+
+    CSingleExit exit(m_sync);
+    if (!m_hDataAvailEvent->WaitMSec(endTime.MillisLeft()))
+      return CACHE_RC_TIMEOUT;
+  }
+  return GetAvailableRead();
+}
+
+int64_t CSparseFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  /* Only the range being written can be read from without a reset. Other
+   * ranges are still cached, but need the writer to move to their end.
+   */
+  int64_t writeRangeEnd = GetRangeEnd(m_nWritePosition);
+  if (GetRangeEnd(iFilePosition) != writeRangeEnd)
+  {
+    int64_t nDiff = iFilePosition - writeRangeEnd;
+    if (nDiff <= 0 || nDiff > 500000)
+    {
+      CLog::Log(LOGDEBUG,"CSparseFileCache::Seek - position %" PRId64" not in the range being cached", iFilePosition);
+      return CACHE_RC_ERROR;
+    }
+
+    // the reader may move once the lock is left
+    int64_t readPosition = m_nReadPosition;
+    lock.Leave();
+    WaitForData((unsigned int)(iFilePosition - readPosition), 5000);
+    lock.Enter();
+
+    if (GetRangeEnd(iFilePosition) != GetRangeEnd(m_nWritePosition))
+    {
+      CLog::Log(LOGDEBUG,"CSparseFileCache::Seek - Attempt to seek past read data");
+      return CACHE_RC_ERROR;
+    }
+  }
+
+  m_nReadPosition = iFilePosition;
+  m_space.Set();
+
+  return iFilePosition;
+}
+
+bool CSparseFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (clearAnyway)
+  {
+    for (BlockMap::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+      m_freeSlots.push_back(it->second.slot);
+    m_blocks.clear();
+  }
+  else
+  {
+    // continue caching at the end of the range holding the new position
+    int64_t end = GetRangeEnd(iSourcePosition);
+    if (end >= 0)
+    {
+      m_nReadPosition = iSourcePosition;
+      m_nWritePosition = end;
+      return false;
+    }
+  }
+
+  m_nReadPosition = iSourcePosition;
+  m_nWritePosition = iSourcePosition;
+  return true;
+}
+
+void CSparseFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_hDataAvailEvent->Set();
+}
+
+int64_t CSparseFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  int64_t end = GetRangeEnd(iFilePosition);
+  return end >= 0 ? end : iFilePosition;
+}
+
+int64_t CSparseFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_nWritePosition;
+}
+
+bool CSparseFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return GetRangeEnd(iFilePosition) >= 0;
+}
+
+bool CSparseFileCache::GetCachedRanges(std::vector<SCacheRange> &ranges)
+{
+  CSingleLock lock(m_sync);
+
+  ranges.clear();
+  for (BlockMap::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (it->second.begin == it->second.end)
+      continue;
+
+    int64_t start = it->first * SPARSE_CACHE_BLOCK_SIZE + it->second.begin;
+    int64_t end = it->first * SPARSE_CACHE_BLOCK_SIZE + it->second.end;
+    if (!ranges.empty() && ranges.back().end == start)
+      ranges.back().end = end;
+    else
+    {
+      SCacheRange range = { start, end };
+      ranges.push_back(range);
+    }
+  }
+
+  return true;
+}
+
+CCacheStrategy *CSparseFileCache::CreateNew()
+{
+  return new CSparseFileCache(m_maxSize);
+}
+
+
 CDoubleCache::CDoubleCache(CCacheStrategy *impl)
 {
   assert(NULL != impl);
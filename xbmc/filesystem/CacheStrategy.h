@@ -23,7 +23,10 @@
 #define XFILECACHESTRATEGY_H
 
 #include <stdint.h>
+#include <map>
 #include <string>
+#include <vector>
+#include "IFileTypes.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -68,6 +71,13 @@ public:
   virtual int64_t CachedDataEndPos() = 0;
   virtual bool IsCachedPosition(int64_t iFilePosition) = 0;
 
+  /*!
+   \brief Get all ranges of the file held by the cache
+   \param ranges receives the cached ranges, sorted by position
+   \return false if the strategy doesn't keep track of its ranges
+   */
+  virtual bool GetCachedRanges(std::vector<SCacheRange> &ranges) { return false; }
+
   virtual CCacheStrategy *CreateNew() = 0;
 
   CEvent m_space;
@@ -112,6 +122,68 @@ protected:
   volatile int64_t m_nReadPosition;
 };
 
+/*!
+ \brief Disk backed cache keeping a sparse set of downloaded ranges.
+
+ The file is split in blocks of SPARSE_CACHE_BLOCK_SIZE bytes which are stored
+ in slots of a temporary file of bounded size. Seeking outside of the range
+ being downloaded doesn't discard anything: previously downloaded ranges stay
+ available until their blocks are reused for new data, least recently used
+ first. Blocks between the read and the write position are never reused.
+ */
+class CSparseFileCache : public CCacheStrategy {
+public:
+  CSparseFileCache(size_t maxSize);
+  virtual ~CSparseFileCache();
+
+  virtual int Open() ;
+  virtual void Close() ;
+
+  virtual size_t GetMaxWriteSize(const size_t& iRequestSize) ;
+  virtual int WriteToCache(const char *pBuffer, size_t iSize) ;
+  virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) ;
+  virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) ;
+
+  virtual int64_t Seek(int64_t iFilePosition);
+  virtual bool Reset(int64_t iSourcePosition, bool clearAnyway=true);
+  virtual void EndOfInput();
+
+  virtual int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition);
+  virtual int64_t CachedDataEndPos();
+  virtual bool IsCachedPosition(int64_t iFilePosition);
+  virtual bool GetCachedRanges(std::vector<SCacheRange> &ranges);
+
+  virtual CCacheStrategy *CreateNew();
+
+protected:
+  typedef struct
+  {
+    unsigned int slot;  // slot of the block in the cache file
+    unsigned int begin; // valid data of the block, relative to its start
+    unsigned int end;
+    uint64_t lastUse;
+  } Block;
+  typedef std::map<int64_t, Block> BlockMap;
+
+  int64_t GetRangeEnd(int64_t iFilePosition) const;
+  int64_t GetAvailableRead() const;
+  bool IsProtected(int64_t block) const;
+  unsigned int GetFreeSlots() const;
+  Block* GetWriteBlock();
+
+  size_t        m_maxSize;
+  unsigned int  m_slotCount;
+  std::string   m_filename;
+  IFile*        m_cacheFile;
+  CEvent*       m_hDataAvailEvent;
+  BlockMap      m_blocks;
+  std::vector<unsigned int> m_freeSlots;
+  uint64_t      m_useCounter;
+  int64_t       m_nWritePosition;
+  int64_t       m_nReadPosition;
+  CCriticalSection m_sync;
+};
+
 class CDoubleCache : public CCacheStrategy{
 public:
   CDoubleCache(CCacheStrategy *impl);
@@ -0,0 +1,567 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ChangeJournal.h"
+#include "File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#ifdef TARGET_LINUX
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+#endif
+
+using namespace XFILE;
+
+#define JOURNAL_FILE "special://masterprofile/changejournal.xml"
+
+#ifdef TARGET_LINUX
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | \
+                    IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+// filesystems that can be changed by other hosts without us being told
+static const uint32_t NetworkFilesystems[] = {
+  0x6969,     // nfs
+  0x517B,     // smbfs
+  0xFF534D42, // cifs
+  0xFE534D42, // smb2
+  0x65735546, // fuse (sshfs, davfs, ...)
+  0x73757245, // coda
+  0x5346414F, // afs
+  0x01021997, // 9p
+  0x00C36400  // ceph
+};
+#endif
+
+CChangeJournal::CChangeJournal() : CThread("ChangeJournal")
+{
+#ifdef TARGET_LINUX
+  m_fd = -1;
+#endif
+  m_sequence = 0;
+}
+
+CChangeJournal::~CChangeJournal()
+{
+}
+
+CChangeJournal &CChangeJournal::Get()
+{
+  static CChangeJournal sChangeJournal;
+  return sChangeJournal;
+}
+
+void CChangeJournal::Start()
+{
+#ifdef TARGET_LINUX
+  if (m_fd >= 0)
+    return;
+
+  m_fd = inotify_init();
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGERROR, "CChangeJournal: unable to initialize inotify (%s)", strerror(errno));
+    return;
+  }
+  fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+  fcntl(m_fd, F_SETFD, FD_CLOEXEC);
+
+  Load();
+  Create();
+#endif
+}
+
+void CChangeJournal::Stop()
+{
+#ifdef TARGET_LINUX
+  if (m_fd < 0)
+    return;
+
+  StopThread();
+  close(m_fd);
+  m_fd = -1;
+  m_watches.clear();
+  m_links.clear();
+
+  Save();
+
+  CSingleLock lock(m_critSection);
+  for (Roots::iterator it = m_roots.begin(); it != m_roots.end(); ++it)
+    it->second.watching = false;
+  m_scanned.clear();
+  m_changes.clear();
+#endif
+}
+
+void CChangeJournal::Watch(const std::string &path)
+{
+  std::string directory(GetPath(path));
+  if (!IsLocal(directory))
+    return;
+
+  CSingleLock lock(m_critSection);
+  Root &root = m_roots[directory];
+  root.used = true;
+  if (!root.watching)
+    root.pending = true;
+}
+
+unsigned int CChangeJournal::GetSequence() const
+{
+  CSingleLock lock(m_critSection);
+  return m_sequence;
+}
+
+bool CChangeJournal::IsUnchanged(const std::string &client, const std::string &path, bool recursive) const
+{
+  std::string directory(GetPath(path));
+
+  CSingleLock lock(m_critSection);
+  std::map<std::string, Sequences>::const_iterator scanned = m_scanned.find(client);
+  if (scanned == m_scanned.end())
+    return false;
+  Sequences::const_iterator it = scanned->second.find(directory);
+  if (it == scanned->second.end())
+    return false;
+  unsigned int since = it->second;
+
+  // changes made before the watches were complete may not have been recorded
+  if (!IsWatched(directory, since))
+    return false;
+
+  if (!recursive)
+  {
+    it = m_changes.find(directory);
+    return it == m_changes.end() || it->second <= since;
+  }
+
+  for (it = m_changes.lower_bound(directory); it != m_changes.end() && StringUtils::StartsWith(it->first, directory); ++it)
+  {
+    if (it->second > since)
+      return false;
+  }
+  return true;
+}
+
+void CChangeJournal::SetScanned(const std::string &client, const std::string &path, unsigned int sequence)
+{
+  std::string directory(GetPath(path));
+
+  CSingleLock lock(m_critSection);
+  // no point in remembering folders we couldn't vouch for
+  if (!IsWatched(directory, sequence))
+    return;
+
+  unsigned int &scanned = m_scanned[client][directory];
+  if (sequence > scanned)
+    scanned = sequence;
+}
+
+void CChangeJournal::GetRoots(const std::set<std::string> &paths, std::vector<std::string> &roots)
+{
+  // folders below another one sort right after it
+  roots.clear();
+  for (std::set<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+  {
+    if (roots.empty() || !StringUtils::StartsWith(*it, roots.back()))
+      roots.push_back(*it);
+  }
+}
+
+std::string CChangeJournal::GetPath(const std::string &path)
+{
+  std::string directory(path);
+  URIUtils::AddSlashAtEnd(directory);
+  return directory;
+}
+
+bool CChangeJournal::IsLocal(const std::string &path)
+{
+#ifdef TARGET_LINUX
+  // only plain paths, as changes are recorded under the paths we are given
+  if (!StringUtils::StartsWith(path, "/"))
+    return false;
+
+  struct statfs fs;
+  if (statfs(path.c_str(), &fs) != 0)
+    return false;
+
+  for (size_t i = 0; i < sizeof(NetworkFilesystems) / sizeof(NetworkFilesystems[0]); i++)
+  {
+    if ((uint32_t)fs.f_type == NetworkFilesystems[i])
+      return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool CChangeJournal::IsWatched(const std::string &directory, unsigned int since) const
+{
+  // look for a root at or above the directory that has been watched without a break since then
+  std::string parent(directory);
+  while (parent.size() > 1)
+  {
+    Roots::const_iterator it = m_roots.find(parent);
+    if (it != m_roots.end() && it->second.watching && it->second.watchedAt <= since)
+      return true;
+    parent.erase(parent.rfind('/', parent.size() - 2) + 1);
+  }
+  return false;
+}
+
+void CChangeJournal::AddChange(const std::string &directory)
+{
+  CSingleLock lock(m_critSection);
+  m_changes[directory] = ++m_sequence;
+}
+
+void CChangeJournal::RemoveChanges(const std::string &directory)
+{
+  CSingleLock lock(m_critSection);
+  Sequences::iterator it = m_changes.lower_bound(directory);
+  while (it != m_changes.end() && StringUtils::StartsWith(it->first, directory))
+    m_changes.erase(it++);
+
+  for (std::map<std::string, Sequences>::iterator client = m_scanned.begin(); client != m_scanned.end(); ++client)
+  {
+    it = client->second.lower_bound(directory);
+    while (it != client->second.end() && StringUtils::StartsWith(it->first, directory))
+      client->second.erase(it++);
+  }
+}
+
+void CChangeJournal::Invalidate(const std::string &directory, bool ancestors)
+{
+  CSingleLock lock(m_critSection);
+  for (Roots::iterator it = m_roots.lower_bound(directory); it != m_roots.end() && StringUtils::StartsWith(it->first, directory); ++it)
+    it->second.watching = false;
+
+  if (ancestors)
+  {
+    std::string parent(directory);
+    while (parent.size() > 1)
+    {
+      parent.erase(parent.rfind('/', parent.size() - 2) + 1);
+      Roots::iterator it = m_roots.find(parent);
+      if (it != m_roots.end() && it->second.watching)
+      {
+        CLog::Log(LOGWARNING, "CChangeJournal: lost track of changes below %s, it will be scanned in full", parent.c_str());
+        it->second.watching = false;
+      }
+    }
+  }
+}
+
+void CChangeJournal::Resync()
+{
+  // the watches are still in place, but anything verified before now can't be trusted
+  CSingleLock lock(m_critSection);
+  unsigned int sequence = ++m_sequence;
+  for (Roots::iterator it = m_roots.begin(); it != m_roots.end(); ++it)
+    it->second.watchedAt = sequence;
+}
+
+bool CChangeJournal::Load()
+{
+  if (!CFile::Exists(JOURNAL_FILE))
+    return false;
+
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(JOURNAL_FILE))
+  {
+    CLog::Log(LOGERROR, "CChangeJournal: unable to load %s (row %i column %i)", JOURNAL_FILE, doc.Row(), doc.Column());
+    return false;
+  }
+  TiXmlElement *rootElement = doc.RootElement();
+  if (!rootElement || strcmp(rootElement->Value(), "changejournal"))
+    return false;
+
+  CSingleLock lock(m_critSection);
+  for (TiXmlElement *root = rootElement->FirstChildElement("root"); root; root = root->NextSiblingElement("root"))
+  {
+    if (root->FirstChild())
+      m_roots[GetPath(root->FirstChild()->Value())].pending = true;
+  }
+  return true;
+}
+
+bool CChangeJournal::Save()
+{
+  CXBMCTinyXML doc;
+  TiXmlElement xmlRootElement("changejournal");
+  TiXmlNode *rootNode = doc.InsertEndChild(xmlRootElement);
+  if (!rootNode)
+    return false;
+
+  {
+    // roots that weren't asked for in this session are no longer part of a library
+    CSingleLock lock(m_critSection);
+    for (Roots::const_iterator it = m_roots.begin(); it != m_roots.end(); ++it)
+    {
+      if (!it->second.used)
+        continue;
+      TiXmlElement rootElement("root");
+      TiXmlText path(it->first);
+      rootElement.InsertEndChild(path);
+      rootNode->InsertEndChild(rootElement);
+    }
+  }
+
+  return doc.SaveFile(JOURNAL_FILE);
+}
+
+void CChangeJournal::Process()
+{
+#ifdef TARGET_LINUX
+  while (!m_bStop)
+  {
+    AddRoots();
+
+    struct pollfd fds = { m_fd, POLLIN, 0 };
+    if (poll(&fds, 1, 500) > 0 && (fds.revents & POLLIN))
+      ReadEvents();
+  }
+#endif
+}
+
+#ifdef TARGET_LINUX
+void CChangeJournal::AddRoots()
+{
+  std::vector<std::string> pending;
+  {
+    CSingleLock lock(m_critSection);
+    for (Roots::iterator it = m_roots.begin(); it != m_roots.end(); ++it)
+    {
+      if (it->second.pending)
+      {
+        pending.push_back(it->first);
+        it->second.pending = false;
+      }
+    }
+  }
+
+  for (std::vector<std::string>::const_iterator it = pending.begin(); it != pending.end() && !m_bStop; ++it)
+  {
+    std::set<std::pair<dev_t, ino_t> > seen;
+    std::vector<std::string> added;
+    bool watching = AddWatches(*it, 0, seen, added);
+    if (!watching)
+      RemoveWatches(added); // no use for them, and they may be what we ran out of
+
+    CSingleLock lock(m_critSection);
+    Root &root = m_roots[*it];
+    root.watching = watching;
+    root.watchedAt = ++m_sequence;
+    if (watching)
+      CLog::Log(LOGDEBUG, "CChangeJournal: watching %u folders below %s", (unsigned int)added.size(), it->c_str());
+    else
+      CLog::Log(LOGNOTICE, "CChangeJournal: unable to watch all folders below %s, it will be scanned in full", it->c_str());
+  }
+}
+
+bool CChangeJournal::AddWatches(const std::string &directory, dev_t device, std::set<std::pair<dev_t, ino_t> > &seen, std::vector<std::string> &added)
+{
+  if (m_bStop)
+    return false;
+
+  struct stat st;
+  if (stat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+    return true; // gone in the meantime, or not a directory
+
+  if (st.st_dev != device && !IsLocal(directory))
+  {
+    CLog::Log(LOGDEBUG, "CChangeJournal: %s is a network mount", directory.c_str());
+    return false;
+  }
+
+  // a folder reachable through two paths would only have its changes recorded under one of them
+  if (!seen.insert(std::make_pair(st.st_dev, st.st_ino)).second)
+  {
+    CLog::Log(LOGDEBUG, "CChangeJournal: %s is linked to more than once", directory.c_str());
+    return false;
+  }
+
+  int wd = inotify_add_watch(m_fd, directory.c_str(), WATCH_MASK);
+  if (wd < 0)
+  {
+    if (errno == ENOENT)
+      return true;
+    CLog::Log(LOGWARNING, "CChangeJournal: unable to watch %s (%s)", directory.c_str(), strerror(errno));
+    return false;
+  }
+  // the folder is already watched through another path, possibly below another root
+  std::map<int, std::string>::const_iterator watch = m_watches.find(wd);
+  if (watch != m_watches.end() && watch->second != directory)
+  {
+    CLog::Log(LOGDEBUG, "CChangeJournal: %s is already watched as %s", directory.c_str(), watch->second.c_str());
+    return false;
+  }
+  m_watches[wd] = directory;
+  added.push_back(directory);
+
+  // removing a symlink doesn't tell us it pointed to a folder
+  struct stat lst;
+  if (lstat(directory.substr(0, directory.size() - 1).c_str(), &lst) == 0 && S_ISLNK(lst.st_mode))
+    m_links.insert(directory);
+
+  DIR *dir = opendir(directory.c_str());
+  if (!dir)
+    return true; // can't be listed by the scanners either
+
+  bool result = true;
+  struct dirent *entry;
+  while (result && (entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_type != DT_DIR && entry->d_type != DT_LNK && entry->d_type != DT_UNKNOWN)
+      continue;
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+    result = AddWatches(directory + entry->d_name + "/", st.st_dev, seen, added);
+  }
+  closedir(dir);
+  return result;
+}
+
+void CChangeJournal::RemoveWatches(const std::string &directory)
+{
+  std::map<int, std::string>::iterator it = m_watches.begin();
+  while (it != m_watches.end())
+  {
+    if (StringUtils::StartsWith(it->second, directory))
+    {
+      inotify_rm_watch(m_fd, it->first);
+      m_watches.erase(it++);
+    }
+    else
+      ++it;
+  }
+
+  std::set<std::string>::iterator link = m_links.lower_bound(directory);
+  while (link != m_links.end() && StringUtils::StartsWith(*link, directory))
+    m_links.erase(link++);
+}
+
+void CChangeJournal::RemoveWatches(const std::vector<std::string> &directories)
+{
+  std::set<std::string> remove(directories.begin(), directories.end());
+  std::map<int, std::string>::iterator it = m_watches.begin();
+  while (it != m_watches.end())
+  {
+    if (remove.find(it->second) != remove.end())
+    {
+      inotify_rm_watch(m_fd, it->first);
+      m_links.erase(it->second);
+      m_watches.erase(it++);
+    }
+    else
+      ++it;
+  }
+}
+
+void CChangeJournal::ReadEvents()
+{
+  char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  ssize_t length;
+  while ((length = read(m_fd, buffer, sizeof(buffer))) > 0)
+  {
+    const struct inotify_event *event;
+    for (char *ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + event->len)
+    {
+      event = (const struct inotify_event *)ptr;
+
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        CLog::Log(LOGWARNING, "CChangeJournal: too many changes at once, all folders will be scanned in full");
+        Resync();
+        continue;
+      }
+
+      std::map<int, std::string>::iterator watch = m_watches.find(event->wd);
+      if (watch == m_watches.end())
+        continue;
+      const std::string directory(watch->second);
+
+      if (event->mask & IN_IGNORED)
+      { // the watch is gone, the folder was removed or we removed the watch
+        m_watches.erase(watch);
+        continue;
+      }
+      if (event->mask & IN_UNMOUNT)
+      { // everything below is gone, and nothing will tell us when it comes back
+        Invalidate(directory, true);
+        AddChange(directory);
+        continue;
+      }
+      if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+      { // roots at or below the folder are gone, a watched parent reports the change itself
+        RemoveWatches(directory);
+        Invalidate(directory, false);
+        continue;
+      }
+
+      AddChange(directory);
+
+      if (event->len == 0)
+        continue;
+
+      // symlinks to folders are followed when watching, but their events aren't flagged IN_ISDIR
+      std::string child = directory + event->name + "/";
+      if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+      {
+        if (!(event->mask & IN_ISDIR) && m_links.find(child) == m_links.end())
+          continue;
+        RemoveWatches(child);
+        RemoveChanges(child);
+        Invalidate(child, false);
+      }
+      else if (event->mask & (IN_CREATE | IN_MOVED_TO))
+      {
+        struct stat st;
+        if (!(event->mask & IN_ISDIR) && (stat(child.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)))
+          continue;
+        std::set<std::pair<dev_t, ino_t> > seen;
+        std::vector<std::string> added;
+        if (!AddWatches(child, 0, seen, added))
+        {
+          RemoveWatches(added);
+          Invalidate(child, true);
+          continue;
+        }
+        // recorded once watched, so folders read before their watch was added are read again
+        for (std::vector<std::string>::const_iterator it = added.begin(); it != added.end(); ++it)
+          AddChange(*it);
+      }
+    }
+  }
+}
+#endif
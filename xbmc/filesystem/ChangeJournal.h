@@ -0,0 +1,156 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#ifdef TARGET_LINUX
+#include <sys/types.h>
+#endif
+
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+namespace XFILE
+{
+  /*!
+   \brief Journal of the directories that changed below watched local roots.
+
+   Roots handed to Watch() are watched recursively (via inotify on Linux), and every
+   directory in which an entry is created, removed, renamed or written is recorded
+   against a sequence number that increases with each change.
+
+   Library scanners use the journal to skip the hash walk of folders that haven't
+   changed since they last checked them: a scanner takes GetSequence() when it starts,
+   calls SetScanned() for every folder whose database hash it has verified or stored,
+   and asks IsUnchanged() before hashing a folder on its next run. Each scanner (the
+   client) keeps its own record of what it has verified.
+
+   A folder is only reported unchanged if it was verified after the watches of its
+   root were complete, so a client always walks everything once after the watches are
+   added, after a restart (changes made while we weren't running are unknown), and
+   after events may have been lost (queue overflow, running out of watches, a mount
+   going away). Roots on network protocols or network mounts are never watched, as
+   changes made by other hosts aren't reported locally - those keep using the hash walk.
+
+   The watched roots are stored in special://masterprofile/changejournal.xml so they
+   are watched again as soon as we start, before the first library update.
+   */
+  class CChangeJournal : public CThread
+  {
+  public:
+    static CChangeJournal &Get();
+
+    /*!
+     \brief Load the stored roots and start watching them.
+     */
+    void Start();
+
+    /*!
+     \brief Stop watching and store the roots that have been watched in this session.
+     */
+    void Stop();
+
+    /*!
+     \brief Watch a directory and everything below it.
+     Does nothing if the directory isn't on a local filesystem or is already watched.
+     The watches are added in the background.
+     */
+    void Watch(const std::string &path);
+
+    /*!
+     \brief The sequence number of the latest change.
+     */
+    unsigned int GetSequence() const;
+
+    /*!
+     \brief Whether a folder hasn't changed since the client last verified it.
+     \param client the client asking, e.g. the video or music scanner
+     \param path the folder
+     \param recursive true to also check everything below the folder
+     \return true if nothing changed since SetScanned() was called for the folder
+     */
+    bool IsUnchanged(const std::string &client, const std::string &path, bool recursive) const;
+
+    /*!
+     \brief Record that the client has verified a folder.
+     \param client the client that verified the folder
+     \param path the folder
+     \param sequence the result of GetSequence() taken before the folder was read
+     */
+    void SetScanned(const std::string &client, const std::string &path, unsigned int sequence);
+
+    /*!
+     \brief Reduce a set of folders to the ones that aren't below another one.
+     */
+    static void GetRoots(const std::set<std::string> &paths, std::vector<std::string> &roots);
+
+  protected:
+    virtual void Process();
+
+  private:
+    struct Root
+    {
+      Root() : watchedAt(0), watching(false), pending(false), used(false) {}
+      unsigned int watchedAt; // sequence from which all changes below the root are recorded
+      bool watching;          // all directories below the root are watched
+      bool pending;           // the watches are to be added
+      bool used;              // Watch() has been called in this session
+    };
+    typedef std::map<std::string, Root> Roots;
+    typedef std::map<std::string, unsigned int> Sequences;
+
+    CChangeJournal();
+    CChangeJournal(const CChangeJournal&);
+    CChangeJournal const& operator=(CChangeJournal const&);
+    virtual ~CChangeJournal();
+
+    static std::string GetPath(const std::string &path);
+    static bool IsLocal(const std::string &path);
+    bool IsWatched(const std::string &directory, unsigned int since) const;
+    void AddChange(const std::string &directory);
+    void RemoveChanges(const std::string &directory);
+    void Invalidate(const std::string &directory, bool ancestors);
+    void Resync();
+    bool Load();
+    bool Save();
+
+#ifdef TARGET_LINUX
+    void AddRoots();
+    bool AddWatches(const std::string &directory, dev_t device, std::set<std::pair<dev_t, ino_t> > &seen, std::vector<std::string> &added);
+    void RemoveWatches(const std::string &directory);
+    void RemoveWatches(const std::vector<std::string> &directories);
+    void ReadEvents();
+
+    int m_fd;
+    std::map<int, std::string> m_watches;  // watch descriptor -> directory, only used by our thread
+    std::set<std::string> m_links;         // watched directories that are symlinks, only used by our thread
+#endif
+
+    mutable CCriticalSection m_critSection;
+    unsigned int m_sequence;
+    Roots m_roots;
+    Sequences m_changes;                    // directory -> sequence of its latest change
+    std::map<std::string, Sequences> m_scanned;  // client -> directory -> sequence it was verified at
+  };
+}
@@ -24,6 +24,7 @@
 #include "commons/Exception.h"
 #include "FileItem.h"
 #include "DirectoryCache.h"
+#include "DirectoryListingCache.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
@@ -151,6 +152,13 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
     // check our cache for this path
     if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
       items.SetURL(url);
+    else if ((hints.flags & DIR_FLAG_ALLOW_STORED) && !(hints.flags & DIR_FLAG_BYPASS_CACHE) &&
+             CDirectoryListingCache::Get().GetDirectory(realURL, url.Get(), hints.flags, items))
+    {
+      // show the listing of an earlier session, it's revalidated in the background.
+      // it's not put in the memory cache, as callers that want an up to date listing read from there
+      items.SetURL(url);
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -215,7 +223,10 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
 
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
+      {
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+        CDirectoryListingCache::Get().SetDirectory(realURL, items);
+      }
     }
 
     // now filter for allowed files
@@ -288,7 +299,10 @@ bool CDirectory::Create(const CURL& url)
     auto_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realURL));
     if (pDirectory.get())
       if(pDirectory->Create(realURL))
+      {
+        CDirectoryListingCache::Get().ClearFile(realURL.Get());
         return true;
+      }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
@@ -349,6 +363,7 @@ bool CDirectory::Remove(const CURL& url)
       if(pDirectory->Remove(realURL))
       {
         g_directoryCache.ClearFile(realURL.Get());
+        CDirectoryListingCache::Get().ClearFile(realURL.Get());
         return true;
       }
   }
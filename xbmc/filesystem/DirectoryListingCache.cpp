@@ -0,0 +1,351 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <time.h>
+
+#include "DirectoryListingCache.h"
+#include "CurlFile.h"
+#include "Directory.h"
+#include "DirectoryCache.h"
+#include "DirectoryFactory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "GUIUserMessages.h"
+#include "URL.h"
+#include "guilib/GUIMessage.h"
+#include "guilib/GUIWindowManager.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/HttpHeader.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+using namespace XFILE;
+
+#define LISTING_CACHE_PATH     "special://temp/listings/"
+#define LISTING_CACHE_VERSION  1
+// directories with a validator aren't revalidated more often than this
+#define REVALIDATE_INTERVAL    30000
+
+static std::string GetCachePath(const CURL &url)
+{
+  std::string path(url.Get());
+  URIUtils::AddSlashAtEnd(path);
+  return path;
+}
+
+static std::string GetSignature(const CFileItemList &items)
+{
+  Crc32 crc;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    crc.Compute(item->GetPath());
+    crc.Compute(StringUtils::Format("%" PRId64 "|%s|%d", item->m_dwSize,
+                                    item->m_dateTime.IsValid() ? item->m_dateTime.GetAsDBDateTime().c_str() : "",
+                                    item->m_bIsFolder ? 1 : 0));
+  }
+  return StringUtils::Format("%d:%08x", items.Size(), (uint32_t)crc);
+}
+
+class CDirectoryListingCache::CValidateJob : public CJob
+{
+public:
+  // revalidate a stored listing
+  CValidateJob(const CURL &url, const std::string &path, int flags, const std::string &validator, const CFileItemList &items)
+    : m_url(url),
+      m_cachePath(::GetCachePath(url)),
+      m_path(path),
+      m_flags(flags & ~(DIR_FLAG_ALLOW_PROMPT | DIR_FLAG_ALLOW_STORED)),
+      m_validator(validator),
+      m_signature(GetSignature(items)),
+      m_store(false),
+      m_changed(false)
+  { }
+
+  // store a listing that has just been fetched
+  CValidateJob(const CURL &url, const CFileItemList &items)
+    : m_url(url),
+      m_cachePath(::GetCachePath(url)),
+      m_flags(DIR_FLAG_DEFAULTS),
+      m_store(true),
+      m_changed(false)
+  {
+    m_items.Copy(items);
+  }
+
+  virtual const char *GetType() const { return "directorylistingcache"; }
+
+  virtual bool DoWork()
+  {
+    // read the validator before the listing, so changes made in between are caught next time
+    std::string validator = GetValidator(m_url);
+
+    if (m_store)
+      return Save(m_cachePath, m_items, validator);
+
+    if (!m_validator.empty() && validator == m_validator)
+      return true;
+
+    std::auto_ptr<IDirectory> directory(CDirectoryFactory::Create(m_url));
+    if (!directory.get())
+      return false;
+
+    CFileItemList items;
+    items.SetURL(m_url);
+    directory->SetFlags(m_flags);
+    if (!directory->GetDirectory(m_url, items))
+    {
+      CLog::Log(LOGDEBUG, "%s - unable to revalidate %s", __FUNCTION__, m_url.GetRedacted().c_str());
+      return false;
+    }
+
+    m_changed = GetSignature(items) != m_signature;
+    return Save(m_cachePath, items, validator);
+  }
+
+  const std::string &GetCachePath() const { return m_cachePath; }
+  const std::string &GetPath() const { return m_path; }
+  bool HasChanged() const { return m_changed; }
+
+private:
+  CURL m_url;
+  std::string m_cachePath;
+  std::string m_path;
+  int m_flags;
+  std::string m_validator;
+  std::string m_signature;
+  CFileItemList m_items;
+  bool m_store;
+  bool m_changed;
+};
+
+CDirectoryListingCache::CDirectoryListingCache()
+{ }
+
+CDirectoryListingCache::~CDirectoryListingCache()
+{ }
+
+CDirectoryListingCache &CDirectoryListingCache::Get()
+{
+  static CDirectoryListingCache sListingCache;
+  return sListingCache;
+}
+
+bool CDirectoryListingCache::IsCached(const CURL &url) const
+{
+  if (g_advancedSettings.m_networkListingCacheTTL == 0)
+    return false;
+
+  return url.IsProtocol("upnp") ||
+         url.IsProtocol("ftp") || url.IsProtocol("ftps") || url.IsProtocol("sftp") ||
+         url.IsProtocol("dav") || url.IsProtocol("davs") ||
+         url.IsProtocol("http") || url.IsProtocol("https") ||
+         url.IsProtocol("smb") || url.IsProtocol("nfs");
+}
+
+bool CDirectoryListingCache::GetDirectory(const CURL &url, const std::string &path, int flags, CFileItemList &items)
+{
+  if (!IsCached(url))
+    return false;
+
+  const std::string cachePath(::GetCachePath(url));
+  std::string validator;
+  int64_t stored;
+  if (!Load(cachePath, items, validator, stored))
+    return false;
+
+  CSingleLock lock(m_critSection);
+  if (m_pending.find(cachePath) != m_pending.end())
+    return true;
+
+  if (validator.empty())
+  {
+    // nothing to revalidate with, fetch the listing again once it has expired
+    int64_t age = (int64_t)time(NULL) - stored;
+    if (age >= 0 && age < (int64_t)g_advancedSettings.m_networkListingCacheTTL)
+      return true;
+  }
+  else
+  {
+    std::map<std::string, unsigned int>::const_iterator checked = m_checked.find(cachePath);
+    if (checked != m_checked.end() && XbmcThreads::SystemClockMillis() - checked->second < REVALIDATE_INTERVAL)
+      return true;
+  }
+
+  m_pending.insert(cachePath);
+  lock.Leave();
+
+  CLog::Log(LOGDEBUG, "%s - revalidating %s", __FUNCTION__, url.GetRedacted().c_str());
+  CJobManager::GetInstance().AddJob(new CValidateJob(url, path, flags, validator, items), this, CJob::PRIORITY_LOW);
+  return true;
+}
+
+void CDirectoryListingCache::SetDirectory(const CURL &url, const CFileItemList &items)
+{
+  if (!IsCached(url))
+    return;
+
+  const std::string cachePath(::GetCachePath(url));
+  CSingleLock lock(m_critSection);
+  if (m_pending.find(cachePath) != m_pending.end())
+    return;
+  m_pending.insert(cachePath);
+  lock.Leave();
+
+  CJobManager::GetInstance().AddJob(new CValidateJob(url, items), this, CJob::PRIORITY_LOW);
+}
+
+void CDirectoryListingCache::ClearDirectory(const std::string &path)
+{
+  CURL url(URIUtils::SubstitutePath(path));
+  if (!IsCached(url))
+    return;
+
+  const std::string cachePath(::GetCachePath(url));
+  {
+    CSingleLock lock(m_critSection);
+    m_checked.erase(cachePath);
+  }
+
+  std::string cacheFile(GetCacheFile(cachePath));
+  if (CFile::Exists(cacheFile))
+    CFile::Delete(cacheFile);
+}
+
+void CDirectoryListingCache::ClearFile(const std::string &path)
+{
+  ClearDirectory(URIUtils::GetDirectory(path));
+}
+
+void CDirectoryListingCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CValidateJob *validate = static_cast<CValidateJob*>(job);
+  const std::string cachePath(validate->GetCachePath());
+
+  CSingleLock lock(m_critSection);
+  m_pending.erase(cachePath);
+  m_checked[cachePath] = XbmcThreads::SystemClockMillis();
+  lock.Leave();
+
+  if (success && validate->HasChanged())
+  {
+    CLog::Log(LOGDEBUG, "%s - listing of %s has changed", __FUNCTION__, CURL::GetRedacted(cachePath).c_str());
+    g_directoryCache.ClearDirectory(cachePath);
+
+    CGUIMessage message(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_PATH);
+    message.SetStringParam(validate->GetPath());
+    g_windowManager.SendThreadMessage(message);
+  }
+}
+
+std::string CDirectoryListingCache::GetCacheFile(const std::string &path)
+{
+  Crc32 crc;
+  crc.Compute(path);
+  return StringUtils::Format(LISTING_CACHE_PATH "%08x.fi", (uint32_t)crc);
+}
+
+std::string CDirectoryListingCache::GetValidator(const CURL &url)
+{
+  if (url.IsProtocol("smb") || url.IsProtocol("nfs") || url.IsProtocol("sftp"))
+  {
+    struct __stat64 buffer;
+    if (CFile::Stat(url, &buffer) == 0 && buffer.st_mtime != 0)
+      return StringUtils::Format("mtime:%" PRId64, (int64_t)buffer.st_mtime);
+  }
+  else if (url.IsProtocol("http") || url.IsProtocol("https") ||
+           url.IsProtocol("dav") || url.IsProtocol("davs"))
+  {
+    CHttpHeader header;
+    if (CCurlFile::GetHttpHeader(url, header))
+    {
+      std::string value(header.GetValue("etag"));
+      if (!value.empty())
+        return "etag:" + value;
+      value = header.GetValue("last-modified");
+      if (!value.empty())
+        return "modified:" + value;
+    }
+  }
+  // upnp and ftp don't offer anything cheaper than the listing itself
+  return "";
+}
+
+bool CDirectoryListingCache::Load(const std::string &path, CFileItemList &items, std::string &validator, int64_t &stored)
+{
+  CFile file;
+  if (!file.Open(GetCacheFile(path)))
+    return false;
+
+  CArchive ar(&file, CArchive::load);
+  int version = 0;
+  std::string storedPath;
+  ar >> version;
+  if (version == LISTING_CACHE_VERSION)
+    ar >> storedPath;
+
+  // the file could be of an older version or of a directory with the same crc
+  bool valid = version == LISTING_CACHE_VERSION && storedPath == path;
+  if (valid)
+  {
+    ar >> validator;
+    ar >> stored;
+    ar >> items;
+    CLog::Log(LOGDEBUG, "%s - loaded %i items of %s", __FUNCTION__, items.Size(), CURL::GetRedacted(path).c_str());
+  }
+  ar.Close();
+  file.Close();
+
+  return valid;
+}
+
+bool CDirectoryListingCache::Save(const std::string &path, CFileItemList &items, const std::string &validator)
+{
+  if (!CDirectory::Exists(LISTING_CACHE_PATH) && !CDirectory::Create(LISTING_CACHE_PATH))
+    return false;
+
+  // write to a temporary file first, the listing may be read while we are writing it
+  std::string cacheFile(GetCacheFile(path));
+  std::string tempFile(cacheFile + ".tmp");
+
+  CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+    return false;
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)LISTING_CACHE_VERSION;
+  ar << path;
+  ar << validator;
+  ar << (int64_t)time(NULL);
+  ar << items;
+  ar.Close();
+  file.Close();
+
+  if (CFile::Exists(cacheFile))
+    CFile::Delete(cacheFile);
+  return CFile::Rename(tempFile, cacheFile);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <set>
+#include <string>
+
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+
+class CFileItemList;
+class CURL;
+class TestDirectoryListingCache;
+
+namespace XFILE
+{
+  /*!
+   \brief Keeps directory listings of slow network sources on disk across sessions.
+
+   Listings of UPnP, FTP, SFTP, WebDAV, HTTP, SMB and NFS directories are stored
+   in special://temp/listings/ once they have been fetched. When a directory isn't
+   in the in-memory CDirectoryCache and the caller passes DIR_FLAG_ALLOW_STORED
+   (as the media windows do), its stored listing is shown right away and
+   revalidated in the background:
+    - SMB, NFS and SFTP directories are revalidated by their modification time.
+    - HTTP and WebDAV directories are revalidated by their ETag, or their
+      Last-Modified header if there is no ETag.
+    - Other protocols can't be revalidated cheaply, their listing is fetched again
+      once it's older than advancedsettings' network/listingcachettl.
+
+   If the fetched listing differs from the stored one, it replaces it and the
+   windows showing the directory are told to update.
+
+   The cache is disabled when network/listingcachettl is 0.
+   */
+  class CDirectoryListingCache : public IJobCallback
+  {
+    friend class ::TestDirectoryListingCache;
+
+  public:
+    static CDirectoryListingCache &Get();
+
+    /*!
+     \brief Whether listings of the given directory are kept on disk.
+     */
+    bool IsCached(const CURL &url) const;
+
+    /*!
+     \brief Load the stored listing of a directory and revalidate it in the background.
+     \param url the directory, after path substitution
+     \param path the directory as requested, windows showing this path are updated if the listing changed
+     \param flags the DIR_FLAG flags used to fetch the directory again
+     \param items the list to fill
+     \return true if a listing was stored for this directory
+     */
+    bool GetDirectory(const CURL &url, const std::string &path, int flags, CFileItemList &items);
+
+    /*!
+     \brief Store a listing that has just been fetched.
+     The listing is copied and written in the background.
+     */
+    void SetDirectory(const CURL &url, const CFileItemList &items);
+
+    /*!
+     \brief Remove the stored listing of a directory.
+     */
+    void ClearDirectory(const std::string &path);
+
+    /*!
+     \brief Remove the stored listing of the directory containing a file.
+     */
+    void ClearFile(const std::string &path);
+
+    virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+  private:
+    class CValidateJob;
+
+    CDirectoryListingCache();
+    CDirectoryListingCache(const CDirectoryListingCache&);
+    CDirectoryListingCache const& operator=(CDirectoryListingCache const&);
+    virtual ~CDirectoryListingCache();
+
+    static std::string GetCacheFile(const std::string &path);
+    static std::string GetValidator(const CURL &url);
+    static bool Load(const std::string &path, CFileItemList &items, std::string &validator, int64_t &stored);
+    static bool Save(const std::string &path, CFileItemList &items, const std::string &validator);
+
+    CCriticalSection m_critSection;
+    std::set<std::string> m_pending;                 // directories being revalidated or stored
+    std::map<std::string, unsigned int> m_checked;   // when a directory has last been revalidated
+  };
+}
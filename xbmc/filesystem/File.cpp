@@ -25,6 +25,7 @@
 #include "FileFactory.h"
 #include "Application.h"
 #include "DirectoryCache.h"
+#include "DirectoryListingCache.h"
 #include "Directory.h"
 #include "FileCache.h"
 #include "utils/log.h"
@@ -338,6 +339,7 @@ bool CFile::OpenForWrite(const CURL& file, bool bOverWrite)
     {
       // add this file to our directory cache (if it's stored)
       g_directoryCache.AddFile(url.Get());
+      CDirectoryListingCache::Get().ClearFile(url.Get());
       return true;
     }
     return false;
@@ -799,6 +801,7 @@ bool CFile::Delete(const CURL& file)
     if(pFile->Delete(url))
     {
       g_directoryCache.ClearFile(url.Get());
+      CDirectoryListingCache::Get().ClearFile(url.Get());
       return true;
     }
   }
@@ -834,6 +837,8 @@ bool CFile::Rename(const CURL& file, const CURL& newFile)
     {
       g_directoryCache.ClearFile(url.Get());
       g_directoryCache.AddFile(urlnew.Get());
+      CDirectoryListingCache::Get().ClearFile(url.Get());
+      CDirectoryListingCache::Get().ClearFile(urlnew.Get());
       return true;
     }
   }
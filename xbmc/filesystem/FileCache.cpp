@@ -108,7 +108,13 @@ CFileCache::CFileCache(bool useDoubleCache)
    m_seekPos = 0;
    m_readPos = 0;
    m_writePos = 0;
-   if (g_advancedSettings.m_cacheMemBufferSize == 0)
+   if (g_advancedSettings.m_cacheSparseFileSize > 0)
+   {
+     // keeps all the ranges read so far, no need for a second cache
+     m_pCache = new CSparseFileCache(g_advancedSettings.m_cacheSparseFileSize);
+     useDoubleCache = false;
+   }
+   else if (g_advancedSettings.m_cacheMemBufferSize == 0)
      m_pCache = new CSimpleFileCache();
    else
    {
@@ -544,6 +550,9 @@ int CFileCache::IoControl(EIoControl request, void* param)
     return 0;
   }
 
+  if (request == IOCTRL_CACHE_RANGES)
+    return m_pCache->GetCachedRanges(*(std::vector<SCacheRange>*)param) ? 0 : -1;
+
   if (request == IOCTRL_CACHE_SETRATE)
   {
     m_writeRate = *(unsigned*)param;
@@ -39,12 +39,19 @@ struct SCacheStatus
   bool     full;     /**< is the cache full */
 };
 
+struct SCacheRange
+{
+  int64_t start;     /**< first cached byte */
+  int64_t end;       /**< position after the last cached byte */
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1, /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2, /**< return 0 if known not to work, 1 if it should work */
   IOCTRL_CACHE_STATUS  = 3, /**< SCacheStatus structure */
   IOCTRL_CACHE_SETRATE = 4, /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE    = 8, /** <CFileCache */
+  IOCTRL_CACHE_RANGES = 9, /**< std::vector<SCacheRange> receiving all cached ranges, sorted by position */
 } EIoControl;
 
 }
@@ -123,6 +123,10 @@ bool CNFSDirectory::ResolveSymlink( const std::string &dirName, struct nfsdirent
   resolvedUrl.SetProtocol("nfs");
   resolvedUrl.SetHostName(gNfsConnection.GetConnectedIp()); 
   
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  if (!pMount)
+    return false;
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_readlink(gNfsConnection.GetNfsContext(), fullpath.c_str(), resolvedLink, MAX_PATH);    
   
   if(ret == 0)
@@ -215,6 +219,8 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
   struct nfsdir *nfsdir = NULL;
   struct nfsdirent *nfsdirent = NULL;
 
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_opendir(gNfsConnection.GetNfsContext(), strDirName.c_str(), &nfsdir);
 
   if(ret != 0)
@@ -222,6 +228,7 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
     CLog::Log(LOGERROR, "Failed to open(%s) %s\n", strDirName.c_str(), gNfsConnection.GetImpl()->nfs_get_error(gNfsConnection.GetNfsContext()));
     return false;
   }
+  mountLock.Leave();
   lock.Leave();
   
   while((nfsdirent = gNfsConnection.GetImpl()->nfs_readdir(gNfsConnection.GetNfsContext(), nfsdir)) != NULL) 
@@ -305,6 +312,8 @@ bool CNFSDirectory::Create(const CURL& url2)
   if(!gNfsConnection.Connect(url,folderName))
     return false;
   
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_mkdir(gNfsConnection.GetNfsContext(), folderName.c_str());
 
   success = (ret == 0 || -EEXIST == ret);
@@ -326,6 +335,8 @@ bool CNFSDirectory::Remove(const CURL& url2)
   if(!gNfsConnection.Connect(url,folderName))
     return false;
   
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_rmdir(gNfsConnection.GetNfsContext(), folderName.c_str());
 
   if(ret != 0 && errno != ENOENT)
@@ -350,6 +361,8 @@ bool CNFSDirectory::Exists(const CURL& url2)
     return false;
   
   NFSSTAT info;
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_stat(gNfsConnection.GetNfsContext(), folderName.c_str(), &info);
   
   if (ret != 0)
@@ -24,6 +24,9 @@
 #include "system.h"
 
 #ifdef HAS_FILESYSTEM_NFS
+#include <algorithm>
+#include <vector>
+
 #include "NFSFile.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
@@ -39,6 +42,10 @@
 #include <sys\stat.h>
 #endif
 
+#ifdef TARGET_POSIX
+#include <poll.h>
+#endif
+
 //KEEP_ALIVE_TIMEOUT is decremented every half a second
 //360 * 0.5s == 180s == 3mins
 //so when no read was done for 3mins and files are open
@@ -53,8 +60,46 @@
 #define CONTEXT_NEW      1    //new context created
 #define CONTEXT_CACHED   2    //context cached and therefore already mounted (no new mount needed)
 
+//maximum number of READ requests in flight for a single read
+#define MAX_PIPELINED_READS 8
+//a pipelined read is given up when the server didn't answer for 30s
+#define PIPELINED_READ_TIMEOUT 30000
+
 using namespace XFILE;
 
+CNfsMount::CNfsMount(const std::string &id)
+: m_id(id)
+{
+  m_statistics.bytes = 0;
+  m_statistics.requests = 0;
+  m_statistics.time = 0;
+}
+
+void CNfsMount::AddRead(uint64_t bytes, unsigned int requests, uint64_t time)
+{
+  CSingleLock lock(m_statisticsLock);
+  m_statistics.bytes += bytes;
+  m_statistics.requests += requests;
+  m_statistics.time += time;
+}
+
+CNfsMount::readStatistics CNfsMount::GetStatistics() const
+{
+  CSingleLock lock(m_statisticsLock);
+  return m_statistics;
+}
+
+void CNfsMount::LogStatistics() const
+{
+  readStatistics statistics = GetStatistics();
+  if (statistics.requests == 0)
+    return;
+
+  CLog::Log(LOGDEBUG, "NFS: %s - read %" PRIu64" bytes with %" PRIu64" requests in %" PRIu64" ms (%.1f MB/s)",
+            m_id.c_str(), statistics.bytes, statistics.requests, statistics.time,
+            statistics.time > 0 ? statistics.bytes / 1000.0 / statistics.time : 0.0);
+}
+
 CNfsConnection::CNfsConnection()
 : m_pNfsContext(NULL)
 , m_exportPath("")
@@ -131,6 +176,7 @@ void CNfsConnection::clearMembers()
     m_writeChunkSize = 0;
     m_readChunkSize = 0;  
     m_pNfsContext = NULL;
+    m_pMount.reset();
     m_KeepAliveTimeouts.clear();
 }
 
@@ -139,6 +185,7 @@ void CNfsConnection::destroyOpenContexts()
   CSingleLock lock(openContextLock);
   for(tOpenContextMap::iterator it = m_openContextMap.begin();it!=m_openContextMap.end();++it)
   {
+    it->second.pMount->LogStatistics();
     m_pLibNfs->nfs_destroy_context(it->second.pContext);
   }
   m_openContextMap.clear();
@@ -150,12 +197,13 @@ void CNfsConnection::destroyContext(const std::string &exportName)
   tOpenContextMap::iterator it = m_openContextMap.find(exportName.c_str());
   if (it != m_openContextMap.end()) 
   {
+      it->second.pMount->LogStatistics();
       m_pLibNfs->nfs_destroy_context(it->second.pContext);
       m_openContextMap.erase(it);
   }
 }
 
-struct nfs_context *CNfsConnection::getContextFromMap(const std::string &exportname, bool forceCacheHit/* = false*/)
+struct nfs_context *CNfsConnection::getContextFromMap(const std::string &exportname, bool forceCacheHit/* = false*/, CNfsMountPtr *pMount/* = NULL*/)
 {
   struct nfs_context *pRet = NULL;
   CSingleLock lock(openContextLock);
@@ -174,12 +222,15 @@ struct nfs_context *CNfsConnection::getContextFromMap(const std::string &exportn
         CLog::Log(LOGDEBUG, "NFS: Refreshing context for %s, old: %" PRId64", new: %" PRId64, exportname.c_str(), it->second.lastAccessedTime, now);
       it->second.lastAccessedTime = now;
       pRet = it->second.pContext;
+      if (pMount)
+        *pMount = it->second.pMount;
     }
     else 
     {
       //context is timed out
       //destroy it and return NULL
       CLog::Log(LOGDEBUG, "NFS: Old context timed out - destroying it");
+      it->second.pMount->LogStatistics();
       m_pLibNfs->nfs_destroy_context(it->second.pContext);
       m_openContextMap.erase(it);
     }
@@ -195,7 +246,7 @@ int CNfsConnection::getContextForExport(const std::string &exportname)
   {
     clearMembers();  
     
-    m_pNfsContext = getContextFromMap(exportname);
+    m_pNfsContext = getContextFromMap(exportname, false, &m_pMount);
 
     if(!m_pNfsContext)
     {
@@ -212,6 +263,8 @@ int CNfsConnection::getContextForExport(const std::string &exportname)
         CSingleLock lock(openContextLock);        
         tmp.pContext = m_pNfsContext;
         tmp.lastAccessedTime = XbmcThreads::SystemClockMillis();
+        tmp.pMount.reset(new CNfsMount(exportname));
+        m_pMount = tmp.pMount;
         m_openContextMap[exportname] = tmp; //add context to list of all contexts      
         ret = CONTEXT_NEW;
       }
@@ -418,13 +471,19 @@ void CNfsConnection::keepAlive(std::string _exportPath, struct nfsfh  *_pFileHan
   // true forces a cachehit regardless the context is timedout
   // on this call we are sure its not timedout even if the last accessed
   // time suggests it.
-  struct nfs_context *pContext = getContextFromMap(_exportPath, true);
+  CNfsMountPtr pMount;
+  struct nfs_context *pContext = getContextFromMap(_exportPath, true, &pMount);
   
   if (!pContext)// this should normally never happen - paranoia
+  {
     pContext = m_pNfsContext;
+    pMount = m_pMount;
+  }
+  if (!pContext || !pMount)
+    return;
   
   CLog::Log(LOGNOTICE, "NFS: sending keep alive after %i s.",KEEP_ALIVE_TIMEOUT/2);
-  CSingleLock lock(*this);
+  CSingleLock lock(*pMount);
   m_pLibNfs->nfs_lseek(pContext, _pFileHandle, 0, SEEK_CUR, &offset);
   m_pLibNfs->nfs_read(pContext, _pFileHandle, 32, buffer);
   m_pLibNfs->nfs_lseek(pContext, _pFileHandle, offset, SEEK_SET, &offset);
@@ -488,12 +547,24 @@ void CNfsConnection::AddIdleConnection()
   m_IdleTimeout = 180;
 }
 
+std::map<std::string, CNfsMount::readStatistics> CNfsConnection::GetStatistics()
+{
+  std::map<std::string, CNfsMount::readStatistics> statistics;
+  CSingleLock lock(openContextLock);
+  for(tOpenContextMap::const_iterator it = m_openContextMap.begin();it!=m_openContextMap.end();++it)
+  {
+    statistics[it->first] = it->second.pMount->GetStatistics();
+  }
+  return statistics;
+}
+
 CNfsConnection gNfsConnection;
 
 CNFSFile::CNFSFile()
 : m_fileSize(0)
 , m_pFileHandle(NULL)
 , m_pNfsContext(NULL)
+, m_readChunkSize(0)
 {
   gNfsConnection.AddActiveConnection();
 }
@@ -508,15 +579,15 @@ int64_t CNFSFile::GetPosition()
 {
   int ret = 0;
   uint64_t offset = 0;
-  CSingleLock lock(gNfsConnection);
   
-  if (gNfsConnection.GetNfsContext() == NULL || m_pFileHandle == NULL) return 0;
-  
-  ret = (int)gNfsConnection.GetImpl()->nfs_lseek(gNfsConnection.GetNfsContext(), m_pFileHandle, 0, SEEK_CUR, &offset);
+  if (m_pNfsContext == NULL || m_pFileHandle == NULL) return 0;
+
+  CSingleLock lock(*m_pMount);
+  ret = (int)gNfsConnection.GetImpl()->nfs_lseek(m_pNfsContext, m_pFileHandle, 0, SEEK_CUR, &offset);
   
   if (ret < 0) 
   {
-    CLog::Log(LOGERROR, "NFS: Failed to lseek(%s)",gNfsConnection.GetImpl()->nfs_get_error(gNfsConnection.GetNfsContext()));
+    CLog::Log(LOGERROR, "NFS: Failed to lseek(%s)",gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
   }
   return offset;
 }
@@ -547,14 +618,20 @@ bool CNFSFile::Open(const CURL& url)
     return false;
   
   m_pNfsContext = gNfsConnection.GetNfsContext(); 
+  m_pMount = gNfsConnection.GetMount();
+  m_readChunkSize = gNfsConnection.GetMaxReadChunkSize();
   m_exportPath = gNfsConnection.GetContextMapId();
   
-  ret = gNfsConnection.GetImpl()->nfs_open(m_pNfsContext, filename.c_str(), O_RDONLY, &m_pFileHandle);
+  {
+    CSingleLock mountLock(*m_pMount);
+    ret = gNfsConnection.GetImpl()->nfs_open(m_pNfsContext, filename.c_str(), O_RDONLY, &m_pFileHandle);
+  }
   
   if (ret != 0) 
   {
     CLog::Log(LOGINFO, "CNFSFile::Open: Unable to open file : '%s'  error : '%s'", url.GetFileName().c_str(), gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
     m_pNfsContext = NULL;
+    m_pMount.reset();
     m_exportPath.clear();
     return false;
   } 
@@ -600,6 +677,8 @@ int CNFSFile::Stat(const CURL& url, struct __stat64* buffer)
 
   NFSSTAT tmpBuffer = {0};
 
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_stat(gNfsConnection.GetNfsContext(), filename.c_str(), &tmpBuffer);
   
   //if buffer == NULL we where called from Exists - in that case don't spam the log with errors
@@ -639,33 +718,158 @@ ssize_t CNFSFile::Read(void *lpBuf, size_t uiBufSize)
     uiBufSize = SSIZE_MAX;
 
   ssize_t numberOfBytesRead = 0;
-  CSingleLock lock(gNfsConnection);
+  unsigned int requests = 0;
   
   if (m_pFileHandle == NULL || m_pNfsContext == NULL )
     return -1;
 
-  numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
+  uint64_t start = XbmcThreads::SystemClockMillis();
+  CSingleLock lock(*m_pMount);//only reads on the same export have to wait for us
 
-  lock.Leave();//no need to keep the connection lock after that
+  numberOfBytesRead = PipelinedRead((char *)lpBuf, uiBufSize, requests);
+
+  lock.Leave();//no need to keep the mount lock after that
   
   gNfsConnection.resetKeepAlive(m_exportPath, m_pFileHandle);//triggers keep alive timer reset for this filehandle
   
   //something went wrong ...
   if (numberOfBytesRead < 0) 
     CLog::Log(LOGERROR, "%s - Error( %" PRId64", %s )", __FUNCTION__, (int64_t)numberOfBytesRead, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+  else
+    m_pMount->AddRead(numberOfBytesRead, requests, XbmcThreads::SystemClockMillis() - start);
 
   return numberOfBytesRead;
 }
 
+#ifdef TARGET_POSIX
+struct pipelinedRead
+{
+  char *buffer;
+  uint64_t size;
+  int result;
+  bool done;
+  bool abandoned;//the read was given up, the callback has to free the request
+};
+
+static void pipelinedReadCallback(int status, struct nfs_context *nfs, void *data, void *private_data)
+{
+  struct pipelinedRead *request = (struct pipelinedRead *)private_data;
+  if (request->abandoned)
+  {
+    delete request;
+    return;
+  }
+
+  if (status > 0)
+    memcpy(request->buffer, data, std::min((uint64_t)status, request->size));
+  request->result = status;
+  request->done = true;
+}
+#endif
+
+ssize_t CNFSFile::PipelinedRead(char *buffer, size_t size, unsigned int &requests)
+{
+  DllLibNfs *pLibNfs = gNfsConnection.GetImpl();
+
+#ifdef TARGET_POSIX
+  uint64_t offset = 0;
+  if (m_readChunkSize > 0 && size > m_readChunkSize &&
+      pLibNfs->nfs_lseek(m_pNfsContext, m_pFileHandle, 0, SEEK_CUR, &offset) == 0 &&
+      offset < (uint64_t)m_fileSize)
+  {
+    //don't request anything behind the end of the file
+    size = (size_t)std::min((uint64_t)size, (uint64_t)m_fileSize - offset);
+    size = (size_t)std::min((uint64_t)size, m_readChunkSize * MAX_PIPELINED_READS);
+
+    //send all READ requests at once and collect the replies as they come in
+    std::vector<struct pipelinedRead *> pending;
+    for (uint64_t position = 0; position < size; position += m_readChunkSize)
+    {
+      struct pipelinedRead *request = new struct pipelinedRead;
+      request->buffer = buffer + position;
+      request->size = std::min((uint64_t)size - position, m_readChunkSize);
+      request->result = -1;
+      request->done = false;
+      request->abandoned = false;
+      if (pLibNfs->nfs_pread_async(m_pNfsContext, m_pFileHandle, offset + position, request->size, pipelinedReadCallback, request) != 0)
+        request->done = true;
+      pending.push_back(request);
+    }
+    requests = pending.size();
+
+    bool failed = false;
+    while (!failed)
+    {
+      bool done = true;
+      for (std::vector<struct pipelinedRead *>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+        done &= (*it)->done;
+      if (done)
+        break;
+
+      struct pollfd pfd;
+      pfd.fd = pLibNfs->nfs_get_fd(m_pNfsContext);
+      pfd.events = pLibNfs->nfs_which_events(m_pNfsContext);
+      pfd.revents = 0;
+
+      int ret = poll(&pfd, 1, PIPELINED_READ_TIMEOUT);
+      if (ret < 0 && errno == EINTR)
+        continue;
+      if (ret <= 0 || pLibNfs->nfs_service(m_pNfsContext, pfd.revents) < 0)
+      {
+        CLog::Log(LOGERROR, "NFS: pipelined read of %" PRIuS" bytes failed (%s)", size, ret == 0 ? "timeout" : pLibNfs->nfs_get_error(m_pNfsContext));
+        failed = true;
+      }
+    }
+
+    //the data is valid up to the first short or failed reply
+    ssize_t numberOfBytesRead = 0;
+    bool complete = true;
+    bool error = false;
+    for (std::vector<struct pipelinedRead *>::iterator it = pending.begin(); it != pending.end(); ++it)
+    {
+      struct pipelinedRead *request = *it;
+      if (complete && (!request->done || request->result < 0))
+        error = true;
+
+      if (!request->done)
+      {
+        //libnfs still owns the request, the callback frees it
+        request->abandoned = true;
+        complete = false;
+        continue;
+      }
+
+      if (complete)
+      {
+        if (request->result > 0)
+          numberOfBytesRead += request->result;
+        if (request->result < 0 || (uint64_t)request->result < request->size)
+          complete = false;
+      }
+      delete request;
+    }
+
+    if (numberOfBytesRead == 0 && error)
+      return -1;
+
+    pLibNfs->nfs_lseek(m_pNfsContext, m_pFileHandle, offset + numberOfBytesRead, SEEK_SET, &offset);
+    return numberOfBytesRead;
+  }
+#endif
+
+  //a single READ request
+  requests = 1;
+  return pLibNfs->nfs_read(m_pNfsContext, m_pFileHandle, size, buffer);
+}
+
 int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
 {
   int ret = 0;
   uint64_t offset = 0;
 
-  CSingleLock lock(gNfsConnection);  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
   
- 
+  CSingleLock lock(*m_pMount);
   ret = (int)gNfsConnection.GetImpl()->nfs_lseek(m_pNfsContext, m_pFileHandle, iFilePosition, iWhence, &offset);
   if (ret < 0) 
   {
@@ -679,10 +883,9 @@ int CNFSFile::Truncate(int64_t iSize)
 {
   int ret = 0;
   
-  CSingleLock lock(gNfsConnection);  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
   
-  
+  CSingleLock lock(*m_pMount);
   ret = (int)gNfsConnection.GetImpl()->nfs_ftruncate(m_pNfsContext, m_pFileHandle, iSize);
   if (ret < 0) 
   {
@@ -694,8 +897,6 @@ int CNFSFile::Truncate(int64_t iSize)
 
 void CNFSFile::Close()
 {
-  CSingleLock lock(gNfsConnection);
-  
   if (m_pFileHandle != NULL && m_pNfsContext != NULL)
   {
     int ret = 0;
@@ -703,7 +904,10 @@ void CNFSFile::Close()
     // remove it from keep alive list before closing
     // so keep alive code doens't process it anymore
     gNfsConnection.removeFromKeepAliveList(m_pFileHandle);
-    ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
+    {
+      CSingleLock lock(*m_pMount);
+      ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
+    }
         
 	  if (ret < 0) 
     {
@@ -711,6 +915,7 @@ void CNFSFile::Close()
     }
     m_pFileHandle = NULL;
     m_pNfsContext = NULL;    
+    m_pMount.reset();
     m_fileSize = 0;
     m_exportPath.clear();
   }
@@ -727,9 +932,9 @@ ssize_t CNFSFile::Write(const void* lpBuf, size_t uiBufSize)
   //clamp max write chunksize to 32kb - fixme - this might be superfluious with future libnfs versions
   size_t chunkSize = gNfsConnection.GetMaxWriteChunkSize() > 32768 ? 32768 : (size_t)gNfsConnection.GetMaxWriteChunkSize();
   
-  CSingleLock lock(gNfsConnection);
-  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
+
+  CSingleLock lock(*m_pMount);
   
   //write as long as some bytes are left to be written
   while( leftBytes )
@@ -772,7 +977,8 @@ bool CNFSFile::Delete(const CURL& url)
   if(!gNfsConnection.Connect(url, filename))
     return false;
   
-  
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_unlink(gNfsConnection.GetNfsContext(), filename.c_str());
   
   if(ret != 0)
@@ -795,6 +1001,8 @@ bool CNFSFile::Rename(const CURL& url, const CURL& urlnew)
   std::string strDummy;
   gNfsConnection.splitUrlIntoExportAndPath(urlnew, strDummy, strFileNew);
   
+  CNfsMountPtr pMount = gNfsConnection.GetMount();
+  CSingleLock mountLock(*pMount);
   ret = gNfsConnection.GetImpl()->nfs_rename(gNfsConnection.GetNfsContext() , strFile.c_str(), strFileNew.c_str());
   
   if(ret != 0)
@@ -819,8 +1027,11 @@ bool CNFSFile::OpenForWrite(const CURL& url, bool bOverWrite)
     return false;
   
   m_pNfsContext = gNfsConnection.GetNfsContext();
+  m_pMount = gNfsConnection.GetMount();
+  m_readChunkSize = gNfsConnection.GetMaxReadChunkSize();
   m_exportPath = gNfsConnection.GetContextMapId();
   
+  CSingleLock mountLock(*m_pMount);
   if (bOverWrite)
   {
     CLog::Log(LOGWARNING, "FileNFS::OpenForWrite() called with overwriting enabled! - %s", filename.c_str());
@@ -841,6 +1052,7 @@ bool CNFSFile::OpenForWrite(const CURL& url, bool bOverWrite)
     // write error to logfile
     CLog::Log(LOGERROR, "CNFSFile::Open: Unable to open file : '%s' error : '%s'", filename.c_str(), gNfsConnection.GetImpl()->nfs_get_error(gNfsConnection.GetNfsContext()));
     m_pNfsContext = NULL;
+    m_pMount.reset();
     m_exportPath.clear();
     return false;
   }
@@ -28,6 +28,7 @@
 #include <list>
 #include "SectionLoader.h"
 #include <map>
+#include <boost/shared_ptr.hpp>
 #include "DllLibNfs.h" // for define NFSSTAT
 
 #ifdef TARGET_WINDOWS
@@ -48,6 +49,34 @@
 
 class DllLibNfs;
 
+//a mounted export
+//libnfs contexts aren't thread safe so every call on the context of a mount
+//has to hold the lock of the mount. Files on different exports don't block
+//each other anymore.
+class CNfsMount : public CCriticalSection
+{
+public:
+  struct readStatistics
+  {
+    uint64_t bytes;//bytes read from the export
+    uint64_t requests;//READ requests sent to the server
+    uint64_t time;//time spent reading in ms
+  };
+
+  CNfsMount(const std::string &id);
+  const std::string& GetId() const {return m_id;}
+  void AddRead(uint64_t bytes, unsigned int requests, uint64_t time);
+  readStatistics GetStatistics() const;
+  void LogStatistics() const;
+
+private:
+  std::string m_id;
+  readStatistics m_statistics;
+  CCriticalSection m_statisticsLock;
+};
+
+typedef boost::shared_ptr<CNfsMount> CNfsMountPtr;
+
 class CNfsConnection : public CCriticalSection
 {     
 public:
@@ -62,6 +91,7 @@ public:
   {
     struct nfs_context *pContext;
     uint64_t lastAccessedTime;
+    CNfsMountPtr pMount;
   };
 
   typedef std::map<std::string, struct contextTimeout> tOpenContextMap;    
@@ -70,6 +100,7 @@ public:
   ~CNfsConnection();
   bool Connect(const CURL &url, std::string &relativePath);
   struct nfs_context *GetNfsContext(){return m_pNfsContext;}
+  CNfsMountPtr      GetMount(){return m_pMount;}
   uint64_t          GetMaxReadChunkSize(){return m_readChunkSize;}
   uint64_t          GetMaxWriteChunkSize(){return m_writeChunkSize;} 
   DllLibNfs        *GetImpl(){return m_pLibNfs;}
@@ -97,9 +128,12 @@ public:
   const std::string& GetConnectedIp() const {return m_resolvedHostName;}
   const std::string& GetConnectedExport() const {return m_exportPath;}
   const std::string  GetContextMapId() const {return m_hostName + m_exportPath;}
+  //read statistics of all open mounts by their context map id
+  std::map<std::string, CNfsMount::readStatistics> GetStatistics();
 
 private:
   struct nfs_context *m_pNfsContext;//current nfs context
+  CNfsMountPtr m_pMount;//mount of the current nfs context
   std::string m_exportPath;//current connected export path
   std::string m_hostName;//current connected host
   std::string m_resolvedHostName;//current connected host - as ip
@@ -116,7 +150,7 @@ private:
   CCriticalSection openContextLock;
  
   void clearMembers();
-  struct nfs_context *getContextFromMap(const std::string &exportname, bool forceCacheHit = false);
+  struct nfs_context *getContextFromMap(const std::string &exportname, bool forceCacheHit = false, CNfsMountPtr *pMount = NULL);
   int  getContextForExport(const std::string &exportname);//get context for given export and add to open contexts map - sets m_pNfsContext (my return a already mounted cached context)
   void destroyOpenContexts();
   void destroyContext(const std::string &exportName);
@@ -156,9 +190,13 @@ namespace XFILE
   protected:
     CURL m_url;
     bool IsValidFile(const std::string& strFileName);
+    //reads with several READ requests in flight at once, the mount has to be locked
+    ssize_t PipelinedRead(char *buffer, size_t size, unsigned int &requests);
     int64_t m_fileSize;
     struct nfsfh  *m_pFileHandle;
     struct nfs_context *m_pNfsContext;//current nfs context
+    CNfsMountPtr m_pMount;//mount of m_pNfsContext
+    uint64_t m_readChunkSize;//max size of a READ request on m_pNfsContext
     std::string m_exportPath;
   };
 }
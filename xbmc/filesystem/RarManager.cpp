@@ -57,6 +57,47 @@ CFileInfo::~CFileInfo()
 {
 }
 
+CRarListing::CRarListing(ArchiveList_struct* pList)
+  : m_pList(pList)
+{
+  for (ArchiveList_struct* pIterator = m_pList; pIterator; pIterator = pIterator->next)
+  {
+    std::string strName;
+
+    /* convert to utf8 */
+    if( pIterator->item.NameW && wcslen(pIterator->item.NameW) > 0)
+      g_charsetConverter.wToUTF8(pIterator->item.NameW, strName);
+    else
+      g_charsetConverter.unknownToUTF8(pIterator->item.Name, strName);
+
+    /* replace back slashes into forward slashes */
+    /* this could get us into troubles, file could two different files, one with / and one with \ */
+    std::string strPath(strName);
+    StringUtils::Replace(strPath, '\\', '/');
+
+    // the first entry wins if names are used twice, like it did with a linear search
+    m_nameIndex.insert(make_pair(strName, m_entries.size()));
+    m_pathIndex.insert(make_pair(strPath, m_entries.size()));
+    m_entries.push_back(pIterator);
+    m_paths.push_back(strPath);
+  }
+}
+
+CRarListing::~CRarListing()
+{
+#ifdef HAS_FILESYSTEM_RAR
+  if (m_pList)
+    urarlib_freelist(m_pList);
+#endif
+}
+
+bool CRarListing::IsDirectory(size_t iEntry) const
+{
+  const ArchiveList_struct* pEntry = m_entries[iEntry];
+  unsigned int iMask = (pEntry->item.HostOS==3 ? 0x0040000:16); // win32 or unix attribs?
+  return (pEntry->item.FileAttr & iMask) == iMask;
+}
+
 /////////////////////////////////////////////////
 CRarManager::CRarManager()
 {
@@ -139,7 +180,7 @@ bool CRarManager::CacheRarredFile(std::string& strPathInCache, const std::string
 
   //If file is listed in the cache, then use listed copy or cleanup before overwriting.
   bool bOverwrite = (bOptions & EXFILE_OVERWRITE) != 0;
-  map<std::string, pair<ArchiveList_struct*,vector<CFileInfo> > >::iterator j = m_ExFiles.find( strRarPath );
+  map<std::string, pair<CRarListingPtr,vector<CFileInfo> > >::iterator j = m_ExFiles.find( strRarPath );
   CFileInfo* pFile=NULL;
   if( j != m_ExFiles.end() )
   {
@@ -226,21 +267,10 @@ bool CRarManager::CacheRarredFile(std::string& strPathInCache, const std::string
 
     if (iOffset == -1 && j != m_ExFiles.end())  // grab from list
     {
-      for( ArchiveList_struct* pIterator = j->second.first; pIterator; pIterator = pIterator->next)
-      {
-        std::string strName;
-
-        /* convert to utf8 */
-        if( pIterator->item.NameW && wcslen(pIterator->item.NameW) > 0)
-          g_charsetConverter.wToUTF8(pIterator->item.NameW, strName);
-        else
-          g_charsetConverter.unknownToUTF8(pIterator->item.Name, strName);
-        if (strName == strPath)
-        {
-          iOffset = pIterator->item.iOffset;
-          break;
-        }
-      }
+      const CRarListing& listing = *j->second.first;
+      map<std::string, size_t>::const_iterator entry = listing.m_nameIndex.find(strPath);
+      if (entry != listing.m_nameIndex.end())
+        iOffset = listing.m_entries[entry->second]->item.iOffset;
     }
     bool bShowProgress=false;
     if (iSize > 1024*1024 || iSize == -2) // 1MB
@@ -266,14 +296,9 @@ bool CRarManager::CacheRarredFile(std::string& strPathInCache, const std::string
     fileInfo.m_strPathInRar = strPathInRar;
     if (j == m_ExFiles.end())
     {
-      ArchiveList_struct* pArchiveList;
-      if(ListArchive(strRarPath,pArchiveList))
-      {
-        m_ExFiles.insert(make_pair(strRarPath,make_pair(pArchiveList,vector<CFileInfo>())));
-        j = m_ExFiles.find(strRarPath);
-      }
-      else
+      if (!GetListing(strRarPath))
         return false;
+      j = m_ExFiles.find(strRarPath);
     }
     j->second.second.push_back(fileInfo);
     pFile = &(j->second.second[j->second.second.size()-1]);
@@ -299,22 +324,10 @@ bool CRarManager::GetFilesInRar(CFileItemList& vecpItems, const std::string& str
                                 bool bMask, const std::string& strPathInRar)
 {
 #ifdef HAS_FILESYSTEM_RAR
-  CSingleLock lock(m_CritSection);
-
-  ArchiveList_struct* pFileList = NULL;
-  map<std::string,pair<ArchiveList_struct*,vector<CFileInfo> > >::iterator it = m_ExFiles.find(strRarPath);
-  if (it == m_ExFiles.end())
-  {
-    if( urarlib_list((char*) strRarPath.c_str(), &pFileList, NULL) )
-      m_ExFiles.insert(make_pair(strRarPath,make_pair(pFileList,vector<CFileInfo>())));
-    else
-    {
-      if( pFileList ) urarlib_freelist(pFileList);
-      return false;
-    }
-  }
-  else
-    pFileList = it->second.first;
+  // the listing isn't changed once it's read, walk it without holding the lock
+  CRarListingPtr listing = GetListing(strRarPath);
+  if (!listing)
+    return false;
 
   CFileItemPtr pFileItem;
   vector<std::string> vec;
@@ -322,23 +335,13 @@ bool CRarManager::GetFilesInRar(CFileItemList& vecpItems, const std::string& str
   StringUtils::Tokenize(strPathInRar,vec,"/");
   unsigned int iDepth = vec.size();
 
-  ArchiveList_struct* pIterator;
   std::string strCompare = strPathInRar;
   if (!URIUtils::HasSlashAtEnd(strCompare) && !strCompare.empty())
     strCompare += '/';
-  for( pIterator = pFileList; pIterator  ; pIterator = pIterator->next )
+  for (size_t iEntry = 0; iEntry < listing->m_entries.size(); iEntry++)
   {
-    std::string strName;
-
-    /* convert to utf8 */
-    if( pIterator->item.NameW && wcslen(pIterator->item.NameW) > 0)
-      g_charsetConverter.wToUTF8(pIterator->item.NameW, strName);
-    else
-      g_charsetConverter.unknownToUTF8(pIterator->item.Name, strName);
-
-    /* replace back slashes into forward slashes */
-    /* this could get us into troubles, file could two different files, one with / and one with \ */
-    StringUtils::Replace(strName, '\\', '/');
+    const ArchiveList_struct* pIterator = listing->m_entries[iEntry];
+    const std::string& strName = listing->m_paths[iEntry];
 
     if (bMask)
     {
@@ -351,8 +354,7 @@ bool CRarManager::GetFilesInRar(CFileItemList& vecpItems, const std::string& str
         continue;
     }
 
-    unsigned int iMask = (pIterator->item.HostOS==3 ? 0x0040000:16); // win32 or unix attribs?
-    if (((pIterator->item.FileAttr & iMask) == iMask) || (vec.size() > iDepth+1 && bMask)) // we have a directory
+    if (listing->IsDirectory(iEntry) || (vec.size() > iDepth+1 && bMask)) // we have a directory
     {
       if (!bMask) continue;
       if (vec.size() == iDepth)
@@ -404,10 +406,40 @@ bool CRarManager::ListArchive(const std::string& strRarPath, ArchiveList_struct*
 #endif
 }
 
+CRarListingPtr CRarManager::GetListing(const std::string& strRarPath)
+{
+#ifdef HAS_FILESYSTEM_RAR
+  CSingleLock lock(m_CritSection);
+  map<std::string,pair<CRarListingPtr,vector<CFileInfo> > >::iterator it = m_ExFiles.find(strRarPath);
+  if (it != m_ExFiles.end())
+    return it->second.first;
+  lock.Leave();
+
+  ArchiveList_struct* pArchiveList = NULL;
+  if (!ListArchive(strRarPath, pArchiveList))
+  {
+    if (pArchiveList)
+      urarlib_freelist(pArchiveList);
+    return CRarListingPtr();
+  }
+  CRarListingPtr listing(new CRarListing(pArchiveList));
+
+  // the archive may have been listed by another thread meanwhile
+  lock.Enter();
+  it = m_ExFiles.find(strRarPath);
+  if (it != m_ExFiles.end())
+    return it->second.first;
+  m_ExFiles.insert(make_pair(strRarPath,make_pair(listing,vector<CFileInfo>())));
+  return listing;
+#else
+  return CRarListingPtr();
+#endif
+}
+
 CFileInfo* CRarManager::GetFileInRar(const std::string& strRarPath, const std::string& strPathInRar)
 {
 #ifdef HAS_FILESYSTEM_RAR
-  map<std::string,pair<ArchiveList_struct*,vector<CFileInfo> > >::iterator j = m_ExFiles.find(strRarPath);
+  map<std::string,pair<CRarListingPtr,vector<CFileInfo> > >::iterator j = m_ExFiles.find(strRarPath);
   if (j == m_ExFiles.end())
     return NULL;
 
@@ -421,7 +453,7 @@ CFileInfo* CRarManager::GetFileInRar(const std::string& strRarPath, const std::s
 bool CRarManager::GetPathInCache(std::string& strPathInCache, const std::string& strRarPath, const std::string& strPathInRar)
 {
 #ifdef HAS_FILESYSTEM_RAR
-  map<std::string,pair<ArchiveList_struct*,vector<CFileInfo> > >::iterator j = m_ExFiles.find(strRarPath);
+  map<std::string,pair<CRarListingPtr,vector<CFileInfo> > >::iterator j = m_ExFiles.find(strRarPath);
   if (j == m_ExFiles.end())
     return false;
 
@@ -436,19 +468,14 @@ bool CRarManager::IsFileInRar(bool& bResult, const std::string& strRarPath, cons
 {
 #ifdef HAS_FILESYSTEM_RAR
   bResult = false;
-  CFileItemList ItemList;
-
-  if (!GetFilesInRar(ItemList,strRarPath,false))
+  CRarListingPtr listing = GetListing(strRarPath);
+  if (!listing)
     return false;
 
-  int it;
-  for (it=0;it<ItemList.Size();++it)
-  {
-    if (strPathInRar.compare(ItemList[it]->GetPath()) == 0)
-      break;
-  }
-  if (it != ItemList.Size())
-    bResult = true;
+  // directories aren't files
+  map<std::string, size_t>::const_iterator it = listing->m_pathIndex.find(strPathInRar);
+  if (it != listing->m_pathIndex.end())
+    bResult = !listing->IsDirectory(it->second);
 
   return true;
 #else
@@ -460,7 +487,7 @@ void CRarManager::ClearCache(bool force)
 {
 #ifdef HAS_FILESYSTEM_RAR
   CSingleLock lock(m_CritSection);
-  map<std::string, pair<ArchiveList_struct*,vector<CFileInfo> > >::iterator j;
+  map<std::string, pair<CRarListingPtr,vector<CFileInfo> > >::iterator j;
   for (j = m_ExFiles.begin() ; j != m_ExFiles.end() ; ++j)
   {
 
@@ -470,7 +497,6 @@ void CRarManager::ClearCache(bool force)
       if (pFile->m_bAutoDel && (pFile->m_iUsed < 1 || force))
         CFile::Delete( pFile->m_strCachedPath );
     }
-    urarlib_freelist(j->second.first);
   }
 
   m_ExFiles.clear();
@@ -482,7 +508,7 @@ void CRarManager::ClearCachedFile(const std::string& strRarPath, const std::stri
 #ifdef HAS_FILESYSTEM_RAR
   CSingleLock lock(m_CritSection);
 
-  map<std::string,pair<ArchiveList_struct*,vector<CFileInfo> > >::iterator j = m_ExFiles.find(strRarPath);
+  map<std::string,pair<CRarListingPtr,vector<CFileInfo> > >::iterator j = m_ExFiles.find(strRarPath);
   if (j == m_ExFiles.end())
   {
     return; // no such subpath
@@ -25,6 +25,9 @@
 #include <string>
 #include "threads/CriticalSection.h"
 #include <map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 #include "UnrarXLib/UnrarX.hpp"
 #include "utils/Stopwatch.h"
 
@@ -62,6 +65,28 @@ public:
   int m_iIsSeekable;
 };
 
+/*!
+ \brief The listing of a rar archive.
+
+ The names of the entries are converted to UTF-8 once when the archive is listed,
+ and indexed so entries can be looked up without walking the list.
+ */
+class CRarListing : public boost::noncopyable
+{
+public:
+  explicit CRarListing(ArchiveList_struct* pList);
+  ~CRarListing();
+
+  bool IsDirectory(size_t iEntry) const;
+
+  ArchiveList_struct* m_pList;
+  std::vector<ArchiveList_struct*> m_entries;
+  std::vector<std::string> m_paths;            // names with forward slashes
+  std::map<std::string, size_t> m_nameIndex;   // entry by name
+  std::map<std::string, size_t> m_pathIndex;   // entry by path
+};
+typedef boost::shared_ptr<CRarListing> CRarListingPtr;
+
 class CRarManager
 {
 public:
@@ -82,7 +107,12 @@ public:
 protected:
 
   bool ListArchive(const std::string& strRarPath, ArchiveList_struct* &pArchiveList);
-  std::map<std::string, std::pair<ArchiveList_struct*,std::vector<CFileInfo> > > m_ExFiles;
+  /*!
+   \brief Get the listing of an archive, listing it if it hasn't been listed yet.
+   The archive is listed without holding the lock, unless the caller holds it.
+   */
+  CRarListingPtr GetListing(const std::string& strRarPath);
+  std::map<std::string, std::pair<CRarListingPtr,std::vector<CFileInfo> > > m_ExFiles;
   CCriticalSection m_CritSection;
 
   int64_t CheckFreeSpace(const std::string& strDrive);
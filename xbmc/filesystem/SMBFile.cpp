@@ -56,6 +56,81 @@ SMBCSRV* xb_smbc_cache(SMBCCTX* c, const char* server, const char* share, const
   return orig_cache(c, server, share, workgroup, username);
 }
 
+// file functions of a context, the global smbc_* functions only work on the default context
+static SMBCFILE* xb_smbc_open(SMBCCTX *c, const char *path, int flags, mode_t mode)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionOpen(c)(c, path, flags, mode);
+#else
+  return c->open(c, path, flags, mode);
+#endif
+}
+
+static SMBCFILE* xb_smbc_creat(SMBCCTX *c, const char *path, mode_t mode)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionCreat(c)(c, path, mode);
+#else
+  return c->creat(c, path, mode);
+#endif
+}
+
+static ssize_t xb_smbc_read(SMBCCTX *c, SMBCFILE *file, void *buf, size_t count)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionRead(c)(c, file, buf, count);
+#else
+  return c->read(c, file, buf, count);
+#endif
+}
+
+static ssize_t xb_smbc_write(SMBCCTX *c, SMBCFILE *file, void *buf, size_t count)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionWrite(c)(c, file, buf, count);
+#else
+  return c->write(c, file, buf, count);
+#endif
+}
+
+static off_t xb_smbc_lseek(SMBCCTX *c, SMBCFILE *file, off_t offset, int whence)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionLseek(c)(c, file, offset, whence);
+#else
+  return c->lseek(c, file, offset, whence);
+#endif
+}
+
+static int xb_smbc_fstat(SMBCCTX *c, SMBCFILE *file, struct stat *st)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionFstat(c)(c, file, st);
+#else
+  return c->fstat(c, file, st);
+#endif
+}
+
+static int xb_smbc_close(SMBCCTX *c, SMBCFILE *file)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionClose(c)(c, file);
+#else
+  return c->close_fn(c, file);
+#endif
+}
+
+CSMBServerContext::CSMBServerContext(SMBCCTX *context, CCriticalSection *section)
+  : m_context(context),
+    m_section(section ? *section : m_ownSection)
+{
+}
+
+CSMBServerContext::~CSMBServerContext()
+{
+  smbc_free_context(m_context, 1);
+}
+
 CSMB::CSMB()
 {
   m_IdleTimeout = 0;
@@ -75,6 +150,9 @@ void CSMB::Deinit()
 {
   CSingleLock lock(*this);
 
+  /* the contexts of the servers are freed once their last file is closed */
+  m_servers.clear();
+
   /* samba goes loco if deinited while it has some files opened */
   if (m_context)
   {
@@ -133,51 +211,103 @@ void CSMB::Init()
       }
     }
 
+#ifdef HAVE_SMBC_THREAD_POSIX
+    // let libsmbclient lock its global state so contexts can be used from several threads
+    static bool threadsInitialized = false;
+    if (!threadsInitialized)
+    {
+      smbc_thread_posix();
+      threadsInitialized = true;
+    }
+#endif
+
     // reads smb.conf so this MUST be after we create smb.conf
     // multiple smbc_init calls are ignored by libsmbclient.
     smbc_init(xb_smbc_auth, 0);
 
     // setup our context
-    m_context = smbc_new_context();
-#ifdef DEPRECATED_SMBC_INTERFACE
-    smbc_setDebug(m_context, g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
-    smbc_setFunctionAuthData(m_context, xb_smbc_auth);
-    orig_cache = smbc_getFunctionGetCachedServer(m_context);
-    smbc_setFunctionGetCachedServer(m_context, xb_smbc_cache);
-    smbc_setOptionOneSharePerServer(m_context, false);
-    smbc_setOptionBrowseMaxLmbCount(m_context, 0);
-    smbc_setTimeout(m_context, g_advancedSettings.m_sambaclienttimeout * 1000);
-    if (CSettings::Get().GetString("smb.workgroup").length() > 0)
-      smbc_setWorkgroup(m_context, strdup(CSettings::Get().GetString("smb.workgroup").c_str()));
-    smbc_setUser(m_context, strdup("guest"));
-#else
-    m_context->debug = (g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
-    m_context->callbacks.auth_fn = xb_smbc_auth;
-    orig_cache = m_context->callbacks.get_cached_srv_fn;
-    m_context->callbacks.get_cached_srv_fn = xb_smbc_cache;
-    m_context->options.one_share_per_server = false;
-    m_context->options.browse_max_lmb_count = 0;
-    m_context->timeout = g_advancedSettings.m_sambaclienttimeout * 1000;
-    if (CSettings::Get().GetString("smb.workgroup").length() > 0)
-      m_context->workgroup = strdup(CSettings::Get().GetString("smb.workgroup").c_str());
-    m_context->user = strdup("guest");
-#endif
-
-    // initialize samba and do some hacking into the settings
-    if (smbc_init_context(m_context))
+    m_context = CreateContext();
+    if (m_context)
     {
       /* setup old interface to use this context */
       smbc_set_context(m_context);
     }
-    else
-    {
-      smbc_free_context(m_context, 1);
-      m_context = NULL;
-    }
   }
   m_IdleTimeout = 180;
 }
 
+SMBCCTX* CSMB::CreateContext()
+{
+  SMBCCTX *context = smbc_new_context();
+  if (!context)
+    return NULL;
+
+#ifdef DEPRECATED_SMBC_INTERFACE
+  smbc_setDebug(context, g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
+  smbc_setFunctionAuthData(context, xb_smbc_auth);
+  orig_cache = smbc_getFunctionGetCachedServer(context);
+  smbc_setFunctionGetCachedServer(context, xb_smbc_cache);
+  smbc_setOptionOneSharePerServer(context, false);
+  smbc_setOptionBrowseMaxLmbCount(context, 0);
+  smbc_setTimeout(context, g_advancedSettings.m_sambaclienttimeout * 1000);
+  if (CSettings::Get().GetString("smb.workgroup").length() > 0)
+    smbc_setWorkgroup(context, strdup(CSettings::Get().GetString("smb.workgroup").c_str()));
+  smbc_setUser(context, strdup("guest"));
+#else
+  context->debug = (g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
+  context->callbacks.auth_fn = xb_smbc_auth;
+  orig_cache = context->callbacks.get_cached_srv_fn;
+  context->callbacks.get_cached_srv_fn = xb_smbc_cache;
+  context->options.one_share_per_server = false;
+  context->options.browse_max_lmb_count = 0;
+  context->timeout = g_advancedSettings.m_sambaclienttimeout * 1000;
+  if (CSettings::Get().GetString("smb.workgroup").length() > 0)
+    context->workgroup = strdup(CSettings::Get().GetString("smb.workgroup").c_str());
+  context->user = strdup("guest");
+#endif
+
+  // initialize samba and do some hacking into the settings
+  if (!smbc_init_context(context))
+  {
+    smbc_free_context(context, 1);
+    return NULL;
+  }
+
+  return context;
+}
+
+SMBServerContextPtr CSMB::GetServerContext(const CURL &url)
+{
+  CSingleLock lock(*this);
+  Init();
+  if (!m_context)
+    return SMBServerContextPtr();
+
+  std::string server = url.GetHostName();
+  StringUtils::ToLower(server);
+
+  std::map<std::string, SMBServerContextPtr>::const_iterator it = m_servers.find(server);
+  if (it != m_servers.end())
+    return it->second;
+
+  SMBCCTX *context = CreateContext();
+  if (!context)
+  {
+    CLog::Log(LOGERROR, "%s - failed to create a context for %s", __FUNCTION__, server.c_str());
+    return SMBServerContextPtr();
+  }
+
+  CLog::Log(LOGDEBUG, "%s - created a context for %s", __FUNCTION__, server.c_str());
+#ifdef HAVE_SMBC_THREAD_POSIX
+  SMBServerContextPtr serverContext(new CSMBServerContext(context, NULL));
+#else
+  // libsmbclient isn't thread safe, so all calls still have to hold our lock
+  SMBServerContextPtr serverContext(new CSMBServerContext(context, this));
+#endif
+  m_servers.insert(std::make_pair(server, serverContext));
+  return serverContext;
+}
+
 std::string CSMB::URLEncode(const CURL &url)
 {
   /* due to smb wanting encoded urls we have to build it manually */
@@ -275,7 +405,8 @@ CSMB smb;
 CSMBFile::CSMBFile()
 {
   smb.Init();
-  m_fd = -1;
+  m_fileSize = 0;
+  m_file = NULL;
   smb.AddActiveConnection();
 }
 
@@ -287,15 +418,15 @@ CSMBFile::~CSMBFile()
 
 int64_t CSMBFile::GetPosition()
 {
-  if (m_fd == -1)
+  if (m_file == NULL)
     return -1;
-  CSingleLock lock(smb);
-  return smbc_lseek(m_fd, 0, SEEK_CUR);
+  CSingleLock lock(m_server->GetSection());
+  return xb_smbc_lseek(m_server->GetContext(), m_file, 0, SEEK_CUR);
 }
 
 int64_t CSMBFile::GetLength()
 {
-  if (m_fd == -1)
+  if (m_file == NULL)
     return -1;
   return m_fileSize;
 }
@@ -318,34 +449,25 @@ bool CSMBFile::Open(const CURL& url)
   // listed, which will create lot's of open sessions.
 
   std::string strFileName;
-  m_fd = OpenFile(url, strFileName);
-
-  CLog::Log(LOGDEBUG,"CSMBFile::Open - opened %s, fd=%d",url.GetFileName().c_str(), m_fd);
-  if (m_fd == -1)
+  if (!OpenFile(url, strFileName))
   {
     // write error to logfile
     CLog::Log(LOGINFO, "SMBFile->Open: Unable to open file : '%s'\nunix_err:'%x' error : '%s'", CURL::GetRedacted(strFileName).c_str(), errno, strerror(errno));
     return false;
   }
+  CLog::Log(LOGDEBUG,"CSMBFile::Open - opened %s",url.GetFileName().c_str());
 
-  CSingleLock lock(smb);
+  CSingleLock lock(m_server->GetSection());
   struct stat tmpBuffer;
-  if (smbc_stat(strFileName.c_str(), &tmpBuffer) < 0)
+  if (xb_smbc_fstat(m_server->GetContext(), m_file, &tmpBuffer) < 0 ||
+      xb_smbc_lseek(m_server->GetContext(), m_file, 0, SEEK_SET) < 0)
   {
-    smbc_close(m_fd);
-    m_fd = -1;
+    lock.Leave();
+    Close();
     return false;
   }
 
   m_fileSize = tmpBuffer.st_size;
-
-  int64_t ret = smbc_lseek(m_fd, 0, SEEK_SET);
-  if ( ret < 0 )
-  {
-    smbc_close(m_fd);
-    m_fd = -1;
-    return false;
-  }
   // We've successfully opened the file!
   return true;
 }
@@ -376,23 +498,27 @@ int CSMBFile::OpenFile(std::string& strAuth)
 }
 */
 
-int CSMBFile::OpenFile(const CURL &url, std::string& strAuth)
+bool CSMBFile::OpenFile(const CURL &url, std::string& strAuth)
 {
-  int fd = -1;
-  smb.Init();
-
   strAuth = GetAuthenticatedPath(url);
-  std::string strPath = strAuth;
+
+  // every server has its own context so reads from different servers don't block each other
+  m_server = smb.GetServerContext(url);
+  if (!m_server)
+    return false;
 
   {
-    CSingleLock lock(smb);
-    fd = smbc_open(strPath.c_str(), O_RDONLY, 0);
+    CSingleLock lock(m_server->GetSection());
+    m_file = xb_smbc_open(m_server->GetContext(), strAuth.c_str(), O_RDONLY, 0);
   }
 
-  if (fd >= 0)
-    strAuth = strPath;
+  if (m_file == NULL)
+  {
+    m_server.reset();
+    return false;
+  }
 
-  return fd;
+  return true;
 }
 
 bool CSMBFile::Exists(const CURL& url)
@@ -415,13 +541,13 @@ bool CSMBFile::Exists(const CURL& url)
 
 int CSMBFile::Stat(struct __stat64* buffer)
 {
-  if (m_fd == -1)
+  if (m_file == NULL)
     return -1;
 
   struct stat tmpBuffer = {0};
 
-  CSingleLock lock(smb);
-  int iResult = smbc_fstat(m_fd, &tmpBuffer);
+  CSingleLock lock(m_server->GetSection());
+  int iResult = xb_smbc_fstat(m_server->GetContext(), m_file, &tmpBuffer);
   CUtil::StatToStat64(buffer, &tmpBuffer);
   return iResult;
 }
@@ -440,7 +566,7 @@ int CSMBFile::Stat(const CURL& url, struct __stat64* buffer)
 
 int CSMBFile::Truncate(int64_t size)
 {
-  if (m_fd == -1) return 0;
+  if (m_file == NULL) return 0;
 /* 
  * This would force us to be dependant on SMBv3.2 which is GPLv3
  * This is only used by the TagLib writers, which are not currently in use
@@ -462,7 +588,7 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
-  if (m_fd == -1)
+  if (m_file == NULL)
     return -1;
 
   // Some external libs (libass) use test read with zero size and 
@@ -473,7 +599,7 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
   if (uiBufSize == 0 && lpBuf == NULL)
     return 0;
 
-  CSingleLock lock(smb); // Init not called since it has to be "inited" by now
+  CSingleLock lock(m_server->GetSection()); // see CSMBServerContext for who has to wait for us
   smb.SetActivityTime();
   /* work around stupid bug in samba */
   /* some samba servers has a bug in it where the */
@@ -485,12 +611,12 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
   if( uiBufSize >= 64*1024-2 )
     uiBufSize = 64*1024-2;
 
-  ssize_t bytesRead = smbc_read(m_fd, lpBuf, (int)uiBufSize);
+  ssize_t bytesRead = xb_smbc_read(m_server->GetContext(), m_file, lpBuf, uiBufSize);
 
   if ( bytesRead < 0 && errno == EINVAL )
   {
     CLog::Log(LOGERROR, "%s - Error( %"PRIdS", %d, %s ) - Retrying", __FUNCTION__, bytesRead, errno, strerror(errno));
-    bytesRead = smbc_read(m_fd, lpBuf, (int)uiBufSize);
+    bytesRead = xb_smbc_read(m_server->GetContext(), m_file, lpBuf, uiBufSize);
   }
 
   if ( bytesRead < 0 )
@@ -501,11 +627,11 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
 
 int64_t CSMBFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  if (m_fd == -1) return -1;
+  if (m_file == NULL) return -1;
 
-  CSingleLock lock(smb); // Init not called since it has to be "inited" by now
+  CSingleLock lock(m_server->GetSection());
   smb.SetActivityTime();
-  int64_t pos = smbc_lseek(m_fd, iFilePosition, iWhence);
+  int64_t pos = xb_smbc_lseek(m_server->GetContext(), m_file, iFilePosition, iWhence);
 
   if ( pos < 0 )
   {
@@ -518,23 +644,24 @@ int64_t CSMBFile::Seek(int64_t iFilePosition, int iWhence)
 
 void CSMBFile::Close()
 {
-  if (m_fd != -1)
+  if (m_file != NULL)
   {
-    CLog::Log(LOGDEBUG,"CSMBFile::Close closing fd %d", m_fd);
-    CSingleLock lock(smb);
-    smbc_close(m_fd);
+    CLog::Log(LOGDEBUG,"CSMBFile::Close closing %s", m_url.GetFileName().c_str());
+    CSingleLock lock(m_server->GetSection());
+    xb_smbc_close(m_server->GetContext(), m_file);
   }
-  m_fd = -1;
+  m_file = NULL;
+  m_server.reset();
 }
 
 ssize_t CSMBFile::Write(const void* lpBuf, size_t uiBufSize)
 {
-  if (m_fd == -1) return -1;
+  if (m_file == NULL) return -1;
 
   // lpBuf can be safely casted to void* since xbmc_write will only read from it.
-  CSingleLock lock(smb);
+  CSingleLock lock(m_server->GetSection());
 
-  return  smbc_write(m_fd, (void*)lpBuf, uiBufSize);
+  return xb_smbc_write(m_server->GetContext(), m_file, (void*)lpBuf, uiBufSize);
 }
 
 bool CSMBFile::Delete(const CURL& url)
@@ -577,20 +704,26 @@ bool CSMBFile::OpenForWrite(const CURL& url, bool bOverWrite)
   if (!IsValidFile(url.GetFileName())) return false;
 
   std::string strFileName = GetAuthenticatedPath(url);
-  CSingleLock lock(smb);
+  m_server = smb.GetServerContext(url);
+  if (!m_server)
+    return false;
+
+  CSingleLock lock(m_server->GetSection());
 
   if (bOverWrite)
   {
     CLog::Log(LOGWARNING, "SMBFile::OpenForWrite() called with overwriting enabled! - %s", strFileName.c_str());
-    m_fd = smbc_creat(strFileName.c_str(), 0);
+    m_file = xb_smbc_creat(m_server->GetContext(), strFileName.c_str(), 0);
   }
   else
   {
-    m_fd = smbc_open(strFileName.c_str(), O_RDWR, 0);
+    m_file = xb_smbc_open(m_server->GetContext(), strFileName.c_str(), O_RDWR, 0);
   }
 
-  if (m_fd == -1)
+  if (m_file == NULL)
   {
+    lock.Leave();
+    m_server.reset();
     // write error to logfile
     CLog::Log(LOGERROR, "SMBFile->Open: Unable to open file : '%s'\nunix_err:'%x' error : '%s'", strFileName.c_str(), errno, strerror(errno));
     return false;
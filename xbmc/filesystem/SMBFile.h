@@ -27,6 +27,9 @@
 //////////////////////////////////////////////////////////////////////
 
 
+#include <map>
+#include <boost/shared_ptr.hpp>
+
 #include "IFile.h"
 #include "URL.h"
 #include "threads/CriticalSection.h"
@@ -39,6 +42,40 @@
 
 struct _SMBCCTX;
 typedef _SMBCCTX SMBCCTX;
+struct _SMBCFILE;
+typedef _SMBCFILE SMBCFILE;
+
+/*!
+ \brief libsmbclient context used for the files of one server.
+
+ libsmbclient contexts aren't thread safe, so every call on a context has to
+ hold its lock. When libsmbclient supports threads, files on different servers
+ use different locks and don't block each other. Otherwise all contexts share
+ the global lock of CSMB.
+ */
+class CSMBServerContext
+{
+public:
+  /*!
+   \param context the context, freed with this object
+   \param section the lock to use, or NULL for a lock of its own
+   */
+  CSMBServerContext(SMBCCTX *context, CCriticalSection *section);
+  ~CSMBServerContext();
+
+  SMBCCTX* GetContext() const { return m_context; }
+  CCriticalSection& GetSection() { return m_section; }
+
+private:
+  CSMBServerContext(const CSMBServerContext&);
+  CSMBServerContext& operator=(const CSMBServerContext&);
+
+  SMBCCTX *m_context;
+  CCriticalSection m_ownSection;
+  CCriticalSection &m_section;
+};
+
+typedef boost::shared_ptr<CSMBServerContext> SMBServerContextPtr;
 
 class CSMB : public CCriticalSection
 {
@@ -51,12 +88,19 @@ public:
   void SetActivityTime();
   void AddActiveConnection();
   void AddIdleConnection();
+  /*!
+   \brief Get the context for the files of the server of the given url, creating it if needed.
+   */
+  SMBServerContextPtr GetServerContext(const CURL &url);
   std::string URLEncode(const std::string &value);
   std::string URLEncode(const CURL &url);
 
   DWORD ConvertUnixToNT(int error);
 private:
+  SMBCCTX* CreateContext();
+
   SMBCCTX *m_context;
+  std::map<std::string, SMBServerContextPtr> m_servers;
 #ifdef TARGET_POSIX
   int m_OpenConnections;
   unsigned int m_IdleTimeout;
@@ -71,7 +115,7 @@ class CSMBFile : public IFile
 {
 public:
   CSMBFile();
-  int OpenFile(const CURL &url, std::string& strAuth);
+  bool OpenFile(const CURL &url, std::string& strAuth);
   virtual ~CSMBFile();
   virtual void Close();
   virtual int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET);
@@ -95,7 +139,8 @@ protected:
   bool IsValidFile(const std::string& strFileName);
   std::string GetAuthenticatedPath(const CURL &url);
   int64_t m_fileSize;
-  int m_fd;
+  SMBServerContextPtr m_server;
+  SMBCFILE *m_file;
 };
 }
 
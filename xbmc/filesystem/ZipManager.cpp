@@ -27,16 +27,21 @@
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
 #include "SpecialProtocol.h"
+#include "threads/Atomics.h"
 
 
 #ifndef min
 #define min(a,b)            (((a) < (b)) ? (a) : (b))
 #endif
 
+// number of central directories kept in memory
+#define ZIP_CACHE_SIZE 16
+
 using namespace XFILE;
 using namespace std;
 
 CZipManager::CZipManager()
+  : m_useCounter(0)
 {
 }
 
@@ -49,36 +54,82 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
 {
   CLog::Log(LOGDEBUG, "%s - Processing %s", __FUNCTION__, url.GetRedacted().c_str());
 
-  struct __stat64 m_StatData = {};
+  ZipArchivePtr archive = GetArchive(url, true);
+  if (!archive)
+    return false;
+
+  items = archive->entries;
+  return true;
+}
+
+bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
+{
+  ZipArchivePtr archive = GetArchive(url, false);
+  if (!archive)
+    return false;
+
+  map<std::string, size_t>::const_iterator it = archive->index.find(url.GetFileName());
+  if (it == archive->index.end())
+    return false;
+
+  memcpy(&item, &archive->entries[it->second], sizeof(SZipEntry));
+  return true;
+}
 
+CZipManager::ZipArchivePtr CZipManager::GetArchive(const CURL& url, bool validate)
+{
   std::string strFile = url.GetHostName();
 
-  if (CFile::Stat(strFile,&m_StatData))
+  ZipArchivePtr archive;
   {
-    CLog::Log(LOGDEBUG,"CZipManager::GetZipList: failed to stat file %s", url.GetRedacted().c_str());
-    return false;
+    CSharedLock lock(m_critSection);
+    map<std::string, ZipArchivePtr>::const_iterator it = m_archives.find(strFile);
+    if (it != m_archives.end())
+      archive = it->second;
   }
 
-  map<std::string,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
+  if (archive && !validate)
   {
-    map<std::string,int64_t>::iterator it2=mZipDate.find(strFile);
-    CLog::Log(LOGDEBUG,"statdata: %" PRId64" new: %" PRIu64, it2->second, (uint64_t)m_StatData.st_mtime);
+    Touch(*archive);
+    return archive;
+  }
 
-      if (m_StatData.st_mtime == it2->second)
-      {
-        items = it->second;
-        return true;
-      }
-      mZipMap.erase(it);
-      mZipDate.erase(it2);
+  struct __stat64 statData = {};
+  if (CFile::Stat(strFile,&statData))
+  {
+    CLog::Log(LOGDEBUG,"CZipManager::GetZipList: failed to stat file %s", url.GetRedacted().c_str());
+    return ZipArchivePtr();
   }
 
+  // already listed, just return it if not changed, else reread
+  if (archive)
+  {
+    CLog::Log(LOGDEBUG,"statdata: %" PRId64" new: %" PRIu64, archive->mtime, (uint64_t)statData.st_mtime);
+    if (archive->mtime == (int64_t)statData.st_mtime && archive->size == (int64_t)statData.st_size)
+    {
+      Touch(*archive);
+      return archive;
+    }
+  }
+
+  // read the central directory without holding the lock, so other archives can be used meanwhile
+  archive = ReadArchive(strFile, statData);
+  if (archive)
+    AddArchive(strFile, archive);
+  return archive;
+}
+
+CZipManager::ZipArchivePtr CZipManager::ReadArchive(const std::string& strFile, const struct __stat64& statData)
+{
+  ZipArchivePtr archive(new SZipArchive);
+  archive->mtime = statData.st_mtime;
+  archive->size = statData.st_size;
+
   CFile mFile;
   if (!mFile.Open(strFile))
   {
     CLog::Log(LOGDEBUG,"ZipManager: unable to open file %s!",strFile.c_str());
-    return false;
+    return ZipArchivePtr();
   }
 
   unsigned int hdr;
@@ -86,11 +137,8 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
   {
     CLog::Log(LOGDEBUG,"ZipManager: not a zip file!");
     mFile.Close();
-    return false;
+    return ZipArchivePtr();
   }
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
-
 
   // Look for end of central directory record
   // Zipfile comment may be up to 65535 bytes
@@ -114,7 +162,7 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
   {
     mFile.Seek(fileSize-ECDREC_SIZE+1-(blockSize*nb),SEEK_SET);
     if (mFile.Read(buffer.get(), blockSize + 3) != blockSize + 3)
-      return false;
+      return ZipArchivePtr();
     for (int i=blockSize-1; !found && (i >= 0); i--)
     {
       if ( Endian_SwapLE32(*((unsigned int*)(buffer.get()+i))) == ZIP_END_CENTRAL_HEADER )
@@ -131,7 +179,7 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
   {
     mFile.Seek(fileSize-ECDREC_SIZE+1-searchSize,SEEK_SET);
     if (mFile.Read(buffer.get(), extraBlockSize + 3) != extraBlockSize + 3)
-      return false;
+      return ZipArchivePtr();
     for (int i=extraBlockSize-1; !found && (i >= 0); i--)
     {
       if ( Endian_SwapLE32(*((unsigned int*)(buffer.get()+i))) == ZIP_END_CENTRAL_HEADER )
@@ -149,18 +197,18 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
   {
     CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
     mFile.Close();
-    return false;
+    return ZipArchivePtr();
   }
 
   unsigned int cdirOffset, cdirSize;
   // Get size of the central directory
   mFile.Seek(12,SEEK_CUR);
   if (mFile.Read(&cdirSize, 4) != 4)
-    return false;
+    return ZipArchivePtr();
   cdirSize = Endian_SwapLE32(cdirSize);
   // Get Offset of start of central directory with respect to the starting disk number
   if (mFile.Read(&cdirOffset, 4) != 4)
-    return false;
+    return ZipArchivePtr();
   cdirOffset = Endian_SwapLE32(cdirOffset);
 
   // Go to the start of central directory
@@ -171,19 +219,19 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
   {
     SZipEntry ze;
     if (mFile.Read(temp, CHDR_SIZE) != CHDR_SIZE)
-      return false;
+      return ZipArchivePtr();
     readCHeader(temp, ze);
     if (ze.header != ZIP_CENTRAL_HEADER)
     {
       CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
       mFile.Close();
-      return false;
+      return ZipArchivePtr();
     }
 
     // Get the filename just after the central file header
     auto_buffer bufName(ze.flength);
     if (mFile.Read(bufName.get(), ze.flength) != ze.flength)
-      return false;
+      return ZipArchivePtr();
     std::string strName(bufName.get(), bufName.size());
     bufName.clear();
     g_charsetConverter.unknownToUTF8(strName);
@@ -193,18 +241,18 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
     // Jump after central file header extra field and file comment
     mFile.Seek(ze.eclength + ze.clength,SEEK_CUR);
 
-    items.push_back(ze);
+    archive->entries.push_back(ze);
   }
 
   /* go through list and figure out file header lengths */
-  for(vector<SZipEntry>::iterator it = items.begin(); it != items.end(); ++it)
+  for(vector<SZipEntry>::iterator it = archive->entries.begin(); it != archive->entries.end(); ++it)
   {
     SZipEntry& ze = *it;
     // Go to the local file header to get the extra field length
     // !! local header extra field length != central file header extra field length !!
     mFile.Seek(ze.lhdrOffset+28,SEEK_SET);
     if (mFile.Read(&(ze.elength), 2) != 2)
-      return false;
+      return ZipArchivePtr();
     ze.elength = Endian_SwapLE16(ze.elength);
 
     // Compressed data offset = local header offset + size of local header + filename length + local file header extra field length
@@ -212,36 +260,38 @@ bool CZipManager::GetZipList(const CURL& url, vector<SZipEntry>& items)
 
   }
 
-  mZipMap.insert(make_pair(strFile,items));
+  // names aren't unique in broken archives, the first entry wins like it did with a linear search
+  for (size_t i = 0; i < archive->entries.size(); i++)
+    archive->index.insert(make_pair(std::string(archive->entries[i].name), i));
+
   mFile.Close();
-  return true;
+  return archive;
 }
 
-bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
+void CZipManager::AddArchive(const std::string& strFile, const ZipArchivePtr& archive)
 {
-  std::string strFile = url.GetHostName();
+  Touch(*archive);
 
-  map<std::string,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  vector<SZipEntry> items;
-  if (it == mZipMap.end()) // we need to list the zip
-  {
-    GetZipList(url,items);
-  }
-  else
-  {
-    items = it->second;
-  }
+  CExclusiveLock lock(m_critSection);
+  m_archives[strFile] = archive;
 
-  std::string strFileName = url.GetFileName();
-  for (vector<SZipEntry>::iterator it2=items.begin();it2 != items.end();++it2)
+  // forget the least recently used archive if there are too many
+  if (m_archives.size() > ZIP_CACHE_SIZE)
   {
-    if (std::string(it2->name) == strFileName)
+    map<std::string, ZipArchivePtr>::iterator oldest = m_archives.end();
+    for (map<std::string, ZipArchivePtr>::iterator it = m_archives.begin(); it != m_archives.end(); ++it)
     {
-      memcpy(&item,&(*it2),sizeof(SZipEntry));
-      return true;
+      if (it->second != archive && (oldest == m_archives.end() || it->second->lastUsed < oldest->second->lastUsed))
+        oldest = it;
     }
+    if (oldest != m_archives.end())
+      m_archives.erase(oldest);
   }
-  return false;
+}
+
+void CZipManager::Touch(SZipArchive& archive)
+{
+  archive.lastUsed = AtomicIncrement(&m_useCounter);
 }
 
 bool CZipManager::ExtractArchive(const std::string& strArchive, const std::string& strPath)
@@ -309,13 +359,8 @@ void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
 void CZipManager::release(const std::string& strPath)
 {
   CURL url(strPath);
-  map<std::string,vector<SZipEntry> >::iterator it= mZipMap.find(url.GetHostName());
-  if (it != mZipMap.end())
-  {
-    map<std::string,int64_t>::iterator it2=mZipDate.find(url.GetHostName());
-    mZipMap.erase(it);
-    mZipDate.erase(it2);
-  }
+  CExclusiveLock lock(m_critSection);
+  m_archives.erase(url.GetHostName());
 }
 
 
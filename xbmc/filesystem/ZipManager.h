@@ -34,6 +34,10 @@
 #include <vector>
 #include <map>
 
+#include <boost/shared_ptr.hpp>
+
+#include "threads/SharedSection.h"
+
 class CURL;
 
 struct SZipEntry {
@@ -109,8 +113,37 @@ public:
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
-  std::map<std::string,std::vector<SZipEntry> > mZipMap;
-  std::map<std::string,int64_t> mZipDate;
+  /*!
+   \brief The parsed central directory of an archive.
+
+   The entries of an archive are never changed once they have been read, only the
+   time it was last used is updated. A changed archive is read again and replaces
+   the old one, readers still holding the old one keep using it.
+   */
+  struct SZipArchive
+  {
+    SZipArchive() : mtime(0), size(0), lastUsed(0) { }
+    int64_t mtime;
+    int64_t size;
+    volatile long lastUsed;
+    std::vector<SZipEntry> entries;
+    std::map<std::string, size_t> index; // position of an entry in entries by its name
+  };
+  typedef boost::shared_ptr<SZipArchive> ZipArchivePtr;
+
+  /*!
+   \brief Get the central directory of an archive, reading it if it isn't cached.
+   \param url the archive, as the host name of a zip:// url
+   \param validate whether a cached archive should be checked for changes first
+   */
+  ZipArchivePtr GetArchive(const CURL& url, bool validate);
+  ZipArchivePtr ReadArchive(const std::string& strFile, const struct __stat64& statData);
+  void AddArchive(const std::string& strFile, const ZipArchivePtr& archive);
+  void Touch(SZipArchive& archive);
+
+  CSharedSection m_critSection;
+  std::map<std::string, ZipArchivePtr> m_archives;
+  volatile long m_useCounter;
 };
 
 extern CZipManager g_ZipManager;
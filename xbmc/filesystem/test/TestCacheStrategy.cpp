@@ -0,0 +1,121 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CacheStrategy.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+using namespace XFILE;
+
+#define BLOCK (256 * 1024)
+
+static void Fill(std::vector<char> &buffer, int64_t position)
+{
+  for (size_t i = 0; i < buffer.size(); i++)
+    buffer[i] = (char)((position + i) % 251);
+}
+
+static void Write(CCacheStrategy &cache, int64_t position, size_t size)
+{
+  std::vector<char> buffer(size);
+  Fill(buffer, position);
+  ASSERT_EQ((int)size, cache.WriteToCache(&buffer[0], size));
+}
+
+TEST(TestSparseFileCache, WriteRead)
+{
+  CSparseFileCache cache(16 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, BLOCK + 100);
+  EXPECT_EQ(BLOCK + 100, cache.CachedDataEndPos());
+  EXPECT_EQ(BLOCK + 100, cache.WaitForData(0, 0));
+
+  std::vector<char> expected(BLOCK + 100);
+  std::vector<char> buffer(BLOCK + 100);
+  Fill(expected, 0);
+  EXPECT_EQ(BLOCK + 100, cache.ReadFromCache(&buffer[0], buffer.size()));
+  EXPECT_EQ(0, memcmp(&expected[0], &buffer[0], buffer.size()));
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(&buffer[0], buffer.size()));
+
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, KeepsRangesOnReset)
+{
+  CSparseFileCache cache(16 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, 1000);
+  EXPECT_TRUE(cache.Reset(3 * BLOCK + 10, false));
+  Write(cache, 3 * BLOCK + 10, 2000);
+
+  // the first range is still there, but needs a reset to be read
+  EXPECT_TRUE(cache.IsCachedPosition(500));
+  EXPECT_FALSE(cache.IsCachedPosition(2000));
+  EXPECT_EQ(1000, cache.CachedDataEndPosIfSeekTo(500));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(500));
+  EXPECT_FALSE(cache.Reset(500, false));
+  EXPECT_EQ(1000, cache.CachedDataEndPos());
+
+  std::vector<char> expected(500);
+  std::vector<char> buffer(500);
+  Fill(expected, 500);
+  EXPECT_EQ(500, cache.ReadFromCache(&buffer[0], buffer.size()));
+  EXPECT_EQ(0, memcmp(&expected[0], &buffer[0], buffer.size()));
+
+  std::vector<SCacheRange> ranges;
+  EXPECT_TRUE(cache.GetCachedRanges(ranges));
+  ASSERT_EQ(2U, ranges.size());
+  EXPECT_EQ(0, ranges[0].start);
+  EXPECT_EQ(1000, ranges[0].end);
+  EXPECT_EQ(3 * BLOCK + 10, ranges[1].start);
+  EXPECT_EQ(3 * BLOCK + 2010, ranges[1].end);
+
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, ReusesLeastRecentlyUsedBlocks)
+{
+  CSparseFileCache cache(4 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  std::vector<char> buffer(2 * BLOCK);
+  Write(cache, 0, 2 * BLOCK);
+  EXPECT_EQ(2 * BLOCK, cache.ReadFromCache(&buffer[0], buffer.size()));
+
+  cache.Reset(10 * BLOCK, false);
+  Write(cache, 10 * BLOCK, 3 * BLOCK);
+  EXPECT_FALSE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(BLOCK));
+  EXPECT_TRUE(cache.IsCachedPosition(10 * BLOCK));
+
+  // unread data can't be dropped
+  Write(cache, 13 * BLOCK, BLOCK);
+  EXPECT_FALSE(cache.IsCachedPosition(BLOCK));
+  EXPECT_EQ(0U, cache.GetMaxWriteSize(BLOCK));
+
+  EXPECT_EQ(BLOCK, cache.ReadFromCache(&buffer[0], BLOCK));
+  EXPECT_EQ((size_t)BLOCK, cache.GetMaxWriteSize(BLOCK));
+
+  cache.Close();
+}
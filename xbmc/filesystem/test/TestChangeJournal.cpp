@@ -0,0 +1,173 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/ChangeJournal.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+
+#ifdef TARGET_POSIX
+#include "../linux/XTimeUtils.h"
+#endif
+#ifdef TARGET_LINUX
+#include <unistd.h>
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+TEST(TestChangeJournal, GetRoots)
+{
+  std::set<std::string> paths;
+  paths.insert("/media/movies/");
+  paths.insert("/media/movies/a/");
+  paths.insert("/media/movies/a/b/");
+  paths.insert("/media/movies-hd/");
+  paths.insert("/media/tv/");
+  paths.insert("/media/tv/show/");
+  paths.insert("smb://server/share/");
+
+  std::vector<std::string> roots;
+  CChangeJournal::GetRoots(paths, roots);
+  ASSERT_EQ(4U, roots.size());
+  EXPECT_STREQ("/media/movies-hd/", roots[0].c_str());
+  EXPECT_STREQ("/media/movies/", roots[1].c_str());
+  EXPECT_STREQ("/media/tv/", roots[2].c_str());
+  EXPECT_STREQ("smb://server/share/", roots[3].c_str());
+}
+
+TEST(TestChangeJournal, NotWatched)
+{
+  CChangeJournal &journal = CChangeJournal::Get();
+
+  journal.Watch("smb://server/share/");
+  journal.SetScanned("test", "smb://server/share/", journal.GetSequence());
+  EXPECT_FALSE(journal.IsUnchanged("test", "smb://server/share/", false));
+
+  journal.SetScanned("test", "/never/watched/", journal.GetSequence());
+  EXPECT_FALSE(journal.IsUnchanged("test", "/never/watched/", false));
+  EXPECT_FALSE(journal.IsUnchanged("test", "/never/watched/", true));
+}
+
+#ifdef TARGET_LINUX
+static bool Scan(const std::string &path, bool recursive)
+{
+  // folders can only be vouched for once they are watched
+  for (int i = 0; i < 100; i++)
+  {
+    CChangeJournal::Get().SetScanned("test", path, CChangeJournal::Get().GetSequence());
+    if (CChangeJournal::Get().IsUnchanged("test", path, recursive))
+      return true;
+    Sleep(50);
+  }
+  return false;
+}
+
+static bool WaitForChange(const std::string &path)
+{
+  for (int i = 0; i < 100; i++)
+  {
+    if (!CChangeJournal::Get().IsUnchanged("test", path, false))
+      return true;
+    Sleep(50);
+  }
+  return false;
+}
+
+TEST(TestChangeJournal, RecordsChanges)
+{
+  CChangeJournal &journal = CChangeJournal::Get();
+  std::string root = CSpecialProtocol::TranslatePath("special://temp/changejournal/");
+  std::string folder = root + "folder/";
+  ASSERT_TRUE(CDirectory::Create(root));
+  ASSERT_TRUE(CDirectory::Create(folder));
+
+  journal.Start();
+  journal.Watch(root);
+
+  ASSERT_TRUE(Scan(folder, false));
+  ASSERT_TRUE(Scan(root, true));
+  EXPECT_FALSE(journal.IsUnchanged("other", root, true));
+
+  // a new file changes its folder, and the folders above it when checked recursively
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite(folder + "file.txt", true));
+  EXPECT_EQ(4, file.Write("test", 4));
+  file.Close();
+  EXPECT_TRUE(WaitForChange(folder));
+  EXPECT_TRUE(journal.IsUnchanged("test", root, false));
+  EXPECT_FALSE(journal.IsUnchanged("test", root, true));
+
+  // verifying the folders again catches up with the change
+  unsigned int sequence = journal.GetSequence();
+  journal.SetScanned("test", folder, sequence);
+  journal.SetScanned("test", root, sequence);
+  EXPECT_TRUE(journal.IsUnchanged("test", root, true));
+
+  // new folders are watched as well
+  std::string created = folder + "created/";
+  ASSERT_TRUE(CDirectory::Create(created));
+  EXPECT_TRUE(WaitForChange(folder));
+  ASSERT_TRUE(Scan(created, false));
+  ASSERT_TRUE(file.OpenForWrite(created + "file.txt", true));
+  file.Close();
+  EXPECT_TRUE(WaitForChange(created));
+
+  CFile::Delete(created + "file.txt");
+  CDirectory::Remove(created);
+  CFile::Delete(folder + "file.txt");
+  CDirectory::Remove(folder);
+  CDirectory::Remove(root);
+}
+
+TEST(TestChangeJournal, FollowsLinks)
+{
+  CChangeJournal &journal = CChangeJournal::Get();
+  std::string root = CSpecialProtocol::TranslatePath("special://temp/changejournal-links/");
+  std::string target = CSpecialProtocol::TranslatePath("special://temp/changejournal-target/");
+  std::string link = root + "link/";
+  ASSERT_TRUE(CDirectory::Create(root));
+  ASSERT_TRUE(CDirectory::Create(target));
+
+  journal.Start();
+  journal.Watch(root);
+  ASSERT_TRUE(Scan(root, true));
+
+  // a link to a folder created later is watched like the folder itself
+  ASSERT_EQ(0, symlink(target.c_str(), (root + "link").c_str()));
+  EXPECT_TRUE(WaitForChange(root));
+  ASSERT_TRUE(Scan(link, false));
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite(target + "file.txt", true));
+  file.Close();
+  EXPECT_TRUE(WaitForChange(link));
+
+  // and forgotten once the link is removed
+  ASSERT_TRUE(Scan(root, false));
+  unlink((root + "link").c_str());
+  EXPECT_TRUE(WaitForChange(root));
+  EXPECT_FALSE(journal.IsUnchanged("test", link, false));
+
+  CFile::Delete(target + "file.txt");
+  CDirectory::Remove(target);
+  CDirectory::Remove(root);
+}
+#endif
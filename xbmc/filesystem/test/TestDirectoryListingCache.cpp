@@ -0,0 +1,215 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryListingCache.h"
+#include "filesystem/File.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/URIUtils.h"
+
+#ifdef TARGET_POSIX
+#include "../linux/XTimeUtils.h"
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+class TestDirectoryListingCache : public testing::Test
+{
+protected:
+  TestDirectoryListingCache() : m_ttl(g_advancedSettings.m_networkListingCacheTTL) { }
+  ~TestDirectoryListingCache() { g_advancedSettings.m_networkListingCacheTTL = m_ttl; }
+
+  // the directory as the cache stores it
+  static std::string CachePath(const std::string &path)
+  {
+    std::string cachePath(CURL(path).Get());
+    URIUtils::AddSlashAtEnd(cachePath);
+    return cachePath;
+  }
+
+  static std::string GetCacheFile(const std::string &path)
+  {
+    return CDirectoryListingCache::GetCacheFile(path);
+  }
+
+  static bool Load(const std::string &path, CFileItemList &items, std::string &validator)
+  {
+    int64_t stored;
+    return CDirectoryListingCache::Load(path, items, validator, stored);
+  }
+
+  static bool Save(const std::string &path, CFileItemList &items, const std::string &validator)
+  {
+    return CDirectoryListingCache::Save(path, items, validator);
+  }
+
+  static bool IsPending(const std::string &path)
+  {
+    CDirectoryListingCache &cache = CDirectoryListingCache::Get();
+    CSingleLock lock(cache.m_critSection);
+    return cache.m_pending.find(path) != cache.m_pending.end();
+  }
+
+  static void CreateListing(const std::string &path, CFileItemList &items)
+  {
+    CFileItemPtr folder(new CFileItem(path + "folder/", true));
+    folder->SetLabel("folder");
+    items.Add(folder);
+    CFileItemPtr file(new CFileItem(path + "movie.mkv", false));
+    file->SetLabel("movie");
+    file->m_dwSize = 1234;
+    items.Add(file);
+  }
+
+  unsigned int m_ttl;
+};
+
+TEST_F(TestDirectoryListingCache, IsCached)
+{
+  CDirectoryListingCache &cache = CDirectoryListingCache::Get();
+
+  g_advancedSettings.m_networkListingCacheTTL = 0;
+  EXPECT_FALSE(cache.IsCached(CURL("upnp://server/1/")));
+  EXPECT_FALSE(cache.IsCached(CURL("smb://server/share/")));
+
+  g_advancedSettings.m_networkListingCacheTTL = 3600;
+  EXPECT_TRUE(cache.IsCached(CURL("upnp://server/1/")));
+  EXPECT_TRUE(cache.IsCached(CURL("ftp://server/movies/")));
+  EXPECT_TRUE(cache.IsCached(CURL("davs://server/movies/")));
+  EXPECT_TRUE(cache.IsCached(CURL("smb://server/share/")));
+  EXPECT_FALSE(cache.IsCached(CURL("special://temp/")));
+  EXPECT_FALSE(cache.IsCached(CURL("/home/user/movies/")));
+  EXPECT_FALSE(cache.IsCached(CURL("plugin://plugin.video.test/")));
+}
+
+TEST_F(TestDirectoryListingCache, NotStored)
+{
+  CDirectoryListingCache &cache = CDirectoryListingCache::Get();
+  CFileItemList items;
+
+  g_advancedSettings.m_networkListingCacheTTL = 3600;
+  cache.ClearDirectory("upnp://server/never/stored/");
+  EXPECT_FALSE(cache.GetDirectory(CURL("upnp://server/never/stored/"), "upnp://server/never/stored/", 0, items));
+  EXPECT_EQ(0, items.Size());
+
+  g_advancedSettings.m_networkListingCacheTTL = 0;
+  EXPECT_FALSE(cache.GetDirectory(CURL("upnp://server/never/stored/"), "upnp://server/never/stored/", 0, items));
+}
+
+TEST_F(TestDirectoryListingCache, SaveLoad)
+{
+  const std::string path(CachePath("upnp://server/saveload/"));
+  CFileItemList items;
+  CreateListing(path, items);
+  ASSERT_TRUE(Save(path, items, "etag:\"1\""));
+
+  CFileItemList loaded;
+  std::string validator;
+  ASSERT_TRUE(Load(path, loaded, validator));
+  EXPECT_EQ("etag:\"1\"", validator);
+  ASSERT_EQ(2, loaded.Size());
+  EXPECT_EQ(path + "folder/", loaded[0]->GetPath());
+  EXPECT_TRUE(loaded[0]->m_bIsFolder);
+  EXPECT_EQ(path + "movie.mkv", loaded[1]->GetPath());
+  EXPECT_EQ("movie", loaded[1]->GetLabel());
+  EXPECT_EQ(1234, loaded[1]->m_dwSize);
+
+  // a directory whose name hashes to the same file gets nothing
+  const std::string other(CachePath("upnp://server/other/"));
+  CFile::Delete(GetCacheFile(other));
+  ASSERT_TRUE(CFile::Rename(GetCacheFile(path), GetCacheFile(other)));
+  loaded.Clear();
+  EXPECT_FALSE(Load(other, loaded, validator));
+  CFile::Delete(GetCacheFile(other));
+}
+
+TEST_F(TestDirectoryListingCache, OlderVersion)
+{
+  const std::string path(CachePath("upnp://server/version/"));
+  CFileItemList items;
+  CreateListing(path, items);
+  ASSERT_TRUE(Save(path, items, ""));
+
+  // overwrite it with a version 0 file
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite(GetCacheFile(path), true));
+  CArchive ar(&file, CArchive::store);
+  ar << (int)0;
+  ar << path;
+  ar.Close();
+  file.Close();
+
+  CFileItemList loaded;
+  std::string validator;
+  EXPECT_FALSE(Load(path, loaded, validator));
+  CFile::Delete(GetCacheFile(path));
+}
+
+TEST_F(TestDirectoryListingCache, Expired)
+{
+  CDirectoryListingCache &cache = CDirectoryListingCache::Get();
+  // ftp has no validator, nothing listens on port 1 so revalidating fails right away
+  const std::string path(CachePath("ftp://127.0.0.1:1/expired/"));
+  CFileItemList items;
+  CreateListing(path, items);
+  ASSERT_TRUE(Save(path, items, ""));
+
+  // fresh listings are used as they are
+  g_advancedSettings.m_networkListingCacheTTL = 3600;
+  CFileItemList loaded;
+  EXPECT_TRUE(cache.GetDirectory(CURL(path), path, 0, loaded));
+  EXPECT_EQ(2, loaded.Size());
+  EXPECT_FALSE(IsPending(path));
+
+  // expired ones are still shown, but fetched again
+  g_advancedSettings.m_networkListingCacheTTL = 1;
+  Sleep(1100);
+  loaded.Clear();
+  EXPECT_TRUE(cache.GetDirectory(CURL(path), path, 0, loaded));
+  EXPECT_EQ(2, loaded.Size());
+  EXPECT_TRUE(IsPending(path));
+
+  for (int i = 0; i < 100 && IsPending(path); i++)
+    Sleep(100);
+  EXPECT_FALSE(IsPending(path));
+  cache.ClearDirectory(path);
+}
+
+TEST_F(TestDirectoryListingCache, ClearFile)
+{
+  CDirectoryListingCache &cache = CDirectoryListingCache::Get();
+  const std::string path(CachePath("upnp://server/clearfile/"));
+  CFileItemList items;
+  CreateListing(path, items);
+  ASSERT_TRUE(Save(path, items, ""));
+  ASSERT_TRUE(CFile::Exists(GetCacheFile(path)));
+
+  g_advancedSettings.m_networkListingCacheTTL = 3600;
+  cache.ClearFile(path + "movie.mkv");
+  EXPECT_FALSE(CFile::Exists(GetCacheFile(path)));
+
+  CFileItemList loaded;
+  EXPECT_FALSE(cache.GetDirectory(CURL(path), path, 0, loaded));
+}
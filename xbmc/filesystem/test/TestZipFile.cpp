@@ -20,6 +20,8 @@
 
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/ZipManager.h"
+#include "threads/Thread.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "FileItem.h"
@@ -142,6 +144,82 @@ TEST_F(TestZipFile, Stat)
   EXPECT_TRUE(buffer.st_mode | _S_IFREG);
 }
 
+TEST_F(TestZipFile, GetZipEntry)
+{
+  std::string reffile;
+  std::vector<SZipEntry> entries;
+  SZipEntry entry;
+
+  reffile = XBMC_REF_FILE_PATH("xbmc/filesystem/test/reffile.txt.zip");
+  CURL zipUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), "");
+  ASSERT_TRUE(g_ZipManager.GetZipList(zipUrl, entries));
+  ASSERT_FALSE(entries.empty());
+
+  CURL entryUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), entries[0].name);
+  ASSERT_TRUE(g_ZipManager.GetZipEntry(entryUrl, entry));
+  EXPECT_STREQ(entries[0].name, entry.name);
+  EXPECT_EQ(entries[0].offset, entry.offset);
+  EXPECT_EQ(entries[0].usize, entry.usize);
+
+  CURL missingUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), "missing.txt");
+  EXPECT_FALSE(g_ZipManager.GetZipEntry(missingUrl, entry));
+
+  // the archive is read again after it has been released
+  g_ZipManager.release(zipUrl.Get());
+  EXPECT_TRUE(g_ZipManager.GetZipEntry(entryUrl, entry));
+  EXPECT_STREQ(entries[0].name, entry.name);
+}
+
+class CTestZipReadThread : public CThread
+{
+public:
+  CTestZipReadThread(const std::string &path) :
+    CThread("TestZipRead"), m_path(path), m_reads(0) {}
+
+  void Process()
+  {
+    for (int i = 0; i < 50; i++)
+    {
+      XFILE::CFile file;
+      char buf[20];
+      if (!file.Open(m_path))
+        return;
+      if (file.Read(buf, sizeof(buf)) != sizeof(buf) ||
+          memcmp("About\n-----\nXBMC is ", buf, sizeof(buf) - 1))
+        return;
+      file.Close();
+      m_reads++;
+    }
+  }
+
+  std::string m_path;
+  int m_reads;
+};
+
+TEST_F(TestZipFile, ConcurrentRead)
+{
+  std::string reffile, strpathinzip;
+  CFileItemList itemlist;
+
+  reffile = XBMC_REF_FILE_PATH("xbmc/filesystem/test/reffile.txt.zip");
+  CURL zipUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), "");
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(zipUrl, itemlist, "",
+    XFILE::DIR_FLAG_NO_FILE_DIRS));
+  strpathinzip = itemlist[0]->GetPath();
+
+  CTestZipReadThread thread1(strpathinzip), thread2(strpathinzip), thread3(strpathinzip);
+  thread1.Create();
+  thread2.Create();
+  thread3.Create();
+  EXPECT_TRUE(thread1.WaitForThreadExit(10000));
+  EXPECT_TRUE(thread2.WaitForThreadExit(10000));
+  EXPECT_TRUE(thread3.WaitForThreadExit(10000));
+
+  EXPECT_EQ(50, thread1.m_reads);
+  EXPECT_EQ(50, thread2.m_reads);
+  EXPECT_EQ(50, thread3.m_reads);
+}
+
 /* Test case to test for graceful handling of corrupted input.
  * NOTE: The test case is considered a "success" as long as the corrupted
  * file was successfully generated and the test case runs without a segfault.
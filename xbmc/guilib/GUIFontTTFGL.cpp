@@ -22,6 +22,7 @@
 #include "GUIFont.h"
 #include "GUIFontTTFGL.h"
 #include "GUIFontManager.h"
+#include "GUITextureGL.h"
 #include "Texture.h"
 #include "TextureManager.h"
 #include "GraphicContext.h"
@@ -57,6 +58,10 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0 && m_texture != NULL)
   {
+#ifdef HAS_GL
+    // text is drawn on top of the textures collected so far
+    CGUITextureGL::Flush();
+#endif
     if (m_textureStatus == TEXTURE_REALLOCATED)
     {
       if (glIsTexture(m_nTexture))
@@ -51,6 +51,8 @@ public:
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
+  const std::vector<std::string>& GetFiles() const { return m_files; };
+
 private:
   void ResolveIncludesForNode(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
   std::string ResolveConstant(const std::string &constant) const;
@@ -0,0 +1,283 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUITextureBatchGL.h"
+
+#if defined(HAS_GL)
+
+#include <algorithm>
+#include <stddef.h>
+
+#include "utils/GLUtils.h"
+
+// flush once that many vertices have been collected
+#define BATCH_MAX_VERTICES  16384
+// how many batches a quad may be moved back to join a batch with the same state
+#define BATCH_MERGE_DEPTH   16
+
+static bool Overlaps(const CRect &a, const CRect &b)
+{
+  return a.x1 < b.x2 && b.x1 < a.x2 && a.y1 < b.y2 && b.y1 < a.y2;
+}
+
+CGUITextureBatchGL& CGUITextureBatchGL::Get()
+{
+  static CGUITextureBatchGL s_batch;
+  return s_batch;
+}
+
+CGUITextureBatchGL::CGUITextureBatchGL()
+  : m_batchCount(0),
+    m_vertexCount(0),
+    m_depth(0.0f),
+    m_flat(true),
+    m_vertexBuffer(0),
+    m_useVertexBuffer(true),
+    m_drawCalls(0),
+    m_drawnVertices(0),
+    m_lastDrawCalls(0),
+    m_lastDrawnVertices(0)
+{ }
+
+void CGUITextureBatchGL::AddQuad(const State &state, const Vertex *vertices)
+{
+  // under the perspective projection quads at another depth don't end up where
+  // their x and y coordinates suggest, so they can't be checked for overlaps
+  const bool flat = vertices[1].z == vertices[0].z && vertices[2].z == vertices[0].z && vertices[3].z == vertices[0].z;
+  if (m_batchCount > 0 && !(flat && m_flat && vertices[0].z == m_depth))
+    Flush();
+  m_depth = vertices[0].z;
+  m_flat = flat;
+
+  CRect bounds(vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y);
+  for (int i = 1; i < 4; i++)
+  {
+    bounds.x1 = std::min(bounds.x1, vertices[i].x);
+    bounds.y1 = std::min(bounds.y1, vertices[i].y);
+    bounds.x2 = std::max(bounds.x2, vertices[i].x);
+    bounds.y2 = std::max(bounds.y2, vertices[i].y);
+  }
+
+  // find the most recent batch with the same state we can move the quad to
+  // without it ending up below a quad that is painted after it
+  Batch *batch = NULL;
+  for (unsigned int i = m_batchCount; i > 0 && i + BATCH_MERGE_DEPTH > m_batchCount; i--)
+  {
+    Batch &candidate = m_batches[i - 1];
+    if (candidate.state == state)
+    {
+      batch = &candidate;
+      break;
+    }
+    if (Overlaps(candidate.bounds, bounds))
+      break;
+  }
+
+  if (batch == NULL)
+  {
+    if (m_batchCount == m_batches.size())
+      m_batches.push_back(Batch());
+    batch = &m_batches[m_batchCount++];
+    batch->state = state;
+    batch->bounds = bounds;
+    batch->vertices.clear();
+  }
+  else
+    batch->bounds.Union(bounds);
+
+  batch->vertices.insert(batch->vertices.end(), vertices, vertices + 4);
+  m_vertexCount += 4;
+
+  if (m_vertexCount >= BATCH_MAX_VERTICES)
+    Flush();
+}
+
+void CGUITextureBatchGL::Flush()
+{
+  if (m_batchCount == 0)
+    return;
+
+  m_vertices.clear();
+  m_vertices.reserve(m_vertexCount);
+  for (unsigned int i = 0; i < m_batchCount; i++)
+    m_vertices.insert(m_vertices.end(), m_batches[i].vertices.begin(), m_batches[i].vertices.end());
+
+  if (m_useVertexBuffer && m_vertexBuffer == 0)
+  {
+    if (GLEW_ARB_vertex_buffer_object)
+      glGenBuffersARB(1, &m_vertexBuffer);
+    m_useVertexBuffer = m_vertexBuffer != 0;
+  }
+
+  const char *base = (const char*)&m_vertices[0];
+  if (m_useVertexBuffer)
+  {
+    // orphan the previous contents so the driver doesn't have to wait for pending draws
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_vertexBuffer);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_vertices.size() * sizeof(Vertex), NULL, GL_STREAM_DRAW_ARB);
+    glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, m_vertices.size() * sizeof(Vertex), &m_vertices[0]);
+    base = NULL;
+  }
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, x));
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, r));
+  glClientActiveTexture(GL_TEXTURE1);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, u2));
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glClientActiveTexture(GL_TEXTURE0);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, u1));
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glEnable(GL_BLEND);
+  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+  GLint first = 0;
+  for (unsigned int i = 0; i < m_batchCount; i++)
+  {
+    const Batch &batch = m_batches[i];
+    applyState(batch.state);
+    glDrawArrays(GL_QUADS, first, batch.vertices.size());
+    first += batch.vertices.size();
+  }
+
+  glPopClientAttrib();
+
+  if (m_useVertexBuffer)
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+
+  for (int unit = 2; unit >= 0; unit--)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+  }
+  VerifyGLState();
+
+  m_drawCalls += m_batchCount;
+  m_drawnVertices += m_vertexCount;
+  m_batchCount = 0;
+  m_vertexCount = 0;
+}
+
+void CGUITextureBatchGL::applyState(const State &state)
+{
+  unsigned int unit = 0;
+
+  glActiveTexture(GL_TEXTURE0);
+  if (state.texture)
+  {
+    glBindTexture(GL_TEXTURE_2D, state.texture);
+    glEnable(GL_TEXTURE_2D);
+  }
+  else
+    glDisable(GL_TEXTURE_2D);
+  unit++;
+
+  // diffuse coloring
+  glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PRIMARY_COLOR);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
+
+  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
+
+  if (state.diffuse)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit++);
+    glBindTexture(GL_TEXTURE_2D, state.diffuse);
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PREVIOUS);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
+
+    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PREVIOUS);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
+  }
+
+  if (state.limitedColor)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit++);
+    glBindTexture(GL_TEXTURE_2D, state.texture); // dummy bind
+    glEnable(GL_TEXTURE_2D);
+    const GLfloat rgba[4] = {16.0f / 255.0f, 16.0f / 255.0f, 16.0f / 255.0f, 0.0f};
+    glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE , GL_COMBINE);
+    glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, rgba);
+    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_RGB      , GL_ADD);
+    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_RGB      , GL_PREVIOUS);
+    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE1_RGB      , GL_CONSTANT);
+    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND0_RGB     , GL_SRC_COLOR);
+    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND1_RGB     , GL_SRC_COLOR);
+
+    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_ALPHA    , GL_REPLACE);
+    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_ALPHA    , GL_PREVIOUS);
+  }
+
+  // switch off the units the previous batch may have used
+  for (; unit < 3; unit++)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glDisable(GL_TEXTURE_2D);
+  }
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void CGUITextureBatchGL::NewFrame()
+{
+  Flush();
+  m_lastDrawCalls = m_drawCalls;
+  m_lastDrawnVertices = m_drawnVertices;
+  m_drawCalls = 0;
+  m_drawnVertices = 0;
+}
+
+void CGUITextureBatchGL::Reset()
+{
+  m_batchCount = 0;
+  m_vertexCount = 0;
+  if (m_vertexBuffer)
+    glDeleteBuffersARB(1, &m_vertexBuffer);
+  m_vertexBuffer = 0;
+  m_useVertexBuffer = true;
+}
+
+void CGUITextureBatchGL::GetStatistics(unsigned int &drawCalls, unsigned int &vertices) const
+{
+  drawCalls = m_lastDrawCalls;
+  vertices = m_lastDrawnVertices;
+}
+
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#if defined(HAS_GL)
+
+#include <vector>
+
+#include "system_gl.h"
+#include "guilib/Geometry.h"
+
+/*!
+ \brief Collects the quads of the GUI textures of a frame and draws them in as few draw calls as possible.
+
+ Quads are grouped in batches of quads sharing the same textures and blend state.
+ A quad may join an earlier batch only if it doesn't overlap any quad drawn after
+ that batch, so the paint order stays the same. Overlaps are checked on the x and
+ y coordinates, which only holds for quads at the same depth: the batch is flushed
+ whenever a quad is at another depth than the previous one or isn't parallel to
+ the screen, as happens with 3D transforms. All batches are uploaded into a
+ single streaming vertex buffer and drawn when Flush() is called.
+
+ Anything drawing with OpenGL outside of the batch has to call Flush() first.
+ The render system does so whenever it changes state (scissors, viewport, camera,
+ transforms, state blocks) and before presenting a frame.
+ */
+class CGUITextureBatchGL
+{
+public:
+  typedef struct
+  {
+    GLfloat x, y, z;
+    GLubyte r, g, b, a;
+    GLfloat u1, v1; // texture
+    GLfloat u2, v2; // diffuse texture
+  } Vertex;
+
+  typedef struct State
+  {
+    GLuint texture;    // 0 for untextured quads
+    GLuint diffuse;    // 0 if there is no diffuse texture
+    bool limitedColor; // whether the output has to be limited to the 16-235 range
+    bool operator==(const State &rhs) const
+    {
+      return texture == rhs.texture && diffuse == rhs.diffuse && limitedColor == rhs.limitedColor;
+    }
+  } State;
+
+  static CGUITextureBatchGL& Get();
+
+  /*!
+   \brief Add a quad to the batch.
+   \param state the textures and blend state to draw the quad with
+   \param vertices the four corners of the quad
+   */
+  void AddQuad(const State &state, const Vertex *vertices);
+
+  /*!
+   \brief Draw all collected quads.
+   */
+  void Flush();
+
+  /*!
+   \brief Start collecting statistics for a new frame.
+   */
+  void NewFrame();
+
+  /*!
+   \brief Release the vertex buffer, e.g. because the GL context is about to be destroyed.
+   */
+  void Reset();
+
+  /*!
+   \brief Get the number of draw calls and vertices of the last frame.
+   */
+  void GetStatistics(unsigned int &drawCalls, unsigned int &vertices) const;
+
+private:
+  CGUITextureBatchGL();
+  CGUITextureBatchGL(const CGUITextureBatchGL&);
+  CGUITextureBatchGL const& operator=(CGUITextureBatchGL const&);
+
+  typedef struct
+  {
+    State state;
+    CRect bounds;
+    std::vector<Vertex> vertices;
+  } Batch;
+
+  void applyState(const State &state);
+
+  std::vector<Batch> m_batches;
+  unsigned int m_batchCount;    // number of batches in use, the rest are kept for their buffers
+  unsigned int m_vertexCount;   // number of vertices in use
+  GLfloat m_depth;              // z of the quads collected since the last flush
+  bool m_flat;                  // whether these quads are parallel to the screen
+  std::vector<Vertex> m_vertices;
+  GLuint m_vertexBuffer;
+  bool m_useVertexBuffer;
+
+  unsigned int m_drawCalls;
+  unsigned int m_drawnVertices;
+  unsigned int m_lastDrawCalls;
+  unsigned int m_lastDrawnVertices;
+};
+
+#endif
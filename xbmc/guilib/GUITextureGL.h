@@ -29,6 +29,7 @@
  */
 
 #include "GUITexture.h"
+#include "GUITextureBatchGL.h"
 
 #include "system_gl.h"
 
@@ -37,12 +38,19 @@ class CGUITextureGL : public CGUITextureBase
 public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+
+  /*!
+   \brief Draw all batched quads. Has to be called before drawing anything with OpenGL directly.
+   \sa CGUITextureBatchGL
+   */
+  static void Flush();
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
 private:
   GLubyte m_col[4];
+  CGUITextureBatchGL::State m_state;
 };
 
 #endif
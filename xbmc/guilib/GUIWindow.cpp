@@ -26,6 +26,8 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUIWindowXMLCache.h"
+#include "TextureManager.h"
 
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
@@ -71,6 +73,7 @@ CGUIWindow::CGUIWindow(int id, const std::string &xmlFile)
   m_exclusiveMouseControl = 0;
   m_clearBackground = 0xff000000; // opaque black -> always clear
   m_windowXMLRootElement = NULL;
+  m_xmlFromCache = false;
 }
 
 CGUIWindow::~CGUIWindow(void)
@@ -87,10 +90,9 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
   if (m_windowLoaded || g_SkinInfo == NULL)
     return true;      // no point loading if it's already there
 
-#ifdef _DEBUG
   int64_t start;
   start = CurrentHostCounter();
-#endif
+
   const char* strLoadType;
   switch (m_loadType)
   {
@@ -123,20 +125,30 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
   bool ret = LoadXML(strPath.c_str(), strLowerPath.c_str());
 
-#ifdef _DEBUG
   int64_t end, freq;
   end = CurrentHostCounter();
   freq = CurrentHostFrequency();
-  CLog::Log(LOGDEBUG,"Load %s: %.2fms", GetProperty("xmlfile").c_str(), 1000.f * (end - start) / freq);
-#endif
+  CLog::Log(LOGDEBUG,"Load %s: %.2fms%s", GetProperty("xmlfile").c_str(), 1000.f * (end - start) / freq, m_xmlFromCache ? " (cached)" : "");
   return ret;
 }
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  m_xmlFromCache = false;
+  // only a freshly parsed window is stored in the cache, a stored tree has been cached when it was parsed
+  std::string cacheFile;
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
+    // use the precompiled window if the skin and include conditions haven't changed
+    TiXmlElement *cachedRootElement = CGUIWindowXMLCache::Load(strPath, m_xmlIncludeConditions);
+    if (cachedRootElement)
+    {
+      m_xmlFromCache = true;
+      return LoadResolved(cachedRootElement);
+    }
+
     CXBMCTinyXML xmlDoc;
     std::string strPathLower = strPath;
     StringUtils::ToLower(strPathLower);
@@ -147,14 +159,15 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
       return false;
     }
     m_windowXMLRootElement = (TiXmlElement*)xmlDoc.RootElement()->Clone();
+    cacheFile = strPath;
   }
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(m_windowXMLRootElement);
+  return Load(m_windowXMLRootElement, cacheFile);
 }
 
-bool CGUIWindow::Load(TiXmlElement* pRootElement)
+bool CGUIWindow::Load(TiXmlElement* pRootElement, const std::string &xmlFile /* = "" */)
 {
   if (!pRootElement)
     return false;
@@ -169,14 +182,24 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
   // and we don't want original root element to change
   pRootElement = (TiXmlElement*)pRootElement->Clone();
 
+  // Resolve any includes that may be present and save conditions used to do it
+  g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+
+  if (!xmlFile.empty())
+    CGUIWindowXMLCache::Save(xmlFile, pRootElement, m_xmlIncludeConditions);
+
+  return LoadResolved(pRootElement);
+}
+
+bool CGUIWindow::LoadResolved(TiXmlElement* pRootElement)
+{
   // set the scaling resolution so that any control creation or initialisation can
   // be done with respect to the correct aspect ratio
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
-  // Resolve any includes that may be present and save conditions used to do it
-  g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
   // now load in the skin file
   SetDefaults();
+  m_textures.clear();
 
   CGUIControlFactory::GetInfoColor(pRootElement, "backgroundcolor", m_clearBackground, GetID());
   CGUIControlFactory::GetActions(pRootElement, "onload", m_loadActions);
@@ -249,6 +272,8 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
     }
     else if (strValue == "controls")
     {
+      GetTextures(pChild, m_textures);
+
       TiXmlElement *pControl = pChild->FirstChildElement();
       while (pControl)
       {
@@ -276,6 +301,28 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
   return true;
 }
 
+void CGUIWindow::GetTextures(const TiXmlElement *element, std::vector<std::string> &textures)
+{
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    // <texture>, <texturefocus>, <midtexture>, <bordertexture> etc.
+    // skip textures that depend on info labels, they are only known once rendered,
+    // and background textures as they are loaded by the large texture manager
+    if (strstr(child->Value(), "texture"))
+    {
+      const char *background = child->Attribute("background");
+      if (background && strcmpi(background, "true") == 0)
+        continue;
+
+      const char *texture = child->GetText();
+      if (texture && *texture && *texture != '$')
+        textures.push_back(texture);
+    }
+    else
+      GetTextures(child, textures);
+  }
+}
+
 void CGUIWindow::LoadControl(TiXmlElement* pControl, CGUIControlGroup *pGroup, const CRect &rect)
 {
   // get control type
@@ -739,9 +786,14 @@ void CGUIWindow::AllocResources(bool forceLoad /*= FALSE */)
   int64_t slend;
   slend = CurrentHostCounter();
 
+  // decode the bundled textures in parallel, the controls pick them up below
+  g_TextureManager.PreloadTextures(m_textures);
+
   // and now allocate resources
   CGUIControlGroup::AllocResources();
 
+  g_TextureManager.ClearPreloadedTextures();
+
 #ifdef _DEBUG
   int64_t end, freq;
   end = CurrentHostCounter();
@@ -196,7 +196,7 @@ public:
 protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const std::string& strPath, const std::string &strLowerPath);  ///< Loads from the given file
-  bool Load(TiXmlElement *pRootElement);                 ///< Loads from the given XML root element
+  bool Load(TiXmlElement *pRootElement, const std::string &xmlFile = ""); ///< Loads from the given XML root element, caching the resolved window if xmlFile is given
   /*! \brief Check if XML file needs (re)loading
    XML file has to be (re)loaded when window is not loaded or include conditions values were changed
    */
@@ -230,7 +230,9 @@ protected:
   typedef std::map<int, SELECTED_EVENT> MAPCONTROLSELECTEDEVENTS;
   MAPCONTROLSELECTEDEVENTS m_mapSelectedEvents;
 
+  bool LoadResolved(TiXmlElement *pRootElement); ///< Loads from a <window> element with includes resolved, takes ownership of the element
   void LoadControl(TiXmlElement* pControl, CGUIControlGroup *pGroup, const CRect &rect);
+  static void GetTextures(const TiXmlElement *element, std::vector<std::string> &textures);
 
   std::vector<int> m_idRange;
   OVERLAY_STATE m_overlayState;
@@ -269,6 +271,8 @@ protected:
   CGUIAction m_unloadActions;
 
   TiXmlElement* m_windowXMLRootElement;
+  bool m_xmlFromCache; ///< whether the window was loaded from the precompiled window cache
+  std::vector<std::string> m_textures; ///< static textures used by the controls, decoded up front in AllocResources()
 
   bool m_manualRunActions;
 
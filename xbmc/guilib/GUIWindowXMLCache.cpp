@@ -0,0 +1,319 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowXMLCache.h"
+#include "GUIInfoManager.h"
+#include "addons/Skin.h"
+#include "filesystem/File.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#define CACHE_MAGIC   "XBMCWINDOW"
+#define CACHE_VERSION 1
+
+// sanity limit for corrupted cache files
+#define CACHE_MAX_DEPTH 256
+
+enum NodeType
+{
+  NodeEnd = 0,
+  NodeElement,
+  NodeText
+};
+
+TiXmlElement* CGUIWindowXMLCache::Load(const std::string &xmlFile, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions)
+{
+  if (!g_SkinInfo)
+    return NULL;
+
+  XFILE::CFile file;
+  if (!file.Open(GetCacheFile(xmlFile)))
+    return NULL;
+
+  // no string in the cache can be longer than the file itself
+  int64_t length = file.GetLength();
+  if (length <= 0)
+    return NULL;
+  size_t maxLength = (size_t)length;
+
+  CArchive ar(&file, CArchive::load);
+
+  std::string magic, skin, version, path;
+  int cacheVersion = 0;
+  if (!ReadString(ar, magic, maxLength) || magic != CACHE_MAGIC)
+    return NULL;
+  ar >> cacheVersion;
+  if (cacheVersion != CACHE_VERSION)
+    return NULL;
+  if (!ReadString(ar, skin, maxLength) || !ReadString(ar, version, maxLength) || !ReadString(ar, path, maxLength) ||
+      skin != g_SkinInfo->ID() || version != g_SkinInfo->Version().asString() ||
+      path != xmlFile)
+    return NULL;
+
+  // the window file and all include files have to be unchanged
+  unsigned int files = 0;
+  ar >> files;
+  for (unsigned int i = 0; i < files; i++)
+  {
+    std::string name;
+    int64_t modified = 0, size = 0, currentModified, currentSize;
+    if (!ReadString(ar, name, maxLength))
+      return NULL;
+    ar >> modified;
+    ar >> size;
+    if (!GetFileInfo(name, currentModified, currentSize) ||
+        modified != currentModified || size != currentSize)
+    {
+      CLog::Log(LOGDEBUG, "CGUIWindowXMLCache: %s changed, not using the cache for %s", name.c_str(), xmlFile.c_str());
+      return NULL;
+    }
+  }
+
+  // includes have to resolve the same way
+  std::map<INFO::InfoPtr, bool> conditions;
+  unsigned int count = 0;
+  ar >> count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::string expression;
+    bool value = false;
+    if (!ReadString(ar, expression, maxLength))
+      return NULL;
+    ar >> value;
+
+    INFO::InfoPtr condition = g_infoManager.Register(expression);
+    if (!condition || condition->Get() != value)
+      return NULL;
+    conditions[condition] = value;
+  }
+
+  TiXmlNode *node = Deserialize(ar, 0, maxLength);
+  TiXmlElement *window = node ? node->ToElement() : NULL;
+
+  int end = -1;
+  ar >> end;
+  if (window == NULL || end != NodeEnd)
+  {
+    CLog::Log(LOGWARNING, "CGUIWindowXMLCache: cache for %s is corrupt", xmlFile.c_str());
+    delete node;
+    return NULL;
+  }
+
+  xmlIncludeConditions = conditions;
+  return window;
+}
+
+bool CGUIWindowXMLCache::Save(const std::string &xmlFile, const TiXmlElement *window, const std::map<INFO::InfoPtr, bool> &xmlIncludeConditions)
+{
+  if (!g_SkinInfo || !window)
+    return false;
+
+  std::vector<std::string> files;
+  files.push_back(xmlFile);
+  files.insert(files.end(), g_SkinInfo->GetIncludeFiles().begin(), g_SkinInfo->GetIncludeFiles().end());
+
+  std::vector<std::pair<int64_t, int64_t> > info;
+  for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+  {
+    int64_t modified, size;
+    if (!GetFileInfo(*it, modified, size))
+      return false;
+    info.push_back(std::make_pair(modified, size));
+  }
+
+  // write to a temporary file first, so a window never gets loaded from a partly written cache
+  std::string cacheFile(GetCacheFile(xmlFile));
+  std::string tempFile(cacheFile + ".tmp");
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+  {
+    CLog::Log(LOGWARNING, "CGUIWindowXMLCache: unable to write cache for %s", xmlFile.c_str());
+    return false;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << std::string(CACHE_MAGIC);
+  ar << (int)CACHE_VERSION;
+  ar << g_SkinInfo->ID();
+  ar << g_SkinInfo->Version().asString();
+  ar << xmlFile;
+
+  ar << (unsigned int)files.size();
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    ar << files[i];
+    ar << info[i].first;
+    ar << info[i].second;
+  }
+
+  ar << (unsigned int)xmlIncludeConditions.size();
+  for (std::map<INFO::InfoPtr, bool>::const_iterator it = xmlIncludeConditions.begin(); it != xmlIncludeConditions.end(); ++it)
+  {
+    ar << it->first->GetExpression();
+    ar << it->second;
+  }
+
+  Serialize(ar, window);
+  ar << (int)NodeEnd;
+  ar.Close();
+  file.Close();
+
+  if (XFILE::CFile::Exists(cacheFile))
+    XFILE::CFile::Delete(cacheFile);
+  return XFILE::CFile::Rename(tempFile, cacheFile);
+}
+
+std::string CGUIWindowXMLCache::GetCacheFile(const std::string &xmlFile)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(xmlFile);
+  return StringUtils::Format("special://temp/skin-%08x.xbw", (uint32_t)crc);
+}
+
+bool CGUIWindowXMLCache::GetFileInfo(const std::string &file, int64_t &modified, int64_t &size)
+{
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(file, &buffer) != 0)
+    return false;
+
+  modified = buffer.st_mtime;
+  size = buffer.st_size;
+  return true;
+}
+
+void CGUIWindowXMLCache::Serialize(CArchive &ar, const TiXmlNode *node)
+{
+  if (node->Type() == TiXmlNode::TINYXML_ELEMENT)
+  {
+    const TiXmlElement *element = node->ToElement();
+    ar << (int)NodeElement;
+    ar << element->ValueStr();
+
+    unsigned int attributes = 0;
+    for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+      attributes++;
+    ar << attributes;
+    for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    {
+      ar << std::string(attribute->Name());
+      ar << attribute->ValueStr();
+    }
+
+    // comments and the like are of no interest
+    unsigned int children = 0;
+    for (const TiXmlNode *child = node->FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->Type() == TiXmlNode::TINYXML_ELEMENT || child->Type() == TiXmlNode::TINYXML_TEXT)
+        children++;
+    }
+    ar << children;
+    for (const TiXmlNode *child = node->FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->Type() == TiXmlNode::TINYXML_ELEMENT || child->Type() == TiXmlNode::TINYXML_TEXT)
+        Serialize(ar, child);
+    }
+  }
+  else if (node->Type() == TiXmlNode::TINYXML_TEXT)
+  {
+    ar << (int)NodeText;
+    ar << node->ValueStr();
+    ar << node->ToText()->CDATA();
+  }
+}
+
+bool CGUIWindowXMLCache::ReadString(CArchive &ar, std::string &str, size_t maxLength)
+{
+  // CArchive would allocate whatever length a corrupt file claims
+  size_t length = 0;
+  ar >> length;
+  if (length > maxLength)
+    return false;
+
+  str.resize(length);
+  for (size_t i = 0; i < length; i++)
+    ar >> str[i];
+  return true;
+}
+
+TiXmlNode* CGUIWindowXMLCache::Deserialize(CArchive &ar, unsigned int depth, size_t maxLength)
+{
+  if (depth > CACHE_MAX_DEPTH)
+    return NULL;
+
+  int type = NodeEnd;
+  std::string value;
+  ar >> type;
+  if (!ReadString(ar, value, maxLength))
+    return NULL;
+
+  if (type == NodeText)
+  {
+    bool cdata = false;
+    ar >> cdata;
+    TiXmlText *text = new TiXmlText(value);
+    text->SetCDATA(cdata);
+    return text;
+  }
+  else if (type != NodeElement)
+    return NULL;
+
+  TiXmlElement *element = new TiXmlElement(value);
+
+  unsigned int attributes = 0, children = 0;
+  ar >> attributes;
+  if (attributes > maxLength)
+  {
+    delete element;
+    return NULL;
+  }
+  for (unsigned int i = 0; i < attributes; i++)
+  {
+    std::string name, attribute;
+    if (!ReadString(ar, name, maxLength) || !ReadString(ar, attribute, maxLength))
+    {
+      delete element;
+      return NULL;
+    }
+    element->SetAttribute(name, attribute);
+  }
+
+  ar >> children;
+  if (children > maxLength)
+  {
+    delete element;
+    return NULL;
+  }
+  for (unsigned int i = 0; i < children; i++)
+  {
+    TiXmlNode *child = Deserialize(ar, depth + 1, maxLength);
+    if (child == NULL)
+    {
+      delete element;
+      return NULL;
+    }
+    element->LinkEndChild(child);
+  }
+
+  return element;
+}
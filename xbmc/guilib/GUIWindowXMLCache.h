@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include "interfaces/info/InfoBool.h"
+
+class CArchive;
+class TiXmlElement;
+class TiXmlNode;
+
+/*!
+ \ingroup windows
+ \brief Binary cache of window XML files with all includes resolved.
+
+ Parsing a window's XML file and resolving its includes, defaults and constants
+ is done every time a window is loaded. The cache stores the resolved tree
+ together with the include conditions it was resolved with, so that loading the
+ window again can skip both steps.
+
+ A cached window is only used if the skin version, the window and include files
+ as well as the values of all include conditions are unchanged.
+ */
+class CGUIWindowXMLCache
+{
+public:
+  /*! \brief Load the resolved tree of a window from the cache
+   \param xmlFile path of the window's XML file
+   \param xmlIncludeConditions [out] the include conditions used to resolve the window
+   \return the resolved <window> element, to be deleted by the caller, or NULL if there is no valid cache
+   */
+  static TiXmlElement* Load(const std::string &xmlFile, std::map<INFO::InfoPtr, bool> &xmlIncludeConditions);
+
+  /*! \brief Store the resolved tree of a window in the cache
+   \param xmlFile path of the window's XML file
+   \param window the <window> element with all includes resolved
+   \param xmlIncludeConditions the include conditions used to resolve the window
+   \return true if the window was stored, false otherwise
+   */
+  static bool Save(const std::string &xmlFile, const TiXmlElement *window, const std::map<INFO::InfoPtr, bool> &xmlIncludeConditions);
+
+private:
+  static std::string GetCacheFile(const std::string &xmlFile);
+  static bool GetFileInfo(const std::string &file, int64_t &modified, int64_t &size);
+  static void Serialize(CArchive &ar, const TiXmlNode *node);
+  static bool ReadString(CArchive &ar, std::string &str, size_t maxLength);
+  static TiXmlNode* Deserialize(CArchive &ar, unsigned int depth, size_t maxLength);
+};
@@ -40,6 +40,7 @@
 #include "settings/lib/ISettingCallback.h"
 #include "settings/lib/Setting.h"
 #include "settings/Settings.h"
+#include "settings/SettingHandle.h"
 #include "rendering/RenderSystem.h"
 #include "utils/log.h"
 #include "utils/RegExp.h"
@@ -47,6 +48,8 @@
 #include "URL.h"
 #include "windowing/WindowingFactory.h"
 
+static CSettingHandle<int> s_stereoscopicMode("videoscreen.stereoscopicmode");
+
 
 struct StereoModeMap
 {
@@ -117,7 +120,7 @@ void CStereoscopicsManager::Initialize(void)
 
 RENDER_STEREO_MODE CStereoscopicsManager::GetStereoMode(void)
 {
-  return (RENDER_STEREO_MODE) CSettings::Get().GetInt("videoscreen.stereoscopicmode");
+  return (RENDER_STEREO_MODE) s_stereoscopicMode.Get();
 }
 
 void CStereoscopicsManager::SetStereoMode(const RENDER_STEREO_MODE &mode)
@@ -353,7 +356,8 @@ void CStereoscopicsManager::OnSettingChanged(const CSetting *setting)
 
   if (settingId == "videoscreen.stereoscopicmode")
   {
-    RENDER_STEREO_MODE mode = GetStereoMode();
+    // s_stereoscopicMode may not have seen the change yet
+    RENDER_STEREO_MODE mode = (RENDER_STEREO_MODE) static_cast<const CSettingInt*>(setting)->GetValue();
     CLog::Log(LOGDEBUG, "StereoscopicsManager: stereo mode setting changed to %s", GetLabelForStereoMode(mode).c_str());
     ApplyStereoMode(mode);
   }
@@ -103,6 +103,12 @@ int CTextureBundle::LoadAnim(const std::string& Filename, CBaseTexture*** ppText
   }
 }
 
+bool CTextureBundle::CanLoadConcurrently() const
+{
+  // xbt bundles are read from a read-only mapping (or under a lock)
+  return m_useXBT;
+}
+
 void CTextureBundle::Cleanup()
 {
   m_tbXBT.Cleanup();
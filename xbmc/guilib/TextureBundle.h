@@ -42,6 +42,9 @@ public:
 
   int LoadAnim(const std::string& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Whether LoadTexture() may be called from several threads at once. */
+  bool CanLoadConcurrently() const;
+
 private:
   CTextureBundleXPR m_tbXPR;
   CTextureBundleXBT m_tbXBT;
@@ -24,6 +24,7 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/TextureManager.h"
+#include "guilib/GUITextureBatchGL.h"
 
 #if defined(HAS_GL) || defined(HAS_GLES)
 
@@ -50,6 +51,8 @@ void CGLTexture::CreateTextureObject()
 
 void CGLTexture::DestroyTextureObject()
 {
+  // the texture is deleted by CGUITextureManager::FreeUnusedTextures(), which
+  // flushes the quads queued for drawing first
   if (m_texture)
     g_TextureManager.ReleaseHwTexture(m_texture);
 }
@@ -67,6 +70,13 @@ void CGLTexture::LoadToGPU()
     // this happens only one time - the first time the texture is loaded
     CreateTextureObject();
   }
+#if defined(HAS_GL)
+  else
+  {
+    // queued quads have to be drawn with the old contents
+    CGUITextureBatchGL::Get().Flush();
+  }
+#endif
 
   // Bind the texture object
   glBindTexture(GL_TEXTURE_2D, m_texture);
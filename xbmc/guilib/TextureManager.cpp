@@ -22,6 +22,8 @@
 #include "Texture.h"
 #include "AnimatedGif.h"
 #include "GraphicContext.h"
+#include "GUITextureBatchGL.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -34,7 +36,12 @@
 #include "filesystem/File.h"
 #include "filesystem/Directory.h"
 #include "URL.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include <assert.h>
+#include <algorithm>
+#include <set>
+#include <boost/shared_ptr.hpp>
 
 #if defined(TARGET_DARWIN_IOS) && !defined(TARGET_DARWIN_IOS_ATV2)
 #include "windowing/WindowingFactory.h" // for g_Windowing in CGUITextureManager::FreeUnusedTextures
@@ -42,6 +49,88 @@
 
 using namespace std;
 
+// number of jobs helping the calling thread to decode preloaded textures
+#define PRELOAD_MAX_JOBS 3
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+class CTexturePreloadBatch
+{
+public:
+  typedef struct
+  {
+    std::string name;
+    CTextureBundle *bundle;
+    CBaseTexture *texture;
+    int width;
+    int height;
+  } Item;
+
+  CTexturePreloadBatch(const std::vector<Item> &items)
+    : m_items(items), m_next(0), m_done(0)
+  { }
+
+  ~CTexturePreloadBatch()
+  {
+    for (std::vector<Item>::iterator it = m_items.begin(); it != m_items.end(); ++it)
+      delete it->texture;
+  }
+
+  // decode items until none are left, may be called from several threads
+  void Process()
+  {
+    while (true)
+    {
+      size_t index;
+      {
+        CSingleLock lock(m_section);
+        if (m_next >= m_items.size())
+          return;
+        index = m_next++;
+      }
+
+      Item &item = m_items[index];
+      if (!item.bundle->LoadTexture(item.name, &item.texture, item.width, item.height))
+        item.texture = NULL;
+
+      CSingleLock lock(m_section);
+      if (++m_done == m_items.size())
+        m_finished.Set();
+    }
+  }
+
+  void Wait()
+  {
+    if (!m_items.empty())
+      m_finished.Wait();
+  }
+
+  std::vector<Item>& GetItems() { return m_items; }
+
+private:
+  std::vector<Item> m_items;
+  size_t m_next;
+  size_t m_done;
+  CCriticalSection m_section;
+  CEvent m_finished;
+};
+
+class CTexturePreloadJob : public CJob
+{
+public:
+  CTexturePreloadJob(const boost::shared_ptr<CTexturePreloadBatch> &batch) : m_batch(batch) { }
+  virtual const char *GetType() const { return "texturepreload"; }
+  virtual bool DoWork()
+  {
+    m_batch->Process();
+    return true;
+  }
+
+private:
+  boost::shared_ptr<CTexturePreloadBatch> m_batch;
+};
+
 
 /************************************************************************/
 /*                                                                      */
@@ -393,7 +482,15 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   CBaseTexture *pTexture = NULL;
   int width = 0, height = 0;
-  if (bundle >= 0)
+  std::map<std::string, PreloadedTexture>::iterator preloaded = m_preloadedTextures.find(strTextureName);
+  if (preloaded != m_preloadedTextures.end())
+  {
+    pTexture = preloaded->second.texture;
+    width = preloaded->second.width;
+    height = preloaded->second.height;
+    m_preloadedTextures.erase(preloaded);
+  }
+  else if (bundle >= 0)
   {
     if (!m_TexBundle[bundle].LoadTexture(strTextureName, &pTexture, width, height))
     {
@@ -469,6 +566,11 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
       ++i;
   }
 
+#if defined(HAS_GL)
+  // the ids of the deleted textures may be reused before queued quads using them are drawn
+  if (!m_unusedHwTextures.empty())
+    CGUITextureBatchGL::Get().Flush();
+#endif
 #if defined(HAS_GL) || defined(HAS_GLES)
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
   {
@@ -490,10 +592,80 @@ void CGUITextureManager::ReleaseHwTexture(unsigned int texture)
   m_unusedHwTextures.push_back(texture);
 }
 
+void CGUITextureManager::PreloadTextures(const std::vector<std::string> &textureNames)
+{
+  CSingleLock lock(g_graphicsContext);
+
+  std::vector<CTexturePreloadBatch::Item> items;
+  std::set<std::string> names; // the same texture is often used by several controls
+  for (std::vector<std::string>::const_iterator it = textureNames.begin(); it != textureNames.end(); ++it)
+  {
+    if (!names.insert(*it).second)
+      continue;
+
+    std::string path;
+    int bundle = -1;
+    int size = 0;
+    if (m_preloadedTextures.find(*it) != m_preloadedTextures.end() ||
+        !HasTexture(*it, &path, &bundle, &size) || size || bundle < 0 ||
+        !m_TexBundle[bundle].CanLoadConcurrently() ||
+        StringUtils::EndsWithNoCase(path, ".gif"))
+      continue;
+
+    bool unused = false;
+    for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end() && !unused; ++i)
+      unused = i->first->GetName() == *it;
+    if (unused)
+      continue;
+
+    CTexturePreloadBatch::Item item = { *it, &m_TexBundle[bundle], NULL, 0, 0 };
+    items.push_back(item);
+  }
+
+  if (items.size() < 2)
+    return;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
+  boost::shared_ptr<CTexturePreloadBatch> batch(new CTexturePreloadBatch(items));
+  size_t jobs = std::min(items.size() - 1, (size_t)PRELOAD_MAX_JOBS);
+  for (size_t i = 0; i < jobs; i++)
+    CJobManager::GetInstance().AddJob(new CTexturePreloadJob(batch), NULL, CJob::PRIORITY_HIGH);
+
+  // help out so we don't depend on free workers
+  batch->Process();
+  batch->Wait();
+
+  unsigned int count = 0;
+  std::vector<CTexturePreloadBatch::Item> &decoded = batch->GetItems();
+  for (std::vector<CTexturePreloadBatch::Item>::iterator it = decoded.begin(); it != decoded.end(); ++it)
+  {
+    if (it->texture == NULL)
+      continue;
+
+    PreloadedTexture texture = { it->texture, it->width, it->height };
+    m_preloadedTextures[it->name] = texture;
+    it->texture = NULL;
+    count++;
+  }
+
+  CLog::Log(LOGDEBUG, "%s: decoded %u textures in %u ms", __FUNCTION__, count, XbmcThreads::SystemClockMillis() - start);
+}
+
+void CGUITextureManager::ClearPreloadedTextures()
+{
+  CSingleLock lock(g_graphicsContext);
+  for (std::map<std::string, PreloadedTexture>::iterator it = m_preloadedTextures.begin(); it != m_preloadedTextures.end(); ++it)
+    delete it->second.texture;
+  m_preloadedTextures.clear();
+}
+
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
 
+  ClearPreloadedTextures();
+
   ivecTextures i;
   i = m_vecTextures.begin();
   while (i != m_vecTextures.end())
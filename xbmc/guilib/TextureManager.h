@@ -28,6 +28,7 @@
 
 #include <vector>
 #include <list>
+#include <map>
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -124,7 +125,21 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  /*! \brief Decode bundled textures that are about to be loaded in parallel.
+   The decoded textures are handed out by Load() until ClearPreloadedTextures() is called.
+   \param textureNames names of the textures to decode
+   */
+  void PreloadTextures(const std::vector<std::string> &textureNames);
+  void ClearPreloadedTextures(); ///< Free any preloaded texture that wasn't picked up by Load()
 protected:
+  typedef struct
+  {
+    CBaseTexture *texture;
+    int width;
+    int height;
+  } PreloadedTexture;
+
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
   std::vector<unsigned int> m_unusedHwTextures;
@@ -134,6 +149,7 @@ protected:
   CTextureBundle m_TexBundle[2];
 
   std::vector<std::string> m_texturePaths;
+  std::map<std::string, PreloadedTexture> m_preloadedTextures;
   CCriticalSection m_section;
 };
 
@@ -20,11 +20,15 @@
 
 #include <sys/stat.h>
 #include "XBTFReader.h"
+#include "threads/SingleLock.h"
 #include "utils/EndianSwap.h"
 #include "utils/CharsetConverter.h"
 #include <stdio.h>
 #ifdef TARGET_WINDOWS
 #include "FileSystem/SpecialProtocol.h"
+#include <io.h>
+#else
+#include <sys/mman.h>
 #endif
 
 #include <string.h>
@@ -47,6 +51,16 @@
 CXBTFReader::CXBTFReader()
 {
   m_file = NULL;
+  m_data = NULL;
+  m_dataSize = 0;
+#ifdef TARGET_WINDOWS
+  m_mapping = NULL;
+#endif
+}
+
+CXBTFReader::~CXBTFReader()
+{
+  Close();
 }
 
 bool CXBTFReader::IsOpen() const
@@ -136,11 +150,63 @@ bool CXBTFReader::Open(const std::string& fileName)
     return false;
   }
 
+  // frames are read straight from the mapping if possible, otherwise we
+  // fall back to reading them from the file
+  Map();
+
+  return true;
+}
+
+bool CXBTFReader::Map()
+{
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == -1 || fileStat.st_size <= 0)
+    return false;
+
+#ifdef TARGET_WINDOWS
+  m_mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(m_file)), NULL, PAGE_READONLY, 0, 0, NULL);
+  if (m_mapping == NULL)
+    return false;
+
+  m_data = (unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (m_data == NULL)
+  {
+    CloseHandle(m_mapping);
+    m_mapping = NULL;
+    return false;
+  }
+#else
+  void *data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+  if (data == MAP_FAILED)
+    return false;
+
+  m_data = (unsigned char*)data;
+#endif
+  m_dataSize = fileStat.st_size;
+
   return true;
 }
 
+void CXBTFReader::Unmap()
+{
+  if (m_data == NULL)
+    return;
+
+#ifdef TARGET_WINDOWS
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+  m_mapping = NULL;
+#else
+  munmap(m_data, (size_t)m_dataSize);
+#endif
+  m_data = NULL;
+  m_dataSize = 0;
+}
+
 void CXBTFReader::Close()
 {
+  Unmap();
+
   if (m_file)
   {
     fclose(m_file);
@@ -183,12 +249,31 @@ CXBTFFile* CXBTFReader::Find(const std::string& name)
   return &(iter->second);
 }
 
+const unsigned char* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (m_data == NULL ||
+      frame.GetOffset() > m_dataSize ||
+      frame.GetPackedSize() > m_dataSize - frame.GetOffset())
+    return NULL;
+
+  return m_data + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
 {
   if (!m_file)
   {
     return false;
   }
+
+  const unsigned char* data = GetData(frame);
+  if (data != NULL)
+  {
+    memcpy(buffer, data, (size_t)frame.GetPackedSize());
+    return true;
+  }
+
+  CSingleLock lock(m_fileSection);
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD) || defined(TARGET_ANDROID)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
@@ -25,11 +25,13 @@
 #include <map>
 #include <string>
 #include "XBTF.h"
+#include "threads/CriticalSection.h"
 
 class CXBTFReader
 {
 public:
   CXBTFReader();
+  ~CXBTFReader();
   bool IsOpen() const;
   bool Open(const std::string& fileName);
   void Close();
@@ -37,13 +39,31 @@ public:
   bool Exists(const std::string& name);
   CXBTFFile* Find(const std::string& name);
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
+
+  /*! \brief Get the (packed) data of a frame without copying it.
+   Only available if the bundle could be memory mapped. The data stays valid
+   until the reader is closed.
+   \param frame the frame to get the data of
+   \return pointer to the packed frame data or NULL if not available
+   */
+  const unsigned char* GetData(const CXBTFFrame& frame) const;
   std::vector<CXBTFFile>&  GetFiles();
 
 private:
+  bool Map();
+  void Unmap();
+
   CXBTF      m_xbtf;
   std::string m_fileName;
   FILE*      m_file;
   std::map<std::string, CXBTFFile> m_filesMap;
+
+  unsigned char* m_data;   // read-only mapping of the whole bundle
+  uint64_t       m_dataSize;
+#ifdef TARGET_WINDOWS
+  HANDLE         m_mapping;
+#endif
+  CCriticalSection m_fileSection; // protects m_file for unmapped reads
 };
 
 #endif
@@ -0,0 +1,349 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUITextureBatchGL.h"
+
+#if defined(HAS_GL) && defined(TARGET_LINUX)
+
+#include <dlfcn.h>
+#include <iostream>
+#include <vector>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "gtest/gtest.h"
+
+#define TEST_SIZE 64
+
+/*
+ Renders into a framebuffer object of an offscreen context. The context is
+ created through Mesa's surfaceless EGL platform, so the tests run without a
+ display on the software rasterizer (llvmpipe). libEGL is loaded at runtime and
+ the tests are reported as skipped if there is no such context.
+ */
+class TestGUITextureBatchGL : public testing::Test
+{
+protected:
+  TestGUITextureBatchGL()
+    : m_egl(NULL), m_display(EGL_NO_DISPLAY), m_context(EGL_NO_CONTEXT),
+      m_framebuffer(0), m_renderbuffer(0)
+  {
+    m_textures[0] = m_textures[1] = 0;
+  }
+
+  virtual void SetUp()
+  {
+    if (!CreateContext())
+      return;
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // older GLEW versions can't be initialized without a GLX display
+    glewInit();
+#endif
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glGenRenderbuffers(1, &m_renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, TEST_SIZE, TEST_SIZE);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffer);
+
+    glViewport(0, 0, TEST_SIZE, TEST_SIZE);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, TEST_SIZE, TEST_SIZE, 0, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    // a red/green checkerboard and a half transparent white to blue gradient
+    GLubyte pixels[2][4 * 4 * 4];
+    for (int i = 0; i < 16; i++)
+    {
+      GLubyte *checker = &pixels[0][i * 4];
+      bool odd = ((i % 4) + (i / 4)) % 2;
+      checker[0] = odd ? 255 : 0;
+      checker[1] = odd ? 0 : 255;
+      checker[2] = 0;
+      checker[3] = 255;
+      GLubyte *gradient = &pixels[1][i * 4];
+      gradient[0] = gradient[1] = 255 - i * 16;
+      gradient[2] = 255;
+      gradient[3] = 128;
+    }
+    glGenTextures(2, m_textures);
+    for (int i = 0; i < 2; i++)
+    {
+      glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels[i]);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  virtual void TearDown()
+  {
+    if (m_context != EGL_NO_CONTEXT)
+    {
+      CGUITextureBatchGL::Get().Reset();
+      glDeleteTextures(2, m_textures);
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      glDeleteRenderbuffers(1, &m_renderbuffer);
+      glDeleteFramebuffers(1, &m_framebuffer);
+      m_eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+      m_eglDestroyContext(m_display, m_context);
+    }
+    if (m_display != EGL_NO_DISPLAY)
+      m_eglTerminate(m_display);
+    if (m_egl)
+      dlclose(m_egl);
+  }
+
+  //! Report the test as skipped if there is no context, our gtest has no GTEST_SKIP
+  bool Skipped()
+  {
+    if (m_context != EGL_NO_CONTEXT)
+      return false;
+    const testing::TestInfo *info = testing::UnitTest::GetInstance()->current_test_info();
+    std::cout << "[  SKIPPED ] " << info->test_case_name() << "." << info->name()
+              << ": no offscreen OpenGL context available" << std::endl;
+    RecordProperty("skipped", "no offscreen OpenGL context available");
+    return true;
+  }
+
+  CGUITextureBatchGL::State MakeState(GLuint texture, GLuint diffuse, bool limitedColor = false)
+  {
+    CGUITextureBatchGL::State state;
+    state.texture = texture;
+    state.diffuse = diffuse;
+    state.limitedColor = limitedColor;
+    return state;
+  }
+
+  void AddQuad(const CGUITextureBatchGL::State &state, float x1, float y1, float x2, float y2, unsigned int color, float z = 0.0f)
+  {
+    const float x[4] = { x1, x2, x2, x1 };
+    const float y[4] = { y1, y1, y2, y2 };
+    const float u[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+    const float v[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+    CGUITextureBatchGL::Vertex vertices[4];
+    for (int i = 0; i < 4; i++)
+    {
+      vertices[i].x = x[i];
+      vertices[i].y = y[i];
+      vertices[i].z = z;
+      vertices[i].r = (color >> 16) & 0xff;
+      vertices[i].g = (color >> 8) & 0xff;
+      vertices[i].b = color & 0xff;
+      vertices[i].a = color >> 24;
+      vertices[i].u1 = vertices[i].u2 = u[i];
+      vertices[i].v1 = vertices[i].v2 = 1.0f - v[i];
+    }
+    m_quads.push_back(std::make_pair(state, std::vector<CGUITextureBatchGL::Vertex>(vertices, vertices + 4)));
+  }
+
+  //! Draw the quads added before, flushing after each of them if not batched
+  std::vector<GLubyte> Render(bool batched, unsigned int &drawCalls)
+  {
+    CGUITextureBatchGL &batch = CGUITextureBatchGL::Get();
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    batch.NewFrame();
+    for (size_t i = 0; i < m_quads.size(); i++)
+    {
+      batch.AddQuad(m_quads[i].first, &m_quads[i].second[0]);
+      if (!batched)
+        batch.Flush();
+    }
+    batch.NewFrame();
+
+    unsigned int vertices;
+    batch.GetStatistics(drawCalls, vertices);
+    EXPECT_EQ(m_quads.size() * 4, vertices);
+
+    std::vector<GLubyte> pixels(TEST_SIZE * TEST_SIZE * 4);
+    glReadPixels(0, 0, TEST_SIZE, TEST_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+    EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+    return pixels;
+  }
+
+  void ExpectSameOutput(unsigned int expectedBatchedDrawCalls)
+  {
+    unsigned int unbatchedDrawCalls, batchedDrawCalls;
+    std::vector<GLubyte> unbatched = Render(false, unbatchedDrawCalls);
+    std::vector<GLubyte> batched = Render(true, batchedDrawCalls);
+
+    EXPECT_EQ(m_quads.size(), unbatchedDrawCalls);
+    EXPECT_EQ(expectedBatchedDrawCalls, batchedDrawCalls);
+
+    size_t differences = 0;
+    for (size_t i = 0; i < batched.size(); i++)
+    {
+      if (batched[i] != unbatched[i] && differences++ == 0)
+        ADD_FAILURE() << "first difference at pixel " << (i / 4) % TEST_SIZE << "," << (i / 4) / TEST_SIZE
+                      << " channel " << i % 4 << ": " << (int)batched[i] << " instead of " << (int)unbatched[i];
+    }
+    EXPECT_EQ(0U, differences);
+
+    // make sure something has been drawn at all
+    size_t black = 0;
+    for (size_t i = 0; i < unbatched.size(); i += 4)
+    {
+      if (unbatched[i] == 0 && unbatched[i + 1] == 0 && unbatched[i + 2] == 0)
+        black++;
+    }
+    EXPECT_GT(unbatched.size() / 4, black);
+  }
+
+  GLuint m_textures[2];
+
+private:
+  bool CreateContext()
+  {
+    m_egl = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+    if (!m_egl)
+      return false;
+
+    PFNEGLGETPROCADDRESSPROC getProcAddress = (PFNEGLGETPROCADDRESSPROC)dlsym(m_egl, "eglGetProcAddress");
+    PFNEGLINITIALIZEPROC initialize = (PFNEGLINITIALIZEPROC)dlsym(m_egl, "eglInitialize");
+    PFNEGLBINDAPIPROC bindAPI = (PFNEGLBINDAPIPROC)dlsym(m_egl, "eglBindAPI");
+    PFNEGLCHOOSECONFIGPROC chooseConfig = (PFNEGLCHOOSECONFIGPROC)dlsym(m_egl, "eglChooseConfig");
+    PFNEGLCREATECONTEXTPROC createContext = (PFNEGLCREATECONTEXTPROC)dlsym(m_egl, "eglCreateContext");
+    m_eglMakeCurrent = (PFNEGLMAKECURRENTPROC)dlsym(m_egl, "eglMakeCurrent");
+    m_eglDestroyContext = (PFNEGLDESTROYCONTEXTPROC)dlsym(m_egl, "eglDestroyContext");
+    m_eglTerminate = (PFNEGLTERMINATEPROC)dlsym(m_egl, "eglTerminate");
+    if (!getProcAddress || !initialize || !bindAPI || !chooseConfig || !createContext ||
+        !m_eglMakeCurrent || !m_eglDestroyContext || !m_eglTerminate)
+      return false;
+
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+      (PFNEGLGETPLATFORMDISPLAYEXTPROC)getProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay)
+      return false;
+
+    m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (m_display == EGL_NO_DISPLAY)
+      return false;
+    EGLint major, minor;
+    if (!initialize(m_display, &major, &minor))
+    {
+      m_display = EGL_NO_DISPLAY;
+      return false;
+    }
+
+    const EGLint attributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_NONE };
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!bindAPI(EGL_OPENGL_API) ||
+        !chooseConfig(m_display, attributes, &config, 1, &configs) || configs == 0)
+      return false;
+
+    m_context = createContext(m_display, config, EGL_NO_CONTEXT, NULL);
+    if (m_context == EGL_NO_CONTEXT)
+      return false;
+    if (!m_eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+    {
+      m_eglDestroyContext(m_display, m_context);
+      m_context = EGL_NO_CONTEXT;
+      return false;
+    }
+    return true;
+  }
+
+  void *m_egl;
+  EGLDisplay m_display;
+  EGLContext m_context;
+  PFNEGLMAKECURRENTPROC m_eglMakeCurrent;
+  PFNEGLDESTROYCONTEXTPROC m_eglDestroyContext;
+  PFNEGLTERMINATEPROC m_eglTerminate;
+  GLuint m_framebuffer;
+  GLuint m_renderbuffer;
+  std::vector<std::pair<CGUITextureBatchGL::State, std::vector<CGUITextureBatchGL::Vertex> > > m_quads;
+};
+
+TEST_F(TestGUITextureBatchGL, SameStates)
+{
+  if (Skipped())
+    return;
+
+  // a list of icons, all of them are drawn at once
+  for (int i = 0; i < 6; i++)
+    AddQuad(MakeState(m_textures[0], 0), 2.0f + i * 10, 2.0f, 10.0f + i * 10, 30.0f, 0xffffffff);
+  ExpectSameOutput(1);
+}
+
+TEST_F(TestGUITextureBatchGL, MixedStates)
+{
+  if (Skipped())
+    return;
+
+  // untextured background
+  AddQuad(MakeState(0, 0), 0.0f, 0.0f, 64.0f, 64.0f, 0xff202040);
+  // two buttons with a transparent label each, the second button joins the
+  // batch of the first one and so does its label
+  AddQuad(MakeState(m_textures[0], 0), 4.0f, 4.0f, 28.0f, 20.0f, 0xffffffff);
+  AddQuad(MakeState(m_textures[1], 0), 6.0f, 6.0f, 26.0f, 18.0f, 0x80ffffff);
+  AddQuad(MakeState(m_textures[0], 0), 36.0f, 4.0f, 60.0f, 20.0f, 0xff8080ff);
+  AddQuad(MakeState(m_textures[1], 0), 38.0f, 6.0f, 58.0f, 18.0f, 0xc0ff8000);
+  // a diffuse textured quad and one limited to the 16-235 range
+  AddQuad(MakeState(m_textures[0], m_textures[1]), 4.0f, 28.0f, 60.0f, 44.0f, 0xffffffff);
+  AddQuad(MakeState(m_textures[1], 0, true), 4.0f, 48.0f, 60.0f, 60.0f, 0xffffffff);
+  ExpectSameOutput(5);
+}
+
+TEST_F(TestGUITextureBatchGL, OverlapKeepsOrder)
+{
+  if (Skipped())
+    return;
+
+  // the third quad has the state of the first one, but it must not be moved
+  // below the second quad it overlaps
+  AddQuad(MakeState(m_textures[0], 0), 0.0f, 0.0f, 32.0f, 32.0f, 0xffffffff);
+  AddQuad(MakeState(m_textures[1], 0), 16.0f, 16.0f, 48.0f, 48.0f, 0xffffffff);
+  AddQuad(MakeState(m_textures[0], 0), 32.0f, 32.0f, 64.0f, 64.0f, 0x80ffffff);
+  AddQuad(MakeState(m_textures[0], 0), 24.0f, 24.0f, 40.0f, 40.0f, 0xffff0000);
+  ExpectSameOutput(3);
+}
+
+TEST_F(TestGUITextureBatchGL, DepthKeepsOrder)
+{
+  if (Skipped())
+    return;
+
+  // like the GUI camera: quads at z 0 are drawn 1:1, quads further away shrink
+  // towards the center
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  glFrustum(-16.0, 16.0, 16.0, -16.0, 16.0, 256.0);
+  glMatrixMode(GL_MODELVIEW);
+  glLoadIdentity();
+  glTranslatef(-32.0f, -32.0f, -32.0f);
+
+  // the third quad doesn't overlap the coordinates of the second one, but it
+  // does on screen as the second one is further away, so it must not be moved
+  // below it
+  AddQuad(MakeState(m_textures[0], 0), 0.0f, 0.0f, 16.0f, 16.0f, 0xffffffff);
+  AddQuad(MakeState(m_textures[1], 0), 64.0f, 64.0f, 96.0f, 96.0f, 0xffffffff, -32.0f);
+  AddQuad(MakeState(m_textures[0], 0), 48.0f, 48.0f, 64.0f, 64.0f, 0xffff0000);
+  ExpectSameOutput(3);
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "FileOperations.h"
 #include "utils/URIUtils.h"
 #include "utils/ISerializable.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/Variant.h"
 #include "video/VideoInfoTag.h"
 #include "music/tags/MusicInfoTag.h"
@@ -192,7 +193,7 @@ void CFileItemHandler::FillDetails(const ISerializable *info, const CFileItemPtr
     return;
 
   CVariant serialization;
-  info->Serialize(serialization);
+  info->SerializeFields(serialization, fields);
 
   bool fetchedArt = false;
 
@@ -213,6 +214,67 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
 void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */)
 {
   int start, end;
+  LimitFileItemList(items, parameterObject, result, size, sortLimit, start, end);
+  HandleFileItems(ID, allowFile, resultname, items, start, end, parameterObject, result);
+}
+
+class CFileItemHandler::CFileItemListStream : public IResultStream
+{
+public:
+  CFileItemListStream(const char *ID, bool allowFile, const CFileItemList &items, int start, int end, const CVariant &parameterObject)
+    : m_ID(ID),
+      m_allowFile(allowFile),
+      m_parameterObject(parameterObject)
+  {
+    for (int i = start; i < end; i++)
+      m_items.Add(items.Get(i));
+  }
+
+  virtual bool Write(CJSONStreamWriter &writer)
+  {
+    std::set<std::string> fields;
+    GetFields(m_parameterObject, fields);
+
+    // only one item exists as a CVariant at a time
+    CThumbLoader *thumbLoader = CreateThumbLoader(m_items, 0, m_items.Size());
+    bool success = writer.StartArray();
+    for (int i = 0; success && i < m_items.Size(); i++)
+    {
+      CVariant result;
+      HandleFileItem(m_ID, m_allowFile, "item", m_items.Get(i), m_parameterObject, fields, result, false, thumbLoader);
+      const CVariant &item = result;
+      success = writer.Value(item["item"]);
+    }
+    delete thumbLoader;
+
+    return success && writer.EndArray();
+  }
+
+private:
+  const char *m_ID;
+  bool m_allowFile;
+  CFileItemList m_items;
+  CVariant m_parameterObject;
+};
+
+void CFileItemHandler::StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */)
+{
+  int start, end;
+  LimitFileItemList(items, parameterObject, result, size, sortLimit, start, end);
+
+  // an empty list isn't added to the result at all
+  if (end > start)
+  {
+    ResultStreamPtr stream(new CFileItemListStream(ID, allowFile, items, start, end, parameterObject));
+    if (CJSONRPC::StreamResult(result, resultname, stream))
+      return;
+  }
+
+  HandleFileItems(ID, allowFile, resultname, items, start, end, parameterObject, result);
+}
+
+void CFileItemHandler::LimitFileItemList(CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit, int &start, int &end)
+{
   HandleLimits(parameterObject, result, size, start, end);
 
   if (sortLimit)
@@ -222,33 +284,47 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
     start = 0;
     end = items.Size();
   }
+}
 
-  CThumbLoader *thumbLoader = NULL;
-  if (end - start > 0)
-  {
-    if (items.Get(start)->HasVideoInfoTag())
-      thumbLoader = new CVideoThumbLoader();
-    else if (items.Get(start)->HasMusicInfoTag())
-      thumbLoader = new CMusicThumbLoader();
+void CFileItemHandler::HandleFileItems(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, int start, int end, const CVariant &parameterObject, CVariant &result)
+{
+  std::set<std::string> fields;
+  GetFields(parameterObject, fields);
 
-    if (thumbLoader != NULL)
-      thumbLoader->OnLoaderStart();
+  CThumbLoader *thumbLoader = CreateThumbLoader(items, start, end);
+  for (int i = start; i < end; i++)
+  {
+    CFileItemPtr item = items.Get(i);
+    HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader);
   }
 
-  std::set<std::string> fields;
+  delete thumbLoader;
+}
+
+void CFileItemHandler::GetFields(const CVariant &parameterObject, std::set<std::string> &fields)
+{
   if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
   {
     for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
       fields.insert(field->asString());
   }
+}
 
-  for (int i = start; i < end; i++)
+CThumbLoader* CFileItemHandler::CreateThumbLoader(const CFileItemList &items, int start, int end)
+{
+  CThumbLoader *thumbLoader = NULL;
+  if (end - start > 0)
   {
-    CFileItemPtr item = items.Get(i);
-    HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader);
+    if (items.Get(start)->HasVideoInfoTag())
+      thumbLoader = new CVideoThumbLoader();
+    else if (items.Get(start)->HasMusicInfoTag())
+      thumbLoader = new CMusicThumbLoader();
+
+    if (thumbLoader != NULL)
+      thumbLoader->OnLoaderStart();
   }
 
-  delete thumbLoader;
+  return thumbLoader;
 }
 
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append /* = true */, CThumbLoader *thumbLoader /* = NULL */)
@@ -381,6 +457,7 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
 
   if (resultname)
   {
+    object.makeShareable();
     if (append)
       result[resultname].append(object);
     else
@@ -27,6 +27,8 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/ThreadLocal.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -38,6 +40,18 @@ using namespace std;
 
 bool CJSONRPC::m_initialized = false;
 
+namespace
+{
+  // the method running on the current thread, for StreamResult()
+  typedef struct
+  {
+    CVariant *result;
+    std::map<std::string, ResultStreamPtr> streams;
+  } MethodContext;
+
+  XbmcThreads::ThreadLocal<MethodContext> s_method;
+}
+
 void CJSONRPC::Initialize()
 {
   if (m_initialized)
@@ -229,54 +243,86 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
-  bool hasResponse = false;
+  CJSONStringSink sink;
+  {
+    CJSONStreamWriter writer(sink, g_advancedSettings.m_jsonOutputCompact);
+    if (!MethodCall(inputString, transport, client, writer) || !writer.Flush())
+      return "";
+  }
+
+  return sink.GetOutput();
+}
+
+bool CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CJSONStreamWriter &writer)
+{
+  CVariant inputroot;
 
   if(g_advancedSettings.CanLogComponent(LOGJSONRPC))
     CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
 
   inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
-  if (!inputroot.isNull())
+  if (inputroot.isNull())
   {
-    if (inputroot.isArray())
-    {
-      if (inputroot.size() <= 0)
-      {
-        CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
-        BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
-        hasResponse = true;
-      }
-      else
-      {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
-        {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
-        }
-      }
-    }
-    else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+    CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
+    return WriteResponse(inputroot, ParseError, CVariant(), ResultStreams(), writer);
   }
-  else
+
+  if (!inputroot.isArray())
   {
-    CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
-    BuildResponse(inputroot, ParseError, CVariant(), outputroot);
+    JSONRPC_STATUS code;
+    CVariant result;
+    ResultStreams streams;
+    if (!HandleMethodCall(inputroot, code, result, streams, transport, client))
+      return false;
+
+    return WriteResponse(inputroot, code, result, streams, writer);
+  }
+
+  if (inputroot.size() <= 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
+    return WriteResponse(inputroot, InvalidRequest, CVariant(), ResultStreams(), writer);
+  }
+
+  // the array is only opened once there is something to answer because
+  // a batch of notifications must not be answered at all
+  bool hasResponse = false;
+  for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
+  {
+    JSONRPC_STATUS code;
+    CVariant result;
+    ResultStreams streams;
+    if (!HandleMethodCall(*itr, code, result, streams, transport, client))
+      continue;
+
+    if (!hasResponse && !writer.StartArray())
+      return false;
     hasResponse = true;
+
+    if (!WriteResponse(*itr, code, result, streams, writer))
+      return false;
   }
 
-  std::string str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  if (hasResponse && !writer.EndArray())
+    return false;
+
+  return hasResponse;
+}
+
+bool CJSONRPC::StreamResult(CVariant &result, const std::string &member, const ResultStreamPtr &stream)
+{
+  MethodContext *context = s_method.get();
+  if (context == NULL || context->result != &result || !result.isObject() || !stream)
+    return false;
+
+  result[member] = CVariant(CVariant::VariantTypeNull);
+  context->streams[member] = stream;
+  return true;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::HandleMethodCall(const CVariant& request, JSONRPC_STATUS &code, CVariant& result, ResultStreams &streams, ITransportLayer *transport, IClient *client)
 {
   JSONRPC_STATUS errorCode = OK;
-  CVariant result;
   bool isNotification = false;
 
   if (IsProperJSONRPC(request))
@@ -290,7 +336,26 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CVariant params;
 
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      // methods may call other methods on this thread, their results aren't streamed
+      MethodContext context;
+      context.result = &result;
+      MethodContext *parent = s_method.get();
+      s_method.set(&context);
       errorCode = method(methodName, transport, client, params, result);
+      s_method.set(parent);
+
+      if (errorCode == OK)
+        streams.swap(context.streams);
+      else
+      {
+        for (ResultStreams::const_iterator it = context.streams.begin(); it != context.streams.end(); ++it)
+          result.erase(it->first);
+      }
+
+      // the method is done with the result, copying it into the response may share it
+      result.makeShareable();
+    }
     else
       result = params;
   }
@@ -300,7 +365,7 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  code = errorCode;
 
   return !isNotification;
 }
@@ -355,3 +420,42 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       break;
   }
 }
+
+bool CJSONRPC::WriteResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, const ResultStreams &streams, CJSONStreamWriter &writer)
+{
+  if (code != OK)
+  {
+    CVariant response;
+    BuildResponse(request, code, result, response);
+    return writer.Value(response);
+  }
+
+  // write the result directly instead of copying it into a response object
+  // (the members are written in the same order as CVariant sorts them)
+  return writer.StartObject() &&
+         writer.Key("id") && writer.Value(request.isObject() && request.isMember("id") ? request["id"] : CVariant()) &&
+         writer.Key("jsonrpc") && writer.Value(CVariant("2.0")) &&
+         writer.Key("result") && WriteResult(result, streams, writer) &&
+         writer.EndObject();
+}
+
+bool CJSONRPC::WriteResult(const CVariant& result, const ResultStreams &streams, CJSONStreamWriter &writer)
+{
+  if (streams.empty() || !result.isObject())
+    return writer.Value(result);
+
+  if (!writer.StartObject())
+    return false;
+
+  for (CVariant::const_iterator_map it = result.begin_map(); it != result.end_map(); ++it)
+  {
+    if (!writer.Key(it->first))
+      return false;
+
+    ResultStreams::const_iterator stream = streams.find(it->first);
+    if (stream != streams.end() ? !stream->second->Write(writer) : !writer.Value(it->second))
+      return false;
+  }
+
+  return writer.EndObject();
+}
@@ -24,12 +24,34 @@
 #include <stdio.h>
 #include <string>
 
+#include <boost/shared_ptr.hpp>
+
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
 #include "interfaces/IAnnouncer.h"
 
+class CJSONStreamWriter;
+
 namespace JSONRPC
 {
+  /*!
+   \ingroup jsonrpc
+   \brief Generates a member of a method's result while the response is written.
+   */
+  class IResultStream
+  {
+  public:
+    virtual ~IResultStream() { }
+
+    /*!
+     \brief Write the value of the result member.
+     \return false if writing failed
+     */
+    virtual bool Write(CJSONStreamWriter &writer) = 0;
+  };
+
+  typedef boost::shared_ptr<IResultStream> ResultStreamPtr;
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -63,6 +85,35 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request and streams the response
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param writer Writer the JSON-RPC response is generated into
+     \return True if a response has been written, false if there is nothing to answer or writing failed
+
+     Works like MethodCall() but writes every response into the given writer
+     as soon as it is available instead of collecting the whole response in
+     memory, so large results can be sent to the client while they are being
+     serialized. The writer is not flushed.
+     */
+    static bool MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CJSONStreamWriter &writer);
+
+    /*!
+     \brief Generate a member of a method's result while the response is written
+     \param result the result passed to the running method
+     \param member name of the member of the result
+     \param stream writes the value of the member
+     \return True if the member is written by the stream, false if the caller has to fill it in itself
+
+     Lets methods with large results (e.g. item lists) avoid building the whole
+     member as a CVariant. Only the result the running method has been called
+     with can be streamed, and only once the method returns OK. The member is
+     added to the result as null in the meantime.
+     */
+    static bool StreamResult(CVariant &result, const std::string &member, const ResultStreamPtr &stream);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -72,11 +123,15 @@ namespace JSONRPC
     static JSONRPC_STATUS NotifyAll(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
   
   private:
+    typedef std::map<std::string, ResultStreamPtr> ResultStreams;
+
     static void setup();
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleMethodCall(const CVariant& request, JSONRPC_STATUS &code, CVariant& result, ResultStreams &streams, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    static bool WriteResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, const ResultStreams &streams, CJSONStreamWriter &writer);
+    static bool WriteResult(const CVariant& result, const ResultStreams &streams, CJSONStreamWriter &writer);
 
     static bool m_initialized;
   };
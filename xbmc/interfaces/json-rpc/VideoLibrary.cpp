@@ -193,7 +193,7 @@ JSONRPC_STATUS CVideoLibrary::GetTVShows(const std::string &method, ITransportLa
   int size = items.Size();
   if (items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("tvshowid", true, "tvshows", items, parameterObject, result, size, false);
+  StreamFileItemList("tvshowid", true, "tvshows", items, parameterObject, result, size, false);
 
   return OK;
 }
@@ -860,27 +860,31 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalMovieDetails(const CVariant &paramete
   if (!videodatabase.Open())
     return InternalError;
 
-  bool additionalInfo = false;
+  // only load the details that have been asked for
+  int additionalDetails = VideoDbDetailsNone;
   for (CVariant::const_iterator_array itr = parameterObject["properties"].begin_array(); itr != parameterObject["properties"].end_array(); itr++)
   {
     std::string fieldValue = itr->asString();
-    if (fieldValue == "cast" || fieldValue == "showlink" || fieldValue == "tag" || fieldValue == "streamdetails")
-      additionalInfo = true;
+    if (fieldValue == "cast")
+      additionalDetails |= VideoDbDetailsCast;
+    else if (fieldValue == "showlink")
+      additionalDetails |= VideoDbDetailsShowLink;
+    else if (fieldValue == "tag")
+      additionalDetails |= VideoDbDetailsTag;
+    else if (fieldValue == "streamdetails")
+      additionalDetails |= VideoDbDetailsStream;
   }
 
-  if (additionalInfo)
+  if (additionalDetails != VideoDbDetailsNone)
   {
     for (int index = 0; index < items.Size(); index++)
-    {
-      if (additionalInfo)
-        videodatabase.GetMovieInfo("", *(items[index]->GetVideoInfoTag()), items[index]->GetVideoInfoTag()->m_iDbId);
-    }
+      videodatabase.GetMovieInfo("", *(items[index]->GetVideoInfoTag()), items[index]->GetVideoInfoTag()->m_iDbId, additionalDetails);
   }
 
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("movieid", true, "movies", items, parameterObject, result, size, limit);
+  StreamFileItemList("movieid", true, "movies", items, parameterObject, result, size, limit);
 
   return OK;
 }
@@ -910,7 +914,7 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalEpisodeDetails(const CVariant &parame
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("episodeid", true, "episodes", items, parameterObject, result, size, limit);
+  StreamFileItemList("episodeid", true, "episodes", items, parameterObject, result, size, limit);
 
   return OK;
 }
@@ -936,7 +940,7 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalMusicVideoDetails(const CVariant &par
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList("musicvideoid", true, "musicvideos", items, parameterObject, result, size, limit);
+  StreamFileItemList("musicvideoid", true, "musicvideos", items, parameterObject, result, size, limit);
 
   return OK;
 }
@@ -0,0 +1,285 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#if (defined HAVE_CONFIG_H) && (!defined TARGET_WINDOWS)
+  #include "config.h"
+#endif
+
+// python.h should always be included first before any other includes
+#include <Python.h>
+
+#include "system.h"
+#include "PythonInterpreterPool.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+// maximum number of parked interpreters per add-on and in total
+#define POOL_MAX_INTERPRETERS_PER_KEY 2
+#define POOL_MAX_INTERPRETERS         4
+
+#define GC_SCRIPT \
+  "import gc\n" \
+  "gc.collect(2)\n"
+
+CPythonInterpreterPool::CPythonInterpreterPool()
+  : m_size(0)
+{ }
+
+CPythonInterpreterPool::~CPythonInterpreterPool()
+{
+  // the python engine is finalized before we get here so all we can do is
+  // forget about any interpreter that is still around
+  if (m_size > 0)
+    CLog::Log(LOGWARNING, "CPythonInterpreterPool: %u interpreters were never ended", (unsigned int)m_size);
+}
+
+void* CPythonInterpreterPool::Acquire(const std::string &key, Interpreter &interpreter)
+{
+  {
+    CSingleLock lock(m_critical);
+    std::map<std::string, Interpreters>::iterator it = m_interpreters.find(key);
+    if (it == m_interpreters.end() || it->second.empty())
+      return NULL;
+
+    interpreter = it->second.back();
+    it->second.pop_back();
+    if (it->second.empty())
+      m_interpreters.erase(it);
+    m_size--;
+  }
+
+  PyThreadState *state = PyThreadState_New((PyInterpreterState*)interpreter.interpreter);
+  if (state == NULL)
+  {
+    CLog::Log(LOGERROR, "CPythonInterpreterPool: failed to create a thread state for a pooled interpreter of %s", key.c_str());
+    end(interpreter);
+    return NULL;
+  }
+
+  return state;
+}
+
+void CPythonInterpreterPool::Prepare(void *threadState, Interpreter &interpreter)
+{
+  PyThreadState *state = (PyThreadState*)threadState;
+  interpreter = Interpreter();
+  if (state == NULL)
+    return;
+
+  PyObject *keys = PyDict_Keys(PyImport_GetModuleDict());
+  PyObject *modules = keys != NULL ? PySet_New(keys) : NULL;
+  Py_XDECREF(keys);
+
+  PyObject *sysPath = PySys_GetObject((char*)"path"); // borrowed ref, no need to delete
+  PyObject *path = NULL;
+  if (sysPath != NULL && PyList_Check(sysPath))
+    path = PyList_GetSlice(sysPath, 0, PyList_Size(sysPath));
+
+  if (modules == NULL || path == NULL)
+  {
+    CLog::Log(LOGWARNING, "CPythonInterpreterPool: unable to record the initial interpreter state");
+    Py_XDECREF(modules);
+    Py_XDECREF(path);
+    PyErr_Clear();
+    return;
+  }
+
+  interpreter.interpreter = state->interp;
+  interpreter.modules = modules;
+  interpreter.path = path;
+}
+
+bool CPythonInterpreterPool::Release(const std::string &key, void *threadState, Interpreter &interpreter)
+{
+  PyThreadState *state = (PyThreadState*)threadState;
+  if (!interpreter.IsValid() || state == NULL || state->interp != interpreter.interpreter)
+  {
+    Discard(interpreter);
+    return false;
+  }
+
+  // only the thread running the script may be left over
+  if (state->interp->tstate_head != state || state->next != NULL)
+  {
+    Discard(interpreter);
+    return false;
+  }
+
+  {
+    CSingleLock lock(m_critical);
+    if (m_size >= POOL_MAX_INTERPRETERS ||
+        m_interpreters[key].size() >= POOL_MAX_INTERPRETERS_PER_KEY)
+    {
+      lock.Leave();
+      Discard(interpreter);
+      return false;
+    }
+  }
+
+  if (!reset(interpreter))
+  {
+    CLog::Log(LOGWARNING, "CPythonInterpreterPool: failed to reset interpreter of %s", key.c_str());
+    Discard(interpreter);
+    return false;
+  }
+
+  PyThreadState_Clear(state);
+  PyThreadState_Swap(NULL);
+  PyThreadState_Delete(state);
+
+  interpreter.lastUsed = XbmcThreads::SystemClockMillis();
+
+  CSingleLock lock(m_critical);
+  m_interpreters[key].push_back(interpreter);
+  m_size++;
+  interpreter = Interpreter();
+
+  return true;
+}
+
+void CPythonInterpreterPool::Discard(Interpreter &interpreter)
+{
+  Py_XDECREF((PyObject*)interpreter.modules);
+  Py_XDECREF((PyObject*)interpreter.path);
+  interpreter = Interpreter();
+}
+
+void CPythonInterpreterPool::Expire(unsigned int idleTime)
+{
+  Interpreters expired;
+  {
+    CSingleLock lock(m_critical);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    for (std::map<std::string, Interpreters>::iterator it = m_interpreters.begin(); it != m_interpreters.end(); )
+    {
+      for (Interpreters::iterator interpreter = it->second.begin(); interpreter != it->second.end(); )
+      {
+        if (idleTime == 0 || now - interpreter->lastUsed >= idleTime)
+        {
+          expired.push_back(*interpreter);
+          interpreter = it->second.erase(interpreter);
+          m_size--;
+        }
+        else
+          ++interpreter;
+      }
+
+      if (it->second.empty())
+        m_interpreters.erase(it++);
+      else
+        ++it;
+    }
+  }
+
+  if (expired.empty())
+    return;
+
+  CLog::Log(LOGDEBUG, "CPythonInterpreterPool: ending %u unused interpreters", (unsigned int)expired.size());
+
+  // grabbing the GIL while holding m_critical is asking for a deadlock
+  PyEval_AcquireLock();
+  for (Interpreters::iterator interpreter = expired.begin(); interpreter != expired.end(); ++interpreter)
+    end(*interpreter);
+  PyEval_ReleaseLock();
+}
+
+bool CPythonInterpreterPool::IsEmpty() const
+{
+  CSingleLock lock(m_critical);
+  return m_size == 0;
+}
+
+bool CPythonInterpreterPool::reset(Interpreter &interpreter)
+{
+  PyObject *modules = (PyObject*)interpreter.modules;
+  PyObject *path = (PyObject*)interpreter.path;
+
+  // drop every module the script imported so the next run starts clean
+  PyObject *sysModules = PyImport_GetModuleDict(); // borrowed ref, no need to delete
+  PyObject *keys = PyDict_Keys(sysModules);
+  if (keys == NULL)
+    return false;
+
+  for (Py_ssize_t i = 0; i < PyList_Size(keys); i++)
+  {
+    PyObject *name = PyList_GetItem(keys, i); // borrowed ref, no need to delete
+    if (PySet_Contains(modules, name) == 0)
+      PyDict_DelItem(sysModules, name);
+  }
+  Py_DECREF(keys);
+
+  // restore sys.path
+  PyObject *newPath = PyList_GetSlice(path, 0, PyList_Size(path));
+  if (newPath == NULL || PySys_SetObject((char*)"path", newPath) != 0)
+  {
+    Py_XDECREF(newPath);
+    return false;
+  }
+  Py_DECREF(newPath);
+
+  // empty __main__ but keep it usable for the next script
+  PyObject *mainModule = PyImport_AddModule((char*)"__main__"); // borrowed ref, no need to delete
+  if (mainModule == NULL)
+    return false;
+
+  PyObject *mainDict = PyModule_GetDict(mainModule); // borrowed ref, no need to delete
+  PyDict_Clear(mainDict);
+
+  PyObject *name = PyString_FromString("__main__");
+  PyDict_SetItemString(mainDict, "__name__", name);
+  Py_XDECREF(name);
+
+  PyObject *builtins = PyImport_ImportModule((char*)"__builtin__");
+  if (builtins == NULL)
+    return false;
+  PyDict_SetItemString(mainDict, "__builtins__", builtins);
+  Py_DECREF(builtins);
+
+  PyObject *xbmcModule = PyImport_AddModule((char*)"xbmc"); // borrowed ref, no need to delete
+  if (xbmcModule == NULL || PyObject_SetAttrString(xbmcModule, (char*)"abortRequested", Py_False))
+    return false;
+
+  if (PyRun_SimpleString(GC_SCRIPT) == -1)
+    return false;
+
+  if (PyErr_Occurred())
+  {
+    PyErr_Clear();
+    return false;
+  }
+
+  return true;
+}
+
+void CPythonInterpreterPool::end(Interpreter &interpreter)
+{
+  PyThreadState *state = PyThreadState_New((PyInterpreterState*)interpreter.interpreter);
+  if (state == NULL)
+  {
+    Discard(interpreter);
+    return;
+  }
+
+  PyThreadState *old = PyThreadState_Swap(state);
+  Discard(interpreter);
+  Py_EndInterpreter(state);
+  PyThreadState_Swap(old);
+}
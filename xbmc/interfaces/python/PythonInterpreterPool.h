@@ -0,0 +1,121 @@
+#pragma once
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+/*!
+ \brief Pool of already initialized python sub-interpreters.
+
+ Creating a sub-interpreter with Py_NewInterpreter() and initializing the
+ xbmc modules is expensive on slow hardware. Add-ons that opt in get their
+ interpreter parked here after a successful run. The next invocation of the
+ same add-on borrows it, skipping interpreter creation and module setup.
+
+ Before an interpreter is parked it is reset to the state recorded right after
+ its initialization: __main__ is emptied, every module imported by the script
+ is dropped from sys.modules and sys.path is restored.
+
+ Unless noted otherwise all methods must be called with the GIL held.
+ */
+class CPythonInterpreterPool
+{
+public:
+  /*!
+   \brief A parked interpreter together with its initial state.
+   All pointers are python objects but we don't want to draw Python.h into
+   this header.
+   */
+  class Interpreter
+  {
+  public:
+    Interpreter() : interpreter(NULL), modules(NULL), path(NULL), lastUsed(0) { }
+
+    bool IsValid() const { return interpreter != NULL; }
+
+    void *interpreter; // PyInterpreterState*
+    void *modules;     // PyObject* (set) of the module names loaded after initialization
+    void *path;        // PyObject* (list) copy of sys.path after initialization
+    unsigned int lastUsed;
+  };
+
+  CPythonInterpreterPool();
+  ~CPythonInterpreterPool();
+
+  /*!
+   \brief Borrow a parked interpreter for the given key.
+   \param key the pool the interpreter belongs to (usually the add-on id)
+   \param interpreter filled with the borrowed interpreter
+   \return a new thread state (PyThreadState*) for the interpreter or NULL if none is available
+   */
+  void* Acquire(const std::string &key, Interpreter &interpreter);
+
+  /*!
+   \brief Record the state of a freshly initialized interpreter.
+   \param threadState the current thread state (PyThreadState*) of the interpreter
+   \param interpreter filled with the recorded state
+   */
+  static void Prepare(void *threadState, Interpreter &interpreter);
+
+  /*!
+   \brief Reset a borrowed interpreter and park it in the pool.
+   The given thread state has to be the current one. It is deleted if the
+   interpreter is parked, leaving no current thread state.
+   \param key the pool to park the interpreter in
+   \param threadState the current thread state (PyThreadState*) of the interpreter
+   \param interpreter the interpreter to park
+   \return false if the interpreter could not be parked and needs to be ended by the caller
+   */
+  bool Release(const std::string &key, void *threadState, Interpreter &interpreter);
+
+  /*!
+   \brief Forget about an interpreter which won't be parked again.
+   \param interpreter the interpreter to forget about
+   */
+  static void Discard(Interpreter &interpreter);
+
+  /*!
+   \brief End all interpreters which haven't been used for the given time.
+   Must be called WITHOUT holding the GIL.
+   \param idleTime time in ms an interpreter may stay unused
+   */
+  void Expire(unsigned int idleTime);
+
+  /*!
+   \brief End all parked interpreters.
+   Must be called WITHOUT holding the GIL.
+   */
+  void Clear() { Expire(0); }
+
+  bool IsEmpty() const;
+
+private:
+  static bool reset(Interpreter &interpreter);
+  static void end(Interpreter &interpreter);
+
+  typedef std::vector<Interpreter> Interpreters;
+  std::map<std::string, Interpreters> m_interpreters;
+  size_t m_size;
+  CCriticalSection m_critical;
+};
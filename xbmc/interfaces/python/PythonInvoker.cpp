@@ -43,6 +43,7 @@
 #include "interfaces/python/swig.h"
 #include "interfaces/python/XBPython.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #if defined(TARGET_WINDOWS)
 #include "utils/CharsetConverter.h"
 #endif // defined(TARGET_WINDOWS)
@@ -65,6 +66,9 @@ extern "C" FILE *fopen_utf8(const char *_Filename, const char *_Mode);
 // Time before ill-behaved scripts are terminated
 #define PYTHON_SCRIPT_TIMEOUT 5000 // ms
 
+// Extra info of plugin add-ons which allow their interpreter to be reused
+#define PYTHON_REUSE_INTERPRETER "reuselanguageinvoker"
+
 using namespace std;
 using namespace XFILE;
 
@@ -157,10 +161,21 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): start processing", GetId(), m_sourceFile.c_str());
   int m_Py_file_input = Py_file_input;
+  unsigned int startTime = XbmcThreads::SystemClockMillis();
+  unsigned int runTime = startTime;
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+
+  // try to borrow an already initialized interpreter
+  bool reuseInterpreter = canReuseInterpreter();
+  PyThreadState* state = NULL;
+  if (reuseInterpreter)
+    state = (PyThreadState*)g_pythonParser.GetInterpreterPool().Acquire(m_addon->ID(), m_interpreter);
+
+  bool pooled = state != NULL;
+  if (!pooled)
+    state = Py_NewInterpreter();
   if (state == NULL)
   {
     PyEval_ReleaseLock();
@@ -173,7 +188,13 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(new XBMCAddon::Python::PythonLanguageHook(state->interp));
   languageHook->RegisterMe();
 
-  onInitialization();
+  // a pooled interpreter already has all modules initialized
+  if (!pooled)
+  {
+    onInitialization();
+    if (reuseInterpreter)
+      CPythonInterpreterPool::Prepare(state, m_interpreter);
+  }
   setState(InvokerStateInitialized);
 
   std::string realFilename(CSpecialProtocol::TranslatePath(m_sourceFile));
@@ -288,6 +309,7 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
         Py_DECREF(f);
         setState(InvokerStateRunning);
+        runTime = XbmcThreads::SystemClockMillis();
         XBMCAddon::Python::PyContext pycontext; // this is a guard class that marks this callstack as being in a python context
         PyRun_FileExFlags(fp, nativeFilename.c_str(), m_Py_file_input, moduleDict, moduleDict, 1, NULL);
       }
@@ -308,6 +330,10 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
     }
   }
 
+  CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): startup took %u ms (%s interpreter), execution took %u ms",
+            GetId(), m_sourceFile.c_str(), runTime - startTime, pooled ? "pooled" : "new",
+            XbmcThreads::SystemClockMillis() - runTime);
+
   bool systemExitThrown = false;
   InvokerState stateToSet;
   if (!failed && !PyErr_Occurred())
@@ -340,6 +366,7 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   // no need to do anything else because the script has already stopped
   if (failed)
   {
+    CPythonInterpreterPool::Discard(m_interpreter);
     setState(stateToSet);
     return true;
   }
@@ -401,7 +428,18 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
       PyRun_SimpleString(GC_SCRIPT) == -1)
     CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to run the gc to clean up after running prior to shutting down the Interpreter", GetId(), m_sourceFile.c_str());
 
-  Py_EndInterpreter(state);
+  // only a cleanly finished interpreter can be handed to the next invocation
+  bool parked = false;
+  if (m_interpreter.IsValid())
+  {
+    if (stateToSet == InvokerStateDone && !m_stop && !languageHook->HasRegisteredAddonClasses())
+      parked = g_pythonParser.GetInterpreterPool().Release(m_addon->ID(), state, m_interpreter);
+    else
+      CPythonInterpreterPool::Discard(m_interpreter);
+  }
+
+  if (!parked)
+    Py_EndInterpreter(state);
 
   // If we still have objects left around, produce an error message detailing what's been left behind
   if (languageHook->HasRegisteredAddonClasses())
@@ -627,6 +665,17 @@ void CPythonInvoker::getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<s
   }
 }
 
+bool CPythonInvoker::canReuseInterpreter() const
+{
+  // only plugins may opt in as they are invoked over and over again for
+  // every directory the user opens
+  if (m_addon == NULL || m_addon->Type() != ADDON::ADDON_PLUGIN)
+    return false;
+
+  ADDON::InfoMap::const_iterator it = m_addon->ExtraInfo().find(PYTHON_REUSE_INTERPRETER);
+  return it != m_addon->ExtraInfo().end() && StringUtils::EqualsNoCase(it->second, "true");
+}
+
 void CPythonInvoker::addPath(const std::string& path)
 {
 #if defined(TARGET_WINDOWS)
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "interfaces/generic/ILanguageInvoker.h"
+#include "interfaces/python/PythonInterpreterPool.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -67,9 +68,11 @@ private:
   void addPath(const std::string& path); // add path in UTF-8 encoding
   void addNativePath(const std::string& path); // add path in system/Python encoding
   void getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<std::string>& paths);
+  bool canReuseInterpreter() const;
 
   std::string m_pythonPath;
   void *m_threadState;
+  CPythonInterpreterPool::Interpreter m_interpreter;
   bool m_stop;
   CEvent m_stoppedEvent;
 
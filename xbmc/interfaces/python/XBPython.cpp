@@ -54,6 +54,9 @@
 #include "interfaces/python/AddonPythonInvoker.h"
 #include "interfaces/python/PythonInvoker.h"
 
+// Time pooled interpreters are kept around without being used
+#define PYTHON_INTERPRETER_IDLE_TIMEOUT 300000 // ms
+
 using namespace ANNOUNCEMENT;
 
 XBPython::XBPython()
@@ -593,6 +596,8 @@ void XBPython::Finalize()
     m_mainThreadState = NULL; // clear the main thread state before releasing the lock
     {
       CSingleExit exit(m_critSection);
+      m_interpreterPool.Clear();
+
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
@@ -656,8 +661,12 @@ void XBPython::Process()
     //delete scripts which are done
     tmpvec.clear(); // boost releases the XBPyThreads which, if deleted, calls FinalizeScript
 
+    // end pooled interpreters nobody asked for in a while
+    m_interpreterPool.Expire(PYTHON_INTERPRETER_IDLE_TIMEOUT);
+
     CSingleLock l2(m_critSection);
-    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
+    if(m_iDllScriptCounter == 0 && m_interpreterPool.IsEmpty() &&
+       (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
     {
       Finalize();
     }
@@ -26,6 +26,7 @@
 #include "threads/Thread.h"
 #include "interfaces/IAnnouncer.h"
 #include "interfaces/generic/ILanguageInvocationHandler.h"
+#include "interfaces/python/PythonInterpreterPool.h"
 #include "addons/IAddon.h"
 
 #include <boost/shared_ptr.hpp>
@@ -108,6 +109,8 @@ public:
   void UnregisterExtensionLib(LibraryLoader *pLib);
   void UnloadExtensionLibs();
 
+  CPythonInterpreterPool& GetInterpreterPool() { return m_interpreterPool; }
+
 private:
   void Finalize();
 
@@ -129,6 +132,9 @@ private:
   // any global events that scripts should be using
   CEvent m_globalEvent;
 
+  // initialized interpreters kept around for plugins that opted in
+  CPythonInterpreterPool m_interpreterPool;
+
   // in order to finalize and unload the python library, need to save all the extension libraries that are
   // loaded by it and unload them first (not done by finalize)
   PythonExtensionLibraries m_extensions;
@@ -23,6 +23,7 @@
 #include "music/tags/MusicInfoTagLoaderFactory.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "filesystem/ChangeJournal.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "Util.h"
@@ -42,6 +43,7 @@
 #include "settings/Settings.h"
 #include "FileItem.h"
 #include "guilib/LocalizeStrings.h"
+#include "profiles/ProfilesManager.h"
 #include "utils/StringUtils.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
@@ -71,6 +73,7 @@ CMusicInfoScanner::CMusicInfoScanner() : CThread("MusicInfoScanner"), m_fileCoun
   m_currentItem=0;
   m_itemCount=0;
   m_flags = 0;
+  m_journalSequence = 0;
 }
 
 CMusicInfoScanner::~CMusicInfoScanner()
@@ -128,6 +131,14 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      // have our local sources watched, so later scans can skip the folders that didn't change
+      m_journalClient = StringUtils::Format("music:%i", CProfilesManager::Get().GetCurrentProfileId());
+      m_journalSequence = CChangeJournal::Get().GetSequence();
+      vector<string> roots;
+      CChangeJournal::GetRoots(m_pathsToScan, roots);
+      for (vector<string>::const_iterator it = roots.begin(); it != roots.end(); ++it)
+        CChangeJournal::Get().Watch(*it);
+
       bool commit = true;
       for (std::set<std::string>::const_iterator it = m_pathsToScan.begin(); it != m_pathsToScan.end(); it++)
       {
@@ -441,6 +452,17 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
     return true;
 
+  // check whether anything below the folder changed since we last scanned it
+  std::string dbHash;
+  if (!(m_flags & SCAN_RESCAN) && m_musicDatabase.GetPathHash(strDirectory, dbHash) && !dbHash.empty() &&
+      CChangeJournal::Get().IsUnchanged(m_journalClient, strDirectory, true))
+  {
+    CLog::Log(LOGDEBUG, "%s Skipping dir '%s' and its subfolders due to no change (journal)", __FUNCTION__, strDirectory.c_str());
+    if (m_handle)
+      OnDirectoryScanned(strDirectory);
+    return true;
+  }
+
   // load subfolder
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_musicExtensions + "|.jpg|.tbn|.lrc|.cdg");
@@ -453,7 +475,6 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   GetPathHash(items, hash);
 
   // check whether we need to rescan or not
-  std::string dbHash;
   if ((m_flags & SCAN_RESCAN) || !m_musicDatabase.GetPathHash(strDirectory, dbHash) || dbHash != hash)
   { // path has changed - rescan
     if (dbHash.empty())
@@ -507,6 +528,10 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     }
   }
 
+  // the folder and everything below it is up to date
+  if (!m_bStop)
+    CChangeJournal::Get().SetScanned(m_journalClient, strDirectory, m_journalSequence);
+
   return !m_bStop;
 }
 
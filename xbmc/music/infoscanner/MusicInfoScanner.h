@@ -220,6 +220,8 @@ protected:
 
   std::set<std::string> m_pathsToScan;
   std::set<std::string> m_seenPaths;
+  std::string m_journalClient;       ///< our name in the change journal
+  unsigned int m_journalSequence;    ///< change journal sequence when the scan started
   int m_flags;
   CThread m_fileCountReader;
 };
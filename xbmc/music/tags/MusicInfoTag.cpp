@@ -575,33 +575,69 @@ void CMusicInfoTag::SetSong(const CSong& song)
 
 void CMusicInfoTag::Serialize(CVariant& value) const
 {
-  value["url"] = m_strURL;
-  value["title"] = m_strTitle;
-  if (m_type.compare(MediaTypeArtist) == 0 && m_artist.size() == 1)
-    value["artist"] = m_artist[0];
-  else
-    value["artist"] = m_artist;
-  value["displayartist"] = StringUtils::Join(m_artist, g_advancedSettings.m_musicItemSeparator);
-  value["album"] = m_strAlbum;
-  value["albumartist"] = m_albumArtist;
-  value["genre"] = m_genre;
-  value["duration"] = m_iDuration;
-  value["track"] = GetTrackNumber();
-  value["disc"] = GetDiscNumber();
-  value["loaded"] = m_bLoaded;
-  value["year"] = m_dwReleaseDate.wYear;
-  value["musicbrainztrackid"] = m_strMusicBrainzTrackID;
-  value["musicbrainzartistid"] = StringUtils::Join(m_musicBrainzArtistID, " / ");
-  value["musicbrainzalbumid"] = m_strMusicBrainzAlbumID;
-  value["musicbrainzalbumartistid"] = StringUtils::Join(m_musicBrainzAlbumArtistID, " / ");
-  value["musicbrainztrmid"] = m_strMusicBrainzTRMID;
-  value["comment"] = m_strComment;
-  value["rating"] = (int)(m_rating - '0');
-  value["playcount"] = m_iTimesPlayed;
-  value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
-  value["lyrics"] = m_strLyrics;
-  value["albumid"] = m_iAlbumId;
-  value["compilationartist"] = m_bCompilation;
+  serialize(value, NULL);
+}
+
+void CMusicInfoTag::SerializeFields(CVariant& value, const std::set<std::string>& fields) const
+{
+  serialize(value, &fields);
+}
+
+void CMusicInfoTag::serialize(CVariant& value, const std::set<std::string> *fields) const
+{
+  if (IsRequested(fields, "url"))
+    value["url"] = m_strURL;
+  if (IsRequested(fields, "title"))
+    value["title"] = m_strTitle;
+  if (IsRequested(fields, "artist"))
+  {
+    if (m_type.compare(MediaTypeArtist) == 0 && m_artist.size() == 1)
+      value["artist"] = m_artist[0];
+    else
+      value["artist"] = m_artist;
+  }
+  if (IsRequested(fields, "displayartist"))
+    value["displayartist"] = StringUtils::Join(m_artist, g_advancedSettings.m_musicItemSeparator);
+  if (IsRequested(fields, "album"))
+    value["album"] = m_strAlbum;
+  if (IsRequested(fields, "albumartist"))
+    value["albumartist"] = m_albumArtist;
+  if (IsRequested(fields, "genre"))
+    value["genre"] = m_genre;
+  if (IsRequested(fields, "duration"))
+    value["duration"] = m_iDuration;
+  if (IsRequested(fields, "track"))
+    value["track"] = GetTrackNumber();
+  if (IsRequested(fields, "disc"))
+    value["disc"] = GetDiscNumber();
+  if (IsRequested(fields, "loaded"))
+    value["loaded"] = m_bLoaded;
+  if (IsRequested(fields, "year"))
+    value["year"] = m_dwReleaseDate.wYear;
+  if (IsRequested(fields, "musicbrainztrackid"))
+    value["musicbrainztrackid"] = m_strMusicBrainzTrackID;
+  if (IsRequested(fields, "musicbrainzartistid"))
+    value["musicbrainzartistid"] = StringUtils::Join(m_musicBrainzArtistID, " / ");
+  if (IsRequested(fields, "musicbrainzalbumid"))
+    value["musicbrainzalbumid"] = m_strMusicBrainzAlbumID;
+  if (IsRequested(fields, "musicbrainzalbumartistid"))
+    value["musicbrainzalbumartistid"] = StringUtils::Join(m_musicBrainzAlbumArtistID, " / ");
+  if (IsRequested(fields, "musicbrainztrmid"))
+    value["musicbrainztrmid"] = m_strMusicBrainzTRMID;
+  if (IsRequested(fields, "comment"))
+    value["comment"] = m_strComment;
+  if (IsRequested(fields, "rating"))
+    value["rating"] = (int)(m_rating - '0');
+  if (IsRequested(fields, "playcount"))
+    value["playcount"] = m_iTimesPlayed;
+  if (IsRequested(fields, "lastplayed"))
+    value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
+  if (IsRequested(fields, "lyrics"))
+    value["lyrics"] = m_strLyrics;
+  if (IsRequested(fields, "albumid"))
+    value["albumid"] = m_iAlbumId;
+  if (IsRequested(fields, "compilationartist"))
+    value["compilationartist"] = m_bCompilation;
 }
 
 void CMusicInfoTag::ToSortable(SortItem& sortable, Field field) const
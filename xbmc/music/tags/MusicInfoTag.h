@@ -174,10 +174,13 @@ public:
 
   virtual void Archive(CArchive& ar);
   virtual void Serialize(CVariant& ar) const;
+  virtual void SerializeFields(CVariant& value, const std::set<std::string>& fields) const;
   virtual void ToSortable(SortItem& sortable, Field field) const;
 
   void Clear();
 protected:
+  void serialize(CVariant& value, const std::set<std::string> *fields) const;
+
   /*! \brief Trim whitespace off the given string
    \param value string to trim
    \return trimmed value, with spaces removed from left and right, as well as carriage returns from the right.
@@ -28,6 +28,7 @@
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
@@ -240,7 +241,7 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_connections[i]->SendAnnouncement(str);
   }
 }
 
@@ -489,6 +490,7 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_responding = false;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -520,6 +522,56 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
+class CTCPServer::CTCPClient::CResponseSink : public IJSONStreamSink
+{
+public:
+  CResponseSink(CTCPClient &client)
+    : m_client(client), m_started(false)
+  { }
+
+  virtual ~CResponseSink()
+  {
+    if (!m_started)
+      return;
+
+    // send the announcements that came in while the response was being sent
+    CSingleLock lock(m_client.m_critSection);
+    m_client.m_responding = false;
+    std::vector<std::string> announcements;
+    announcements.swap(m_client.m_announcements);
+    for (std::vector<std::string>::const_iterator it = announcements.begin(); it != announcements.end(); ++it)
+      m_client.Send(it->c_str(), it->size());
+  }
+
+  virtual bool Write(const char *data, size_t size)
+  {
+    // keep announcements from being sent in between the chunks of a response.
+    // the lock isn't held in between, as the method being called may wait on threads that announce
+    if (!m_started)
+    {
+      CSingleLock lock(m_client.m_critSection);
+      m_client.m_responding = true;
+      m_started = true;
+    }
+
+    m_client.Send(data, size);
+    return m_client.m_socket != INVALID_SOCKET;
+  }
+
+private:
+  CTCPClient &m_client;
+  bool m_started;
+};
+
+void CTCPServer::CTCPClient::SendAnnouncement(const std::string &announcement)
+{
+  CSingleLock lock(m_critSection);
+  if (m_responding)
+    m_announcements.push_back(announcement);
+  else
+    Send(announcement.c_str(), announcement.size());
+}
+
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
   unsigned int sent = 0;
@@ -558,8 +610,18 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        if (StreamResponses())
+        {
+          CResponseSink sink(*this);
+          CJSONStreamWriter writer(sink, g_advancedSettings.m_jsonOutputCompact);
+          if (CJSONRPC::MethodCall(m_buffer, host, this, writer))
+            writer.Flush();
+        }
+        else
+        {
+          std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
+          Send(line.c_str(), line.size());
+        }
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -590,6 +652,8 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_responding        = client.m_responding;
+  m_announcements     = client.m_announcements;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
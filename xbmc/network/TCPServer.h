@@ -69,9 +69,13 @@ namespace JSONRPC
       virtual void Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
+      // send an announcement, or hold it back until the response being sent is complete
+      void SendAnnouncement(const std::string &announcement);
 
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
+      // whether a response may be sent in several chunks while it is generated
+      virtual bool StreamResponses() const { return true; }
 
       SOCKET           m_socket;
       sockaddr_storage m_cliaddr;
@@ -81,11 +85,15 @@ namespace JSONRPC
     protected:
       void Copy(const CTCPClient& client);
     private:
+      class CResponseSink;
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      bool m_responding;
+      std::vector<std::string> m_announcements;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -103,6 +111,8 @@ namespace JSONRPC
 
       virtual bool IsNew() const { return m_websocket == NULL; }
       virtual bool Closing() const { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
+      // every call to Send() results in a separate websocket message
+      virtual bool StreamResponses() const { return false; }
 
     private:
       CWebSocket *m_websocket;
@@ -25,12 +25,19 @@
 #include "WebServer.h"
 
 #ifdef HAS_WEB_SERVER
+#include <limits>
+
 #include <boost/make_shared.hpp>
+#ifdef TARGET_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "URL.h"
 #include "Util.h"
 #include "XBDateTime.h"
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
@@ -48,6 +55,7 @@
 #endif
 
 #define MAX_POST_BUFFER_SIZE 2048
+#define FILE_BLOCK_SIZE      65536
 
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
@@ -59,6 +67,13 @@
 #define HEADER_BOUNDARY       "--"
 #define HEADER_VALUE_NO_CACHE "no-cache"
 
+#ifndef MHD_SIZE_UNKNOWN
+#define MHD_SIZE_UNKNOWN                  ((uint64_t) -1LL)
+#endif
+#ifndef MHD_CONTENT_READER_END_OF_STREAM
+#define MHD_CONTENT_READER_END_OF_STREAM  -1
+#endif
+
 using namespace XFILE;
 using namespace std;
 using namespace JSONRPC;
@@ -67,6 +82,8 @@ typedef struct ConnectionHandler
 {
   IHTTPRequestHandler *requestHandler;
   struct MHD_PostProcessor *postprocessor;
+  std::string handlerName;  // handler of a response sent with sendfile()
+  uint64_t zeroCopyBytes;   // its length, counted once it has been sent completely
 } ConnectionHandler;
 
 typedef struct {
@@ -79,9 +96,19 @@ typedef struct {
   bool boundaryWritten;
   string contentType;
   int64_t writePosition;
+  string handlerName;
+  uint64_t written;
 } HttpFileDownloadContext;
 
+typedef struct {
+  IHTTPResponseStream *stream;
+  string handlerName;
+  uint64_t written;
+} HttpStreamDownloadContext;
+
 vector<IHTTPRequestHandler *> CWebServer::m_requestHandlers;
+map<string, CWebServer::Statistics> CWebServer::m_statistics;
+CCriticalSection CWebServer::m_statisticsSection;
 
 CWebServer::CWebServer()
   : m_daemon_ip6(NULL),
@@ -219,7 +246,7 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
         }
         // No POST request so nothing special to handle
         else
-          return HandleRequest(handler, request);
+          return HandleRequest(handler, request, con_cls);
       }
     }
   }
@@ -259,7 +286,7 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
           MHD_destroy_post_processor(conHandler->postprocessor);
         *con_cls = NULL;
 
-        int ret = HandleRequest(conHandler->requestHandler, request);
+        int ret = HandleRequest(conHandler->requestHandler, request, con_cls);
         delete conHandler;
         return ret;
       }
@@ -273,7 +300,7 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
       {
         IHTTPRequestHandler *requestHandler = *it;
         if (requestHandler->CheckHTTPRequest(request))
-          return HandleRequest(requestHandler->GetInstance(), request);
+          return HandleRequest(requestHandler->GetInstance(), request, con_cls);
       }
     }
   }
@@ -302,7 +329,25 @@ int CWebServer::HandlePostField(void *cls, enum MHD_ValueKind kind, const char *
   return MHD_YES;
 }
 
-int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request)
+void CWebServer::RequestCompleted(void *cls, struct MHD_Connection *connection, void **con_cls, enum MHD_RequestTerminationCode toe)
+{
+  ConnectionHandler *conHandler = (ConnectionHandler *)*con_cls;
+  if (conHandler == NULL)
+    return;
+  *con_cls = NULL;
+
+  // mhd doesn't tell how much of an aborted response has been sent
+  if (toe == MHD_REQUEST_TERMINATED_COMPLETED_OK && conHandler->zeroCopyBytes > 0)
+    AddStatistics(conHandler->handlerName, 0, conHandler->zeroCopyBytes, true);
+
+  // a POST request aborted before all of its data has been received
+  if (conHandler->postprocessor != NULL)
+    MHD_destroy_post_processor(conHandler->postprocessor);
+  delete conHandler->requestHandler;
+  delete conHandler;
+}
+
+int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request, void **con_cls)
 {
   if (handler == NULL)
     return SendErrorResponse(request.connection, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
@@ -316,6 +361,8 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
 
   struct MHD_Response *response = NULL;
   int responseCode = handler->GetHTTPResonseCode();
+  uint64_t zeroCopyBytes = 0;
+  AddStatistics(handler->GetName(), 1, 0);
   switch (handler->GetHTTPResponseType())
   {
     case HTTPNone:
@@ -327,7 +374,7 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       break;
 
     case HTTPFileDownload:
-      ret = CreateFileDownloadResponse(request.connection, handler->GetHTTPResponseFile(), request.method, response, responseCode);
+      ret = CreateFileDownloadResponse(request.connection, handler->GetHTTPResponseFile(), request.method, response, responseCode, handler->GetName(), zeroCopyBytes);
       break;
 
     case HTTPMemoryDownloadNoFreeNoCopy:
@@ -346,6 +393,10 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       ret = CreateMemoryDownloadResponse(request.connection, handler->GetHTTPResponseData(), handler->GetHTTPResonseDataLength(), true, true, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(request.connection, handler->GetHTTPResponseStream(), response, handler->GetName());
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, handler->GetHTTPResonseCode(), request.method, response);
       break;
@@ -361,6 +412,28 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
     return SendErrorResponse(request.connection, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
   }
 
+  switch (handler->GetHTTPResponseType())
+  {
+    case HTTPMemoryDownloadNoFreeNoCopy:
+    case HTTPMemoryDownloadNoFreeCopy:
+    case HTTPMemoryDownloadFreeNoCopy:
+    case HTTPMemoryDownloadFreeCopy:
+      AddStatistics(handler->GetName(), 0, handler->GetHTTPResonseDataLength());
+      break;
+
+    default:
+      break;
+  }
+
+  // sendfile() happens inside mhd, so the bytes are counted when the request completes
+  if (zeroCopyBytes > 0 && *con_cls == NULL)
+  {
+    ConnectionHandler *conHandler = new ConnectionHandler();
+    conHandler->handlerName = handler->GetName();
+    conHandler->zeroCopyBytes = zeroCopyBytes;
+    *con_cls = (void*)conHandler;
+  }
+
   multimap<string, string> header = handler->GetHTTPResponseHeaderFields();
   for (multimap<string, string>::const_iterator it = header.begin(); it != header.end(); ++it)
     AddHeader(response, it->first, it->second);
@@ -394,7 +467,7 @@ int CWebServer::CreateRedirect(struct MHD_Connection *connection, const string &
   return MHD_YES;
 }
 
-int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, const string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode)
+int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, const string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode, const std::string &handlerName, uint64_t &zeroCopyBytes)
 {
   boost::shared_ptr<CFile> file = boost::make_shared<CFile>();
 
@@ -439,6 +512,8 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
     context->contentType = mimeType;
     context->boundaryWritten = false;
     context->writePosition = 0;
+    context->handlerName = handlerName;
+    context->written = 0;
 
     if (methodType == GET)
     {
@@ -574,15 +649,26 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       // set the initial write position
       context->writePosition = context->ranges.begin()->first;
 
-      // create the response object
-      response = MHD_create_response_from_callback(totalLength, 2048,
-                                                   &CWebServer::ContentReaderCallback,
-                                                   context.get(),
-                                                   &CWebServer::ContentReaderFreeCallback);
+      // a single range of a local file can be sent without reading it
+      if (context->rangeCount == 1)
+      {
+        response = CreateLocalFileResponse(strURL, context->writePosition, totalLength);
+        if (response != NULL)
+          zeroCopyBytes = totalLength;
+      }
+
       if (response == NULL)
-        return MHD_NO;
-        
-      context.release(); // ownership was passed to mhd
+      {
+        // create the response object
+        response = MHD_create_response_from_callback(totalLength, FILE_BLOCK_SIZE,
+                                                     &CWebServer::ContentReaderCallback,
+                                                     context.get(),
+                                                     &CWebServer::ContentReaderFreeCallback);
+        if (response == NULL)
+          return MHD_NO;
+
+        context.release(); // ownership was passed to mhd
+      }
     }
 
     // add Content-Range header
@@ -631,6 +717,45 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
   return MHD_YES;
 }
 
+struct MHD_Response* CWebServer::CreateLocalFileResponse(const std::string &strURL, int64_t offset, uint64_t length)
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00090B00)
+  std::string path = strURL;
+  if (URIUtils::IsSpecial(path))
+    path = CSpecialProtocol::TranslatePath(path);
+
+  // only plain local files can be passed on as file descriptors, everything
+  // else has to be read through the VFS
+  if (path.empty() || path[0] != '/' || URIUtils::IsStack(path))
+    return NULL;
+
+  // older versions of mhd take the length as a size_t
+  if (length > (uint64_t)std::numeric_limits<size_t>::max())
+    return NULL;
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  // mhd sends the file with sendfile() and closes the descriptor when the
+  // response is destroyed
+  struct MHD_Response *response = MHD_create_response_from_fd_at_offset(length, fd, offset);
+  if (response == NULL)
+  {
+    close(fd);
+    return NULL;
+  }
+
+#ifdef WEBSERVER_DEBUG
+  CLog::Log(LOGDEBUG, "webserver [OUT] sending %" PRIu64 " bytes of %s from %" PRId64, length, path.c_str(), offset);
+#endif
+
+  return response;
+#else
+  return NULL;
+#endif
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response)
 {
   size_t payloadSize = 0;
@@ -668,6 +793,29 @@ int CWebServer::CreateMemoryDownloadResponse(struct MHD_Connection *connection,
   return MHD_NO;
 }
 
+int CWebServer::CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response, const std::string &handlerName)
+{
+  if (stream == NULL)
+    return MHD_NO;
+
+  HttpStreamDownloadContext *context = new HttpStreamDownloadContext();
+  context->stream = stream;
+  context->handlerName = handlerName;
+  context->written = 0;
+
+  // the length is unknown so the response is sent with chunked encoding
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 16384,
+                                               &CWebServer::StreamReaderCallback,
+                                               context,
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response != NULL)
+    return MHD_YES;
+
+  delete stream;
+  delete context;
+  return MHD_NO;
+}
+
 int CWebServer::SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method)
 {
   struct MHD_Response *response = NULL;
@@ -713,6 +861,7 @@ int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 
     // copy the boundary into the buffer
     memcpy(buf, endBoundary.c_str(), endBoundary.size());
+    context->written += endBoundary.size();
     return endBoundary.size();
   }
 
@@ -764,6 +913,7 @@ int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 #endif
   // update the current write position
   context->writePosition += res;
+  context->written += written;
 
   // if we have read all the data from the current range
   // remove it from the list
@@ -779,6 +929,8 @@ int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 void CWebServer::ContentReaderFreeCallback(void *cls)
 {
   HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
+  if (context != NULL)
+    AddStatistics(context->handlerName, 0, context->written);
   delete context;
 
 #ifdef WEBSERVER_DEBUG
@@ -786,6 +938,42 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
 #endif
 }
 
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  HttpStreamDownloadContext *context = (HttpStreamDownloadContext *)cls;
+  if (context == NULL || context->stream == NULL || max <= 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+
+  ssize_t read = context->stream->Read(buf, (size_t)max);
+  if (read <= 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+
+  context->written += read;
+
+#ifdef WEBSERVER_DEBUG
+  CLog::Log(LOGDEBUG, "webserver [OUT] streamed %d bytes at %" PRIu64, (int)read, (uint64_t)pos);
+#endif
+
+  return read;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  HttpStreamDownloadContext *context = (HttpStreamDownloadContext *)cls;
+  if (context == NULL)
+    return;
+
+  AddStatistics(context->handlerName, 0, context->written);
+  delete context->stream;
+  delete context;
+}
+
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 {
   unsigned int timeout = 60 * 60 * 24;
@@ -814,6 +1002,7 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           MHD_OPTION_CONNECTION_LIMIT, 512,
                           MHD_OPTION_CONNECTION_TIMEOUT, timeout,
                           MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
+                          MHD_OPTION_NOTIFY_COMPLETED, &CWebServer::RequestCompleted, this,
                           MHD_OPTION_END);
 }
 
@@ -853,6 +1042,7 @@ bool CWebServer::Stop()
     
     m_running = false;
     CLog::Log(LOGNOTICE, "WebServer: Stopped the webserver");
+    LogStatistics();
   }
   else 
     CLog::Log(LOGNOTICE, "WebServer: Stopped failed because its not running");
@@ -860,6 +1050,39 @@ bool CWebServer::Stop()
   return !m_running;
 }
 
+void CWebServer::GetStatistics(std::map<std::string, Statistics> &statistics)
+{
+  CSingleLock lock(m_statisticsSection);
+  statistics = m_statistics;
+}
+
+void CWebServer::LogStatistics()
+{
+  std::map<std::string, Statistics> statistics;
+  GetStatistics(statistics);
+  for (std::map<std::string, Statistics>::const_iterator it = statistics.begin(); it != statistics.end(); ++it)
+  {
+    CLog::Log(LOGDEBUG, "WebServer: %s handled %" PRIu64 " requests, sent %" PRIu64 " bytes (%" PRIu64 " with sendfile)",
+              it->first.c_str(), it->second.requests, it->second.bytes, it->second.zeroCopyBytes);
+  }
+}
+
+void CWebServer::AddStatistics(const std::string &handlerName, uint64_t requests, uint64_t bytes, bool zeroCopy /* = false */)
+{
+  CSingleLock lock(m_statisticsSection);
+  std::map<std::string, Statistics>::iterator it = m_statistics.find(handlerName);
+  if (it == m_statistics.end())
+  {
+    Statistics statistics = { 0, 0, 0 };
+    it = m_statistics.insert(std::make_pair(handlerName, statistics)).first;
+  }
+
+  it->second.requests += requests;
+  it->second.bytes += bytes;
+  if (zeroCopy)
+    it->second.zeroCopyBytes += bytes;
+}
+
 bool CWebServer::IsStarted()
 {
   return m_running;
@@ -22,6 +22,7 @@
 #include "system.h"
 
 #ifdef HAS_WEB_SERVER
+#include <map>
 #include <vector>
 
 #include "interfaces/json-rpc/ITransportLayer.h"
@@ -56,6 +57,19 @@ public:
   static void RegisterRequestHandler(IHTTPRequestHandler *handler);
   static void UnregisterRequestHandler(IHTTPRequestHandler *handler);
 
+  typedef struct
+  {
+    uint64_t requests;
+    uint64_t bytes;         // response bytes sent to clients
+    uint64_t zeroCopyBytes; // part of bytes sent from local files with sendfile(), for completed responses only
+  } Statistics;
+
+  /*!
+   \brief Get the number of requests and response bytes per request handler.
+   */
+  static void GetStatistics(std::map<std::string, Statistics> &statistics);
+  static void LogStatistics();
+
   static std::string GetRequestHeaderValue(struct MHD_Connection *connection, enum MHD_ValueKind kind, const std::string &key);
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::map<std::string, std::string> &headerValues);
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::multimap<std::string, std::string> &headerValues);
@@ -75,6 +89,14 @@ private:
   static int ContentReaderCallback (void *cls, size_t pos, char *buf, int max);
 #endif
 
+#if (MHD_VERSION >= 0x00090200)
+  static ssize_t StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max);
+#elif (MHD_VERSION >= 0x00040001)
+  static int StreamReaderCallback (void *cls, uint64_t pos, char *buf, int max);
+#else
+  static int StreamReaderCallback (void *cls, size_t pos, char *buf, int max);
+#endif
+
 #if (MHD_VERSION >= 0x00040001)
   static int AnswerToConnection (void *cls, struct MHD_Connection *connection,
                         const char *url, const char *method,
@@ -94,12 +116,16 @@ private:
                              const char *transfer_encoding, const char *data, uint64_t off,
                              unsigned int size);
 #endif
-  static int HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request);
+  static void RequestCompleted(void *cls, struct MHD_Connection *connection, void **con_cls, enum MHD_RequestTerminationCode toe);
+  static int HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request, void **con_cls);
   static void ContentReaderFreeCallback (void *cls);
+  static void StreamReaderFreeCallback (void *cls);
   static int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response);
-  static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode);
+  static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode, const std::string &handlerName, uint64_t &zeroCopyBytes);
+  static struct MHD_Response* CreateLocalFileResponse(const std::string &strURL, int64_t offset, uint64_t length);
   static int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response);
   static int CreateMemoryDownloadResponse(struct MHD_Connection *connection, void *data, size_t size, bool free, bool copy, struct MHD_Response *&response);
+  static int CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response, const std::string &handlerName);
 
   static int SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method);
   
@@ -113,6 +139,7 @@ private:
   static int64_t ParseRangeHeader(const std::string &rangeHeaderValue, int64_t totalLength, HttpRanges &ranges, int64_t &firstPosition, int64_t &lastPosition);
   static std::string GenerateMultipartBoundary();
   static bool GetLastModifiedDateTime(XFILE::CFile *file, CDateTime &lastModified);
+  static void AddStatistics(const std::string &handlerName, uint64_t requests, uint64_t bytes, bool zeroCopy = false);
 
   struct MHD_Daemon *m_daemon_ip6;
   struct MHD_Daemon *m_daemon_ip4;
@@ -121,5 +148,7 @@ private:
   std::string m_Credentials64Encoded;
   CCriticalSection m_critSection;
   static std::vector<IHTTPRequestHandler *> m_requestHandlers;
+  static std::map<std::string, Statistics> m_statistics;
+  static CCriticalSection m_statisticsSection;
 };
 #endif
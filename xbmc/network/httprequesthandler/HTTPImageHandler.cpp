@@ -21,6 +21,7 @@
 #include "HTTPImageHandler.h"
 #include "network/WebServer.h"
 #include "URL.h"
+#include "TextureCache.h"
 #include "filesystem/ImageFile.h"
 
 using namespace std;
@@ -36,6 +37,18 @@ int CHTTPImageHandler::HandleHTTPRequest(const HTTPRequest &request)
   {
     m_path = request.url.substr(7);
 
+    // serve images which are already cached straight from the cache so the
+    // webserver can send them as local files, unless they are out of date
+    bool needsRecaching = false;
+    std::string cachedFile = CTextureCache::Get().CheckCachedImage(m_path, false, needsRecaching);
+    if (!cachedFile.empty() && !needsRecaching)
+    {
+      m_path = cachedFile;
+      m_responseCode = MHD_HTTP_OK;
+      m_responseType = HTTPFileDownload;
+      return MHD_YES;
+    }
+
     XFILE::CImageFile imageFile;
     const CURL pathToUrl(m_path);
     if (imageFile.Exists(pathToUrl))
@@ -18,19 +18,136 @@
  *
  */
 
+#include <algorithm>
+#include <deque>
+
 #include "HTTPJsonRpcHandler.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/json-rpc/JSONServiceDescription.h"
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 
 #define MAX_STRING_POST_SIZE 20000
+// number of generated chunks waiting to be sent before generating more output is blocked
+#define MAX_PENDING_CHUNKS   4
 
 using namespace std;
 using namespace JSONRPC;
 
+/*!
+ \brief Executes a JSON-RPC request on its own thread and passes the response
+ on to the webserver while it is being generated.
+ */
+class CHTTPJsonRpcHandler::CResponseStream : public IHTTPResponseStream, public IJSONStreamSink, private IRunnable
+{
+public:
+  CResponseStream(const string &request, CWebServer *transport)
+    : m_request(request),
+      m_transport(transport),
+      m_offset(0),
+      m_finished(false),
+      m_aborted(false),
+      m_thread(this, "JSONRPCResponse")
+  {
+    m_thread.Create();
+  }
+
+  virtual ~CResponseStream()
+  {
+    {
+      CSingleLock lock(m_critical);
+      m_aborted = true;
+      m_changed.notifyAll();
+    }
+
+    // the method call itself can't be interrupted
+    m_thread.StopThread(true);
+  }
+
+  virtual ssize_t Read(char *buffer, size_t max)
+  {
+    CSingleLock lock(m_critical);
+    while (m_chunks.empty() && !m_finished)
+      m_changed.wait(lock);
+
+    if (m_chunks.empty())
+      return -1;
+
+    const string &chunk = m_chunks.front();
+    size_t size = std::min(max, chunk.size() - m_offset);
+    memcpy(buffer, chunk.c_str() + m_offset, size);
+    m_offset += size;
+    if (m_offset >= chunk.size())
+    {
+      m_chunks.pop_front();
+      m_offset = 0;
+      m_changed.notifyAll();
+    }
+
+    return size;
+  }
+
+  virtual bool Write(const char *data, size_t size)
+  {
+    CSingleLock lock(m_critical);
+    while (m_chunks.size() >= MAX_PENDING_CHUNKS && !m_aborted)
+      m_changed.wait(lock);
+
+    if (m_aborted)
+      return false;
+
+    m_chunks.push_back(string(data, size));
+    m_changed.notifyAll();
+    return true;
+  }
+
+private:
+  virtual void Run()
+  {
+    {
+      CJSONStreamWriter writer(*this, g_advancedSettings.m_jsonOutputCompact);
+      if (CJSONRPC::MethodCall(m_request, m_transport, &m_client, writer))
+        writer.Flush();
+    }
+
+    CSingleLock lock(m_critical);
+    m_finished = true;
+    m_changed.notifyAll();
+  }
+
+  string m_request;
+  CWebServer *m_transport;
+  CHTTPClient m_client;
+
+  CCriticalSection m_critical;
+  XbmcThreads::ConditionVariable m_changed;
+  deque<string> m_chunks;
+  size_t m_offset;
+  bool m_finished;
+  bool m_aborted;
+
+  CThread m_thread;
+};
+
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{
+  delete m_responseStream;
+}
+
+IHTTPResponseStream* CHTTPJsonRpcHandler::GetHTTPResponseStream()
+{
+  IHTTPResponseStream *stream = m_responseStream;
+  m_responseStream = NULL;
+  return stream;
+}
+
 bool CHTTPJsonRpcHandler::CheckHTTPRequest(const HTTPRequest &request)
 {
   return (request.url.compare("/jsonrpc") == 0);
@@ -70,20 +187,26 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
   }
 
   if (isRequest)
-    m_response = CJSONRPC::MethodCall(m_request, request.webserver, &client);
+  {
+    // the response is sent while it is being generated so neither the
+    // time to the first byte nor the memory usage depend on its size
+    delete m_responseStream;
+    m_responseStream = new CResponseStream(m_request, request.webserver);
+    m_responseType = HTTPStreamDownload;
+  }
   else
   {
     // get the whole output of JSONRPC.Introspect
     CVariant result;
     CJSONServiceDescription::Print(result, request.webserver, &client);
     m_response = CJSONVariantWriter::Write(result, false);
+    m_responseType = HTTPMemoryDownloadNoFreeCopy;
   }
 
   m_responseHeaderFields.insert(pair<string, string>(MHD_HTTP_HEADER_CONTENT_TYPE, "application/json"));
 
   m_request.clear();
-  
-  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+
   m_responseCode = MHD_HTTP_OK;
 
   return MHD_YES;
@@ -25,8 +25,8 @@
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { }
-  virtual ~CHTTPJsonRpcHandler() { }
+  CHTTPJsonRpcHandler() : m_responseStream(NULL) { }
+  virtual ~CHTTPJsonRpcHandler();
   
   virtual IHTTPRequestHandler* GetInstance() { return new CHTTPJsonRpcHandler(); }
   virtual bool CheckHTTPRequest(const HTTPRequest &request);
@@ -34,8 +34,10 @@ public:
 
   virtual void* GetHTTPResponseData() const { return (void *)m_response.c_str(); };
   virtual size_t GetHTTPResonseDataLength() const { return m_response.size(); }
+  virtual IHTTPResponseStream* GetHTTPResponseStream();
 
   virtual int GetPriority() const { return 2; }
+  virtual std::string GetName() const { return "jsonrpc"; }
 
 protected:
 #if (MHD_VERSION >= 0x00040001)
@@ -45,8 +47,11 @@ protected:
 #endif
 
 private:
+  class CResponseStream;
+
   std::string m_request;
   std::string m_response;
+  CResponseStream *m_responseStream;
 
   class CHTTPClient : public JSONRPC::IClient
   {
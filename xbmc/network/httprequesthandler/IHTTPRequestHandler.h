@@ -50,7 +50,8 @@ enum HTTPResponseType
   HTTPMemoryDownloadNoFreeNoCopy,
   HTTPMemoryDownloadNoFreeCopy,
   HTTPMemoryDownloadFreeNoCopy,
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  HTTPStreamDownload
 };
 
 typedef struct HTTPRequest
@@ -62,6 +63,23 @@ typedef struct HTTPRequest
   CWebServer *webserver;
 } HTTPRequest;
 
+/*!
+ \brief Provides the body of a response whose length is not known in advance.
+
+ The body is sent to the client in chunks as it is read from the stream.
+ */
+class IHTTPResponseStream
+{
+public:
+  virtual ~IHTTPResponseStream() { }
+
+  /*!
+   \brief Read the next part of the response body, blocking until it is available.
+   \return number of bytes written to the buffer or -1 at the end of the body
+   */
+  virtual ssize_t Read(char *buffer, size_t max) = 0;
+};
+
 class IHTTPRequestHandler
 {
 public:
@@ -75,9 +93,13 @@ public:
   virtual size_t GetHTTPResonseDataLength() const { return 0; }
   virtual std::string GetHTTPRedirectUrl() const { return ""; }
   virtual std::string GetHTTPResponseFile() const { return ""; }
+  // ownership of the returned stream is passed to the caller
+  virtual IHTTPResponseStream* GetHTTPResponseStream() { return NULL; }
 
   // The higher the more important
   virtual int GetPriority() const { return 0; }
+  // Name under which the handler's statistics are collected
+  virtual std::string GetName() const = 0;
 
   void AddPostField(const std::string &key, const std::string &value);
 #if (MHD_VERSION >= 0x00040001)
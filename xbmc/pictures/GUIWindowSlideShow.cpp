@@ -18,6 +18,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "threads/SystemClock.h"
 #include "system.h"
 #include "GUIWindowSlideShow.h"
@@ -76,7 +78,9 @@ static float zoomamount[10] = { 1.0f, 1.2f, 1.5f, 2.0f, 2.8f, 4.0f, 6.0f, 9.0f,
 CBackgroundPicLoader::CBackgroundPicLoader() : CThread("BgPicLoader")
 {
   m_pCallback = NULL;
+  m_pPrefetcher = NULL;
   m_isLoading = false;
+  m_requestTime = 0;
 }
 
 CBackgroundPicLoader::~CBackgroundPicLoader()
@@ -84,9 +88,10 @@ CBackgroundPicLoader::~CBackgroundPicLoader()
   StopThread();
 }
 
-void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
+void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback, CSlideShowPrefetcher *pPrefetcher)
 {
   m_pCallback = pCallback;
+  m_pPrefetcher = pPrefetcher;
   m_isLoading = false;
   CThread::Create(false);
 }
@@ -94,17 +99,33 @@ void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
 void CBackgroundPicLoader::Process()
 {
   unsigned int totalTime = 0;
+  unsigned int totalWaitTime = 0;
   unsigned int count = 0;
+  unsigned int prefetched = 0;
   while (!m_bStop)
   { // loop around forever, waiting for the app to call LoadPic
     if (AbortableWait(m_loadPic,10) == WAIT_SIGNALED)
     {
       if (m_pCallback)
       {
-        unsigned int start = XbmcThreads::SystemClockMillis();
-        CBaseTexture* texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight, CSettings::Get().GetBool("pictures.useexifrotation"));
-        totalTime += XbmcThreads::SystemClockMillis() - start;
+        // use the picture decoded in advance if there is one
+        CBaseTexture* texture = NULL;
+        unsigned int decodeTime = 0;
+        bool bPrefetched = m_pPrefetcher && m_pPrefetcher->Take(m_iSlideNumber, m_strFileName, m_maxWidth, m_maxHeight, texture, decodeTime);
+        if (!bPrefetched)
+        {
+          unsigned int start = XbmcThreads::SystemClockMillis();
+          texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight, CSettings::Get().GetBool("pictures.useexifrotation"));
+          decodeTime = XbmcThreads::SystemClockMillis() - start;
+        }
+        unsigned int waitTime = XbmcThreads::SystemClockMillis() - m_requestTime;
+        CLog::Log(LOGDEBUG, "Slide %d is ready %u ms after it was requested (%s, decoded in %u ms)",
+                  m_iSlideNumber, waitTime, bPrefetched ? "prefetched" : "not prefetched", decodeTime);
+        totalTime += decodeTime;
+        totalWaitTime += waitTime;
         count++;
+        if (bPrefetched)
+          prefetched++;
         // tell our parent
         bool bFullSize = false;
         if (texture)
@@ -127,8 +148,8 @@ void CBackgroundPicLoader::Process()
     }
   }
   if (count > 0)
-    CLog::Log(LOGDEBUG, "Time for loading %u images: %u ms, average %u ms",
-              count, totalTime, totalTime / count);
+    CLog::Log(LOGDEBUG, "Time for loading %u images (%u prefetched): %u ms, average %u ms, average time to display %u ms",
+              count, prefetched, totalTime, totalTime / count, totalWaitTime / count);
 }
 
 void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const std::string &strFileName, const int maxWidth, const int maxHeight)
@@ -138,6 +159,7 @@ void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const std::string
   m_strFileName = strFileName;
   m_maxWidth = maxWidth;
   m_maxHeight = maxHeight;
+  m_requestTime = XbmcThreads::SystemClockMillis();
   m_isLoading = true;
   m_loadPic.Set();
 }
@@ -244,6 +266,12 @@ void CGUIWindowSlideShow::Reset()
   m_iCurrentPic = 0;
   m_iDirection = 1;
   m_iLastFailedNextSlide = -1;
+  m_bReloadImage = false;
+  m_prefetcher.Clear();
+  m_iPrefetchSlide = -1;
+  m_iPrefetchDirection = 0;
+  m_iPrefetchWidth = 0;
+  m_iPrefetchHeight = 0;
   CSingleLock lock(m_slideSection);
   m_slides->Clear();
   AnnouncePlaylistClear();
@@ -279,6 +307,8 @@ void CGUIWindowSlideShow::OnDeinitWindow(int nextWindowID)
       delete m_pBackgroundLoader;
       m_pBackgroundLoader = NULL;
     }
+    m_prefetcher.Clear();
+    m_iPrefetchSlide = -1;
     // and close the images.
     m_Image[0].Close();
     m_Image[1].Close();
@@ -316,6 +346,7 @@ void CGUIWindowSlideShow::ShowNext()
   m_fZoom        = 1.0f;
   m_fRotate      = 0.0f;
   m_bLoadNextPic = true;
+  m_bReloadImage = false;
 }
 
 void CGUIWindowSlideShow::ShowPrevious()
@@ -329,6 +360,7 @@ void CGUIWindowSlideShow::ShowPrevious()
   m_fZoom        = 1.0f;
   m_fRotate      = 0.0f;
   m_bLoadNextPic = true;
+  m_bReloadImage = false;
 }
 
 
@@ -426,7 +458,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     {
       throw 1;
     }
-    m_pBackgroundLoader->Create(this);
+    m_pBackgroundLoader->Create(this, &m_prefetcher);
   }
 
   bool bSlideShow = m_bSlideShow && !m_bPause && !m_bPlayingVideo;
@@ -501,6 +533,16 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
 
   CSingleLock lock(m_slideSection);
 
+  // pictures are decoded to the screen size and reloaded in full size when zooming in.
+  // The display effects zoom and pan across the picture and panoramas are scaled to
+  // cover the screen rather than fit it, so they need the picture in full size.
+  int maxWidth, maxHeight;
+  if (bSlideShow && CSettings::Get().GetBool("slideshow.displayeffects"))
+    GetCheckedSize((float)g_Windowing.GetMaxTextureSize(), (float)g_Windowing.GetMaxTextureSize(), maxWidth, maxHeight);
+  else
+    GetCheckedSize((float)res.iWidth, (float)res.iHeight, maxWidth, maxHeight);
+  PrefetchSlides(maxWidth, maxHeight);
+
   if (!m_Image[m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading())
   { // load first image
     CFileItemPtr item = m_slides->Get(m_iCurrentSlide);
@@ -513,11 +555,6 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
         CLog::Log(LOGDEBUG, "Loading the current image %d: %s", m_iCurrentSlide, item->GetPath().c_str());
 
       // load using the background loader
-      int maxWidth, maxHeight;
-
-      GetCheckedSize((float)res.iWidth * m_fZoom,
-                     (float)res.iHeight * m_fZoom,
-                     maxWidth, maxHeight);
       m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, picturePath, maxWidth, maxHeight);
       m_iLastFailedNextSlide = -1;
       m_bLoadNextPic = false;
@@ -528,6 +565,19 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
   if (m_Image[1 - m_iCurrentPic].IsLoaded() && m_Image[1 - m_iCurrentPic].SlideNumber() != m_iNextSlide)
     m_Image[1 - m_iCurrentPic].Close();
 
+  if (m_bReloadImage && m_Image[m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading())
+  { // reload the zoomed image in full size
+    CFileItemPtr item = m_slides->Get(m_iCurrentSlide);
+    std::string picturePath = GetPicturePath(item.get());
+    if (!picturePath.empty())
+    {
+      CLog::Log(LOGDEBUG, "Reloading the current image %d in full size: %s", m_iCurrentSlide, item->GetPath().c_str());
+      m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, picturePath, g_Windowing.GetMaxTextureSize(), g_Windowing.GetMaxTextureSize());
+    }
+    else
+      m_bReloadImage = false;
+  }
+
   if (m_iNextSlide != m_iCurrentSlide && m_Image[m_iCurrentPic].IsLoaded() && !m_Image[1 - m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading() && m_iLastFailedNextSlide != m_iNextSlide)
   { // load the next image
     m_iLastFailedNextSlide = -1;
@@ -539,11 +589,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
         CLog::Log(LOGDEBUG, "Loading the thumb %s for next video %d: %s", picturePath.c_str(), m_iNextSlide, item->GetPath().c_str());
       else
         CLog::Log(LOGDEBUG, "Loading the next image %d: %s", m_iNextSlide, item->GetPath().c_str());
-      
-      int maxWidth, maxHeight;
-      GetCheckedSize((float)res.iWidth * m_fZoom,
-                     (float)res.iHeight * m_fZoom,
-                     maxWidth, maxHeight);
+
       m_pBackgroundLoader->LoadPic(1 - m_iCurrentPic, m_iNextSlide, picturePath, maxWidth, maxHeight);
     }
   }
@@ -642,6 +688,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     m_iZoomFactor = 1;
     m_fZoom = 1.0f;
     m_fRotate = 0.0f;
+    m_bReloadImage = false;
   }
 
   if (m_Image[m_iCurrentPic].IsLoaded())
@@ -678,6 +725,44 @@ int CGUIWindowSlideShow::GetNextSlide()
   return m_iCurrentSlide;
 }
 
+void CGUIWindowSlideShow::PrefetchSlides(int maxWidth, int maxHeight)
+{
+  int iSlides = m_slides->Size();
+  // the decode size changes with the resolution, the prefetched pictures are of no use then
+  if (m_iPrefetchSlide == m_iCurrentSlide && m_iPrefetchDirection == m_iDirection
+   && m_iPrefetchWidth == maxWidth && m_iPrefetchHeight == maxHeight)
+    return;
+  m_iPrefetchSlide = m_iCurrentSlide;
+  m_iPrefetchDirection = m_iDirection;
+  m_iPrefetchWidth = maxWidth;
+  m_iPrefetchHeight = maxHeight;
+
+  // decode the pictures ahead of the current slide first, then the ones behind it
+  CSlideShowPrefetcher::SlideList slides;
+  for (int side = 0; side < 2; side++)
+  {
+    int count = side == 0 ? g_advancedSettings.m_slideshowPrefetchAhead : g_advancedSettings.m_slideshowPrefetchBehind;
+    int step = (side == 0) == (m_iDirection >= 0) ? 1 : -1;
+    int slide = m_iCurrentSlide;
+    for (int i = 1; i < iSlides && count > 0; i++)
+    {
+      slide = (slide + step + iSlides) % iSlides;
+      CFileItemPtr item = m_slides->Get(slide);
+      // video thumbs are cheap to load
+      if (item->IsVideo() || item->HasProperty("unplayable"))
+        continue;
+
+      bool bAdded = false;
+      for (CSlideShowPrefetcher::SlideList::const_iterator it = slides.begin(); it != slides.end(); ++it)
+        bAdded |= it->first == slide;
+      if (!bAdded)
+        slides.push_back(std::make_pair(slide, item->GetPath()));
+      count--;
+    }
+  }
+  m_prefetcher.Prefetch(slides, maxWidth, maxHeight);
+}
+
 EVENT_RESULT CGUIWindowSlideShow::OnMouseEvent(const CPoint &point, const CMouseEvent &event)
 {
   if (event.m_id == ACTION_GESTURE_NOTIFY)
@@ -833,6 +918,9 @@ bool CGUIWindowSlideShow::OnAction(const CAction &action)
         CSlideShowPic::DISPLAY_EFFECT effect = GetDisplayEffect(m_iCurrentSlide);
         if (m_Image[m_iCurrentPic].DisplayEffectNeedChange(effect))
           m_Image[m_iCurrentPic].Reset(effect);
+        // the picture may have been decoded for the screen size only
+        if (effect == CSlideShowPic::EFFECT_RANDOM && !m_Image[m_iCurrentPic].FullSize())
+          m_bReloadImage = true;
       }
       AnnouncePlayerPlay(m_slides->Get(m_iCurrentSlide));
     }
@@ -1089,6 +1177,10 @@ void CGUIWindowSlideShow::ZoomRelative(float fZoom, bool immediate /* = false */
   }
 
   m_Image[m_iCurrentPic].Zoom(m_fZoom, immediate);
+
+  // the picture has been decoded for the screen size only
+  if (m_fZoom > 1.0f && m_Image[m_iCurrentPic].IsLoaded() && !m_Image[m_iCurrentPic].FullSize())
+    m_bReloadImage = true;
 }
 
 void CGUIWindowSlideShow::Move(float fX, float fY)
@@ -1131,6 +1223,20 @@ CSlideShowPic::DISPLAY_EFFECT CGUIWindowSlideShow::GetDisplayEffect(int iSlideNu
 
 void CGUIWindowSlideShow::OnLoadPic(int iPic, int iSlideNumber, const std::string &strFileName, CBaseTexture* pTexture, bool bFullSize)
 {
+  if (m_bReloadImage && iPic == m_iCurrentPic && iSlideNumber == m_iCurrentSlide &&
+      m_Image[iPic].IsLoaded() && m_Image[iPic].SlideNumber() == iSlideNumber)
+  { // the full size version of the zoomed image, keep the current one if it failed
+    m_bReloadImage = false;
+    if (pTexture)
+    {
+      CSingleLock lock(m_slideSection);
+      CLog::Log(LOGDEBUG, "Finished reloading slot %d, %d in full size: %s", iPic, iSlideNumber, strFileName.c_str());
+      m_Image[iPic].UpdateTexture(pTexture);
+      m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
+    }
+    return;
+  }
+
   if (pTexture)
   {
     // set the pic's texture + size etc.
@@ -1285,8 +1391,8 @@ void CGUIWindowSlideShow::AddItems(const std::string &strPath, path_set *recursi
 
 void CGUIWindowSlideShow::GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight)
 {
-  maxWidth = g_Windowing.GetMaxTextureSize();
-  maxHeight = g_Windowing.GetMaxTextureSize();
+  maxWidth = std::min((int)width, (int)g_Windowing.GetMaxTextureSize());
+  maxHeight = std::min((int)height, (int)g_Windowing.GetMaxTextureSize());
 }
 
 std::string CGUIWindowSlideShow::GetPicturePath(CFileItem *item)
@@ -22,6 +22,9 @@
 #include "system.h"
 #include "guilib/GraphicContext.h"
 #include "guilib/Texture.h"
+#if defined(HAS_GL)
+#include "guilib/GUITextureGL.h"
+#endif
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "windowing/WindowingFactory.h"
@@ -806,6 +809,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
 
 #elif defined(HAS_GL)
   g_graphicsContext.BeginPaint();
+  CGUITextureGL::Flush();
   if (pTexture)
   {
     int unit = 0;
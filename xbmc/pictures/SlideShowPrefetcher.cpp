@@ -0,0 +1,170 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <set>
+
+#include "SlideShowPrefetcher.h"
+#include "guilib/Texture.h"
+#include "settings/Settings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+// time to wait for a prefetch job before checking whether it has been cancelled
+#define PREFETCH_WAIT_TIME 100
+
+CSlideShowPrefetchJob::CSlideShowPrefetchJob(const std::string &path, unsigned int maxWidth, unsigned int maxHeight)
+  : m_path(path),
+    m_maxWidth(maxWidth),
+    m_maxHeight(maxHeight),
+    m_decodeTime(0),
+    m_texture(NULL)
+{ }
+
+CSlideShowPrefetchJob::~CSlideShowPrefetchJob()
+{
+  delete m_texture;
+}
+
+bool CSlideShowPrefetchJob::DoWork()
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  m_texture = CTexture::LoadFromFile(m_path, m_maxWidth, m_maxHeight, CSettings::Get().GetBool("pictures.useexifrotation"));
+  m_decodeTime = XbmcThreads::SystemClockMillis() - start;
+  return m_texture != NULL;
+}
+
+CSlideShowPrefetcher::CSlideShowPrefetcher()
+{ }
+
+CSlideShowPrefetcher::~CSlideShowPrefetcher()
+{
+  Clear();
+}
+
+void CSlideShowPrefetcher::Prefetch(const SlideList &slides, unsigned int maxWidth, unsigned int maxHeight)
+{
+  CSingleLock lock(m_section);
+
+  // drop everything that isn't wanted anymore
+  std::set<int> wanted;
+  for (SlideList::const_iterator slide = slides.begin(); slide != slides.end(); ++slide)
+    wanted.insert(slide->first);
+
+  for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); )
+  {
+    if (wanted.find(it->first) == wanted.end())
+    {
+      CLog::Log(LOGDEBUG, "CSlideShowPrefetcher: dropping slide %d: %s", it->first, it->second.path.c_str());
+      Release(it->second);
+      m_entries.erase(it++);
+    }
+    else
+      ++it;
+  }
+
+  // and queue the missing slides in the order they are needed
+  for (SlideList::const_iterator slide = slides.begin(); slide != slides.end(); ++slide)
+  {
+    EntryMap::iterator it = m_entries.find(slide->first);
+    if (it != m_entries.end())
+    {
+      if (it->second.path == slide->second && it->second.maxWidth == maxWidth && it->second.maxHeight == maxHeight)
+        continue;
+
+      Release(it->second);
+      m_entries.erase(it);
+    }
+
+    Entry entry;
+    entry.path = slide->second;
+    entry.maxWidth = maxWidth;
+    entry.maxHeight = maxHeight;
+    entry.done = false;
+    entry.texture = NULL;
+    entry.decodeTime = 0;
+    entry.jobID = CJobManager::GetInstance().AddJob(new CSlideShowPrefetchJob(slide->second, maxWidth, maxHeight), this, CJob::PRIORITY_NORMAL);
+    m_entries.insert(std::make_pair(slide->first, entry));
+  }
+}
+
+bool CSlideShowPrefetcher::Take(int slideNumber, const std::string &path, unsigned int maxWidth, unsigned int maxHeight, CBaseTexture *&texture, unsigned int &decodeTime)
+{
+  CSingleLock lock(m_section);
+  while (true)
+  {
+    EntryMap::iterator it = m_entries.find(slideNumber);
+    if (it == m_entries.end() || it->second.path != path ||
+        it->second.maxWidth != maxWidth || it->second.maxHeight != maxHeight)
+      return false;
+
+    if (it->second.done)
+    {
+      texture = it->second.texture;
+      decodeTime = it->second.decodeTime;
+      m_entries.erase(it);
+      return true;
+    }
+
+    // the picture is still being decoded, so wait for it instead of decoding it twice
+    lock.Leave();
+    m_jobDone.WaitMSec(PREFETCH_WAIT_TIME);
+    lock.Enter();
+  }
+}
+
+void CSlideShowPrefetcher::Clear()
+{
+  CSingleLock lock(m_section);
+  for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    Release(it->second);
+  m_entries.clear();
+}
+
+void CSlideShowPrefetcher::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSlideShowPrefetchJob *prefetchJob = static_cast<CSlideShowPrefetchJob*>(job);
+
+  CSingleLock lock(m_section);
+  for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->second.jobID != jobID)
+      continue;
+
+    it->second.done = true;
+    it->second.jobID = 0;
+    it->second.texture = prefetchJob->m_texture;
+    it->second.decodeTime = prefetchJob->m_decodeTime;
+    prefetchJob->m_texture = NULL;
+    break;
+  }
+  m_jobDone.Set();
+}
+
+void CSlideShowPrefetcher::Release(Entry &entry)
+{
+  if (entry.jobID != 0)
+    CJobManager::GetInstance().CancelJob(entry.jobID);
+  entry.jobID = 0;
+
+  delete entry.texture;
+  entry.texture = NULL;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+
+class CBaseTexture;
+
+/*!
+ \brief Job decoding a picture of the slideshow to the size it is displayed at.
+ */
+class CSlideShowPrefetchJob : public CJob
+{
+public:
+  CSlideShowPrefetchJob(const std::string &path, unsigned int maxWidth, unsigned int maxHeight);
+  virtual ~CSlideShowPrefetchJob();
+
+  virtual bool DoWork();
+  virtual const char *GetType() const { return "slideshowprefetch"; }
+
+  std::string m_path;
+  unsigned int m_maxWidth;
+  unsigned int m_maxHeight;
+  unsigned int m_decodeTime;  ///< time in ms it took to decode the picture
+  CBaseTexture *m_texture;    ///< the decoded picture, owned by the job until taken
+};
+
+/*!
+ \brief Decodes the pictures around the current slide in the background.
+
+ The slideshow tells the prefetcher which slides it is going to show next
+ and the prefetcher decodes them in parallel on the job manager. Slides no
+ longer wanted (e.g. after changing the direction) are cancelled and their
+ textures are freed.
+ */
+class CSlideShowPrefetcher : public IJobCallback
+{
+public:
+  typedef std::vector< std::pair<int, std::string> > SlideList;
+
+  CSlideShowPrefetcher();
+  virtual ~CSlideShowPrefetcher();
+
+  /*!
+   \brief Set the slides to prefetch, in the order they are needed.
+   \param slides slide numbers and picture paths to prefetch
+   \param maxWidth the maximal width to decode the pictures to
+   \param maxHeight the maximal height to decode the pictures to
+   */
+  void Prefetch(const SlideList &slides, unsigned int maxWidth, unsigned int maxHeight);
+
+  /*!
+   \brief Take the prefetched texture of a slide, waiting for it if it is still being decoded.
+   \param texture the decoded texture (ownership is passed to the caller) or NULL if decoding failed
+   \param decodeTime the time in ms it took to decode the picture
+   \return true if the slide has been prefetched, false if the caller needs to decode it itself
+   */
+  bool Take(int slideNumber, const std::string &path, unsigned int maxWidth, unsigned int maxHeight, CBaseTexture *&texture, unsigned int &decodeTime);
+
+  /*!
+   \brief Cancel all prefetches and free the prefetched textures.
+   */
+  void Clear();
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  typedef struct Entry
+  {
+    std::string path;
+    unsigned int maxWidth;
+    unsigned int maxHeight;
+    unsigned int jobID;
+    bool done;
+    CBaseTexture *texture;
+    unsigned int decodeTime;
+  } Entry;
+  typedef std::map<int, Entry> EntryMap;
+
+  void Release(Entry &entry);
+
+  EntryMap m_entries;
+  CCriticalSection m_section;
+  CEvent m_jobDone;
+};
@@ -56,7 +56,8 @@ CPVRChannelGroup::CPVRChannelGroup(void) :
     m_bSelectedGroup(false),
     m_bPreventSortAndRenumber(false),
     m_iLastWatched(0),
-    m_bHidden(false)
+    m_bHidden(false),
+    m_bIndexesValid(false)
 {
 }
 
@@ -72,7 +73,8 @@ CPVRChannelGroup::CPVRChannelGroup(bool bRadio, unsigned int iGroupId, const std
     m_bSelectedGroup(false),
     m_bPreventSortAndRenumber(false),
     m_iLastWatched(0),
-    m_bHidden(false)
+    m_bHidden(false),
+    m_bIndexesValid(false)
 {
 }
 
@@ -88,7 +90,8 @@ CPVRChannelGroup::CPVRChannelGroup(const PVR_CHANNEL_GROUP &group) :
     m_bSelectedGroup(false),
     m_bPreventSortAndRenumber(false),
     m_iLastWatched(0),
-    m_bHidden(false)
+    m_bHidden(false),
+    m_bIndexesValid(false)
 {
 }
 
@@ -111,7 +114,8 @@ bool CPVRChannelGroup::operator!=(const CPVRChannelGroup &right) const
 }
 
 CPVRChannelGroup::CPVRChannelGroup(const CPVRChannelGroup &group) :
-  m_strGroupName(group.m_strGroupName)
+  m_strGroupName(group.m_strGroupName),
+  m_bIndexesValid(false)
 {
   m_bRadio                      = group.m_bRadio;
   m_iGroupType                  = group.m_iGroupType;
@@ -124,7 +128,7 @@ CPVRChannelGroup::CPVRChannelGroup(const CPVRChannelGroup &group) :
   m_bHidden                     = group.m_bHidden;
 
   for (int iPtr = 0; iPtr < group.Size(); iPtr++)
-    m_members.push_back(group.m_members.at(iPtr));
+    AddMember(group.m_members.at(iPtr));
 }
 
 bool CPVRChannelGroup::Load(void)
@@ -162,6 +166,7 @@ void CPVRChannelGroup::Unload(void)
 {
   CSingleLock lock(m_critSection);
   m_members.clear();
+  InvalidateIndexes();
 }
 
 bool CPVRChannelGroup::Update(void)
@@ -193,6 +198,7 @@ bool CPVRChannelGroup::SetChannelNumber(const CPVRChannel &channel, unsigned int
         bReturn = true;
         (*it).iChannelNumber    = iChannelNumber;
         (*it).iSubChannelNumber = iSubChannelNumber;
+        InvalidateIndexes();
       }
       break;
     }
@@ -227,6 +233,7 @@ bool CPVRChannelGroup::MoveChannel(unsigned int iOldChannelNumber, unsigned int
   PVRChannelGroupMember entry = m_members.at(iOldChannelNumber - 1);
   m_members.erase(m_members.begin() + iOldChannelNumber - 1);
   m_members.insert(m_members.begin() + iNewChannelNumber - 1, entry);
+  InvalidateIndexes();
 
   /* renumber the list */
   Renumber();
@@ -362,14 +369,20 @@ void CPVRChannelGroup::SortByClientChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
+  {
     sort(m_members.begin(), m_members.end(), sortByClientChannelNumber());
+    InvalidateIndexes();
+  }
 }
 
 void CPVRChannelGroup::SortByChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
+  {
     sort(m_members.begin(), m_members.end(), sortByChannelNumber());
+    InvalidateIndexes();
+  }
 }
 
 /********** getters **********/
@@ -377,15 +390,21 @@ void CPVRChannelGroup::SortByChannelNumber(void)
 CPVRChannelPtr CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  ChannelPairIndex::const_iterator it = m_clientIndex.find(std::make_pair(iClientID, iUniqueChannelId));
+  if (it != m_clientIndex.end() &&
+      (it->second->UniqueID() != iUniqueChannelId || it->second->ClientID() != iClientID))
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueChannelId &&
-        groupMember.channel->ClientID() == iClientID)
-      return groupMember.channel;
+    /* the channel changed since it was indexed */
+    InvalidateIndexes();
+    UpdateIndexes();
+    it = m_clientIndex.find(std::make_pair(iClientID, iUniqueChannelId));
   }
 
+  if (it != m_clientIndex.end())
+    return it->second;
+
   CPVRChannelPtr empty;
   return empty;
 }
@@ -394,11 +413,10 @@ CPVRChannelPtr CPVRChannelGroup::GetByChannelID(int iChannelID) const
 {
   CSingleLock lock(m_critSection);
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  for (std::vector<PVRChannelGroupMember>::const_iterator it = m_members.begin(); it != m_members.end(); ++it)
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->ChannelID() == iChannelID)
-      return groupMember.channel;
+    if (it->channel->ChannelID() == iChannelID)
+      return it->channel;
   }
 
   CPVRChannelPtr empty;
@@ -409,11 +427,10 @@ CPVRChannelPtr CPVRChannelGroup::GetByChannelEpgID(int iEpgID) const
 {
   CSingleLock lock(m_critSection);
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  for (std::vector<PVRChannelGroupMember>::const_iterator it = m_members.begin(); it != m_members.end(); ++it)
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->EpgID() == iEpgID)
-      return groupMember.channel;
+    if (it->channel->EpgID() == iEpgID)
+      return it->channel;
   }
 
   CPVRChannelPtr empty;
@@ -423,14 +440,20 @@ CPVRChannelPtr CPVRChannelGroup::GetByChannelEpgID(int iEpgID) const
 CPVRChannelPtr CPVRChannelGroup::GetByUniqueID(int iUniqueID) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  ChannelIdIndex::const_iterator it = m_uniqueIdIndex.find(iUniqueID);
+  if (it != m_uniqueIdIndex.end() && it->second->UniqueID() != iUniqueID)
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueID)
-      return groupMember.channel;
+    /* the channel changed since it was indexed */
+    InvalidateIndexes();
+    UpdateIndexes();
+    it = m_uniqueIdIndex.find(iUniqueID);
   }
 
+  if (it != m_uniqueIdIndex.end())
+    return it->second;
+
   CPVRChannelPtr empty;
   return empty;
 }
@@ -498,18 +521,65 @@ unsigned int CPVRChannelGroup::GetChannelNumber(const CPVRChannel &channel) cons
   return iReturn;
 }
 
+void CPVRChannelGroup::AddMember(const PVRChannelGroupMember &member)
+{
+  CSingleLock lock(m_critSection);
+  m_members.push_back(member);
+  if (m_bIndexesValid)
+    AddToIndexes(member);
+}
+
+void CPVRChannelGroup::AddToIndexes(const PVRChannelGroupMember &member) const
+{
+  if (!member.channel)
+    return;
+
+  /* insert() keeps existing entries, so the first member wins like in a linear search */
+  m_uniqueIdIndex.insert(std::make_pair(member.channel->UniqueID(), member.channel));
+  m_clientIndex.insert(std::make_pair(std::make_pair(member.channel->ClientID(), member.channel->UniqueID()), member.channel));
+  m_channelNumberIndex.insert(std::make_pair(std::make_pair(member.iChannelNumber, member.iSubChannelNumber), member.channel));
+  m_mainNumberIndex.insert(std::make_pair(member.iChannelNumber, member.channel));
+}
+
+void CPVRChannelGroup::UpdateIndexes(void) const
+{
+  if (m_bIndexesValid)
+    return;
+
+  m_uniqueIdIndex.clear();
+  m_clientIndex.clear();
+  m_channelNumberIndex.clear();
+  m_mainNumberIndex.clear();
+
+  for (std::vector<PVRChannelGroupMember>::const_iterator it = m_members.begin(); it != m_members.end(); ++it)
+    AddToIndexes(*it);
+
+  m_bIndexesValid = true;
+}
+
 CFileItemPtr CPVRChannelGroup::GetByChannelNumber(unsigned int iChannelNumber, unsigned int iSubChannelNumber /* = 0 */) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  CPVRChannelPtr channel;
+  if (iSubChannelNumber == 0)
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.iChannelNumber == iChannelNumber && (iSubChannelNumber == 0 || iSubChannelNumber == groupMember.iSubChannelNumber))
-    {
-      CFileItemPtr retVal = CFileItemPtr(new CFileItem(*groupMember.channel));
-      return retVal;
-    }
+    ChannelMainNumberIndex::const_iterator it = m_mainNumberIndex.find(iChannelNumber);
+    if (it != m_mainNumberIndex.end())
+      channel = it->second;
+  }
+  else
+  {
+    ChannelNumberIndex::const_iterator it = m_channelNumberIndex.find(std::make_pair(iChannelNumber, iSubChannelNumber));
+    if (it != m_channelNumberIndex.end())
+      channel = it->second;
+  }
+
+  if (channel)
+  {
+    CFileItemPtr retVal = CFileItemPtr(new CFileItem(*channel));
+    return retVal;
   }
 
   CFileItemPtr retVal = CFileItemPtr(new CFileItem);
@@ -699,6 +769,7 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
       }
 
       m_members.erase(m_members.begin() + iChannelPtr);
+      InvalidateIndexes();
       m_bChanged = true;
       bReturn = true;
     }
@@ -780,6 +851,7 @@ void CPVRChannelGroup::RemoveInvalidChannels(void)
       else
       {
         m_members.erase(m_members.begin() + ptr);
+        InvalidateIndexes();
       }
       m_bChanged = true;
     }
@@ -797,6 +869,7 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannel &channel)
     {
       // TODO notify observers
       m_members.erase(m_members.begin() + iChannelPtr);
+      InvalidateIndexes();
       bReturn = true;
       m_bChanged = true;
       break;
@@ -826,7 +899,7 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
     if (realChannel)
     {
       PVRChannelGroupMember newMember = { realChannel, (unsigned int)iChannelNumber };
-      m_members.push_back(newMember);
+      AddMember(newMember);
       m_bChanged = true;
 
       SortAndRenumber();
@@ -960,6 +1033,7 @@ bool CPVRChannelGroup::Renumber(void)
     (*it).iChannelNumber    = iCurrentChannelNumber;
     (*it).iSubChannelNumber = iSubChannelNumber;
   }
+  InvalidateIndexes();
 
   SortByChannelNumber();
   ResetChannelNumberCache();
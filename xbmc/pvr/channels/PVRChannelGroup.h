@@ -26,6 +26,7 @@
 #include "utils/JobManager.h"
 
 #include <boost/shared_ptr.hpp>
+#include <map>
 
 namespace EPG
 {
@@ -528,6 +529,19 @@ namespace PVR
      */
     CPVRChannelPtr GetByChannelID(int iChannelID) const;
 
+    /*!
+     * @brief Add a channel to the end of the member list and to the lookup indexes.
+     * @param member The new member.
+     */
+    void AddMember(const PVRChannelGroupMember &member);
+
+    /*!
+     * @brief Mark the lookup indexes outdated, after the members or their channel numbers changed.
+     *
+     * The indexes are rebuilt on the next lookup.
+     */
+    void InvalidateIndexes(void) const { m_bIndexesValid = false; }
+
     bool             m_bRadio;                      /*!< true if this container holds radio channels, false if it holds TV channels */
     int              m_iGroupType;                  /*!< The type of this group */
     int              m_iGroupId;                    /*!< The ID of this group in the database */
@@ -545,6 +559,21 @@ namespace PVR
     
   private:
     CDateTime GetEPGDate(EpgDateType epgDateType) const;
+
+    typedef std::map<int, CPVRChannelPtr> ChannelIdIndex;
+    typedef std::map<std::pair<int, int>, CPVRChannelPtr> ChannelPairIndex;
+    typedef std::map<std::pair<unsigned int, unsigned int>, CPVRChannelPtr> ChannelNumberIndex;
+    typedef std::map<unsigned int, CPVRChannelPtr> ChannelMainNumberIndex;
+
+    void AddToIndexes(const PVRChannelGroupMember &member) const;
+    void UpdateIndexes(void) const;
+
+    /* lookup indexes for the members, the first member wins if keys are used twice */
+    mutable bool                   m_bIndexesValid;
+    mutable ChannelIdIndex         m_uniqueIdIndex;      /*!< channels by unique ID */
+    mutable ChannelPairIndex       m_clientIndex;        /*!< channels by client ID and unique ID */
+    mutable ChannelNumberIndex     m_channelNumberIndex; /*!< channels by channel number and sub channel number */
+    mutable ChannelMainNumberIndex m_mainNumberIndex;    /*!< channels by channel number */
     
   };
 
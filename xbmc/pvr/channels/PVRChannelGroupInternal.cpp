@@ -100,7 +100,7 @@ void CPVRChannelGroupInternal::UpdateFromClient(const CPVRChannel &channel, unsi
   else
   {
     PVRChannelGroupMember newMember = { CPVRChannelPtr(new CPVRChannel(channel)), iChannelNumber > 0l ? iChannelNumber : (int)m_members.size() + 1 };
-    m_members.push_back(newMember);
+    AddMember(newMember);
     m_bChanged = true;
 
     SortAndRenumber();
@@ -284,6 +284,9 @@ bool CPVRChannelGroupInternal::UpdateChannel(const CPVRChannel &channel)
   }
   updateChannel->UpdateFromClient(channel);
 
+  /* the IDs of the channel may have changed */
+  InvalidateIndexes();
+
   return updateChannel->Persist(!m_bLoaded);
 }
 
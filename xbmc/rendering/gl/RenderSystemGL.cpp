@@ -25,6 +25,7 @@
 
 #include "RenderSystemGL.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITextureBatchGL.h"
 #include "settings/AdvancedSettings.h"
 #include "guilib/MatrixGLES.h"
 #include "settings/DisplaySettings.h"
@@ -241,6 +242,7 @@ bool CRenderSystemGL::ResetRenderSystem(int width, int height, bool fullScreen,
 
 bool CRenderSystemGL::DestroyRenderSystem()
 {
+  CGUITextureBatchGL::Get().Reset();
   m_bRenderCreated = false;
 
   return true;
@@ -259,6 +261,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureBatchGL::Get().Flush();
+
   return true;
 }
 
@@ -267,6 +271,8 @@ bool CRenderSystemGL::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureBatchGL::Get().Flush();
+
   /* clear is not affected by stipple pattern, so we can only clear on first frame */
   if(m_stereoMode == RENDER_STEREO_MODE_INTERLACED && m_stereoView == RENDER_STEREO_VIEW_RIGHT)
     return true;
@@ -299,6 +305,8 @@ bool CRenderSystemGL::PresentRender(const CDirtyRegionList& dirty)
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureBatchGL::Get().NewFrame();
+
   if (m_iVSyncMode != 0 && m_iSwapRate != 0)
   {
     int64_t curr, diff, freq;
@@ -395,6 +403,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureBatchGL::Get().Flush();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -412,6 +422,8 @@ void CRenderSystemGL::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureBatchGL::Get().Flush();
+
   glViewport(m_viewPort[0], m_viewPort[1], m_viewPort[2], m_viewPort[3]);
 
   glMatrixProject.PopLoad();
@@ -431,6 +443,8 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureBatchGL::Get().Flush();
+
   g_graphicsContext.BeginPaint();
 
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
@@ -485,6 +499,8 @@ void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureBatchGL::Get().Flush();
+
   glMatrixModview.Push();
   GLfloat matrix[4][4];
 
@@ -506,6 +522,8 @@ void CRenderSystemGL::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureBatchGL::Get().Flush();
+
   glMatrixModview.PopLoad();
 }
 
@@ -571,6 +589,8 @@ void CRenderSystemGL::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureBatchGL::Get().Flush();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -583,6 +603,8 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUITextureBatchGL::Get().Flush();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -652,6 +674,8 @@ static const GLubyte stipple_3d[] = {
 
 void CRenderSystemGL::SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view)
 {
+  CGUITextureBatchGL::Get().Flush();
+
   CRenderSystemBase::SetStereoMode(mode, view);
 
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
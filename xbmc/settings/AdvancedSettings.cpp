@@ -194,6 +194,8 @@ void CAdvancedSettings::Initialize()
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
   m_slideshowBlackBarCompensation = 20.0f;
+  m_slideshowPrefetchAhead = 2;
+  m_slideshowPrefetchBehind = 1;
 
   m_songInfoDuration = 10;
 
@@ -367,7 +369,9 @@ void CAdvancedSettings::Initialize()
   m_iPVRNumericChannelSwitchTimeout = 1000;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cacheSparseFileSize = 0; // Disabled, use the memory buffer
   m_networkBufferMode = 0; // Default (buffer all internet streams/filesystems)
+  m_networkListingCacheTTL = 0; // Disabled, don't keep listings of network sources on disk
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_readBufferFactor = 1.0f;
@@ -791,6 +795,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "panamount", m_slideshowPanAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "zoomamount", m_slideshowZoomAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "blackbarcompensation", m_slideshowBlackBarCompensation, 0.0f, 50.0f);
+    XMLUtils::GetInt(pElement, "prefetchahead", m_slideshowPrefetchAhead, 0, 10);
+    XMLUtils::GetInt(pElement, "prefetchbehind", m_slideshowPrefetchBehind, 0, 10);
   }
 
   pElement = pRootElement->FirstChildElement("network");
@@ -801,7 +807,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetUInt(pElement, "cachesparsefilesize", m_cacheSparseFileSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_networkBufferMode, 0, 3);
+    XMLUtils::GetUInt(pElement, "listingcachettl", m_networkListingCacheTTL);
     XMLUtils::GetFloat(pElement, "readbufferfactor", m_readBufferFactor);
   }
 
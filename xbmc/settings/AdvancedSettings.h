@@ -207,6 +207,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
     float m_slideshowPanAmount;
+    int m_slideshowPrefetchAhead;
+    int m_slideshowPrefetchBehind;
 
     int m_songInfoDuration;
     int m_logLevel;
@@ -379,7 +381,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    unsigned int m_cacheSparseFileSize;
     unsigned int m_networkBufferMode;
+    unsigned int m_networkListingCacheTTL; // seconds
     float m_readBufferFactor;
 
     bool m_jsonOutputCompact;
@@ -0,0 +1,165 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <set>
+
+#include "SettingHandle.h"
+#include "settings/Settings.h"
+#include "settings/lib/Setting.h"
+#include "settings/lib/SettingsManager.h"
+#include "threads/SingleLock.h"
+
+CSettingHandles::CSettingHandles()
+  : m_settingsManager(NULL)
+{ }
+
+CSettingHandles::~CSettingHandles()
+{
+  for (ValueMap::iterator it = m_values.begin(); it != m_values.end(); ++it)
+    delete it->second;
+  m_values.clear();
+}
+
+CSettingHandles& CSettingHandles::Get()
+{
+  static CSettingHandles sSettingHandles;
+  return sSettingHandles;
+}
+
+CSettingHandles::Value* CSettingHandles::Register(const std::string &id)
+{
+  CSingleLock lock(m_critical);
+  ValueMap::iterator it = m_values.find(id);
+  if (it != m_values.end())
+    return it->second;
+
+  Value *value = new Value;
+  value->id = id;
+  value->value = SETTING_HANDLE_UNCACHED;
+  value->generation = 0;
+  m_values.insert(std::make_pair(id, value));
+
+  // handles created after the settings have been initialized need their own callback
+  CSettingsManager *settingsManager = m_settingsManager;
+  lock.Leave();
+
+  if (settingsManager != NULL)
+  {
+    std::set<std::string> settingSet;
+    settingSet.insert(id);
+    settingsManager->RegisterCallback(this, settingSet);
+  }
+
+  return value;
+}
+
+long CSettingHandles::Load(Value &value)
+{
+  long generation = value.generation;
+
+  // don't hold our lock while accessing the settings to not deadlock with OnSettingChanged()
+  long result = ToLong(CSettings::Get().GetSetting(value.id));
+
+  CSingleLock lock(m_critical);
+  // only cache the value if it hasn't been changed or invalidated in the meantime
+  if (m_settingsManager != NULL && value.generation == generation)
+    value.value = result;
+
+  return result;
+}
+
+void CSettingHandles::Invalidate()
+{
+  CSingleLock lock(m_critical);
+  for (ValueMap::iterator it = m_values.begin(); it != m_values.end(); ++it)
+  {
+    it->second->generation++;
+    it->second->value = SETTING_HANDLE_UNCACHED;
+  }
+}
+
+void CSettingHandles::Initialize(CSettingsManager *settingsManager)
+{
+  if (settingsManager == NULL)
+    return;
+
+  std::set<std::string> settingSet;
+  {
+    CSingleLock lock(m_critical);
+    m_settingsManager = settingsManager;
+    for (ValueMap::const_iterator it = m_values.begin(); it != m_values.end(); ++it)
+      settingSet.insert(it->first);
+  }
+
+  settingsManager->RegisterSettingsHandler(this);
+  settingsManager->RegisterCallback(this, settingSet);
+  Invalidate();
+}
+
+void CSettingHandles::Uninitialize()
+{
+  CSettingsManager *settingsManager;
+  {
+    CSingleLock lock(m_critical);
+    settingsManager = m_settingsManager;
+    m_settingsManager = NULL;
+  }
+
+  if (settingsManager != NULL)
+  {
+    settingsManager->UnregisterCallback(this);
+    settingsManager->UnregisterSettingsHandler(this);
+  }
+  Invalidate();
+}
+
+void CSettingHandles::OnSettingChanged(const CSetting *setting)
+{
+  if (setting == NULL)
+    return;
+
+  CSingleLock lock(m_critical);
+  ValueMap::iterator it = m_values.find(setting->GetId());
+  if (it == m_values.end())
+    return;
+
+  it->second->generation++;
+  it->second->value = ToLong(setting);
+}
+
+long CSettingHandles::ToLong(const CSetting *setting)
+{
+  if (setting == NULL)
+    return 0;
+
+  switch (setting->GetType())
+  {
+    case SettingTypeBool:
+      return static_cast<const CSettingBool*>(setting)->GetValue() ? 1 : 0;
+
+    case SettingTypeInteger:
+      return static_cast<const CSettingInt*>(setting)->GetValue();
+
+    default:
+      break;
+  }
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <climits>
+#include <map>
+#include <string>
+
+#include "settings/lib/ISettingCallback.h"
+#include "settings/lib/ISettingsHandler.h"
+#include "threads/CriticalSection.h"
+
+class CSetting;
+class CSettingsManager;
+
+#define SETTING_HANDLE_UNCACHED LONG_MIN
+
+/*!
+ \brief Keeps the values of the settings used through CSettingHandle.
+
+ The values are updated through the ISettingCallback of the settings and
+ reloaded from the settings after the settings have been (un)loaded.
+ */
+class CSettingHandles : public ISettingCallback, public ISettingsHandler
+{
+public:
+  typedef struct Value
+  {
+    std::string id;
+    volatile long value;      // SETTING_HANDLE_UNCACHED if it has to be reloaded
+    volatile long generation; // increased with every change of the value
+  } Value;
+
+  static CSettingHandles& Get();
+
+  /*!
+   \brief Get the cached value of the given setting, registering it if necessary.
+   */
+  Value* Register(const std::string &id);
+
+  /*!
+   \brief Read the value of a setting from the settings and cache it.
+   \return the value of the setting, 0 if the setting is unknown
+   */
+  long Load(Value &value);
+
+  /*!
+   \brief Make all cached values being reloaded on their next use.
+   */
+  void Invalidate();
+
+  /*!
+   \brief Start receiving the changes of all registered settings from the given settings manager.
+   */
+  void Initialize(CSettingsManager *settingsManager);
+  void Uninitialize();
+
+  virtual void OnSettingChanged(const CSetting *setting);
+
+  virtual void OnSettingsLoaded() { Invalidate(); }
+  virtual void OnSettingsUnloaded() { Invalidate(); }
+  virtual void OnSettingsCleared() { Invalidate(); }
+
+private:
+  CSettingHandles();
+  virtual ~CSettingHandles();
+  CSettingHandles(const CSettingHandles&);
+  CSettingHandles const& operator=(CSettingHandles const&);
+
+  static long ToLong(const CSetting *setting);
+
+  typedef std::map<std::string, Value*> ValueMap;
+  ValueMap m_values;
+  CSettingsManager *m_settingsManager;
+  CCriticalSection m_critical;
+};
+
+/*!
+ \brief Typed handle to a boolean or integer setting for code reading it often.
+
+ Reading the value is a single memory read instead of a lookup of the setting
+ by its identifier. Handles are usually declared static where they are used:
+
+ \code
+ static CSettingHandle<bool> s_limitedRange("videoscreen.limitedrange");
+ if (s_limitedRange)
+   ...
+ \endcode
+
+ The value is updated through a callback of its own, so it may still be the
+ old one inside other ISettingCallback::OnSettingChanged() calls for the same
+ setting. Read the value of the changed setting passed to the callback there.
+ */
+template<typename T>
+class CSettingHandle
+{
+public:
+  explicit CSettingHandle(const std::string &id)
+    : m_value(CSettingHandles::Get().Register(id))
+  { }
+
+  T Get() const
+  {
+    long value = m_value->value;
+    if (value == SETTING_HANDLE_UNCACHED)
+      value = CSettingHandles::Get().Load(*m_value);
+    return Convert(value);
+  }
+
+  operator T() const { return Get(); }
+
+private:
+  static T Convert(long value) { return (T)value; }
+
+  CSettingHandles::Value *m_value;
+};
+
+template<>
+inline bool CSettingHandle<bool>::Convert(long value) { return value != 0; }
@@ -67,6 +67,7 @@
 #include "settings/SettingAddon.h"
 #include "settings/SettingConditions.h"
 #include "settings/SettingControl.h"
+#include "settings/SettingHandle.h"
 #include "settings/SettingPath.h"
 #include "settings/SettingUtils.h"
 #include "settings/SkinSettings.h"
@@ -183,6 +184,10 @@ bool CSettings::Load(const TiXmlElement *root, bool hide /* = false */)
   }
   delete loadedSettings;
 
+  // no settings events have been triggered so the cached values might be outdated
+  if (success && hide)
+    CSettingHandles::Get().Invalidate();
+
   return success;
 }
 
@@ -283,6 +288,7 @@ void CSettings::Uninitialize()
 #if defined(TARGET_DARWIN_OSX)
   m_settingsManager->UnregisterCallback(&XBMCHelper::GetInstance());
 #endif
+  CSettingHandles::Get().Uninitialize();
 
   // cleanup the settings manager
   m_settingsManager->Clear();
@@ -822,6 +828,9 @@ void CSettings::InitializeISettingCallbacks()
   settingSet.insert("input.appleremotealwayson");
   m_settingsManager->RegisterCallback(&XBMCHelper::GetInstance(), settingSet);
 #endif
+
+  // registers itself as ISettingsHandler as well
+  CSettingHandles::Get().Initialize(m_settingsManager);
 }
 
 bool CSettings::Reset()
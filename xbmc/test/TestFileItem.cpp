@@ -21,6 +21,8 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/Variant.h"
+#include "video/VideoInfoTag.h"
 
 #include "gtest/gtest.h"
 
@@ -136,3 +138,40 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+TEST(TestFileItem, SerializeFields)
+{
+  CVideoInfoTag tag;
+  tag.m_strTitle = "Title";
+  tag.m_iYear = 2015;
+  SActorInfo actor;
+  actor.strName = "Actor";
+  tag.m_cast.push_back(actor);
+
+  CFileItem item(tag);
+  item.SetPath("/path/to/movie.mkv");
+
+  std::set<std::string> fields;
+  fields.insert("title");
+  fields.insert("year");
+
+  CVariant projected;
+  item.GetVideoInfoTag()->SerializeFields(projected, fields);
+  EXPECT_EQ(2U, projected.size());
+  EXPECT_STREQ("Title", projected["title"].asString().c_str());
+  EXPECT_EQ(2015, projected["year"].asInteger());
+  EXPECT_FALSE(projected.isMember("cast"));
+
+  // the projection contains the same values as the full serialization
+  CVariant full;
+  item.GetVideoInfoTag()->Serialize(full);
+  EXPECT_TRUE(full.isMember("cast"));
+  EXPECT_TRUE(full["title"] == projected["title"]);
+
+  // nested tags are only serialized when asked for
+  CVariant fileItem;
+  item.SerializeFields(fileItem, fields);
+  EXPECT_TRUE(fileItem.isMember("title"));
+  EXPECT_FALSE(fileItem.isMember("videoInfoTag"));
+  EXPECT_FALSE(fileItem.isMember("strPath"));
+}
@@ -0,0 +1,176 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "PlatformDefs.h"
+#include "ChannelLookupBenchmark.h"
+#include "FileItem.h"
+#include "pvr/channels/PVRChannelGroup.h"
+#include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+
+using namespace PVR;
+
+static int64_t ElapsedTime(int64_t start)
+{
+  return (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency();
+}
+
+class CChannelLookupBenchmark::CGroup : public CPVRChannelGroup
+{
+public:
+  CGroup() : CPVRChannelGroup(false, 1, "benchmark") { }
+
+  void Add(int iUniqueId, int iClientId, unsigned int iChannelNumber)
+  {
+    CPVRChannelPtr channel(new CPVRChannel(false));
+    channel->SetUniqueID(iUniqueId);
+    channel->SetClientID(iClientId);
+    PVRChannelGroupMember member = { channel, iChannelNumber };
+    AddMember(member);
+  }
+
+  // the lookup as it was done before the indexes
+  CPVRChannelPtr GetByClientLinear(int iUniqueChannelId, int iClientID) const
+  {
+    CSingleLock lock(m_critSection);
+
+    for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+    {
+      PVRChannelGroupMember groupMember = m_members.at(ptr);
+      if (groupMember.channel->UniqueID() == iUniqueChannelId &&
+          groupMember.channel->ClientID() == iClientID)
+        return groupMember.channel;
+    }
+
+    CPVRChannelPtr empty;
+    return empty;
+  }
+
+  CPVRChannelPtr GetByUniqueIDLinear(int iUniqueID) const
+  {
+    CSingleLock lock(m_critSection);
+
+    for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+    {
+      PVRChannelGroupMember groupMember = m_members.at(ptr);
+      if (groupMember.channel->UniqueID() == iUniqueID)
+        return groupMember.channel;
+    }
+
+    CPVRChannelPtr empty;
+    return empty;
+  }
+
+  CFileItemPtr GetByChannelNumberLinear(unsigned int iChannelNumber, unsigned int iSubChannelNumber = 0) const
+  {
+    CSingleLock lock(m_critSection);
+
+    for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+    {
+      PVRChannelGroupMember groupMember = m_members.at(ptr);
+      if (groupMember.iChannelNumber == iChannelNumber && (iSubChannelNumber == 0 || iSubChannelNumber == groupMember.iSubChannelNumber))
+      {
+        CFileItemPtr retVal = CFileItemPtr(new CFileItem(*groupMember.channel));
+        return retVal;
+      }
+    }
+
+    CFileItemPtr retVal = CFileItemPtr(new CFileItem);
+    return retVal;
+  }
+};
+
+CChannelLookupBenchmark::CChannelLookupBenchmark(const Options &options)
+  : m_options(options),
+    m_lookups(0),
+    m_fillTime(0),
+    m_indexedTime(0),
+    m_linearTime(0)
+{ }
+
+bool CChannelLookupBenchmark::Run()
+{
+  CGroup group;
+  int clients = std::max(m_options.clients, 1);
+
+  int64_t start = CurrentHostCounter();
+  for (int channel = 0; channel < m_options.channels; channel++)
+    group.Add(channel + 1, channel % clients, channel + 1);
+  m_fillTime = ElapsedTime(start);
+
+  bool success = true;
+  m_lookups = 0;
+
+  start = CurrentHostCounter();
+  for (int tag = 0; tag < m_options.tags; tag++)
+  {
+    for (int channel = 0; channel < m_options.channels; channel++)
+    {
+      CPVRChannelPtr found = group.GetByClient(channel + 1, channel % clients);
+      if (!found || found->UniqueID() != channel + 1)
+        success = false;
+      m_lookups++;
+    }
+  }
+  for (int channel = 0; channel < m_options.channels; channel++)
+  {
+    if (!group.GetByUniqueID(channel + 1))
+      success = false;
+    m_lookups++;
+  }
+  for (int channel = 0; channel < m_options.channels; channel++)
+  {
+    CFileItemPtr found = group.GetByChannelNumber(channel + 1);
+    if (!found->HasPVRChannelInfoTag() || found->GetPVRChannelInfoTag()->UniqueID() != channel + 1)
+      success = false;
+    m_lookups++;
+  }
+  m_indexedTime = ElapsedTime(start);
+
+  start = CurrentHostCounter();
+  for (int tag = 0; tag < m_options.tags; tag++)
+  {
+    for (int channel = 0; channel < m_options.channels; channel++)
+      group.GetByClientLinear(channel + 1, channel % clients);
+  }
+  for (int channel = 0; channel < m_options.channels; channel++)
+    group.GetByUniqueIDLinear(channel + 1);
+  for (int channel = 0; channel < m_options.channels; channel++)
+    group.GetByChannelNumberLinear(channel + 1);
+  m_linearTime = ElapsedTime(start);
+
+  return success;
+}
+
+void CChannelLookupBenchmark::PrintReport(FILE *out) const
+{
+  fprintf(out, "channels:       %d (%d clients)\n", m_options.channels, std::max(m_options.clients, 1));
+  fprintf(out, "epg tags:       %d per channel\n", m_options.tags);
+  fprintf(out, "lookups:        %" PRIu64 "\n", m_lookups);
+  fprintf(out, "fill group:     %" PRId64 " ms\n", m_fillTime / 1000);
+  fprintf(out, "indexed:        %" PRId64 " ms (%.3f us per lookup)\n",
+          m_indexedTime / 1000, m_lookups ? (double)m_indexedTime / m_lookups : 0.0);
+  fprintf(out, "linear search:  %" PRId64 " ms (%.3f us per lookup)\n",
+          m_linearTime / 1000, m_lookups ? (double)m_linearTime / m_lookups : 0.0);
+  if (m_indexedTime > 0)
+    fprintf(out, "speedup:        %.1fx\n", (double)m_linearTime / m_indexedTime);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*!
+ \brief Measures the channel lookups done by a full EPG import.
+
+ A channel group is filled with channels of a number of clients. Then, like the
+ EPG import does for each tag it receives, the channel of every tag is looked up
+ by its client and unique ID. Every channel is then looked up once by its unique
+ ID, like timers do, and once by its channel number, like channel switches do.
+
+ The same lookups are timed with a linear search of the members as a reference.
+ */
+class CChannelLookupBenchmark
+{
+public:
+  typedef struct Options
+  {
+    Options() : channels(1000), tags(50), clients(2) { }
+    int channels;     // number of channels in the group
+    int tags;         // EPG tags imported per channel
+    int clients;      // number of clients the channels are spread over
+  } Options;
+
+  explicit CChannelLookupBenchmark(const Options &options);
+
+  /*!
+   \brief Run the benchmark.
+   \return false if a lookup returned the wrong channel
+   */
+  bool Run();
+
+  /*!
+   \brief Print the results of the last run.
+   */
+  void PrintReport(FILE *out) const;
+
+private:
+  class CGroup;
+
+  Options m_options;
+  uint64_t m_lookups;
+  int64_t m_fillTime;     // microseconds
+  int64_t m_indexedTime;  // microseconds
+  int64_t m_linearTime;   // microseconds
+};
@@ -0,0 +1,493 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <string.h>
+
+#include "PlatformDefs.h"
+#include "PlaybackBenchmark.h"
+#if defined(TARGET_POSIX)
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#include "cores/AudioEngine/AEFactory.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/dvdplayer/DVDCodecs/Audio/DVDAudioCodecFFmpeg.h"
+#include "cores/dvdplayer/DVDCodecs/DVDCodecs.h"
+#include "cores/dvdplayer/DVDCodecs/DVDFactoryCodec.h"
+#include "cores/dvdplayer/DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemux.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/dvdplayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/dvdplayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/dvdplayer/DVDStreamInfo.h"
+#include "utils/TimeUtils.h"
+
+// how long to wait for a decoder to take a packet or to finish, in milliseconds
+#define STAGE_TIMEOUT 30000
+
+static int64_t ElapsedTime(int64_t start)
+{
+  return (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency();
+}
+
+static void SampleQueue(CPlaybackBenchmark::Stage &stats, int level)
+{
+  stats.queueSamples++;
+  stats.queueLevel += level;
+  if (level > stats.queueMax)
+    stats.queueMax = level;
+}
+
+CPlaybackBenchmark::CDecodeStage::CDecodeStage(const char *name, Stage &stats)
+  : CThread(name)
+  , m_queue(name)
+  , m_stats(stats)
+{
+  m_queue.Init();
+}
+
+void CPlaybackBenchmark::CDecodeStage::Process()
+{
+  while (!m_bStop)
+  {
+    CDVDMsg *msg = NULL;
+    MsgQueueReturnCode ret = m_queue.Get(&msg, 1000);
+    if (ret == MSGQ_TIMEOUT)
+      continue;
+    if (MSGQ_IS_ERROR(ret))
+      break;
+
+    int64_t start = CurrentHostCounter();
+    int64_t cpu = ThreadCpuTime();
+
+    bool eof = msg->IsType(CDVDMsg::GENERAL_EOF);
+    if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    {
+      DemuxPacket *packet = ((CDVDMsgDemuxerPacket*)msg)->GetPacket();
+      m_stats.packets++;
+      m_stats.bytes += packet->iSize;
+      decode(packet);
+    }
+    else if (eof)
+      flush();
+    msg->Release();
+
+    m_stats.wallTime += ElapsedTime(start);
+    m_stats.cpuTime += ThreadCpuTime() - cpu;
+
+    if (eof)
+      break;
+  }
+}
+
+CPlaybackBenchmark::CVideoStage::CVideoStage(CDVDVideoCodec *codec, Stage &stats)
+  : CDecodeStage("BenchmarkVideo", stats)
+  , m_codec(codec)
+{ }
+
+CPlaybackBenchmark::CVideoStage::~CVideoStage()
+{
+  delete m_codec;
+}
+
+void CPlaybackBenchmark::CVideoStage::decode(DemuxPacket *packet)
+{
+  output(m_codec->Decode(packet->pData, packet->iSize, packet->dts, packet->pts));
+}
+
+void CPlaybackBenchmark::CVideoStage::flush()
+{
+  output(m_codec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE));
+}
+
+void CPlaybackBenchmark::CVideoStage::output(int state)
+{
+  // same loop as CDVDPlayerVideo but the pictures are thrown away instead of rendered
+  while (!m_bStop)
+  {
+    if (state & VC_ERROR)
+    {
+      m_stats.errors++;
+      m_codec->Reset();
+      break;
+    }
+
+    // the decoder flushed itself, the player would resend the packets since the
+    // last keyframe but there is nothing to render here anyway
+    if (state & VC_FLUSHED)
+      break;
+
+    if (state & VC_PICTURE)
+    {
+      DVDVideoPicture picture;
+      memset(&picture, 0, sizeof(picture));
+      m_codec->ClearPicture(&picture);
+      if (m_codec->GetPicture(&picture) && !(picture.iFlags & DVP_FLAG_DROPPED))
+        m_stats.frames++;
+      m_codec->ClearPicture(&picture);
+    }
+
+    if (state & VC_BUFFER)
+      break;
+
+    state = m_codec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+  }
+}
+
+CPlaybackBenchmark::CAudioStage::CAudioStage(CDVDAudioCodec *codec, Stage &stats, Stage &output)
+  : CDecodeStage("BenchmarkAudio", stats)
+  , m_codec(codec)
+  , m_stream(NULL)
+  , m_output(output)
+{ }
+
+CPlaybackBenchmark::CAudioStage::~CAudioStage()
+{
+  if (m_stream)
+    CAEFactory::FreeStream(m_stream);
+  delete m_codec;
+}
+
+void CPlaybackBenchmark::CAudioStage::decode(DemuxPacket *packet)
+{
+  uint8_t *data = packet->pData;
+  int size = packet->iSize;
+
+  while (size > 0 && !m_bStop)
+  {
+    int len = m_codec->Decode(data, size);
+    if (len < 0 || len > size)
+    {
+      m_stats.errors++;
+      m_codec->Reset();
+      break;
+    }
+    data += len;
+    size -= len;
+
+    DVDAudioFrame frame;
+    m_codec->GetData(frame);
+    if (frame.nb_frames == 0)
+    {
+      if (len == 0)
+        break;
+      continue;
+    }
+    m_stats.frames += frame.nb_frames;
+
+    // time spent in the audio engine is accounted to the output stage only
+    int64_t start = CurrentHostCounter();
+    int64_t cpu = ThreadCpuTime();
+
+    if (m_stream == NULL)
+    {
+      m_stream = CAEFactory::MakeStream(frame.data_format, frame.sample_rate, frame.encoded_sample_rate,
+                                        frame.channel_layout, AESTREAM_AUTOSTART);
+      if (m_stream == NULL)
+        m_output.errors++;
+    }
+
+    unsigned int offset = 0;
+    while (m_stream && offset < frame.nb_frames && !m_bStop)
+    {
+      unsigned int copied = m_stream->AddData(frame.data, offset, frame.nb_frames - offset);
+      if (copied == 0)
+      {
+        Sleep(1);
+        continue;
+      }
+      offset += copied;
+      m_output.packets++;
+    }
+
+    if (m_stream)
+    {
+      m_output.frames += offset;
+      double total = m_stream->GetCacheTotal();
+      if (total > 0.0)
+        SampleQueue(m_output, (int)(100.0 * m_stream->GetCacheTime() / total));
+    }
+
+    int64_t wallTime = ElapsedTime(start);
+    int64_t cpuTime = ThreadCpuTime() - cpu;
+    m_output.wallTime += wallTime;
+    m_output.cpuTime += cpuTime;
+    m_stats.wallTime -= wallTime;
+    m_stats.cpuTime -= cpuTime;
+  }
+}
+
+void CPlaybackBenchmark::CAudioStage::flush()
+{
+  if (m_stream)
+    m_stream->Drain(true);
+}
+
+CPlaybackBenchmark::CPlaybackBenchmark(const Options &options)
+  : m_options(options)
+  , m_mediaTime(0.0)
+  , m_elapsed(0)
+  , m_processCpuTime(0)
+{ }
+
+CPlaybackBenchmark::~CPlaybackBenchmark()
+{ }
+
+int64_t CPlaybackBenchmark::ThreadCpuTime()
+{
+#if defined(TARGET_POSIX) && defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+  return 0;
+}
+
+static int64_t ProcessCpuTime()
+{
+#if defined(TARGET_POSIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return (int64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+  return 0;
+}
+
+bool CPlaybackBenchmark::Run()
+{
+  m_demux = m_video = m_audio = m_audioOutput = Stage();
+  m_mediaTime = 0.0;
+
+  CDVDInputStream *input = CDVDFactoryInputStream::CreateInputStream(NULL, m_options.file, "");
+  if (input == NULL || !input->Open(m_options.file.c_str(), ""))
+  {
+    fprintf(stderr, "unable to open %s\n", m_options.file.c_str());
+    delete input;
+    return false;
+  }
+
+  CDVDDemux *demux = CDVDFactoryDemuxer::CreateDemuxer(input);
+  if (demux == NULL)
+  {
+    fprintf(stderr, "unable to demux %s\n", m_options.file.c_str());
+    delete input;
+    return false;
+  }
+
+  CVideoStage *video = NULL;
+  CAudioStage *audio = NULL;
+  int videoId = -1;
+  int audioId = -1;
+  for (int i = 0; i < demux->GetNrOfStreams(); i++)
+  {
+    CDemuxStream *stream = demux->GetStream(i);
+    if (stream == NULL)
+      continue;
+
+    CDVDStreamInfo hint(*stream, true);
+    hint.software = true;
+    CDVDCodecOptions options;
+
+    if (stream->type == STREAM_VIDEO && m_options.video && video == NULL)
+    {
+      CDVDVideoCodec *codec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, options);
+      if (codec)
+      {
+        video = new CVideoStage(codec, m_video);
+        video->m_queue.SetMaxDataSize(40 * 1024 * 1024);
+        video->m_queue.SetMaxTimeSize(8.0);
+        videoId = stream->iId;
+      }
+    }
+    else if (stream->type == STREAM_AUDIO && m_options.audio && audio == NULL)
+    {
+      CDVDAudioCodec *codec = CDVDFactoryCodec::OpenCodec(new CDVDAudioCodecFFmpeg(), hint, options);
+      if (codec)
+      {
+        audio = new CAudioStage(codec, m_audio, m_audioOutput);
+        audio->m_queue.SetMaxDataSize(6 * 1024 * 1024);
+        audio->m_queue.SetMaxTimeSize(8.0);
+        audioId = stream->iId;
+      }
+    }
+  }
+
+  if (video == NULL && audio == NULL)
+  {
+    fprintf(stderr, "no stream of %s could be decoded\n", m_options.file.c_str());
+    delete demux;
+    delete input;
+    return false;
+  }
+
+  int64_t processCpu = ProcessCpuTime();
+  int64_t start = CurrentHostCounter();
+  if (video)
+    video->Create();
+  if (audio)
+    audio->Create();
+
+  bool success = true;
+  double firstPts = DVD_NOPTS_VALUE;
+  while (true)
+  {
+    int64_t demuxStart = CurrentHostCounter();
+    int64_t demuxCpu = ThreadCpuTime();
+    DemuxPacket *packet = demux->Read();
+    m_demux.wallTime += ElapsedTime(demuxStart);
+    m_demux.cpuTime += ThreadCpuTime() - demuxCpu;
+
+    if (packet == NULL)
+      break;
+
+    m_demux.packets++;
+    m_demux.bytes += packet->iSize;
+
+    double pts = packet->dts != DVD_NOPTS_VALUE ? packet->dts : packet->pts;
+    if (pts != DVD_NOPTS_VALUE)
+    {
+      if (firstPts == DVD_NOPTS_VALUE)
+        firstPts = pts;
+      m_mediaTime = std::max(m_mediaTime, (pts - firstPts) / DVD_TIME_BASE);
+    }
+
+    CDecodeStage *stage = NULL;
+    if (video && packet->iStreamId == videoId)
+      stage = video;
+    else if (audio && packet->iStreamId == audioId)
+      stage = audio;
+
+    if (stage == NULL)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      continue;
+    }
+
+    // wait for room like CDVDPlayer does, sampling the queue levels as we go
+    int64_t waitStart = CurrentHostCounter();
+    while (stage->m_queue.IsFull() && ElapsedTime(waitStart) < STAGE_TIMEOUT * 1000)
+      Sleep(1);
+    if (stage->m_queue.IsFull())
+    {
+      fprintf(stderr, "%s didn't take a packet within %d s\n", stage == video ? "video decoder" : "audio decoder", STAGE_TIMEOUT / 1000);
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      success = false;
+      break;
+    }
+    stage->m_queue.Put(new CDVDMsgDemuxerPacket(packet));
+    m_demux.frames++;
+
+    if (video)
+      SampleQueue(m_video, video->m_queue.GetLevel());
+    if (audio)
+      SampleQueue(m_audio, audio->m_queue.GetLevel());
+
+    if (m_options.seconds > 0 && m_mediaTime >= m_options.seconds)
+      break;
+  }
+
+  CDecodeStage *stages[] = { video, audio };
+  const char *names[] = { "video decoder", "audio decoder" };
+  for (unsigned int i = 0; i < sizeof(stages) / sizeof(stages[0]); i++)
+  {
+    if (stages[i] == NULL)
+      continue;
+    stages[i]->m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  }
+  for (unsigned int i = 0; i < sizeof(stages) / sizeof(stages[0]); i++)
+  {
+    if (stages[i] == NULL)
+      continue;
+    // let the stage work through its queue before stopping it
+    if (!stages[i]->WaitForThreadExit(STAGE_TIMEOUT))
+    {
+      fprintf(stderr, "%s didn't finish within %d s\n", names[i], STAGE_TIMEOUT / 1000);
+      success = false;
+    }
+    stages[i]->StopThread(false);
+    stages[i]->m_queue.Abort();
+    if (!stages[i]->WaitForThreadExit(STAGE_TIMEOUT))
+    {
+      // still stuck in the codec, leak the stage rather than delete a running thread
+      fprintf(stderr, "%s is stuck, giving up on it\n", names[i]);
+      stages[i] = NULL;
+      continue;
+    }
+    stages[i]->m_queue.End();
+  }
+
+  m_elapsed = ElapsedTime(start);
+  m_processCpuTime = ProcessCpuTime() - processCpu;
+
+  delete stages[0];
+  delete stages[1];
+  delete demux;
+  delete input;
+  return success;
+}
+
+static void PrintStage(FILE *out, const char *name, const CPlaybackBenchmark::Stage &stats, int64_t elapsed, const char *unit)
+{
+  fprintf(out, "%-12s %10" PRIu64 " packets %10.1f MB %12" PRIu64 " %-8s %5" PRIu64 " errors  wall %8.1f ms (%5.1f%%)  cpu %8.1f ms (%5.1f%%)",
+          name, stats.packets, stats.bytes / (1024.0 * 1024.0), stats.frames, unit, stats.errors,
+          stats.wallTime / 1000.0, elapsed > 0 ? 100.0 * stats.wallTime / elapsed : 0.0,
+          stats.cpuTime / 1000.0, elapsed > 0 ? 100.0 * stats.cpuTime / elapsed : 0.0);
+  if (stats.queueSamples > 0)
+    fprintf(out, "  queue avg %3d%% max %3d%%", (int)(stats.queueLevel / stats.queueSamples), stats.queueMax);
+  fprintf(out, "\n");
+}
+
+void CPlaybackBenchmark::PrintReport(FILE *out, int64_t allocations, const char *counted) const
+{
+  double seconds = m_elapsed / 1000000.0;
+
+  fprintf(out, "file:        %s\n", m_options.file.c_str());
+  fprintf(out, "media:       %.2f s decoded in %.2f s (%.1fx realtime)\n",
+          m_mediaTime, seconds, seconds > 0.0 ? m_mediaTime / seconds : 0.0);
+  fprintf(out, "process cpu: %.1f ms (%.1f%% of one core)\n",
+          m_processCpuTime / 1000.0, m_elapsed > 0 ? 100.0 * m_processCpuTime / m_elapsed : 0.0);
+
+  PrintStage(out, "demux", m_demux, m_elapsed, "queued");
+  if (m_options.video)
+    PrintStage(out, "video", m_video, m_elapsed, "pictures");
+  if (m_options.audio)
+  {
+    PrintStage(out, "audio", m_audio, m_elapsed, "frames");
+    PrintStage(out, "audio out", m_audioOutput, m_elapsed, "frames");
+  }
+
+  if (m_video.frames > 0)
+    fprintf(out, "video fps:   %.1f\n", seconds > 0.0 ? m_video.frames / seconds : 0.0);
+
+  if (allocations >= 0)
+  {
+    fprintf(out, "allocations: %" PRId64, allocations);
+    if (m_video.frames > 0)
+      fprintf(out, " (%.1f per picture)", (double)allocations / m_video.frames);
+    else if (m_demux.packets > 0)
+      fprintf(out, " (%.1f per packet)", (double)allocations / m_demux.packets);
+    if (counted)
+      fprintf(out, " [%s]", counted);
+    fprintf(out, "\n");
+  }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+
+#include "cores/dvdplayer/DVDMessageQueue.h"
+#include "threads/Thread.h"
+
+class CDVDAudioCodec;
+class CDVDVideoCodec;
+class IAEStream;
+
+/*!
+ \brief Plays a file as fast as possible without any output, to measure demuxing and decoding throughput.
+
+ The file is demuxed on the calling thread. Video and audio packets are passed
+ through message queues, just like CDVDPlayer does, to a video stage decoding
+ with CDVDVideoCodecFFmpeg into a null renderer and an audio stage decoding
+ with CDVDAudioCodecFFmpeg into an ActiveAE stream. There is no clock, every
+ stage runs as fast as it can.
+ */
+class CPlaybackBenchmark
+{
+public:
+  typedef struct Options
+  {
+    Options() : video(true), audio(true), seconds(0) { }
+    std::string file;
+    bool video;       // decode the first video stream
+    bool audio;       // decode the first audio stream and play it into the audio engine
+    int seconds;      // stop after that many seconds of media, 0 for the whole file
+  } Options;
+
+  typedef struct Stage
+  {
+    Stage() : packets(0), bytes(0), frames(0), errors(0), wallTime(0), cpuTime(0),
+              queueSamples(0), queueLevel(0), queueMax(0) { }
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t frames;      // pictures, audio frames or packets depending on the stage
+    uint64_t errors;
+    int64_t wallTime;     // time spent working, in microseconds
+    int64_t cpuTime;      // cpu time of the stage's thread, in microseconds
+    uint64_t queueSamples;
+    uint64_t queueLevel;  // sum of the sampled queue levels
+    int queueMax;
+  } Stage;
+
+  explicit CPlaybackBenchmark(const Options &options);
+  ~CPlaybackBenchmark();
+
+  /*!
+   \brief Run the benchmark.
+   \return false if the file could not be opened, no stream could be decoded
+           or a decoder got stuck
+   */
+  bool Run();
+
+  /*!
+   \brief Print the results of the last run.
+   \param allocations number of heap allocations during the run, if they have been counted
+   \param counted which allocations have been counted, printed along with the number
+   */
+  void PrintReport(FILE *out, int64_t allocations = -1, const char *counted = NULL) const;
+
+private:
+  class CDecodeStage : public CThread
+  {
+  public:
+    CDecodeStage(const char *name, Stage &stats);
+    virtual ~CDecodeStage() { }
+    CDVDMessageQueue m_queue;
+  protected:
+    virtual void Process();
+    virtual void decode(DemuxPacket *packet) = 0;
+    virtual void flush() { }
+    Stage &m_stats;
+  };
+
+  class CVideoStage : public CDecodeStage
+  {
+  public:
+    CVideoStage(CDVDVideoCodec *codec, Stage &stats);
+    virtual ~CVideoStage();
+  protected:
+    virtual void decode(DemuxPacket *packet);
+    virtual void flush();
+  private:
+    void output(int state);
+    CDVDVideoCodec *m_codec;
+  };
+
+  class CAudioStage : public CDecodeStage
+  {
+  public:
+    CAudioStage(CDVDAudioCodec *codec, Stage &stats, Stage &output);
+    virtual ~CAudioStage();
+  protected:
+    virtual void decode(DemuxPacket *packet);
+    virtual void flush();
+  private:
+    CDVDAudioCodec *m_codec;
+    IAEStream *m_stream;
+    Stage &m_output;
+  };
+
+  static int64_t ThreadCpuTime();
+
+  Options m_options;
+  Stage m_demux;
+  Stage m_video;
+  Stage m_audio;
+  Stage m_audioOutput;
+  double m_mediaTime; // seconds of media processed
+  int64_t m_elapsed;  // microseconds
+  int64_t m_processCpuTime;
+};
@@ -0,0 +1,189 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#include "PlatformDefs.h"
+#include "VariantBenchmark.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+static int64_t ElapsedTime(int64_t start)
+{
+  return (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency();
+}
+
+static CVariant CreateMovie(int id)
+{
+  CVariant movie(CVariant::VariantTypeObject);
+  movie["movieid"] = id;
+  movie["label"] = StringUtils::Format("Movie %d", id);
+  movie["title"] = StringUtils::Format("Movie %d", id);
+  movie["file"] = StringUtils::Format("smb://server/movies/Movie %d (2015)/Movie %d (2015).mkv", id, id);
+  movie["plot"] = "A long plot outline that is about as long as the ones scrapers return for "
+                  "an average movie, so strings are not small enough to fit in a short buffer.";
+  movie["year"] = 1950 + id % 65;
+  movie["rating"] = (id % 100) / 10.0;
+  movie["playcount"] = id % 3;
+  movie["runtime"] = 5400 + id % 1800;
+
+  CVariant genres(CVariant::VariantTypeArray);
+  genres.push_back("Action");
+  genres.push_back("Drama");
+  movie["genre"] = genres;
+
+  CVariant cast(CVariant::VariantTypeArray);
+  for (int actor = 0; actor < 5; actor++)
+  {
+    CVariant member(CVariant::VariantTypeObject);
+    member["name"] = StringUtils::Format("Actor %d", (id + actor) % 500);
+    member["role"] = StringUtils::Format("Role %d", actor);
+    member["order"] = actor;
+    cast.push_back(member);
+  }
+  movie["cast"] = cast;
+
+  CVariant &art = movie["art"];
+  art["poster"] = StringUtils::Format("image://smb%%3a%%2f%%2fserver%%2fmovies%%2fMovie%%20%d%%2fposter.jpg/", id);
+  art["fanart"] = StringUtils::Format("image://smb%%3a%%2f%%2fserver%%2fmovies%%2fMovie%%20%d%%2ffanart.jpg/", id);
+
+  // like CFileItemHandler::HandleFileItem before appending the item
+  movie.makeShareable();
+  return movie;
+}
+
+CVariantBenchmark::CVariantBenchmark(const Options &options)
+  : m_options(options),
+    m_jsonSize(0)
+{ }
+
+void CVariantBenchmark::Begin(Phase &phase, int64_t &start) const
+{
+  phase.allocations = m_options.allocations ? *m_options.allocations : 0;
+  start = CurrentHostCounter();
+}
+
+void CVariantBenchmark::End(Phase &phase, int64_t start) const
+{
+  phase.time = ElapsedTime(start);
+  phase.allocations = m_options.allocations ? *m_options.allocations - phase.allocations : 0;
+}
+
+bool CVariantBenchmark::Run()
+{
+  int64_t start;
+  bool success = true;
+
+  Begin(m_build, start);
+  CVariant result(CVariant::VariantTypeObject);
+  CVariant &movies = result["movies"];
+  movies = CVariant(CVariant::VariantTypeArray);
+  for (int id = 0; id < m_options.items; id++)
+    movies.push_back(CreateMovie(id + 1));
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = m_options.items;
+  result["limits"]["total"] = m_options.items;
+  End(m_build, start);
+
+  std::vector<CVariant> copies;
+  copies.reserve(m_options.copies);
+
+  // copies of the tree as the method left it, its containers built through references get copied
+  Begin(m_copyBuilt, start);
+  for (int copy = 0; copy < m_options.copies; copy++)
+    copies.push_back(result);
+  End(m_copyBuilt, start);
+  copies.clear();
+
+  // what CJSONRPC::HandleMethodCall does once the method has returned
+  Begin(m_share, start);
+  result.makeShareable();
+  End(m_share, start);
+
+  Begin(m_copy, start);
+  for (int copy = 0; copy < m_options.copies; copy++)
+    copies.push_back(result);
+  End(m_copy, start);
+
+  Begin(m_modify, start);
+  for (int copy = 0; copy < m_options.copies; copy++)
+  {
+    if (m_options.items > 0)
+      copies[copy]["movies"][copy % m_options.items]["playcount"] = copy;
+  }
+  End(m_modify, start);
+
+  for (int copy = 0; copy < m_options.copies; copy++)
+  {
+    if (m_options.items > 0 && copies[copy]["movies"][copy % m_options.items]["playcount"].asInteger() != copy)
+      success = false;
+  }
+  copies.clear();
+
+  Begin(m_write, start);
+  std::string json = CJSONVariantWriter::Write(result, true);
+  End(m_write, start);
+  m_jsonSize = json.size();
+
+  Begin(m_parse, start);
+  CVariant parsed = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+  End(m_parse, start);
+
+  const CVariant &response = result;
+  if (parsed["movies"].size() != response["movies"].size() ||
+      (m_options.items > 0 && parsed["movies"][0]["title"] != response["movies"][0]["title"]))
+    success = false;
+
+  return success;
+}
+
+void CVariantBenchmark::PrintReport(FILE *out) const
+{
+  const struct
+  {
+    const char *name;
+    const Phase *phase;
+    int count;
+  } phases[] = {
+    { "build tree:    ", &m_build,     1 },
+    { "copy as built: ", &m_copyBuilt, m_options.copies },
+    { "make shareable:", &m_share,     1 },
+    { "copy shared:   ", &m_copy,      m_options.copies },
+    { "modify copy:   ", &m_modify,    m_options.copies },
+    { "write json:    ", &m_write,     1 },
+    { "parse json:    ", &m_parse,     1 },
+  };
+
+  fprintf(out, "items:          %d\n", m_options.items);
+  fprintf(out, "copies:         %d\n", m_options.copies);
+  fprintf(out, "json size:      %u bytes\n", (unsigned int)m_jsonSize);
+  for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++)
+  {
+    const Phase &phase = *phases[i].phase;
+    int count = phases[i].count > 0 ? phases[i].count : 1;
+    fprintf(out, "%s%" PRId64 " us (%.3f us each)", phases[i].name, phase.time, (double)phase.time / count);
+    if (m_options.allocations)
+      fprintf(out, ", %" PRId64 " allocations (%.1f each)", phase.allocations, (double)phase.allocations / count);
+    fprintf(out, "\n");
+  }
+}
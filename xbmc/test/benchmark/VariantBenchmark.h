@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*!
+ \brief Measures the cost of copying, serializing and parsing CVariant trees.
+
+ A tree shaped like a JSON-RPC VideoLibrary.GetMovies response is built through
+ non-const references, the way the JSON-RPC methods build their results. It is
+ copied a number of times as it was built, and again after makeShareable(), like
+ the JSON-RPC and announcement code hands results around. A second pass modifies
+ one item of every copy so the cost of unsharing a part of the tree shows up as
+ well. Finally the tree is written to JSON and parsed back.
+ */
+class CVariantBenchmark
+{
+public:
+  typedef struct Options
+  {
+    Options() : items(1000), copies(100), allocations(NULL) { }
+    int items;                          // number of movies in the response
+    int copies;                         // copies made of the response
+    const volatile long *allocations;   // heap allocation counter, NULL if allocations aren't counted
+  } Options;
+
+  explicit CVariantBenchmark(const Options &options);
+
+  /*!
+   \brief Run the benchmark.
+   \return false if a copy or the parsed tree differs from the original
+   */
+  bool Run();
+
+  /*!
+   \brief Print the results of the last run.
+   */
+  void PrintReport(FILE *out) const;
+
+private:
+  typedef struct Phase
+  {
+    Phase() : time(0), allocations(0) { }
+    int64_t time;         // microseconds
+    int64_t allocations;
+  } Phase;
+
+  void Begin(Phase &phase, int64_t &start) const;
+  void End(Phase &phase, int64_t start) const;
+
+  Options m_options;
+  size_t m_jsonSize;
+  Phase m_build;
+  Phase m_copyBuilt;
+  Phase m_share;
+  Phase m_copy;
+  Phase m_modify;
+  Phase m_write;
+  Phase m_parse;
+};
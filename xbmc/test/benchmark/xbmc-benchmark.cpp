@@ -0,0 +1,260 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+
+#include "ChannelLookupBenchmark.h"
+#include "PlaybackBenchmark.h"
+#include "VariantBenchmark.h"
+#include "commons/ilog.h"
+#include "cores/AudioEngine/AEFactory.h"
+#include "cores/FFmpeg.h"
+#include "filesystem/SpecialProtocol.h"
+#include "powermanagement/PowerManager.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/Settings.h"
+#include "threads/Atomics.h"
+#include "threads/Thread.h"
+
+class NullLogger : public XbmcCommons::ILogger
+{
+public:
+  void log(int loglevel, const char* message) {}
+};
+
+// count every heap allocation while the benchmark runs
+static volatile long g_allocations = 0;
+static volatile long g_countAllocations = 0;
+
+static inline void CountAllocation()
+{
+  if (g_countAllocations)
+    AtomicIncrement(&g_allocations);
+}
+
+#if defined(__GLIBC__)
+// replace malloc itself, so the buffers ffmpeg gets from av_malloc are counted as
+// well as everything allocated through operator new
+#define ALLOCATIONS_COUNTED "all heap allocations"
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+
+void *malloc(size_t size) throw()
+{
+  CountAllocation();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) throw()
+{
+  CountAllocation();
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) throw()
+{
+  if (ptr == NULL)
+    CountAllocation();
+  return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) throw()
+{
+  CountAllocation();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) throw()
+{
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+  CountAllocation();
+  void *p = __libc_memalign(alignment, size);
+  if (p == NULL)
+    return ENOMEM;
+  *ptr = p;
+  return 0;
+}
+}
+#else
+// only what goes through operator new is seen, not the buffers allocated by ffmpeg
+#define ALLOCATIONS_COUNTED "C++ allocations only"
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+  CountAllocation();
+  void *ptr = malloc(size ? size : 1);
+  if (ptr == NULL)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) throw()
+{
+  free(ptr);
+}
+
+void operator delete[](void *ptr) throw()
+{
+  free(ptr);
+}
+#endif
+
+static void Usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [--no-video] [--no-audio] [--seconds N] file\n", name);
+  fprintf(stderr, "       %s --channels N [--tags N] [--clients N]\n", name);
+  fprintf(stderr, "       %s --variant N [--copies N]\n", name);
+  exit(EXIT_FAILURE);
+}
+
+static int RunChannelLookupBenchmark(const CChannelLookupBenchmark::Options &options)
+{
+  NullLogger* nullLogger = new NullLogger();
+  CThread::SetLogger(nullLogger);
+
+  CChannelLookupBenchmark benchmark(options);
+  bool success = benchmark.Run();
+  benchmark.PrintReport(stdout);
+  if (!success)
+    fprintf(stderr, "lookups returned wrong channels\n");
+
+  delete nullLogger;
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int RunVariantBenchmark(CVariantBenchmark::Options options)
+{
+  options.allocations = &g_allocations;
+
+  CVariantBenchmark benchmark(options);
+  g_countAllocations = 1;
+  bool success = benchmark.Run();
+  g_countAllocations = 0;
+  benchmark.PrintReport(stdout);
+  if (!success)
+    fprintf(stderr, "copies or parsed tree differ from the original\n");
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char **argv)
+{
+  CPlaybackBenchmark::Options options;
+  CChannelLookupBenchmark::Options channelOptions;
+  CVariantBenchmark::Options variantOptions;
+  bool channels = false;
+  bool variant = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--channels") == 0 && i + 1 < argc)
+    {
+      channels = true;
+      channelOptions.channels = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--tags") == 0 && i + 1 < argc)
+      channelOptions.tags = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc)
+      channelOptions.clients = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--variant") == 0 && i + 1 < argc)
+    {
+      variant = true;
+      variantOptions.items = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--copies") == 0 && i + 1 < argc)
+      variantOptions.copies = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--no-video") == 0)
+      options.video = false;
+    else if (strcmp(argv[i], "--no-audio") == 0)
+      options.audio = false;
+    else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+      options.seconds = atoi(argv[++i]);
+    else if (argv[i][0] == '-' || !options.file.empty())
+      Usage(argv[0]);
+    else
+      options.file = argv[i];
+  }
+  if (channels)
+    return RunChannelLookupBenchmark(channelOptions);
+  if (variant)
+    return RunVariantBenchmark(variantOptions);
+  if (options.file.empty() || (!options.video && !options.audio))
+    Usage(argv[0]);
+
+  // we need to configure CThread to use a dummy logger
+  NullLogger* nullLogger = new NullLogger();
+  CThread::SetLogger(nullLogger);
+
+  g_advancedSettings.Initialize();
+  g_powerManager.Initialize();
+  CSettings::Get().Initialize();
+
+  char buf[] = "/tmp/xbmcbenchmarkXXXXXX";
+  char *tmp = mkdtemp(buf);
+  if (tmp == NULL)
+  {
+    fprintf(stderr, "unable to create a temporary directory\n");
+    return EXIT_FAILURE;
+  }
+  CSpecialProtocol::SetTempPath(tmp);
+
+  av_lockmgr_register(&ffmpeg_lockmgr_cb);
+  avcodec_register_all();
+  av_register_all();
+
+  // a sink that does not play at realtime so audio never throttles decoding
+  CSettings::Get().SetString("audiooutput.audiodevice", "NULL:unthrottled");
+  if (options.audio && (!CAEFactory::LoadEngine() || !CAEFactory::StartEngine()))
+  {
+    fprintf(stderr, "unable to start the audio engine\n");
+    options.audio = false;
+  }
+
+  CPlaybackBenchmark benchmark(options);
+  g_countAllocations = 1;
+  bool success = benchmark.Run();
+  g_countAllocations = 0;
+
+  if (success)
+    benchmark.PrintReport(stdout, g_allocations, ALLOCATIONS_COUNTED);
+
+  if (options.audio)
+    CAEFactory::UnLoadEngine();
+  av_lockmgr_register(NULL);
+  rmdir(tmp);
+
+  delete nullLogger;
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
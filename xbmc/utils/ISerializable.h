@@ -19,11 +19,35 @@
  *
  */
 
+#include <set>
+#include <string>
+
 class CVariant;
 
 class ISerializable
 {
 public:
   virtual void Serialize(CVariant& value) const = 0;
+
+  /*!
+   \brief Serialize only the given fields.
+
+   Serializing everything only to pick a few values out of it is expensive
+   for big objects, so they should override this and skip the fields that
+   haven't been asked for. Fields that aren't known are ignored.
+   \param value variant to serialize into
+   \param fields names of the fields to serialize
+   */
+  virtual void SerializeFields(CVariant& value, const std::set<std::string>& fields) const { Serialize(value); }
+
   virtual ~ISerializable() {}
+
+protected:
+  /*!
+   \brief Whether a field has to be serialized, NULL meaning all of them.
+   */
+  static bool IsRequested(const std::set<std::string> *fields, const char *field)
+  {
+    return fields == NULL || fields->find(field) != fields->end();
+  }
 };
@@ -0,0 +1,209 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "InitGraph.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+#include "utils/StartupProfiler.h"
+#include "utils/StringUtils.h"
+
+class CInitGraph::CRunner : public IRunnable
+{
+public:
+  CRunner(CInitGraph &graph, Node &node) : m_graph(graph), m_node(node) { }
+  virtual void Run() { m_graph.execute(m_node); }
+private:
+  CInitGraph &m_graph;
+  Node &m_node;
+};
+
+CInitGraph::CInitGraph(const std::string &name)
+  : m_name(name)
+{ }
+
+CInitGraph::~CInitGraph()
+{
+  for (std::vector<Node>::iterator it = m_nodes.begin(); it != m_nodes.end(); ++it)
+    delete it->task;
+}
+
+void CInitGraph::addTask(CTask *task, const std::string &dependencies, bool callingThread)
+{
+  Node node;
+  node.task = task;
+  node.callingThread = callingThread;
+  node.state = TaskPending;
+
+  std::vector<std::string> names = StringUtils::Split(dependencies, ",");
+  for (std::vector<std::string>::iterator it = names.begin(); it != names.end(); ++it)
+  {
+    StringUtils::Trim(*it);
+    if (!it->empty())
+      node.dependencies.push_back(*it);
+  }
+
+  m_nodes.push_back(node);
+}
+
+bool CInitGraph::Run()
+{
+  std::vector<CThread*> threads;
+  std::vector<CRunner*> runners;
+  bool success = true;
+
+  while (true)
+  {
+    Node *next = NULL;
+    bool waiting = false;
+    bool running = false;
+    {
+      CSingleLock lock(m_critical);
+      for (std::vector<Node>::iterator node = m_nodes.begin(); node != m_nodes.end(); ++node)
+      {
+        if (node->state == TaskRunning)
+          running = true;
+        if (node->state != TaskPending)
+          continue;
+
+        bool ready = true;
+        bool skip = false;
+        for (std::vector<std::string>::const_iterator dependency = node->dependencies.begin(); dependency != node->dependencies.end(); ++dependency)
+        {
+          TaskState state = getState(*dependency);
+          if (state == TaskFailed || state == TaskSkipped)
+            skip = true;
+          else if (state != TaskDone)
+            ready = false;
+        }
+
+        if (skip)
+        {
+          CLog::Log(LOGERROR, "CInitGraph(%s): skipping %s because a dependency failed", m_name.c_str(), node->task->GetName().c_str());
+          node->state = TaskSkipped;
+          success = false;
+          continue;
+        }
+
+        waiting = true;
+        if (!ready)
+          continue;
+
+        if (node->callingThread)
+        {
+          if (next == NULL)
+          {
+            node->state = TaskRunning;
+            next = &(*node);
+          }
+          continue;
+        }
+
+        node->state = TaskRunning;
+        running = true;
+        CRunner *runner = new CRunner(*this, *node);
+        CThread *thread = new CThread(runner, ("InitGraph " + node->task->GetName()).c_str());
+        runners.push_back(runner);
+        threads.push_back(thread);
+        thread->Create();
+      }
+    }
+
+    if (next != NULL)
+    {
+      execute(*next);
+      continue;
+    }
+
+    if (!waiting && !running)
+      break;
+
+    // nothing can make progress anymore
+    if (!running)
+    {
+      CLog::Log(LOGERROR, "CInitGraph(%s): circular dependencies detected", m_name.c_str());
+      CSingleLock lock(m_critical);
+      for (std::vector<Node>::iterator node = m_nodes.begin(); node != m_nodes.end(); ++node)
+      {
+        if (node->state == TaskPending)
+          node->state = TaskSkipped;
+      }
+      break;
+    }
+
+    m_changed.Wait();
+  }
+
+  for (unsigned int i = 0; i < threads.size(); i++)
+  {
+    threads[i]->StopThread(true);
+    delete threads[i];
+    delete runners[i];
+  }
+
+  for (std::vector<Node>::const_iterator node = m_nodes.begin(); node != m_nodes.end(); ++node)
+  {
+    if (node->state != TaskDone)
+      success = false;
+  }
+
+  return success;
+}
+
+CInitGraph::TaskState CInitGraph::getState(const std::string &name) const
+{
+  for (std::vector<Node>::const_iterator node = m_nodes.begin(); node != m_nodes.end(); ++node)
+  {
+    if (node->task->GetName() == name)
+      return node->state;
+  }
+
+  CLog::Log(LOGERROR, "CInitGraph(%s): unknown dependency %s", m_name.c_str(), name.c_str());
+  return TaskFailed;
+}
+
+bool CInitGraph::execute(Node &node)
+{
+  bool success = false;
+  {
+    CStartupPhase phase(node.task->GetName());
+    try
+    {
+      success = node.task->Execute();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "CInitGraph(%s): exception in %s", m_name.c_str(), node.task->GetName().c_str());
+    }
+  }
+
+  if (!success)
+    CLog::Log(LOGERROR, "CInitGraph(%s): %s failed", m_name.c_str(), node.task->GetName().c_str());
+
+  finish(node, success);
+  return success;
+}
+
+void CInitGraph::finish(Node &node, bool success)
+{
+  CSingleLock lock(m_critical);
+  node.state = success ? TaskDone : TaskFailed;
+  m_changed.Set();
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+/*!
+ \brief Runs initialization tasks respecting their dependencies.
+
+ Each task names the tasks it depends on. A task is started as soon as all of
+ its dependencies have finished successfully, so independent tasks run
+ concurrently on their own threads. Tasks that have to run on the calling
+ thread (e.g. because they need the rendering context) can be flagged as such.
+
+ If a task fails, all tasks depending on it are skipped. Every task is recorded
+ as a phase in the CStartupProfiler.
+
+ \code
+ CInitGraph graph("startup");
+ graph.AddTask("textures", this, &CFoo::InitTextures);
+ graph.AddTask("video", this, &CFoo::InitVideo, "textures");
+ graph.AddTask("skin", this, &CFoo::LoadSkin, "", true);
+ bool success = graph.Run();
+ \endcode
+ */
+class CInitGraph
+{
+public:
+  typedef bool (*TaskFunction)(void *data);
+
+  explicit CInitGraph(const std::string &name);
+  ~CInitGraph();
+
+  /*!
+   \brief Add a task calling a function.
+   \param name unique name of the task
+   \param function the function to call
+   \param data passed to the function
+   \param dependencies comma separated list of tasks that have to finish before this one
+   \param callingThread whether the task has to run on the thread calling Run()
+   */
+  void AddTask(const std::string &name, TaskFunction function, void *data,
+               const std::string &dependencies = "", bool callingThread = false)
+  {
+    addTask(new CFunctionTask(name, function, data), dependencies, callingThread);
+  }
+
+  /*!
+   \brief Add a task calling a method of an object.
+   \sa AddTask
+   */
+  template<class T>
+  void AddTask(const std::string &name, T *object, bool (T::*method)(),
+               const std::string &dependencies = "", bool callingThread = false)
+  {
+    addTask(new CMethodTask<T>(name, object, method), dependencies, callingThread);
+  }
+
+  /*!
+   \brief Run all tasks and wait for them to finish.
+   \return true if all tasks ran successfully, false otherwise
+   */
+  bool Run();
+
+private:
+  class CTask
+  {
+  public:
+    explicit CTask(const std::string &name) : m_name(name) { }
+    virtual ~CTask() { }
+    virtual bool Execute() = 0;
+    const std::string& GetName() const { return m_name; }
+  private:
+    std::string m_name;
+  };
+
+  class CFunctionTask : public CTask
+  {
+  public:
+    CFunctionTask(const std::string &name, TaskFunction function, void *data)
+      : CTask(name), m_function(function), m_data(data) { }
+    virtual bool Execute() { return m_function(m_data); }
+  private:
+    TaskFunction m_function;
+    void *m_data;
+  };
+
+  template<class T>
+  class CMethodTask : public CTask
+  {
+  public:
+    CMethodTask(const std::string &name, T *object, bool (T::*method)())
+      : CTask(name), m_object(object), m_method(method) { }
+    virtual bool Execute() { return (m_object->*m_method)(); }
+  private:
+    T *m_object;
+    bool (T::*m_method)();
+  };
+
+  enum TaskState { TaskPending, TaskRunning, TaskDone, TaskFailed, TaskSkipped };
+
+  typedef struct
+  {
+    CTask *task;
+    std::vector<std::string> dependencies;
+    bool callingThread;
+    TaskState state;
+  } Node;
+
+  class CRunner;
+  friend class CRunner;
+
+  void addTask(CTask *task, const std::string &dependencies, bool callingThread);
+  TaskState getState(const std::string &name) const;
+  bool execute(Node &node);
+  void finish(Node &node, bool success);
+
+  std::string m_name;
+  std::vector<Node> m_nodes;
+  CCriticalSection m_critical;
+  CEvent m_changed;
+};
@@ -0,0 +1,195 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iomanip>
+#include <locale>
+#include <sstream>
+
+#include "JSONStreamWriter.h"
+#include "Variant.h"
+
+CJSONStreamWriter::CJSONStreamWriter(IJSONStreamSink &sink, bool compact, size_t chunkSize /* = 16384 */)
+  : m_sink(sink),
+    m_chunkSize(chunkSize),
+    m_failed(false)
+{
+#if YAJL_MAJOR == 2
+  m_gen = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_gen, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_gen, yajl_gen_indent_string, "\t");
+#else
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  m_gen = yajl_gen_alloc(&conf, NULL);
+#endif
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+  yajl_gen_clear(m_gen);
+  yajl_gen_free(m_gen);
+}
+
+bool CJSONStreamWriter::StartObject()
+{
+  return check(yajl_gen_map_open(m_gen)) && flush(m_chunkSize);
+}
+
+bool CJSONStreamWriter::EndObject()
+{
+  return check(yajl_gen_map_close(m_gen)) && flush(m_chunkSize);
+}
+
+bool CJSONStreamWriter::StartArray()
+{
+  return check(yajl_gen_array_open(m_gen)) && flush(m_chunkSize);
+}
+
+bool CJSONStreamWriter::EndArray()
+{
+  return check(yajl_gen_array_close(m_gen)) && flush(m_chunkSize);
+}
+
+bool CJSONStreamWriter::Key(const std::string &key)
+{
+#if YAJL_MAJOR == 2
+  return check(yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), (size_t)key.length()));
+#else
+  return check(yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), key.length()));
+#endif
+}
+
+bool CJSONStreamWriter::Value(const CVariant &value)
+{
+  return write(value) && flush(m_chunkSize);
+}
+
+bool CJSONStreamWriter::Flush()
+{
+  return flush(0);
+}
+
+bool CJSONStreamWriter::write(const CVariant &value)
+{
+  switch (value.type())
+  {
+  case CVariant::VariantTypeInteger:
+#if YAJL_MAJOR == 2
+    return check(yajl_gen_integer(m_gen, (long long int)value.asInteger()));
+#else
+    return check(yajl_gen_integer(m_gen, (long int)value.asInteger()));
+#endif
+  case CVariant::VariantTypeUnsignedInteger:
+#if YAJL_MAJOR == 2
+    return check(yajl_gen_integer(m_gen, (long long int)value.asUnsignedInteger()));
+#else
+    return check(yajl_gen_integer(m_gen, (long int)value.asUnsignedInteger()));
+#endif
+  case CVariant::VariantTypeDouble:
+    return writeDouble(value.asDouble());
+  case CVariant::VariantTypeBoolean:
+    return check(yajl_gen_bool(m_gen, value.asBoolean() ? 1 : 0));
+  case CVariant::VariantTypeString:
+#if YAJL_MAJOR == 2
+    return check(yajl_gen_string(m_gen, (const unsigned char*)value.c_str(), (size_t)value.size()));
+#else
+    return check(yajl_gen_string(m_gen, (const unsigned char*)value.c_str(), value.size()));
+#endif
+  case CVariant::VariantTypeArray:
+    if (!check(yajl_gen_array_open(m_gen)))
+      return false;
+
+    for (CVariant::const_iterator_array itr = value.begin_array(); itr != value.end_array(); ++itr)
+    {
+      // pass on complete chunks while walking through large lists
+      if (!write(*itr) || !flush(m_chunkSize))
+        return false;
+    }
+
+    return check(yajl_gen_array_close(m_gen));
+  case CVariant::VariantTypeObject:
+    if (!check(yajl_gen_map_open(m_gen)))
+      return false;
+
+    for (CVariant::const_iterator_map itr = value.begin_map(); itr != value.end_map(); ++itr)
+    {
+      if (!Key(itr->first) || !write(itr->second) || !flush(m_chunkSize))
+        return false;
+    }
+
+    return check(yajl_gen_map_close(m_gen));
+  case CVariant::VariantTypeConstNull:
+  case CVariant::VariantTypeNull:
+  default:
+    return check(yajl_gen_null(m_gen));
+  }
+}
+
+bool CJSONStreamWriter::writeDouble(double value)
+{
+  // yajl_gen_double() formats the number according to the global locale, which
+  // may use a decimal comma, so format it like yajl does but with the "C" locale
+  if (value != value || value - value != 0.0)
+    return check(yajl_gen_double(m_gen, value)); // NaN and infinity have no decimal point
+
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+#if YAJL_MAJOR == 2
+  stream << std::setprecision(20) << value;
+  std::string number = stream.str();
+  if (number.find_first_not_of("0123456789-") == std::string::npos)
+    number += ".0";
+  return check(yajl_gen_number(m_gen, number.c_str(), (size_t)number.length()));
+#else
+  stream << value;
+  std::string number = stream.str();
+  return check(yajl_gen_number(m_gen, number.c_str(), number.length()));
+#endif
+}
+
+bool CJSONStreamWriter::check(yajl_gen_status status)
+{
+  if (status != yajl_gen_status_ok)
+    m_failed = true;
+
+  return !m_failed;
+}
+
+bool CJSONStreamWriter::flush(size_t threshold)
+{
+  if (m_failed)
+    return false;
+
+  const unsigned char *buffer;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_gen, &buffer, &length);
+
+  if (length == 0 || length < threshold)
+    return true;
+
+  if (!m_sink.Write((const char *)buffer, length))
+    m_failed = true;
+
+  yajl_gen_clear(m_gen);
+  return !m_failed;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "system.h"
+#include <yajl/yajl_gen.h>
+#ifdef HAVE_YAJL_YAJL_VERSION_H
+#include <yajl/yajl_version.h>
+#endif
+
+class CVariant;
+
+/*!
+ \brief Receives the output of a CJSONStreamWriter chunk by chunk.
+ */
+class IJSONStreamSink
+{
+public:
+  virtual ~IJSONStreamSink() { }
+
+  /*!
+   \brief Consume the next chunk of JSON output.
+   \return false to abort writing, e.g. because the receiver went away
+   */
+  virtual bool Write(const char *data, size_t size) = 0;
+};
+
+/*!
+ \brief Generates JSON directly into an IJSONStreamSink.
+
+ Instead of building a complete CVariant and serializing it into one string,
+ the output can be generated value by value and is passed on to the sink
+ whenever more than the configured chunk size has been generated. Single
+ CVariant values (e.g. large result lists) are chunked while they are being
+ written as well, so the amount of buffered output is bounded by the chunk
+ size independent of the size of the generated document.
+
+ \code
+ CJSONStreamWriter writer(sink, true);
+ writer.StartObject();
+ writer.Key("items");
+ writer.Value(items);
+ writer.EndObject();
+ writer.Flush();
+ \endcode
+ */
+class CJSONStreamWriter
+{
+public:
+  CJSONStreamWriter(IJSONStreamSink &sink, bool compact, size_t chunkSize = 16384);
+  ~CJSONStreamWriter();
+
+  bool StartObject();
+  bool EndObject();
+  bool StartArray();
+  bool EndArray();
+  bool Key(const std::string &key);
+  bool Value(const CVariant &value);
+
+  /*!
+   \brief Pass everything generated so far on to the sink.
+   */
+  bool Flush();
+
+  /*!
+   \brief Whether generating or passing on output has failed.
+   */
+  bool HasFailed() const { return m_failed; }
+
+private:
+  CJSONStreamWriter(const CJSONStreamWriter&);
+  CJSONStreamWriter const& operator=(CJSONStreamWriter const&);
+
+  bool write(const CVariant &value);
+  bool writeDouble(double value);
+  bool check(yajl_gen_status status);
+  bool flush(size_t threshold);
+
+  IJSONStreamSink &m_sink;
+  yajl_gen m_gen;
+  size_t m_chunkSize;
+  bool m_failed;
+};
+
+/*!
+ \brief Collects the output of a CJSONStreamWriter in a string.
+ */
+class CJSONStringSink : public IJSONStreamSink
+{
+public:
+  virtual bool Write(const char *data, size_t size) { m_output.append(data, size); return true; }
+
+  std::string& GetOutput() { return m_output; }
+
+private:
+  std::string m_output;
+};
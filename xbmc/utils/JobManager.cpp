@@ -141,7 +141,7 @@ void CJobQueue::AddJob(CJob *job)
 void CJobQueue::QueueNextJob()
 {
   CSingleLock lock(m_section);
-  if (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
+  while (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
   {
     CJobPointer &job = m_jobQueue.back();
     job.m_id = CJobManager::GetInstance().AddJob(job.m_job, this, m_priority);
@@ -166,6 +166,25 @@ bool CJobQueue::QueueEmpty() const
   return m_jobQueue.empty();
 }
 
+size_t CJobQueue::QueueSize() const
+{
+  CSingleLock lock(m_section);
+  return m_jobQueue.size();
+}
+
+bool CJobQueue::IsProcessing() const
+{
+  CSingleLock lock(m_section);
+  return !m_jobQueue.empty() || !m_processing.empty();
+}
+
+void CJobQueue::SetJobsAtOnce(unsigned int jobsAtOnce)
+{
+  CSingleLock lock(m_section);
+  m_jobsAtOnce = std::max(jobsAtOnce, 1U);
+  QueueNextJob();
+}
+
 CJobManager &CJobManager::GetInstance()
 {
   static CJobManager sJobManager;
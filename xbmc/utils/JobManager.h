@@ -135,12 +135,31 @@ public:
    */
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
 
+  /*!
+   \brief Change the number of jobs to process at once.
+   Raising the number immediately starts processing further queued jobs, lowering it lets
+   the jobs currently being processed finish.
+   \param jobsAtOnce number of jobs at once to process.
+   */
+  void SetJobsAtOnce(unsigned int jobsAtOnce);
+
 protected:
   /*!
    \brief Returns if we still have jobs waiting to be processed
    NOTE: This function does not take into account the jobs that are currently processing 
    */
   bool QueueEmpty() const;
+
+  /*!
+   \brief Returns the number of jobs waiting to be processed
+   NOTE: This function does not take into account the jobs that are currently processing
+   */
+  size_t QueueSize() const;
+
+  /*!
+   \brief Returns if any jobs are waiting or being processed
+   */
+  bool IsProcessing() const;
   
 private:
   void QueueNextJob();
@@ -18,12 +18,17 @@
  *
  */
 
+#include "system.h"
 #include <stdlib.h>
 #include <string.h>
 #include <algorithm> 
+#include <map>
 #include "RegExp.h"
 #include "log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/Utf8Utils.h"
 
 using namespace PCRE;
@@ -46,11 +51,51 @@ using namespace PCRE;
 #ifndef PCRE_HAS_JIT_CODE
 #define pcre_free_study(x) pcre_free((x))
 #endif
+// pcre_jit_exec() takes the JIT stack per call, so compiled expressions can be shared between threads
+#if defined(PCRE_HAS_JIT_CODE) && (PCRE_MAJOR > 8 || (PCRE_MAJOR == 8 && PCRE_MINOR >= 32))
+#define PCRE_HAS_JIT_EXEC 1
+#endif
+
+// drop the cached expressions once there are that many of them
+#define REGEXP_CACHE_SIZE 512
 
 int CRegExp::m_Utf8Supported = -1;
 int CRegExp::m_UcpSupported  = -1;
 int CRegExp::m_JitSupported  = -1;
 
+// only collected once enabled, as timing every match isn't free
+static volatile bool s_statisticsEnabled = false;
+static CCriticalSection s_statisticsSection;
+static uint64_t s_compiles    = 0;
+static uint64_t s_cacheHits   = 0;
+static uint64_t s_compileTime = 0;
+static uint64_t s_matches     = 0;
+static uint64_t s_matchTime   = 0;
+
+struct CRegExp::CompiledPattern
+{
+  CompiledPattern() : re(NULL), sd(NULL), jitCompiled(false) { }
+  ~CompiledPattern()
+  {
+    if (sd)
+      pcre_free_study(sd);
+    if (re)
+      pcre_free(re);
+  }
+
+  pcre* re;
+  pcre_extra* sd;
+  bool jitCompiled;
+};
+
+static void AddStatistics(uint64_t &count, uint64_t &time, int64_t start)
+{
+  const uint64_t elapsed = (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency();
+  CSingleLock lock(s_statisticsSection);
+  count++;
+  time += elapsed;
+}
+
 
 CRegExp::CRegExp(bool caseless /*= false*/, CRegExp::utf8Mode utf8 /*= asciiOnly*/)
 {
@@ -244,27 +289,26 @@ CRegExp::CRegExp(const CRegExp& re)
 
 CRegExp& CRegExp::operator=(const CRegExp& re)
 {
-  size_t size;
+  if (this == &re)
+    return *this;
+
   Cleanup();
   m_jitCompiled = false;
   m_pattern = re.m_pattern;
-  if (re.m_re)
+  if (re.m_compiled)
   {
-    if (pcre_fullinfo(re.m_re, NULL, PCRE_INFO_SIZE, &size) >= 0)
-    {
-      if ((m_re = (pcre*)malloc(size)))
-      {
-        memcpy(m_re, re.m_re, size);
-        memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
-        m_offset = re.m_offset;
-        m_iMatchCount = re.m_iMatchCount;
-        m_bMatched = re.m_bMatched;
-        m_subject = re.m_subject;
-        m_iOptions = re.m_iOptions;
-      }
-      else
-        CLog::Log(LOGSEVERE, "%s: Failed to allocate memory", __FUNCTION__);
-    }
+    // the compiled expression is immutable, so it's shared instead of copied
+    m_compiled = re.m_compiled;
+    m_re = m_compiled->re;
+    m_sd = m_compiled->sd;
+    m_jitCompiled = m_compiled->jitCompiled;
+    memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
+    m_offset = re.m_offset;
+    m_iMatchCount = re.m_iMatchCount;
+    m_bMatched = re.m_bMatched;
+    m_subject = re.m_subject;
+    m_iOptions = re.m_iOptions;
+    m_utf8Mode = re.m_utf8Mode;
   }
   return *this;
 }
@@ -283,48 +327,91 @@ bool CRegExp::RegComp(const char *re, studyMode study /*= NoStudy*/)
   m_jitCompiled      = false;
   m_bMatched         = false;
   m_iMatchCount      = 0;
-  const char *errMsg = NULL;
-  int errOffset      = 0;
   int options        = m_iOptions;
   if (m_utf8Mode == autoUtf8 && requireUtf8(re))
     options |= (IsUtf8Supported() ? PCRE_UTF8 : 0) | (AreUnicodePropertiesSupported() ? PCRE_UCP : 0);
 
   Cleanup();
 
-  m_re = pcre_compile(re, options, &errMsg, &errOffset, NULL);
-  if (!m_re)
+  m_compiled = GetCompiledPattern(re, options, study);
+  if (!m_compiled)
   {
     m_pattern.clear();
-    CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
-              errMsg, errOffset, re);
     return false;
   }
 
+  m_re = m_compiled->re;
+  m_sd = m_compiled->sd;
+  m_jitCompiled = m_compiled->jitCompiled;
   m_pattern = re;
 
+  return true;
+}
+
+boost::shared_ptr<CRegExp::CompiledPattern> CRegExp::GetCompiledPattern(const char *re, int options, studyMode study)
+{
+  static CCriticalSection cacheSection;
+  static std::map<std::string, boost::shared_ptr<CompiledPattern> > cache;
+
+  const std::string key = StringUtils::Format("%x:%d:", options, (int)study) + re;
+
+  CSingleLock lock(cacheSection);
+  std::map<std::string, boost::shared_ptr<CompiledPattern> >::const_iterator it = cache.find(key);
+  if (it != cache.end())
+  {
+    if (s_statisticsEnabled)
+    {
+      CSingleLock statisticsLock(s_statisticsSection);
+      s_cacheHits++;
+    }
+    return it->second;
+  }
+
+  const bool statistics = s_statisticsEnabled;
+  const int64_t start = statistics ? CurrentHostCounter() : 0;
+  const char *errMsg = NULL;
+  int errOffset      = 0;
+
+  boost::shared_ptr<CompiledPattern> compiled(new CompiledPattern);
+  compiled->re = pcre_compile(re, options, &errMsg, &errOffset, NULL);
+  if (!compiled->re)
+  {
+    CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
+              errMsg, errOffset, re);
+    return boost::shared_ptr<CompiledPattern>();
+  }
+
   if (study)
   {
     const bool jitCompile = (study == StudyWithJitComp) && IsJitSupported();
     const int studyOptions = jitCompile ? PCRE_STUDY_JIT_COMPILE : 0;
 
-    m_sd = pcre_study(m_re, studyOptions, &errMsg);
+    compiled->sd = pcre_study(compiled->re, studyOptions, &errMsg);
     if (errMsg != NULL)
     {
       CLog::Log(LOGWARNING, "%s: PCRE error \"%s\" while studying expression", __FUNCTION__, errMsg);
-      if (m_sd != NULL)
+      if (compiled->sd != NULL)
       {
-        pcre_free_study(m_sd);
-        m_sd = NULL;
+        pcre_free_study(compiled->sd);
+        compiled->sd = NULL;
       }
     }
     else if (jitCompile)
     {
       int jitPresent = 0;
-      m_jitCompiled = (pcre_fullinfo(m_re, m_sd, PCRE_INFO_JIT, &jitPresent) == 0 && jitPresent == 1);
+      compiled->jitCompiled = (pcre_fullinfo(compiled->re, compiled->sd, PCRE_INFO_JIT, &jitPresent) == 0 && jitPresent == 1);
     }
   }
 
-  return true;
+  if (cache.size() >= REGEXP_CACHE_SIZE)
+    cache.clear(); // objects still using an expression keep their reference
+
+  cache.insert(std::make_pair(key, compiled));
+
+  if (statistics)
+    AddStatistics(s_compiles, s_compileTime, start);
+
+  return compiled;
 }
 
 int CRegExp::RegFind(const char *str, unsigned int startoffset /*= 0*/, int maxNumberOfCharsToTest /*= -1*/)
@@ -356,22 +443,42 @@ int CRegExp::PrivateRegFind(size_t bufferLen, const char *str, unsigned int star
     return -1;
   }
 
-#ifdef PCRE_HAS_JIT_CODE
+#ifdef PCRE_HAS_JIT_EXEC
   if (m_jitCompiled && !m_jitStack)
   {
     m_jitStack = pcre_jit_stack_alloc(32*1024, 512*1024);
     if (m_jitStack == NULL)
       CLog::Log(LOGWARNING, "%s: can't allocate address space for JIT stack", __FUNCTION__);
-
-    pcre_assign_jit_stack(m_sd, NULL, m_jitStack);
   }
 #endif
 
   if (maxNumberOfCharsToTest >= 0)
     bufferLen = std::min<size_t>(bufferLen, startoffset + maxNumberOfCharsToTest);
 
+  const bool statistics = s_statisticsEnabled;
+  const int64_t start = statistics ? CurrentHostCounter() : 0;
+
   m_subject.assign(str + startoffset, bufferLen - startoffset);
-  int rc = pcre_exec(m_re, NULL, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
+  int rc;
+#ifdef PCRE_HAS_JIT_EXEC
+  if (m_jitCompiled && m_jitStack)
+    rc = pcre_jit_exec(m_re, m_sd, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT, m_jitStack);
+  else
+#endif
+    rc = pcre_exec(m_re, m_sd, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
+
+#ifdef PCRE_ERROR_JIT_STACKLIMIT
+  if (rc == PCRE_ERROR_JIT_STACKLIMIT && m_sd)
+  {
+    // the compiled expression is shared, so fall back to the interpreter on a private copy of the study data
+    pcre_extra extra = *m_sd;
+    extra.flags &= ~PCRE_EXTRA_EXECUTABLE_JIT;
+    rc = pcre_exec(m_re, &extra, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
+  }
+#endif
+
+  if (statistics)
+    AddStatistics(s_matches, s_matchTime, start);
 
   if (rc<1)
   {
@@ -557,17 +664,9 @@ void CRegExp::DumpOvector(int iLog /* = LOGDEBUG */)
 
 void CRegExp::Cleanup()
 {
-  if (m_re)
-  {
-    pcre_free(m_re); 
-    m_re = NULL; 
-  }
-
-  if (m_sd)
-  {
-    pcre_free_study(m_sd);
-    m_sd = NULL;
-  }
+  m_compiled.reset();
+  m_re = NULL;
+  m_sd = NULL;
 
 #ifdef PCRE_HAS_JIT_CODE
   if (m_jitStack)
@@ -647,3 +746,60 @@ bool CRegExp::IsJitSupported(void)
 
   return m_JitSupported == 1;
 }
+
+void CRegExp::EnableStatistics(bool enable)
+{
+  s_statisticsEnabled = enable;
+}
+
+CRegExp::Statistics CRegExp::GetStatistics(void)
+{
+  CSingleLock lock(s_statisticsSection);
+  Statistics statistics;
+  statistics.compiles    = s_compiles;
+  statistics.cacheHits   = s_cacheHits;
+  statistics.compileTime = s_compileTime;
+  statistics.matches     = s_matches;
+  statistics.matchTime   = s_matchTime;
+  return statistics;
+}
+
+void CRegExp::LogStatistics(void)
+{
+  const Statistics statistics = GetStatistics();
+  CLog::Log(LOGDEBUG, "CRegExp: %" PRIu64 " expressions compiled in %.1f ms (%" PRIu64 " served from cache), %" PRIu64 " matches in %.1f ms",
+            statistics.compiles, statistics.compileTime / 1000.0, statistics.cacheHits,
+            statistics.matches, statistics.matchTime / 1000.0);
+}
+
+
+CRegExpList::CRegExpList(bool caseless /* = false */, CRegExp::utf8Mode utf8 /* = CRegExp::asciiOnly */,
+                         CRegExp::studyMode study /* = CRegExp::StudyWithJitComp */)
+  : m_caseless(caseless), m_utf8(utf8), m_study(study)
+{ }
+
+CRegExpList::CRegExpList(const std::vector<std::string>& regexps, bool caseless /* = false */,
+                         CRegExp::utf8Mode utf8 /* = CRegExp::asciiOnly */,
+                         CRegExp::studyMode study /* = CRegExp::StudyWithJitComp */)
+  : m_caseless(caseless), m_utf8(utf8), m_study(study)
+{
+  m_regexps.reserve(regexps.size());
+  for (std::vector<std::string>::const_iterator it = regexps.begin(); it != regexps.end(); ++it)
+    Add(*it);
+}
+
+bool CRegExpList::Add(const std::string& re)
+{
+  m_regexps.push_back(CRegExp(m_caseless, m_utf8));
+  return m_regexps.back().RegComp(re, m_study);
+}
+
+int CRegExpList::Find(const std::string& str, unsigned int first /* = 0 */)
+{
+  for (unsigned int i = first; i < m_regexps.size(); i++)
+  {
+    if (m_regexps[i].IsCompiled() && m_regexps[i].RegFind(str) > -1)
+      return i;
+  }
+  return -1;
+}
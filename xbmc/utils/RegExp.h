@@ -22,9 +22,12 @@
 #ifndef REGEXP_H
 #define REGEXP_H
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 namespace PCRE {
 struct real_pcre_jit_stack; // forward declaration for PCRE without JIT
 typedef struct real_pcre_jit_stack pcre_jit_stack;
@@ -148,7 +151,30 @@ public:
   static bool LogCheckUtf8Support(void);
   static bool IsJitSupported(void);
 
+  /**
+   * Compiled expressions are cached process wide, keyed by the expression and the
+   * compile options, and shared by all CRegExp objects using the same expression.
+   * These counters show how much time is spent compiling vs. matching. They are
+   * only collected while enabled through EnableStatistics().
+   */
+  typedef struct
+  {
+    uint64_t compiles;    // number of expressions compiled
+    uint64_t cacheHits;   // number of compilations served from the cache
+    uint64_t compileTime; // in microseconds
+    uint64_t matches;     // number of RegFind calls
+    uint64_t matchTime;   // in microseconds
+  } Statistics;
+
+  static void EnableStatistics(bool enable);
+  static Statistics GetStatistics(void);
+  static void LogStatistics(void);
+
 private:
+  struct CompiledPattern;
+
+  static boost::shared_ptr<CompiledPattern> GetCompiledPattern(const char *re, int options, studyMode study);
+
   int PrivateRegFind(size_t bufferLen, const char *str, unsigned int startoffset = 0, int maxNumberOfCharsToTest = -1);
   void InitValues(bool caseless = false, CRegExp::utf8Mode utf8 = asciiOnly);
   static bool requireUtf8(const std::string& regexp);
@@ -158,8 +184,9 @@ private:
   void Cleanup();
   inline bool IsValidSubNumber(int iSub) const;
 
-  PCRE::pcre* m_re;
-  PCRE::pcre_extra* m_sd;
+  boost::shared_ptr<CompiledPattern> m_compiled;
+  PCRE::pcre* m_re;        // owned by m_compiled
+  PCRE::pcre_extra* m_sd;  // owned by m_compiled
   static const int OVECCOUNT=(m_MaxNumOfBackrefrences + 1) * 3;
   unsigned int m_offset;
   int         m_iOvector[OVECCOUNT];
@@ -178,5 +205,53 @@ private:
 
 typedef std::vector<CRegExp> VECCREGEXP;
 
+/**
+ * Ordered list of regular expressions that are matched against a string in turn.
+ * The expressions are compiled (and studied) once, so a list can be kept around
+ * and matched against many strings.
+ */
+class CRegExpList
+{
+public:
+  /**
+   * @param caseless (optional) Matching will be case insensitive if set to true
+   * @param utf8 (optional) Control UTF-8 processing
+   * @param study (optional) Controls study of the expressions
+   */
+  CRegExpList(bool caseless = false, CRegExp::utf8Mode utf8 = CRegExp::asciiOnly,
+              CRegExp::studyMode study = CRegExp::StudyWithJitComp);
+  CRegExpList(const std::vector<std::string>& regexps, bool caseless = false,
+              CRegExp::utf8Mode utf8 = CRegExp::asciiOnly,
+              CRegExp::studyMode study = CRegExp::StudyWithJitComp);
+
+  /**
+   * Append an expression to the list
+   * Invalid expressions keep their place in the list so indexes stay the same,
+   * but never match.
+   * @param re The regular expression
+   * @return true on success, false if the expression failed to compile
+   */
+  bool Add(const std::string& re);
+
+  /**
+   * Find the first expression in the list matching the given string
+   * @param str   The string to match against the expressions
+   * @param first (optional) Index of the first expression to try
+   * @return index of the matching expression, -1 if none matches. The match
+   *         details are available from Get(index).
+   */
+  int Find(const std::string& str, unsigned int first = 0);
+
+  CRegExp& Get(unsigned int index) { return m_regexps[index]; }
+  const CRegExp& Get(unsigned int index) const { return m_regexps[index]; }
+  unsigned int Size() const { return m_regexps.size(); }
+
+private:
+  bool m_caseless;
+  CRegExp::utf8Mode m_utf8;
+  CRegExp::studyMode m_study;
+  VECCREGEXP m_regexps;
+};
+
 #endif
 
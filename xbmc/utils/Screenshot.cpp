@@ -39,6 +39,9 @@
 
 #include "filesystem/File.h"
 #include "guilib/GraphicContext.h"
+#if defined(HAS_GL)
+#include "guilib/GUITextureGL.h"
+#endif
 
 #include "utils/JobManager.h"
 #include "utils/URIUtils.h"
@@ -127,6 +130,7 @@ bool CScreenshotSurface::capture()
   }
   g_application.RenderNoPresent();
 #ifndef HAS_GLES
+  CGUITextureGL::Flush();
   glReadBuffer(GL_BACK);
 #endif
   //get current viewport
@@ -0,0 +1,127 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PlatformDefs.h"
+#include "StartupProfiler.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+CStartupProfiler& CStartupProfiler::Get()
+{
+  static CStartupProfiler s_profiler;
+  return s_profiler;
+}
+
+CStartupProfiler::CStartupProfiler()
+  : m_start(CurrentHostCounter())
+{ }
+
+void CStartupProfiler::Begin(const std::string &name)
+{
+  CSingleLock lock(m_critical);
+  Event event = { name, true, now(), thread() };
+  m_events.push_back(event);
+}
+
+void CStartupProfiler::End(const std::string &name)
+{
+  CSingleLock lock(m_critical);
+  Event event = { name, false, now(), thread() };
+  m_events.push_back(event);
+}
+
+void CStartupProfiler::Log() const
+{
+  CSingleLock lock(m_critical);
+  for (std::vector<Event>::const_iterator end = m_events.begin(); end != m_events.end(); ++end)
+  {
+    if (end->begin)
+      continue;
+
+    // find the matching begin on the same thread
+    for (std::vector<Event>::const_reverse_iterator begin(end); begin != m_events.rend(); ++begin)
+    {
+      if (begin->begin && begin->thread == end->thread && begin->name == end->name)
+      {
+        CLog::Log(LOGDEBUG, "CStartupProfiler: %s took %" PRId64 " ms (thread %u, started at %" PRId64 " ms)",
+                  end->name.c_str(), (end->time - begin->time) / 1000, end->thread, begin->time / 1000);
+        break;
+      }
+    }
+  }
+}
+
+bool CStartupProfiler::Write(const std::string &path) const
+{
+  CVariant events(CVariant::VariantTypeArray);
+  {
+    CSingleLock lock(m_critical);
+    for (std::vector<Event>::const_iterator it = m_events.begin(); it != m_events.end(); ++it)
+    {
+      CVariant event(CVariant::VariantTypeObject);
+      event["name"] = it->name;
+      event["cat"] = "startup";
+      event["ph"] = it->begin ? "B" : "E";
+      event["ts"] = it->time;
+      event["pid"] = 1;
+      event["tid"] = it->thread;
+      events.push_back(event);
+    }
+  }
+
+  CVariant trace(CVariant::VariantTypeObject);
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+
+  std::string json = CJSONVariantWriter::Write(trace, true);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(json.c_str(), json.size()) != (ssize_t)json.size())
+  {
+    CLog::Log(LOGERROR, "CStartupProfiler: failed to write startup trace to %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "CStartupProfiler: startup trace written to %s", path.c_str());
+  return true;
+}
+
+int64_t CStartupProfiler::now() const
+{
+  return (CurrentHostCounter() - m_start) * 1000000 / CurrentHostFrequency();
+}
+
+unsigned int CStartupProfiler::thread()
+{
+  for (unsigned int i = 0; i < m_threads.size(); i++)
+  {
+    if (CThread::IsCurrentThread(m_threads[i]))
+      return i + 1;
+  }
+
+  m_threads.push_back(CThread::GetCurrentThreadId());
+  return m_threads.size();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/ThreadImpl.h"
+
+/*!
+ \brief Records the phases of application startup.
+
+ Every phase is recorded with the thread it ran on and the time it started and
+ ended. The recorded phases can be written out in the Chrome trace event format
+ so they can be inspected in chrome://tracing.
+ */
+class CStartupProfiler
+{
+public:
+  static CStartupProfiler& Get();
+
+  /*!
+   \brief Mark the start of a phase on the calling thread.
+   \param name name of the phase
+   */
+  void Begin(const std::string &name);
+
+  /*!
+   \brief Mark the end of a phase on the calling thread.
+   \param name name of the phase
+   */
+  void End(const std::string &name);
+
+  /*!
+   \brief Log the duration of all completed phases.
+   */
+  void Log() const;
+
+  /*!
+   \brief Write all recorded phases as Chrome trace JSON.
+   \param path file to write the trace to
+   \return true if the trace was written successfully
+   */
+  bool Write(const std::string &path) const;
+
+private:
+  CStartupProfiler();
+  CStartupProfiler(const CStartupProfiler&);
+  CStartupProfiler const& operator=(CStartupProfiler const&);
+
+  typedef struct
+  {
+    std::string name;
+    bool begin;
+    int64_t time; // in microseconds since construction
+    unsigned int thread;
+  } Event;
+
+  int64_t now() const;
+  unsigned int thread();
+
+  int64_t m_start;
+  std::vector<Event> m_events;
+  std::vector<ThreadIdentifier> m_threads;
+  CCriticalSection m_critical;
+};
+
+/*!
+ \brief Records a startup phase for the lifetime of the object.
+ */
+class CStartupPhase
+{
+public:
+  CStartupPhase(const std::string &name) : m_name(name) { CStartupProfiler::Get().Begin(m_name); }
+  ~CStartupPhase() { CStartupProfiler::Get().End(m_name); }
+
+private:
+  std::string m_name;
+};
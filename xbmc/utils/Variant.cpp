@@ -23,6 +23,7 @@
 #include <sstream>
 
 #include "Variant.h"
+#include "threads/Atomics.h"
 
 #ifndef strtoll
 #ifdef TARGET_WINDOWS
@@ -149,16 +150,16 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new string();
+      m_data.string = new Shared<string>();
       break;
     case VariantTypeWideString:
-      m_data.wstring = new wstring();
+      m_data.wstring = new Shared<wstring>();
       break;
     case VariantTypeArray:
-      m_data.array = new VariantArray();
+      m_data.array = new Shared<VariantArray>();
       break;
     case VariantTypeObject:
-      m_data.map = new VariantMap();
+      m_data.map = new Shared<VariantMap>();
       break;
     default:
       memset(&m_data, 0, sizeof(m_data));
@@ -211,66 +212,66 @@ CVariant::CVariant(bool boolean)
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  m_data.string = new Shared<string>(str);
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str, length);
+  m_data.string = new Shared<string>(string(str, length));
 }
 
 CVariant::CVariant(const string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  m_data.string = new Shared<string>(str);
 }
 
 CVariant::CVariant(const wchar_t *str)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new wstring(str);
+  m_data.wstring = new Shared<wstring>(str);
 }
 
 CVariant::CVariant(const wchar_t *str, unsigned int length)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new wstring(str, length);
+  m_data.wstring = new Shared<wstring>(wstring(str, length));
 }
 
 CVariant::CVariant(const wstring &str)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new wstring(str);
+  m_data.wstring = new Shared<wstring>(str);
 }
 
 CVariant::CVariant(const std::vector<std::string> &strArray)
 {
   m_type = VariantTypeArray;
-  m_data.array = new VariantArray;
-  m_data.array->reserve(strArray.size());
+  m_data.array = new Shared<VariantArray>();
+  m_data.array->value.reserve(strArray.size());
   for (unsigned int index = 0; index < strArray.size(); index++)
-    m_data.array->push_back(strArray.at(index));
+    m_data.array->value.push_back(strArray.at(index));
 }
 
 CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 {
   m_type = VariantTypeObject;
-  m_data.map = new VariantMap;
+  m_data.map = new Shared<VariantMap>();
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); ++it)
-    m_data.map->insert(make_pair(it->first, CVariant(it->second)));
+    m_data.map->value.insert(make_pair(it->first, CVariant(it->second)));
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
 {
   m_type = VariantTypeObject;
-  m_data.map = new VariantMap(variantMap.begin(), variantMap.end());
+  m_data.map = new Shared<VariantMap>(VariantMap(variantMap.begin(), variantMap.end()));
 }
 
 CVariant::CVariant(const CVariant &variant)
 {
   m_type = VariantTypeNull;
-  *this = variant;
+  share(variant);
 }
 
 CVariant::~CVariant()
@@ -278,19 +279,79 @@ CVariant::~CVariant()
   cleanup();
 }
 
+template<typename T>
+CVariant::Shared<T>* CVariant::acquire(Shared<T> *data)
+{
+  // somebody may hold a reference into the value, so it can't be shared
+  if (data->unshareable)
+    return new Shared<T>(data->value);
+
+  AtomicIncrement(&data->refs);
+  return data;
+}
+
+template<typename T>
+void CVariant::release(Shared<T> *data)
+{
+  if (AtomicDecrement(&data->refs) == 0)
+    delete data;
+}
+
+template<typename T>
+void CVariant::detach(Shared<T> *&data)
+{
+  if (data->refs > 1)
+  {
+    Shared<T> *copy = new Shared<T>(data->value);
+    release(data);
+    data = copy;
+  }
+}
+
+template<typename T>
+void CVariant::leak(Shared<T> *&data)
+{
+  detach(data);
+  data->unshareable = true;
+}
+
 void CVariant::cleanup()
 {
   if (m_type == VariantTypeString)
-    delete m_data.string;
+    release(m_data.string);
   else if (m_type == VariantTypeWideString)
-    delete m_data.wstring;
+    release(m_data.wstring);
   else if (m_type == VariantTypeArray)
-    delete m_data.array;
+    release(m_data.array);
   else if (m_type == VariantTypeObject)
-    delete m_data.map;
+    release(m_data.map);
   m_type = VariantTypeNull;
 }
 
+void CVariant::share(const CVariant &variant)
+{
+  m_type = variant.m_type;
+
+  switch (m_type)
+  {
+  case VariantTypeString:
+    m_data.string = acquire(variant.m_data.string);
+    break;
+  case VariantTypeWideString:
+    m_data.wstring = acquire(variant.m_data.wstring);
+    break;
+  case VariantTypeArray:
+    m_data.array = acquire(variant.m_data.array);
+    break;
+  case VariantTypeObject:
+    m_data.map = acquire(variant.m_data.map);
+    break;
+  default:
+    m_data = variant.m_data;
+    break;
+  }
+}
+
 bool CVariant::isInteger() const
 {
   return m_type == VariantTypeInteger;
@@ -352,9 +413,9 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(m_data.string->value, fallback);
     case VariantTypeWideString:
-      return str2int64(*m_data.wstring, fallback);
+      return str2int64(m_data.wstring->value, fallback);
     default:
       return fallback;
   }
@@ -373,9 +434,9 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(m_data.string->value, fallback);
     case VariantTypeWideString:
-      return str2uint64(*m_data.wstring, fallback);
+      return str2uint64(m_data.wstring->value, fallback);
     default:
       return fallback;
   }
@@ -394,9 +455,9 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(m_data.string->value, fallback);
     case VariantTypeWideString:
-      return str2double(*m_data.wstring, fallback);
+      return str2double(m_data.wstring->value, fallback);
     default:
       return fallback;
   }
@@ -415,9 +476,9 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(m_data.string->value, fallback);
     case VariantTypeWideString:
-      return (float)str2double(*m_data.wstring, fallback);
+      return (float)str2double(m_data.wstring->value, fallback);
     default:
       return fallback;
   }
@@ -438,11 +499,11 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+      if (m_data.string->value.empty() || m_data.string->value.compare("0") == 0 || m_data.string->value.compare("false") == 0)
         return false;
       return true;
     case VariantTypeWideString:
-      if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
+      if (m_data.wstring->value.empty() || m_data.wstring->value.compare(L"0") == 0 || m_data.wstring->value.compare(L"false") == 0)
         return false;
       return true;
     default:
@@ -457,7 +518,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return m_data.string->value;
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -485,7 +546,7 @@ std::wstring CVariant::asWideString(const std::wstring &fallback /* = L"" */) co
   switch (m_type)
   {
     case VariantTypeWideString:
-      return *m_data.wstring;
+      return m_data.wstring->value;
     case VariantTypeBoolean:
       return m_data.boolean ? L"true" : L"false";
     case VariantTypeInteger:
@@ -513,11 +574,14 @@ CVariant &CVariant::operator[](const std::string &key)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeObject;
-    m_data.map = new VariantMap;
+    m_data.map = new Shared<VariantMap>();
   }
 
   if (m_type == VariantTypeObject)
-    return (*m_data.map)[key];
+  {
+    leak(m_data.map);
+    return m_data.map->value[key];
+  }
   else
     return ConstNullVariant;
 }
@@ -525,7 +589,7 @@ CVariant &CVariant::operator[](const std::string &key)
 const CVariant &CVariant::operator[](const std::string &key) const
 {
   VariantMap::const_iterator it;
-  if (m_type == VariantTypeObject && (it = m_data.map->find(key)) != m_data.map->end())
+  if (m_type == VariantTypeObject && (it = m_data.map->value.find(key)) != m_data.map->value.end())
     return it->second;
   else
     return ConstNullVariant;
@@ -534,7 +598,10 @@ const CVariant &CVariant::operator[](const std::string &key) const
 CVariant &CVariant::operator[](unsigned int position)
 {
   if (m_type == VariantTypeArray && size() > position)
-    return m_data.array->at(position);
+  {
+    leak(m_data.array);
+    return m_data.array->value.at(position);
+  }
   else
     return ConstNullVariant;
 }
@@ -542,7 +609,7 @@ CVariant &CVariant::operator[](unsigned int position)
 const CVariant &CVariant::operator[](unsigned int position) const
 {
   if (m_type == VariantTypeArray && size() > position)
-    return m_data.array->at(position);
+    return m_data.array->value.at(position);
   else
     return ConstNullVariant;
 }
@@ -552,39 +619,9 @@ CVariant &CVariant::operator=(const CVariant &rhs)
   if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
 
-  cleanup();
-
-  m_type = rhs.m_type;
-
-  switch (m_type)
-  {
-  case VariantTypeInteger:
-    m_data.integer = rhs.m_data.integer;
-    break;
-  case VariantTypeUnsignedInteger:
-    m_data.integer = rhs.m_data.unsignedinteger;
-    break;
-  case VariantTypeBoolean:
-    m_data.boolean = rhs.m_data.boolean;
-    break;
-  case VariantTypeDouble:
-    m_data.dvalue = rhs.m_data.dvalue;
-    break;
-  case VariantTypeString:
-    m_data.string = new string(*rhs.m_data.string);
-    break;
-  case VariantTypeWideString:
-    m_data.wstring = new wstring(*rhs.m_data.wstring);
-    break;
-  case VariantTypeArray:
-    m_data.array = new VariantArray(rhs.m_data.array->begin(), rhs.m_data.array->end());
-    break;
-  case VariantTypeObject:
-    m_data.map = new VariantMap(rhs.m_data.map->begin(), rhs.m_data.map->end());
-    break;
-  default:
-    break;
-  }
+  // rhs may be part of our own value, so share it before letting go of ours
+  CVariant copy(rhs);
+  swap(copy);
 
   return *this;
 }
@@ -604,13 +641,13 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return m_data.string == rhs.m_data.string || m_data.string->value == rhs.m_data.string->value;
     case VariantTypeWideString:
-      return *m_data.wstring == *rhs.m_data.wstring;
+      return m_data.wstring == rhs.m_data.wstring || m_data.wstring->value == rhs.m_data.wstring->value;
     case VariantTypeArray:
-      return *m_data.array == *rhs.m_data.array;
+      return m_data.array == rhs.m_data.array || m_data.array->value == rhs.m_data.array->value;
     case VariantTypeObject:
-      return *m_data.map == *rhs.m_data.map;
+      return m_data.map == rhs.m_data.map || m_data.map->value == rhs.m_data.map->value;
     default:
       break;
     }
@@ -624,11 +661,17 @@ void CVariant::push_back(const CVariant &variant)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeArray;
-    m_data.array = new VariantArray;
+    m_data.array = new Shared<VariantArray>();
   }
 
   if (m_type == VariantTypeArray)
-    m_data.array->push_back(variant);
+  {
+    // variant may be part of our own value, so copy it before detaching
+    CVariant copy(variant);
+    detach(m_data.array);
+    m_data.array->value.push_back(CVariant());
+    m_data.array->value.back().swap(copy);
+  }
 }
 
 void CVariant::append(const CVariant &variant)
@@ -639,7 +682,7 @@ void CVariant::append(const CVariant &variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return m_data.string->value.c_str();
   else
     return NULL;
 }
@@ -656,10 +699,30 @@ void CVariant::swap(CVariant &rhs)
   rhs.m_data = temp_data;
 }
 
+void CVariant::makeShareable()
+{
+  // a child can only have been leaked through its parent, so shareable parents end the walk
+  if (m_type == VariantTypeArray && m_data.array->unshareable)
+  {
+    m_data.array->unshareable = false;
+    for (VariantArray::iterator it = m_data.array->value.begin(); it != m_data.array->value.end(); ++it)
+      it->makeShareable();
+  }
+  else if (m_type == VariantTypeObject && m_data.map->unshareable)
+  {
+    m_data.map->unshareable = false;
+    for (VariantMap::iterator it = m_data.map->value.begin(); it != m_data.map->value.end(); ++it)
+      it->second.makeShareable();
+  }
+}
+
 CVariant::iterator_array CVariant::begin_array()
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->begin();
+  {
+    leak(m_data.array);
+    return m_data.array->value.begin();
+  }
   else
     return iterator_array();
 }
@@ -667,7 +730,7 @@ CVariant::iterator_array CVariant::begin_array()
 CVariant::const_iterator_array CVariant::begin_array() const
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->begin();
+    return m_data.array->value.begin();
   else
     return const_iterator_array();
 }
@@ -675,7 +738,10 @@ CVariant::const_iterator_array CVariant::begin_array() const
 CVariant::iterator_array CVariant::end_array()
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->end();
+  {
+    leak(m_data.array);
+    return m_data.array->value.end();
+  }
   else
     return iterator_array();
 }
@@ -683,7 +749,7 @@ CVariant::iterator_array CVariant::end_array()
 CVariant::const_iterator_array CVariant::end_array() const
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->end();
+    return m_data.array->value.end();
   else
     return const_iterator_array();
 }
@@ -691,7 +757,10 @@ CVariant::const_iterator_array CVariant::end_array() const
 CVariant::iterator_map CVariant::begin_map()
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->begin();
+  {
+    leak(m_data.map);
+    return m_data.map->value.begin();
+  }
   else
     return iterator_map();
 }
@@ -699,7 +768,7 @@ CVariant::iterator_map CVariant::begin_map()
 CVariant::const_iterator_map CVariant::begin_map() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->begin();
+    return m_data.map->value.begin();
   else
     return const_iterator_map();
 }
@@ -707,7 +776,10 @@ CVariant::const_iterator_map CVariant::begin_map() const
 CVariant::iterator_map CVariant::end_map()
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->end();
+  {
+    leak(m_data.map);
+    return m_data.map->value.end();
+  }
   else
     return iterator_map();
 }
@@ -715,7 +787,7 @@ CVariant::iterator_map CVariant::end_map()
 CVariant::const_iterator_map CVariant::end_map() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->end();
+    return m_data.map->value.end();
   else
     return const_iterator_map();
 }
@@ -723,13 +795,13 @@ CVariant::const_iterator_map CVariant::end_map() const
 unsigned int CVariant::size() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->size();
+    return m_data.map->value.size();
   else if (m_type == VariantTypeArray)
-    return m_data.array->size();
+    return m_data.array->value.size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return m_data.string->value.size();
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->size();
+    return m_data.wstring->value.size();
   else
     return 0;
 }
@@ -737,13 +809,13 @@ unsigned int CVariant::size() const
 bool CVariant::empty() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->empty();
+    return m_data.map->value.empty();
   else if (m_type == VariantTypeArray)
-    return m_data.array->empty();
+    return m_data.array->value.empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return m_data.string->value.empty();
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->empty();
+    return m_data.wstring->value.empty();
   else if (m_type == VariantTypeNull)
     return true;
 
@@ -753,13 +825,25 @@ bool CVariant::empty() const
 void CVariant::clear()
 {
   if (m_type == VariantTypeObject)
-    m_data.map->clear();
+  {
+    detach(m_data.map);
+    m_data.map->value.clear();
+  }
   else if (m_type == VariantTypeArray)
-    m_data.array->clear();
+  {
+    detach(m_data.array);
+    m_data.array->value.clear();
+  }
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    detach(m_data.string);
+    m_data.string->value.clear();
+  }
   else if (m_type == VariantTypeWideString)
-    m_data.wstring->clear();
+  {
+    detach(m_data.wstring);
+    m_data.wstring->value.clear();
+  }
 }
 
 void CVariant::erase(const std::string &key)
@@ -767,10 +851,13 @@ void CVariant::erase(const std::string &key)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeObject;
-    m_data.map = new VariantMap;
+    m_data.map = new Shared<VariantMap>();
   }
   else if (m_type == VariantTypeObject)
-    m_data.map->erase(key);
+  {
+    detach(m_data.map);
+    m_data.map->value.erase(key);
+  }
 }
 
 void CVariant::erase(unsigned int position)
@@ -778,17 +865,20 @@ void CVariant::erase(unsigned int position)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeArray;
-    m_data.array = new VariantArray;
+    m_data.array = new Shared<VariantArray>();
   }
 
   if (m_type == VariantTypeArray && position < size())
-    m_data.array->erase(m_data.array->begin() + position);
+  {
+    detach(m_data.array);
+    m_data.array->value.erase(m_data.array->value.begin() + position);
+  }
 }
 
 bool CVariant::isMember(const std::string &key) const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->find(key) != m_data.map->end();
+    return m_data.map->value.find(key) != m_data.map->value.end();
 
   return false;
 }
@@ -31,6 +31,17 @@ uint64_t str2uint64(const std::wstring &str, uint64_t fallback = 0);
 double str2double(const std::string &str, double fallback = 0.0);
 double str2double(const std::wstring &str, double fallback = 0.0);
 
+/*!
+ \brief Value of a JSON-like type.
+
+ Strings, arrays and objects are reference counted and shared between copies
+ of a variant until one of them is modified (copy-on-write). As soon as a
+ non-const reference or iterator into an array or object has been handed out
+ the container isn't shared anymore, so changes through such a reference never
+ show up in copies made afterwards. Copying such a container copies it and its
+ unshareable children again, until makeShareable() is called once the
+ references are gone.
+ */
 class CVariant
 {
 public:
@@ -104,6 +115,13 @@ public:
 
   void swap(CVariant &rhs);
 
+  /*!
+   \brief Let copies share this variant again after it has been built through non-const references.
+   Only call this when no reference or iterator obtained from a non-const accessor
+   of this variant or its children is used anymore.
+   */
+  void makeShareable();
+
 private:
   typedef std::vector<CVariant> VariantArray;
   typedef std::map<std::string, CVariant> VariantMap;
@@ -136,17 +154,34 @@ public:
   static CVariant ConstNullVariant;
 
 private:
+  template<typename T>
+  struct Shared
+  {
+    Shared() : refs(1), unshareable(false) { }
+    explicit Shared(const T &other) : refs(1), unshareable(false), value(other) { }
+
+    volatile long refs;
+    bool unshareable; ///< a non-const reference into the value has been handed out
+    T value;
+  };
+
+  template<typename T> static Shared<T>* acquire(Shared<T> *data);
+  template<typename T> static void release(Shared<T> *data);
+  template<typename T> static void detach(Shared<T> *&data);
+  template<typename T> static void leak(Shared<T> *&data);
+
   void cleanup();
+  void share(const CVariant &variant);
   union VariantUnion
   {
     int64_t integer;
     uint64_t unsignedinteger;
     bool boolean;
     double dvalue;
-    std::string *string;
-    std::wstring *wstring;
-    VariantArray *array;
-    VariantMap *map;
+    Shared<std::string> *string;
+    Shared<std::wstring> *wstring;
+    Shared<VariantArray> *array;
+    Shared<VariantMap> *map;
   };
 
   VariantType m_type;
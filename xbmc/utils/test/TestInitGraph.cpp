@@ -0,0 +1,96 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/InitGraph.h"
+#include "threads/SingleLock.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+class CTestInitGraphRecorder
+{
+public:
+  bool Record(const std::string &name)
+  {
+    CSingleLock lock(m_critical);
+    m_order.push_back(name);
+    return true;
+  }
+
+  bool First() { return Record("first"); }
+  bool Second() { return Record("second"); }
+  bool Third() { return Record("third"); }
+  bool Fail() { Record("fail"); return false; }
+
+  int IndexOf(const std::string &name)
+  {
+    for (unsigned int i = 0; i < m_order.size(); i++)
+    {
+      if (m_order[i] == name)
+        return i;
+    }
+    return -1;
+  }
+
+  std::vector<std::string> m_order;
+  CCriticalSection m_critical;
+};
+
+TEST(TestInitGraph, Dependencies)
+{
+  CTestInitGraphRecorder recorder;
+  CInitGraph graph("test");
+  graph.AddTask("third", &recorder, &CTestInitGraphRecorder::Third, "first, second");
+  graph.AddTask("second", &recorder, &CTestInitGraphRecorder::Second, "first", true);
+  graph.AddTask("first", &recorder, &CTestInitGraphRecorder::First);
+
+  EXPECT_TRUE(graph.Run());
+  ASSERT_EQ(3U, recorder.m_order.size());
+  EXPECT_EQ(0, recorder.IndexOf("first"));
+  EXPECT_EQ(1, recorder.IndexOf("second"));
+  EXPECT_EQ(2, recorder.IndexOf("third"));
+}
+
+TEST(TestInitGraph, Failure)
+{
+  CTestInitGraphRecorder recorder;
+  CInitGraph graph("test");
+  graph.AddTask("fail", &recorder, &CTestInitGraphRecorder::Fail);
+  graph.AddTask("first", &recorder, &CTestInitGraphRecorder::First, "fail");
+  graph.AddTask("second", &recorder, &CTestInitGraphRecorder::Second, "first");
+  graph.AddTask("third", &recorder, &CTestInitGraphRecorder::Third);
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_EQ(-1, recorder.IndexOf("first"));
+  EXPECT_EQ(-1, recorder.IndexOf("second"));
+  EXPECT_NE(-1, recorder.IndexOf("third"));
+}
+
+TEST(TestInitGraph, UnknownDependency)
+{
+  CTestInitGraphRecorder recorder;
+  CInitGraph graph("test");
+  graph.AddTask("first", &recorder, &CTestInitGraphRecorder::First, "unknown");
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_TRUE(recorder.m_order.empty());
+}
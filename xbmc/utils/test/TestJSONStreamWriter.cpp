@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <clocale>
+#include <vector>
+
+#include "utils/JSONStreamWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+class CChunkSink : public IJSONStreamSink
+{
+public:
+  CChunkSink() : accept(true) { }
+  virtual bool Write(const char *data, size_t size)
+  {
+    if (!accept)
+      return false;
+    chunks.push_back(std::string(data, size));
+    return true;
+  }
+
+  std::string Joined() const
+  {
+    std::string joined;
+    for (std::vector<std::string>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+      joined += *it;
+    return joined;
+  }
+
+  std::vector<std::string> chunks;
+  bool accept;
+};
+
+TEST(TestJSONStreamWriter, Value)
+{
+  CVariant variant(CVariant::VariantTypeObject);
+  variant["string"] = "value";
+  variant["integer"] = -5;
+  variant["double"] = 0.5;
+  variant["boolean"] = true;
+  variant["array"].push_back(1);
+  variant["array"].push_back(CVariant());
+
+  CChunkSink sink;
+  {
+    CJSONStreamWriter writer(sink, true);
+    EXPECT_TRUE(writer.Value(variant));
+    EXPECT_TRUE(writer.Flush());
+  }
+
+  EXPECT_EQ(1U, sink.chunks.size());
+  EXPECT_STREQ("{\"array\":[1,null],\"boolean\":true,\"double\":0.5,\"integer\":-5,\"string\":\"value\"}",
+               sink.Joined().c_str());
+}
+
+TEST(TestJSONStreamWriter, Chunks)
+{
+  CVariant items(CVariant::VariantTypeArray);
+  for (int i = 0; i < 1000; i++)
+    items.push_back(StringUtils::Format("item %d", i));
+
+  CChunkSink sink;
+  {
+    CJSONStreamWriter writer(sink, true, 1024);
+    EXPECT_TRUE(writer.StartObject());
+    EXPECT_TRUE(writer.Key("items"));
+    EXPECT_TRUE(writer.Value(items));
+    EXPECT_TRUE(writer.EndObject());
+    EXPECT_TRUE(writer.Flush());
+  }
+
+  // the list is passed on while it is being written
+  EXPECT_LT(1U, sink.chunks.size());
+  for (size_t i = 0; i + 1 < sink.chunks.size(); i++)
+    EXPECT_LE(1024U, sink.chunks[i].size());
+
+  std::string expected = "{\"items\":[";
+  for (int i = 0; i < 1000; i++)
+    expected += StringUtils::Format(i > 0 ? ",\"item %d\"" : "\"item %d\"", i);
+  expected += "]}";
+  EXPECT_STREQ(expected.c_str(), sink.Joined().c_str());
+}
+
+TEST(TestJSONStreamWriter, Abort)
+{
+  CVariant items(CVariant::VariantTypeArray);
+  for (int i = 0; i < 1000; i++)
+    items.push_back(i);
+
+  CChunkSink sink;
+  sink.accept = false;
+
+  CJSONStreamWriter writer(sink, true, 64);
+  EXPECT_FALSE(writer.Value(items));
+  EXPECT_TRUE(writer.HasFailed());
+  EXPECT_FALSE(writer.Flush());
+}
+
+TEST(TestJSONStreamWriter, Locale)
+{
+  // use a locale with a decimal comma if one is installed
+  std::string oldLocale = setlocale(LC_NUMERIC, NULL);
+  const char *locales[] = { "de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "fr_FR" };
+  for (size_t i = 0; i < sizeof(locales) / sizeof(locales[0]); i++)
+  {
+    if (setlocale(LC_NUMERIC, locales[i]) != NULL)
+      break;
+  }
+  std::string locale = setlocale(LC_NUMERIC, NULL);
+
+  CVariant variant(CVariant::VariantTypeArray);
+  variant.push_back(0.5);
+  variant.push_back(-1250.25);
+
+  CChunkSink sink;
+  {
+    CJSONStreamWriter writer(sink, true);
+    EXPECT_TRUE(writer.Value(variant));
+    EXPECT_TRUE(writer.Flush());
+    // the global locale is left alone
+    EXPECT_STREQ(locale.c_str(), setlocale(LC_NUMERIC, NULL));
+  }
+  setlocale(LC_NUMERIC, oldLocale.c_str());
+
+  EXPECT_STREQ("[0.5,-1250.25]", sink.Joined().c_str());
+}
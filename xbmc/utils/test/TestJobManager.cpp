@@ -18,6 +18,7 @@
  *
  */
 
+#include "threads/Event.h"
 #include "utils/JobManager.h"
 #include "settings/Settings.h"
 #include "utils/SystemInfo.h"
@@ -177,3 +178,54 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class BlockingJob : public CJob
+{
+public:
+  BlockingJob(CEvent &event) : m_event(event) { }
+
+  const char * GetType() const
+  {
+    return "BlockingJob";
+  }
+
+  bool DoWork()
+  {
+    m_event.Wait();
+    return true;
+  }
+
+private:
+  CEvent &m_event;
+};
+
+class TestJobQueue : public CJobQueue
+{
+public:
+  TestJobQueue() : CJobQueue(false, 1, CJob::PRIORITY_HIGH) { }
+
+  using CJobQueue::QueueSize;
+  using CJobQueue::IsProcessing;
+};
+}
+
+TEST_F(TestJobManager, JobQueueSetJobsAtOnce)
+{
+  // the jobs may still be running when the test is finished
+  static CEvent finished(true);
+
+  TestJobQueue queue;
+  queue.AddJob(new BlockingJob(finished));
+  queue.AddJob(new BlockingJob(finished));
+  queue.AddJob(new BlockingJob(finished));
+  EXPECT_EQ(2U, queue.QueueSize());
+  EXPECT_TRUE(queue.IsProcessing());
+
+  queue.SetJobsAtOnce(3);
+  EXPECT_EQ(0U, queue.QueueSize());
+  EXPECT_TRUE(queue.IsProcessing());
+
+  finished.Set();
+}
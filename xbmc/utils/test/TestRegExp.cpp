@@ -134,6 +134,51 @@ TEST(TestRegExp, operatorEqual)
   EXPECT_STREQ("string", match.c_str());
 }
 
+TEST(TestRegExp, CompiledPatternCache)
+{
+  CRegExp regex, regex2(false, CRegExp::asciiOnly);
+  CRegExp::EnableStatistics(true);
+  CRegExp::Statistics before = CRegExp::GetStatistics();
+
+  EXPECT_TRUE(regex.RegComp("^TestCompiledPatternCache (\\d+)", CRegExp::StudyWithJitComp));
+  EXPECT_TRUE(regex2.RegComp("^TestCompiledPatternCache (\\d+)", CRegExp::StudyWithJitComp));
+
+  CRegExp::Statistics after = CRegExp::GetStatistics();
+  EXPECT_EQ(before.compiles + 1, after.compiles);
+  EXPECT_EQ(before.cacheHits + 1, after.cacheHits);
+
+  // objects sharing a compiled expression keep their own match state
+  EXPECT_EQ(0, regex.RegFind("TestCompiledPatternCache 12"));
+  EXPECT_EQ(0, regex2.RegFind("TestCompiledPatternCache 345"));
+  EXPECT_STREQ("12", regex.GetMatch(1).c_str());
+  EXPECT_STREQ("345", regex2.GetMatch(1).c_str());
+  EXPECT_EQ(before.matches + 2, CRegExp::GetStatistics().matches);
+
+  // nothing is counted while disabled
+  CRegExp::EnableStatistics(false);
+  EXPECT_EQ(0, regex.RegFind("TestCompiledPatternCache 6789"));
+  EXPECT_EQ(before.matches + 2, CRegExp::GetStatistics().matches);
+}
+
+TEST(TestRegExp, RegExpList)
+{
+  std::vector<std::string> regexps;
+  regexps.push_back("s(\\d+)e(\\d+)");
+  regexps.push_back("(invalid");
+  regexps.push_back("(\\d+)x(\\d+)");
+  regexps.push_back("\\d+");
+
+  CRegExpList list(regexps, true);
+  EXPECT_EQ(4U, list.Size());
+  EXPECT_FALSE(list.Get(1).IsCompiled());
+
+  EXPECT_EQ(0, list.Find("Show.S01E02.avi"));
+  EXPECT_STREQ("02", list.Get(0).GetMatch(2).c_str());
+  EXPECT_EQ(2, list.Find("Show.1x02.avi"));
+  EXPECT_EQ(3, list.Find("Show.1x02.avi", 3));
+  EXPECT_EQ(-1, list.Find("Show.avi"));
+}
+
 class TestRegExpLog : public testing::Test
 {
 protected:
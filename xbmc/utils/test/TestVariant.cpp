@@ -348,3 +348,91 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, copyOnWrite)
+{
+  CVariant a;
+  a["key1"] = "string1";
+  a["key2"].push_back(1);
+  a["key2"].push_back(2);
+
+  CVariant b(a);
+  const CVariant &cb = b;
+  EXPECT_TRUE(a == b);
+
+  b["key1"] = "string2";
+  b["key2"].push_back(3);
+  EXPECT_STREQ("string1", a["key1"].c_str());
+  EXPECT_STREQ("string2", cb["key1"].c_str());
+  EXPECT_EQ(2u, a["key2"].size());
+  EXPECT_EQ(3u, cb["key2"].size());
+
+  CVariant c = a["key2"];
+  c.clear();
+  EXPECT_EQ(2u, a["key2"].size());
+  EXPECT_TRUE(c.empty());
+
+  CVariant d("string"), e(d);
+  e.clear();
+  EXPECT_STREQ("string", d.c_str());
+  EXPECT_TRUE(e.empty());
+}
+
+TEST(TestVariant, copyOnWriteReferences)
+{
+  CVariant a;
+  a["key1"] = "string1";
+
+  // changes through references handed out before copying must not show up in the copy
+  CVariant &ref = a["key1"];
+  CVariant b(a);
+  ref = "string2";
+  EXPECT_STREQ("string2", a["key1"].c_str());
+  EXPECT_STREQ("string1", b["key1"].c_str());
+
+  CVariant c;
+  c.push_back("string1");
+  CVariant::iterator_array it = c.begin_array();
+  CVariant d(c);
+  *it = "string2";
+  EXPECT_STREQ("string2", c[0].c_str());
+  EXPECT_STREQ("string1", d[0].c_str());
+}
+
+TEST(TestVariant, assignPartOfItself)
+{
+  CVariant a;
+  a["key1"]["key2"] = "string";
+  a = a["key1"];
+  EXPECT_STREQ("string", a["key2"].c_str());
+
+  CVariant b;
+  b.push_back("string");
+  b.push_back(b[0]);
+  EXPECT_EQ(2u, b.size());
+  EXPECT_STREQ("string", b[1].c_str());
+}
+
+TEST(TestVariant, makeShareable)
+{
+  CVariant a;
+  a["key1"]["key2"] = "string1";
+  a["key3"].push_back(1);
+  a.makeShareable();
+
+  // copies made afterwards still don't see changes of the original
+  CVariant b(a);
+  const CVariant &cb = b;
+  a["key1"]["key2"] = "string2";
+  a["key3"].push_back(2);
+  EXPECT_STREQ("string1", cb["key1"]["key2"].c_str());
+  EXPECT_EQ(1u, cb["key3"].size());
+  EXPECT_STREQ("string2", a["key1"]["key2"].c_str());
+  EXPECT_EQ(2u, a["key3"].size());
+
+  // and references handed out afterwards are protected again
+  CVariant &ref = a["key1"];
+  CVariant c(a);
+  ref = "string3";
+  EXPECT_TRUE(c["key1"].isObject());
+}
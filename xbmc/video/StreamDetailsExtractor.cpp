@@ -0,0 +1,247 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StreamDetailsExtractor.h"
+#include "TextureCache.h"
+#include "URL.h"
+#include "cores/dvdplayer/DVDFileInfo.h"
+#include "filesystem/StackDirectory.h"
+#include "settings/Settings.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+#include "video/VideoThumbLoader.h"
+
+#define MAX_PROBES            4  // concurrent probes in total
+#define MAX_PROBES_PER_SOURCE 2  // concurrent probes reading from the same source
+#define RESULT_BATCH_SIZE     50 // number of probed files stored in one transaction
+
+using namespace XFILE;
+
+CStreamDetailsExtractor::CProbeJob::CProbeJob(const CFileItemPtr &item, const std::string &source, bool thumb)
+  : m_item(item),
+    m_source(source),
+    m_thumb(thumb)
+{ }
+
+bool CStreamDetailsExtractor::CProbeJob::DoWork()
+{
+  std::string path = m_item->GetPath();
+  if (URIUtils::IsStack(path))
+    path = CStackDirectory::GetFirstStackedFile(path);
+
+  if (m_thumb)
+  {
+    // extract the stream details from the same probe as the thumb
+    CLog::Log(LOGDEBUG, "%s - extracting thumb and stream details from %s", __FUNCTION__, CURL::GetRedacted(path).c_str());
+    std::string thumbURL = CVideoThumbLoader::GetEmbeddedThumbURL(*m_item);
+    CTextureDetails details;
+    details.file = CTextureCache::GetCacheFile(thumbURL) + ".jpg";
+    if (CDVDFileInfo::ExtractThumb(path, details, &m_details))
+    {
+      CTextureCache::Get().AddCachedTexture(thumbURL, details);
+      m_thumbURL = thumbURL;
+    }
+  }
+  else
+  {
+    CLog::Log(LOGDEBUG, "%s - extracting stream details from %s", __FUNCTION__, CURL::GetRedacted(path).c_str());
+    if (CDVDFileInfo::GetFileStreamDetails(m_item.get()))
+      m_details = m_item->GetVideoInfoTag()->m_streamDetails;
+  }
+
+  // Don't know the total time of the stack, so set duration to zero to avoid confusion
+  if (URIUtils::IsStack(m_item->GetPath()))
+    m_details.SetVideoDuration(0, 0);
+
+  return m_details.HasItems();
+}
+
+CStreamDetailsExtractor& CStreamDetailsExtractor::Get()
+{
+  static CStreamDetailsExtractor s_extractor;
+  return s_extractor;
+}
+
+CStreamDetailsExtractor::CStreamDetailsExtractor()
+  : m_runningTotal(0),
+    m_extractThumbs(false)
+{ }
+
+void CStreamDetailsExtractor::ExtractMissing()
+{
+  CFileItemList items;
+  CVideoDatabase db;
+  if (!db.Open())
+    return;
+  bool result = db.GetItemsWithoutStreamDetails(items);
+  db.Close();
+
+  if (!result)
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - %i library items without stream details", __FUNCTION__, items.Size());
+  Extract(items);
+}
+
+void CStreamDetailsExtractor::Extract(const CFileItemList &items)
+{
+  CSingleLock lock(m_critical);
+  m_extractThumbs = CSettings::Get().GetBool("myvideos.extractflags") && CSettings::Get().GetBool("myvideos.extractthumb");
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItemPtr item = items[i];
+    if (!item->HasVideoInfoTag() || item->GetVideoInfoTag()->m_iFileId < 0)
+      continue;
+
+    // files in archives are left to the thumb loader which knows how to open them
+    std::string path = item->GetPath();
+    if (URIUtils::IsStack(path))
+      path = CStackDirectory::GetFirstStackedFile(path);
+    if (URIUtils::IsInArchive(path) || !CThumbExtractor::CanExtract(CFileItem(path, false)))
+      continue;
+
+    int idFile = item->GetVideoInfoTag()->m_iFileId;
+    if (m_failed.find(idFile) != m_failed.end() || !m_files.insert(idFile).second)
+      continue;
+
+    m_queues[GetSource(path)].push_back(CFileItemPtr(new CFileItem(*item)));
+  }
+
+  StartJobs();
+}
+
+void CStreamDetailsExtractor::Stop()
+{
+  {
+    CSingleLock lock(m_critical);
+    for (std::map<std::string, std::deque<CFileItemPtr> >::const_iterator queue = m_queues.begin(); queue != m_queues.end(); ++queue)
+    {
+      for (std::deque<CFileItemPtr>::const_iterator item = queue->second.begin(); item != queue->second.end(); ++item)
+        m_files.erase((*item)->GetVideoInfoTag()->m_iFileId);
+    }
+    m_queues.clear();
+  }
+
+  // the running probes are cancelled along with all other jobs, store what we have
+  WriteResults(true);
+}
+
+bool CStreamDetailsExtractor::IsRunning() const
+{
+  CSingleLock lock(m_critical);
+  return m_runningTotal > 0 || !m_queues.empty();
+}
+
+void CStreamDetailsExtractor::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CProbeJob *probe = (CProbeJob *)job;
+  int idFile = probe->m_item->GetVideoInfoTag()->m_iFileId;
+  bool finished;
+  {
+    CSingleLock lock(m_critical);
+    m_running[probe->m_source]--;
+    m_runningTotal--;
+    m_files.erase(idFile);
+
+    if (success)
+    {
+      m_details[idFile] = probe->m_details;
+      if (!probe->m_thumbURL.empty())
+      {
+        Thumb thumb = { probe->m_item->GetVideoInfoTag()->m_iDbId, probe->m_item->GetVideoInfoTag()->m_type, probe->m_thumbURL };
+        m_thumbs.push_back(thumb);
+      }
+    }
+    else
+      m_failed.insert(idFile);
+
+    StartJobs();
+    finished = m_runningTotal == 0;
+  }
+
+  WriteResults(finished);
+}
+
+std::string CStreamDetailsExtractor::GetSource(const std::string &path)
+{
+  if (!URIUtils::IsRemote(path))
+    return "local";
+
+  CURL url(path);
+  return url.GetProtocol() + "://" + url.GetHostName();
+}
+
+void CStreamDetailsExtractor::StartJobs()
+{
+  CSingleLock lock(m_critical);
+  std::map<std::string, std::deque<CFileItemPtr> >::iterator queue = m_queues.begin();
+  while (queue != m_queues.end() && m_runningTotal < MAX_PROBES)
+  {
+    unsigned int &running = m_running[queue->first];
+    while (!queue->second.empty() && running < MAX_PROBES_PER_SOURCE && m_runningTotal < MAX_PROBES)
+    {
+      CFileItemPtr item = queue->second.front();
+      queue->second.pop_front();
+
+      bool thumb = m_extractThumbs && !item->HasArt("thumb");
+      CJobManager::GetInstance().AddJob(new CProbeJob(item, queue->first, thumb), this, CJob::PRIORITY_LOW_PAUSABLE);
+      running++;
+      m_runningTotal++;
+    }
+
+    if (queue->second.empty())
+      m_queues.erase(queue++);
+    else
+      ++queue;
+  }
+}
+
+void CStreamDetailsExtractor::WriteResults(bool all)
+{
+  std::map<int, CStreamDetails> details;
+  std::deque<Thumb> thumbs;
+  {
+    CSingleLock lock(m_critical);
+    if (!all && m_details.size() < RESULT_BATCH_SIZE)
+      return;
+
+    details.swap(m_details);
+    thumbs.swap(m_thumbs);
+  }
+
+  if (details.empty() && thumbs.empty())
+    return;
+
+  CVideoDatabase db;
+  if (!db.Open())
+    return;
+
+  db.SetStreamDetailsForFileIds(details);
+  for (std::deque<Thumb>::const_iterator thumb = thumbs.begin(); thumb != thumbs.end(); ++thumb)
+    db.SetArtForItem(thumb->dbId, thumb->type, "thumb", thumb->thumb);
+  db.Close();
+
+  CLog::Log(LOGDEBUG, "%s - stored stream details of %" PRIuS " files and %" PRIuS " thumbs", __FUNCTION__, details.size(), thumbs.size());
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+#include "utils/StreamDetails.h"
+
+/*!
+ \ingroup thumbs,jobs
+ \brief Extracts the stream details and thumbs of library items in bulk
+
+ Probing a file for its stream details is usually done by the
+ CVideoThumbLoader while the item is shown. After importing a large number of
+ files this means that most of them never get probed. This service probes all
+ library items without stream details in the background instead.
+
+ Probes run concurrently on the job manager, limited per source (the server a
+ file lives on or the local disks) so a slow share isn't flooded with requests.
+ A single probe extracts both the stream details and, if the item has no thumb
+ yet, the thumb. The results are written to the database in batches.
+
+ Files that can't be probed are remembered until the application exits, so
+ they aren't probed again after every scan.
+ */
+class CStreamDetailsExtractor : public IJobCallback
+{
+public:
+  static CStreamDetailsExtractor& Get();
+
+  /*!
+   \brief Queue all library items without stream details.
+   */
+  void ExtractMissing();
+
+  /*!
+   \brief Queue the given library items.
+   Each item needs the file id, database id and media type in its video info tag.
+   */
+  void Extract(const CFileItemList &items);
+
+  /*!
+   \brief Drop all queued items and store the results of the finished probes.
+   Must be called before the job manager cancels the running probes.
+   */
+  void Stop();
+
+  bool IsRunning() const;
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  CStreamDetailsExtractor();
+  CStreamDetailsExtractor(const CStreamDetailsExtractor&);
+  CStreamDetailsExtractor const& operator=(CStreamDetailsExtractor const&);
+
+  class CProbeJob : public CJob
+  {
+  public:
+    CProbeJob(const CFileItemPtr &item, const std::string &source, bool thumb);
+
+    virtual bool DoWork();
+    virtual const char* GetType() const { return kJobTypeMediaFlags; }
+
+    CFileItemPtr m_item;
+    std::string m_source;
+    bool m_thumb;
+    std::string m_thumbURL; ///< set if a thumb has been extracted
+    CStreamDetails m_details;
+  };
+
+  typedef struct
+  {
+    int dbId;
+    std::string type;
+    std::string thumb;
+  } Thumb;
+
+  static std::string GetSource(const std::string &path);
+  void StartJobs();
+  void WriteResults(bool all);
+
+  CCriticalSection m_critical;
+  std::map<std::string, std::deque<CFileItemPtr> > m_queues; ///< queued items by source
+  std::map<std::string, unsigned int> m_running;              ///< running probes by source
+  unsigned int m_runningTotal;
+  std::set<int> m_files;                                      ///< ids of the queued and running files
+  std::set<int> m_failed;                                     ///< ids of the files that couldn't be probed
+  bool m_extractThumbs;
+
+  std::map<int, CStreamDetails> m_details; ///< probed stream details by file id, not stored yet
+  std::deque<Thumb> m_thumbs;               ///< extracted thumbs, not stored yet
+};
@@ -1764,7 +1764,7 @@ void CVideoDatabase::GetMusicVideosByArtist(const std::string& strArtist, CFileI
 }
 
 //********************************************************************************************************************************
-bool CVideoDatabase::GetMovieInfo(const std::string& strFilenameAndPath, CVideoInfoTag& details, int idMovie /* = -1 */)
+bool CVideoDatabase::GetMovieInfo(const std::string& strFilenameAndPath, CVideoInfoTag& details, int idMovie /* = -1 */, int getDetails /* = VideoDbDetailsAll */)
 {
   try
   {
@@ -1776,7 +1776,7 @@ bool CVideoDatabase::GetMovieInfo(const std::string& strFilenameAndPath, CVideoI
     std::string sql = PrepareSQL("select * from movie_view where idMovie=%i", idMovie);
     if (!m_pDS->query(sql.c_str()))
       return false;
-    details = GetDetailsForMovie(m_pDS, true);
+    details = GetDetailsForMovie(m_pDS, getDetails);
     return !details.IsEmpty();
   }
   catch (...)
@@ -2485,58 +2485,137 @@ void CVideoDatabase::SetStreamDetailsForFileId(const CStreamDetails& details, in
   try
   {
     BeginTransaction();
-    m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
+    SetStreamDetails(details, idFile);
+    CommitTransaction();
+  }
+  catch (...)
+  {
+    RollbackTransaction();
+    CLog::Log(LOGERROR, "%s (%i) failed", __FUNCTION__, idFile);
+  }
+}
 
-    for (int i=1; i<=details.GetVideoStreamCount(); i++)
-    {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration, strStereoMode) "
-        "VALUES (%i,%i,'%s',%f,%i,%i,%i,'%s')",
-        idFile, (int)CStreamDetail::VIDEO,
-        details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
-        details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i),
-        details.GetStereoMode(i).c_str()));
-    }
-    for (int i=1; i<=details.GetAudioStreamCount(); i++)
+void CVideoDatabase::SetStreamDetailsForFileIds(const map<int, CStreamDetails> &details)
+{
+  if (details.empty())
+    return;
+
+  try
+  {
+    BeginTransaction();
+    for (map<int, CStreamDetails>::const_iterator it = details.begin(); it != details.end(); ++it)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
-        "VALUES (%i,%i,'%s',%i,'%s')",
-        idFile, (int)CStreamDetail::AUDIO,
-        details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
-        details.GetAudioLanguage(i).c_str()));
+      if (it->first >= 0)
+        SetStreamDetails(it->second, it->first);
     }
-    for (int i=1; i<=details.GetSubtitleStreamCount(); i++)
+    CommitTransaction();
+  }
+  catch (...)
+  {
+    RollbackTransaction();
+    CLog::Log(LOGERROR, "%s (%" PRIuS " files) failed", __FUNCTION__, details.size());
+  }
+}
+
+void CVideoDatabase::SetStreamDetails(const CStreamDetails& details, int idFile)
+{
+  m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
+
+  for (int i=1; i<=details.GetVideoStreamCount(); i++)
+  {
+    m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
+      "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration, strStereoMode) "
+      "VALUES (%i,%i,'%s',%f,%i,%i,%i,'%s')",
+      idFile, (int)CStreamDetail::VIDEO,
+      details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
+      details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i),
+      details.GetStereoMode(i).c_str()));
+  }
+  for (int i=1; i<=details.GetAudioStreamCount(); i++)
+  {
+    m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
+      "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
+      "VALUES (%i,%i,'%s',%i,'%s')",
+      idFile, (int)CStreamDetail::AUDIO,
+      details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
+      details.GetAudioLanguage(i).c_str()));
+  }
+  for (int i=1; i<=details.GetSubtitleStreamCount(); i++)
+  {
+    m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
+      "(idFile, iStreamType, strSubtitleLanguage) "
+      "VALUES (%i,%i,'%s')",
+      idFile, (int)CStreamDetail::SUBTITLE,
+      details.GetSubtitleLanguage(i).c_str()));
+  }
+
+  // update the runtime information, if empty
+  if (details.GetVideoDuration())
+  {
+    vector< pair<string, int> > tables;
+    tables.push_back(make_pair("movie", VIDEODB_ID_RUNTIME));
+    tables.push_back(make_pair("episode", VIDEODB_ID_EPISODE_RUNTIME));
+    tables.push_back(make_pair("musicvideo", VIDEODB_ID_MUSICVIDEO_RUNTIME));
+    for (vector< pair<string, int> >::iterator i = tables.begin(); i != tables.end(); ++i)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strSubtitleLanguage) "
-        "VALUES (%i,%i,'%s')",
-        idFile, (int)CStreamDetail::SUBTITLE,
-        details.GetSubtitleLanguage(i).c_str()));
+      std::string sql = PrepareSQL("update %s set c%02d=%d where idFile=%d and c%02d=''",
+                                  i->first.c_str(), i->second, details.GetVideoDuration(), idFile, i->second);
+      m_pDS->exec(sql);
     }
+  }
+}
+
+bool CVideoDatabase::GetItemsWithoutStreamDetails(CFileItemList &items)
+{
+  if (NULL == m_pDB.get() || NULL == m_pDS.get())
+    return false;
 
-    // update the runtime information, if empty
-    if (details.GetVideoDuration())
+  try
+  {
+    const char *types[][3] = { { "movie",      "idMovie",   MediaTypeMovie },
+                               { "episode",    "idEpisode", MediaTypeEpisode },
+                               { "musicvideo", "idMVideo",  MediaTypeMusicVideo } };
+
+    for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++)
     {
-      vector< pair<string, int> > tables;
-      tables.push_back(make_pair("movie", VIDEODB_ID_RUNTIME));
-      tables.push_back(make_pair("episode", VIDEODB_ID_EPISODE_RUNTIME));
-      tables.push_back(make_pair("musicvideo", VIDEODB_ID_MUSICVIDEO_RUNTIME));
-      for (vector< pair<string, int> >::iterator i = tables.begin(); i != tables.end(); ++i)
+      std::string sql = PrepareSQL("SELECT %s.%s, files.idFile, path.strPath, files.strFileName, art.url "
+                                   "FROM %s JOIN files ON files.idFile = %s.idFile "
+                                   "JOIN path ON path.idPath = files.idPath "
+                                   "LEFT JOIN art ON art.media_id = %s.%s AND art.media_type = '%s' AND art.type = 'thumb' "
+                                   "WHERE NOT EXISTS (SELECT 1 FROM streamdetails WHERE streamdetails.idFile = files.idFile)",
+                                   types[i][0], types[i][1], types[i][0], types[i][0], types[i][0], types[i][1], types[i][2]);
+      if (!m_pDS->query(sql.c_str()))
+        return false;
+
+      while (!m_pDS->eof())
       {
-        std::string sql = PrepareSQL("update %s set c%02d=%d where idFile=%d and c%02d=''",
-                                    i->first.c_str(), i->second, details.GetVideoDuration(), idFile, i->second);
-        m_pDS->exec(sql);
+        std::string path;
+        ConstructPath(path, m_pDS->fv(2).get_asString(), m_pDS->fv(3).get_asString());
+
+        CFileItemPtr item(new CFileItem(path, false));
+        CVideoInfoTag *tag = item->GetVideoInfoTag();
+        tag->m_iDbId = m_pDS->fv(0).get_asInt();
+        tag->m_type = types[i][2];
+        tag->m_iFileId = m_pDS->fv(1).get_asInt();
+        tag->m_strFileNameAndPath = path;
+
+        std::string thumb = m_pDS->fv(4).get_asString();
+        if (!thumb.empty())
+          item->SetArt("thumb", thumb);
+
+        items.Add(item);
+        m_pDS->next();
       }
+      m_pDS->close();
     }
 
-    CommitTransaction();
+    return true;
   }
   catch (...)
   {
-    RollbackTransaction();
-    CLog::Log(LOGERROR, "%s (%i) failed", __FUNCTION__, idFile);
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
   }
+  return false;
 }
 
 //********************************************************************************************************************************
@@ -3390,12 +3469,12 @@ bool CVideoDatabase::GetResumePoint(CVideoInfoTag& tag)
   return match;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, bool getDetails /* = false */)
+CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, int getDetails /* = VideoDbDetailsNone */)
 {
   return GetDetailsForMovie(pDS->get_sql_record(), getDetails);
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* const record, bool getDetails /* = false */)
+CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */)
 {
   CVideoInfoTag details;
 
@@ -3427,27 +3506,33 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* cons
 
   if (getDetails)
   {
-    GetCast(details.m_iDbId, "movie", details.m_cast);
-    GetTags(details.m_iDbId, MediaTypeMovie, details.m_tags);
+    if (getDetails & VideoDbDetailsCast)
+      GetCast(details.m_iDbId, "movie", details.m_cast);
+    if (getDetails & VideoDbDetailsTag)
+      GetTags(details.m_iDbId, MediaTypeMovie, details.m_tags);
 
     castTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
     details.m_strPictureURL.Parse();
 
-    // create tvshowlink string
-    vector<int> links;
-    GetLinksToTvShow(idMovie,links);
-    for (unsigned int i=0;i<links.size();++i)
+    if (getDetails & VideoDbDetailsShowLink)
     {
-      std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=%i",
-                         VIDEODB_ID_TV_TITLE,links[i]);
-      m_pDS2->query(strSQL.c_str());
-      if (!m_pDS2->eof())
-        details.m_showLink.push_back(m_pDS2->fv(0).get_asString());
+      // create tvshowlink string
+      vector<int> links;
+      GetLinksToTvShow(idMovie,links);
+      for (unsigned int i=0;i<links.size();++i)
+      {
+        std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=%i",
+                           VIDEODB_ID_TV_TITLE,links[i]);
+        m_pDS2->query(strSQL.c_str());
+        if (!m_pDS2->eof())
+          details.m_showLink.push_back(m_pDS2->fv(0).get_asString());
+      }
+      m_pDS2->close();
     }
-    m_pDS2->close();
 
     // get streamdetails
-    GetStreamDetails(details);
+    if (getDetails & VideoDbDetailsStream)
+      GetStreamDetails(details);
   }
   return details;
 }
@@ -8246,7 +8331,7 @@ void CVideoDatabase::ExportToXML(const std::string &path, bool singleFiles /* =
 
     while (!m_pDS->eof())
     {
-      CVideoInfoTag movie = GetDetailsForMovie(m_pDS, true);
+      CVideoInfoTag movie = GetDetailsForMovie(m_pDS, VideoDbDetailsAll);
       // strip paths to make them relative
       if (StringUtils::StartsWith(movie.m_strTrailer, movie.m_strPath))
         movie.m_strTrailer = movie.m_strTrailer.substr(movie.m_strPath.size());
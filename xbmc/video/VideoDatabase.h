@@ -128,6 +128,16 @@ typedef enum
   VIDEODB_CONTENT_MOVIE_SETS = 5
 } VIDEODB_CONTENT_TYPE;
 
+typedef enum // additional details loaded by GetDetailsForMovie() and GetMovieInfo()
+{
+  VideoDbDetailsNone          = 0x00,
+  VideoDbDetailsCast          = 0x01,
+  VideoDbDetailsTag           = 0x02,
+  VideoDbDetailsShowLink      = 0x04,
+  VideoDbDetailsStream        = 0x08,
+  VideoDbDetailsAll           = 0xFF
+} VideoDbDetails;
+
 typedef enum // this enum MUST match the offset struct further down!! and make sure to keep min and max at -1 and sizeof(offsets)
 {
   VIDEODB_ID_MIN = -1,
@@ -444,7 +454,7 @@ public:
   int GetSeasonForEpisode(int idEpisode);
 
   bool LoadVideoInfo(const std::string& strFilenameAndPath, CVideoInfoTag& details);
-  bool GetMovieInfo(const std::string& strFilenameAndPath, CVideoInfoTag& details, int idMovie = -1);
+  bool GetMovieInfo(const std::string& strFilenameAndPath, CVideoInfoTag& details, int idMovie = -1, int getDetails = VideoDbDetailsAll);
   bool GetTvShowInfo(const std::string& strPath, CVideoInfoTag& details, int idTvShow = -1, CFileItem* item = NULL);
   bool GetSeasonInfo(int idSeason, CVideoInfoTag& details);
   bool GetEpisodeInfo(const std::string& strFilenameAndPath, CVideoInfoTag& details, int idEpisode = -1);
@@ -480,6 +490,19 @@ public:
   void SetStreamDetailsForFile(const CStreamDetails& details, const std::string &strFileNameAndPath);
   void SetStreamDetailsForFileId(const CStreamDetails& details, int idFile);
 
+  /*! \brief Set the stream details of several files in a single transaction
+   \param details the stream details keyed by the id of the file
+   \sa SetStreamDetailsForFileId
+   */
+  void SetStreamDetailsForFileIds(const std::map<int, CStreamDetails> &details);
+
+  /*! \brief Get the movies, episodes and music videos whose files have no stream details yet
+   Every item has its path, database id, media type and file id set as well as its thumb if there is one.
+   \param items the fileitemlist to fill
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetItemsWithoutStreamDetails(CFileItemList &items);
+
   bool SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbField, const std::string &strValue);
   bool SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, Field dbField, const std::string &strValue);
   bool SetSingleValue(const std::string &table, const std::string &fieldName, const std::string &strValue,
@@ -813,8 +836,8 @@ protected:
 
   void DeleteStreamDetails(int idFile);
   CVideoInfoTag GetDetailsByTypeAndId(VIDEODB_CONTENT_TYPE type, int id);
-  CVideoInfoTag GetDetailsForMovie(std::auto_ptr<dbiplus::Dataset> &pDS, bool getDetails = false);
-  CVideoInfoTag GetDetailsForMovie(const dbiplus::sql_record* const record, bool getDetails = false);
+  CVideoInfoTag GetDetailsForMovie(std::auto_ptr<dbiplus::Dataset> &pDS, int getDetails = VideoDbDetailsNone);
+  CVideoInfoTag GetDetailsForMovie(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone);
   CVideoInfoTag GetDetailsForTvShow(std::auto_ptr<dbiplus::Dataset> &pDS, bool getDetails = false, CFileItem* item = NULL);
   CVideoInfoTag GetDetailsForTvShow(const dbiplus::sql_record* const record, bool getDetails = false, CFileItem* item = NULL);
   CVideoInfoTag GetDetailsForEpisode(std::auto_ptr<dbiplus::Dataset> &pDS, bool getDetails = false);
@@ -870,6 +893,7 @@ private:
   virtual int GetExportVersion() const { return 1; };
   const char *GetBaseDBName() const { return "MyVideos"; };
 
+  void SetStreamDetails(const CStreamDetails& details, int idFile);
   void ConstructPath(std::string& strDest, const std::string& strPath, const std::string& strFileName);
   void SplitPath(const std::string& strFileNameAndPath, std::string& strPath, std::string& strFileName);
   void InvalidatePathHash(const std::string& strPath);
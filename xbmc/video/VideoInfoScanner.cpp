@@ -22,6 +22,7 @@
 #include "FileItem.h"
 #include "VideoInfoScanner.h"
 #include "addons/AddonManager.h"
+#include "filesystem/ChangeJournal.h"
 #include "filesystem/DirectoryCache.h"
 #include "Util.h"
 #include "NfoFile.h"
@@ -42,10 +43,12 @@
 #include "utils/StringUtils.h"
 #include "guilib/LocalizeStrings.h"
 #include "guilib/GUIWindowManager.h"
+#include "profiles/ProfilesManager.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "video/StreamDetailsExtractor.h"
 #include "video/VideoThumbLoader.h"
 #include "TextureCache.h"
 #include "GUIUserMessages.h"
@@ -68,6 +71,7 @@ namespace VIDEO
     m_itemCount = 0;
     m_bClean = false;
     m_scanAll = false;
+    m_journalSequence = 0;
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
@@ -107,6 +111,7 @@ namespace VIDEO
       m_bCanInterrupt = true;
 
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Starting scan ..");
+      CRegExp::EnableStatistics(CLog::IsLogLevelLogged(LOGDEBUG));
       ANNOUNCEMENT::CAnnouncementManager::Get().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanStarted");
 
       // Reset progress vars
@@ -120,6 +125,14 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // have our local sources watched, so later scans can skip the folders that didn't change
+      m_journalClient = StringUtils::Format("video:%i", CProfilesManager::Get().GetCurrentProfileId());
+      m_journalSequence = CChangeJournal::Get().GetSequence();
+      vector<string> roots;
+      CChangeJournal::GetRoots(m_pathsToScan, roots);
+      for (vector<string>::const_iterator it = roots.begin(); it != roots.end(); ++it)
+        CChangeJournal::Get().Watch(*it);
+
       bool bCancelled = false;
       while (!bCancelled && m_pathsToScan.size())
       {
@@ -160,6 +173,8 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CRegExp::LogStatistics();
+      CRegExp::EnableStatistics(false);
     }
     catch (...)
     {
@@ -169,6 +184,10 @@ namespace VIDEO
     m_bRunning = false;
     ANNOUNCEMENT::CAnnouncementManager::Get().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
 
+    // probe the new items in the background instead of waiting for them to be shown
+    if (CSettings::Get().GetBool("myvideos.extractflags"))
+      CStreamDetailsExtractor::Get().ExtractMissing();
+
     // we need to clear the videodb cache and update any active lists
     CUtil::DeleteVideoDatabaseDirectoryCache();
     CGUIMessage msg(GUI_MSG_SCAN_FINISHED, 0, 0, 0);
@@ -317,26 +336,38 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), info->Name().c_str()));
       }
 
-      std::string fastHash = GetFastHash(strDirectory, regexps);
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && fastHash == dbHash)
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
+      std::string fastHash;
+      bool unchanged = false;
+      if (m_database.GetPathHash(strDirectory, dbHash) && !dbHash.empty() &&
+          CChangeJournal::Get().IsUnchanged(m_journalClient, strDirectory, false))
+      { // nothing changed in the folder since we last checked it - no need to process anything
+        hash = dbHash;
+        unchanged = true;
       }
       else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
-        items.Stack();
-
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
+      {
+        fastHash = GetFastHash(strDirectory, regexps);
+        if (!fastHash.empty() && fastHash == dbHash)
+        { // fast hashes match - no need to process anything
           hash = fastHash;
+        }
+        else
+        { // need to fetch the folder
+          CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+          items.Stack();
+
+          // check whether to re-use previously computed fast hash
+          if (!CanFastHash(items, regexps) || fastHash.empty())
+            GetPathHash(items, hash);
+          else
+            hash = fastHash;
+        }
       }
 
       if (hash == dbHash)
       { // hash matches - skipping
-        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), !fastHash.empty() ? " (fasthash)" : "");
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), unchanged ? " (journal)" : !fastHash.empty() ? " (fasthash)" : "");
+        CChangeJournal::Get().SetScanned(m_journalClient, strDirectory, m_journalSequence);
         bSkip = true;
       }
       else if (hash.empty())
@@ -391,6 +422,7 @@ namespace VIDEO
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
         {
           m_database.SetPathHash(strDirectory, hash);
+          CChangeJournal::Get().SetScanned(m_journalClient, strDirectory, m_journalSequence);
           if (m_bClean)
             m_pathsToClean.insert(m_database.GetPathId(strDirectory));
           CLog::Log(LOGDEBUG, "VideoInfoScanner: Finished adding information from dir %s", CURL::GetRedacted(strDirectory).c_str());
@@ -729,12 +761,21 @@ namespace VIDEO
         m_pathsToScan.erase(it);
 
       std::string hash, dbHash;
-      hash = GetRecursiveFastHash(item->GetPath(), regexps);
-      if (m_database.GetPathHash(item->GetPath(), dbHash) && !hash.empty() && dbHash == hash)
+      if (m_database.GetPathHash(item->GetPath(), dbHash) && !dbHash.empty() &&
+          CChangeJournal::Get().IsUnchanged(m_journalClient, item->GetPath(), true))
       {
-        // fast hashes match - no need to process anything
+        // nothing changed below the folder since we last checked it - no need to process anything
         bSkip = true;
       }
+      else
+      {
+        hash = GetRecursiveFastHash(item->GetPath(), regexps);
+        if (!hash.empty() && dbHash == hash)
+        {
+          // fast hashes match - no need to process anything
+          bSkip = true;
+        }
+      }
 
       // fast hash cannot be computed or we need to rescan. fetch the listing.
       if (!bSkip)
@@ -760,6 +801,7 @@ namespace VIDEO
       if (bSkip)
       {
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change", CURL::GetRedacted(item->GetPath()).c_str());
+        CChangeJournal::Get().SetScanned(m_journalClient, item->GetPath(), m_journalSequence);
         // update our dialog with our progress
         if (m_handle)
           OnDirectoryScanned(item->GetPath());
@@ -949,22 +991,22 @@ namespace VIDEO
 
   bool CVideoInfoScanner::EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList)
   {
-    SETTINGS_TVSHOWLIST expression = g_advancedSettings.m_tvshowEnumRegExps;
+    const SETTINGS_TVSHOWLIST &expression = g_advancedSettings.m_tvshowEnumRegExps;
 
     std::string strLabel=item->GetPath();
     // URLDecode in case an episode is on a http/https/dav/davs:// source and URL-encoded like foo%201x01%20bar.avi
     strLabel = CURL::Decode(strLabel);
 
+    // the compiled expressions come from the regexp cache, so this is cheap
+    CRegExpList regexps(true, CRegExp::autoUtf8);
     for (unsigned int i=0;i<expression.size();++i)
-    {
-      CRegExp reg(true, CRegExp::autoUtf8);
-      if (!reg.RegComp(expression[i].regexp))
-        continue;
+      regexps.Add(expression[i].regexp);
 
+    int i = -1;
+    while ((i = regexps.Find(strLabel, i + 1)) >= 0)
+    {
+      CRegExp &reg = regexps.Get(i);
       int regexppos, regexp2pos;
-      //CLog::Log(LOGDEBUG,"running expression %s on %s",expression[i].regexp.c_str(),strLabel.c_str());
-      if ((regexppos = reg.RegFind(strLabel.c_str())) < 0)
-        continue;
 
       EPISODE episode;
       episode.strPath = item->GetPath();
@@ -256,6 +256,8 @@ namespace VIDEO
     std::set<std::string> m_pathsToScan;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::string m_journalClient;       ///< our name in the change journal
+    unsigned int m_journalSequence;    ///< change journal sequence when the scan started
     CNfoFile m_nfoReader;
   };
 }
@@ -412,70 +412,135 @@ void CVideoInfoTag::Archive(CArchive& ar)
 
 void CVideoInfoTag::Serialize(CVariant& value) const
 {
-  value["director"] = m_director;
-  value["writer"] = m_writingCredits;
-  value["genre"] = m_genre;
-  value["country"] = m_country;
-  value["tagline"] = m_strTagLine;
-  value["plotoutline"] = m_strPlotOutline;
-  value["plot"] = m_strPlot;
-  value["title"] = m_strTitle;
-  value["votes"] = m_strVotes;
-  value["studio"] = m_studio;
-  value["trailer"] = m_strTrailer;
-  value["cast"] = CVariant(CVariant::VariantTypeArray);
-  for (unsigned int i = 0; i < m_cast.size(); ++i)
+  serialize(value, NULL);
+}
+
+void CVideoInfoTag::SerializeFields(CVariant& value, const std::set<std::string>& fields) const
+{
+  serialize(value, &fields);
+}
+
+void CVideoInfoTag::serialize(CVariant& value, const std::set<std::string> *fields) const
+{
+  if (IsRequested(fields, "director"))
+    value["director"] = m_director;
+  if (IsRequested(fields, "writer"))
+    value["writer"] = m_writingCredits;
+  if (IsRequested(fields, "genre"))
+    value["genre"] = m_genre;
+  if (IsRequested(fields, "country"))
+    value["country"] = m_country;
+  if (IsRequested(fields, "tagline"))
+    value["tagline"] = m_strTagLine;
+  if (IsRequested(fields, "plotoutline"))
+    value["plotoutline"] = m_strPlotOutline;
+  if (IsRequested(fields, "plot"))
+    value["plot"] = m_strPlot;
+  if (IsRequested(fields, "title"))
+    value["title"] = m_strTitle;
+  if (IsRequested(fields, "votes"))
+    value["votes"] = m_strVotes;
+  if (IsRequested(fields, "studio"))
+    value["studio"] = m_studio;
+  if (IsRequested(fields, "trailer"))
+    value["trailer"] = m_strTrailer;
+  if (IsRequested(fields, "cast"))
+  {
+    value["cast"] = CVariant(CVariant::VariantTypeArray);
+    for (unsigned int i = 0; i < m_cast.size(); ++i)
+    {
+      CVariant actor;
+      actor["name"] = m_cast[i].strName;
+      actor["role"] = m_cast[i].strRole;
+      actor["order"] = m_cast[i].order;
+      if (!m_cast[i].thumb.empty())
+        actor["thumbnail"] = CTextureUtils::GetWrappedImageURL(m_cast[i].thumb);
+      value["cast"].push_back(actor);
+    }
+  }
+  if (IsRequested(fields, "set"))
+    value["set"] = m_strSet;
+  if (IsRequested(fields, "setid"))
+    value["setid"] = m_iSetId;
+  if (IsRequested(fields, "tag"))
+    value["tag"] = m_tags;
+  if (IsRequested(fields, "runtime"))
+    value["runtime"] = GetDuration();
+  if (IsRequested(fields, "file"))
+    value["file"] = m_strFile;
+  if (IsRequested(fields, "path"))
+    value["path"] = m_strPath;
+  if (IsRequested(fields, "imdbnumber"))
+    value["imdbnumber"] = m_strIMDBNumber;
+  if (IsRequested(fields, "mpaa"))
+    value["mpaa"] = m_strMPAARating;
+  if (IsRequested(fields, "filenameandpath"))
+    value["filenameandpath"] = m_strFileNameAndPath;
+  if (IsRequested(fields, "originaltitle"))
+    value["originaltitle"] = m_strOriginalTitle;
+  if (IsRequested(fields, "sorttitle"))
+    value["sorttitle"] = m_strSortTitle;
+  if (IsRequested(fields, "episodeguide"))
+    value["episodeguide"] = m_strEpisodeGuide;
+  if (IsRequested(fields, "premiered"))
+    value["premiered"] = m_premiered.IsValid() ? m_premiered.GetAsDBDate() : StringUtils::Empty;
+  if (IsRequested(fields, "status"))
+    value["status"] = m_strStatus;
+  if (IsRequested(fields, "productioncode"))
+    value["productioncode"] = m_strProductionCode;
+  if (IsRequested(fields, "firstaired"))
+    value["firstaired"] = m_firstAired.IsValid() ? m_firstAired.GetAsDBDate() : StringUtils::Empty;
+  if (IsRequested(fields, "showtitle"))
+    value["showtitle"] = m_strShowTitle;
+  if (IsRequested(fields, "album"))
+    value["album"] = m_strAlbum;
+  if (IsRequested(fields, "artist"))
+    value["artist"] = m_artist;
+  if (IsRequested(fields, "playcount"))
+    value["playcount"] = m_playCount;
+  if (IsRequested(fields, "lastplayed"))
+    value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
+  if (IsRequested(fields, "top250"))
+    value["top250"] = m_iTop250;
+  if (IsRequested(fields, "year"))
+    value["year"] = m_iYear;
+  if (IsRequested(fields, "season"))
+    value["season"] = m_iSeason;
+  if (IsRequested(fields, "episode"))
+    value["episode"] = m_iEpisode;
+  if (IsRequested(fields, "uniqueid"))
+    value["uniqueid"]["unknown"] = m_strUniqueId;
+  if (IsRequested(fields, "rating"))
+    value["rating"] = m_fRating;
+  if (IsRequested(fields, "dbid"))
+    value["dbid"] = m_iDbId;
+  if (IsRequested(fields, "fileid"))
+    value["fileid"] = m_iFileId;
+  if (IsRequested(fields, "track"))
+    value["track"] = m_iTrack;
+  if (IsRequested(fields, "showlink"))
+    value["showlink"] = m_showLink;
+  if (IsRequested(fields, "streamdetails"))
+    m_streamDetails.Serialize(value["streamdetails"]);
+  if (IsRequested(fields, "resume"))
   {
-    CVariant actor;
-    actor["name"] = m_cast[i].strName;
-    actor["role"] = m_cast[i].strRole;
-    actor["order"] = m_cast[i].order;
-    if (!m_cast[i].thumb.empty())
-      actor["thumbnail"] = CTextureUtils::GetWrappedImageURL(m_cast[i].thumb);
-    value["cast"].push_back(actor);
+    CVariant resume = CVariant(CVariant::VariantTypeObject);
+    resume["position"] = (float)m_resumePoint.timeInSeconds;
+    resume["total"] = (float)m_resumePoint.totalTimeInSeconds;
+    value["resume"] = resume;
   }
-  value["set"] = m_strSet;
-  value["setid"] = m_iSetId;
-  value["tag"] = m_tags;
-  value["runtime"] = GetDuration();
-  value["file"] = m_strFile;
-  value["path"] = m_strPath;
-  value["imdbnumber"] = m_strIMDBNumber;
-  value["mpaa"] = m_strMPAARating;
-  value["filenameandpath"] = m_strFileNameAndPath;
-  value["originaltitle"] = m_strOriginalTitle;
-  value["sorttitle"] = m_strSortTitle;
-  value["episodeguide"] = m_strEpisodeGuide;
-  value["premiered"] = m_premiered.IsValid() ? m_premiered.GetAsDBDate() : StringUtils::Empty;
-  value["status"] = m_strStatus;
-  value["productioncode"] = m_strProductionCode;
-  value["firstaired"] = m_firstAired.IsValid() ? m_firstAired.GetAsDBDate() : StringUtils::Empty;
-  value["showtitle"] = m_strShowTitle;
-  value["album"] = m_strAlbum;
-  value["artist"] = m_artist;
-  value["playcount"] = m_playCount;
-  value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
-  value["top250"] = m_iTop250;
-  value["year"] = m_iYear;
-  value["season"] = m_iSeason;
-  value["episode"] = m_iEpisode;
-  value["uniqueid"]["unknown"] = m_strUniqueId;
-  value["rating"] = m_fRating;
-  value["dbid"] = m_iDbId;
-  value["fileid"] = m_iFileId;
-  value["track"] = m_iTrack;
-  value["showlink"] = m_showLink;
-  m_streamDetails.Serialize(value["streamdetails"]);
-  CVariant resume = CVariant(CVariant::VariantTypeObject);
-  resume["position"] = (float)m_resumePoint.timeInSeconds;
-  resume["total"] = (float)m_resumePoint.totalTimeInSeconds;
-  value["resume"] = resume;
-  value["tvshowid"] = m_iIdShow;
-  value["dateadded"] = m_dateAdded.IsValid() ? m_dateAdded.GetAsDBDateTime() : StringUtils::Empty;
-  value["type"] = m_type;
-  value["seasonid"] = m_iIdSeason;
-  value["specialsortseason"] = m_iSpecialSortSeason;
-  value["specialsortepisode"] = m_iSpecialSortEpisode;
+  if (IsRequested(fields, "tvshowid"))
+    value["tvshowid"] = m_iIdShow;
+  if (IsRequested(fields, "dateadded"))
+    value["dateadded"] = m_dateAdded.IsValid() ? m_dateAdded.GetAsDBDateTime() : StringUtils::Empty;
+  if (IsRequested(fields, "type"))
+    value["type"] = m_type;
+  if (IsRequested(fields, "seasonid"))
+    value["seasonid"] = m_iIdSeason;
+  if (IsRequested(fields, "specialsortseason"))
+    value["specialsortseason"] = m_iSpecialSortSeason;
+  if (IsRequested(fields, "specialsortepisode"))
+    value["specialsortepisode"] = m_iSpecialSortEpisode;
 }
 
 void CVideoInfoTag::ToSortable(SortItem& sortable, Field field) const
@@ -70,6 +70,7 @@ public:
   bool Save(TiXmlNode *node, const std::string &tag, bool savePathInfo = true, const TiXmlElement *additionalNode = NULL);
   virtual void Archive(CArchive& ar);
   virtual void Serialize(CVariant& value) const;
+  virtual void SerializeFields(CVariant& value, const std::set<std::string>& fields) const;
   virtual void ToSortable(SortItem& sortable, Field field) const;
   const std::string GetCast(bool bIncludeRole = false) const;
   bool HasStreamDetails() const;
@@ -161,6 +162,8 @@ private:
    \sa Load
    */
   void ParseNative(const TiXmlElement* element, bool prioritise);
+
+  void serialize(CVariant& value, const std::set<std::string> *fields) const;
 };
 
 typedef std::vector<CVideoInfoTag> VECMOVIES;
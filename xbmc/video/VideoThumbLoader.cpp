@@ -77,26 +77,34 @@ bool CThumbExtractor::operator==(const CJob* job) const
   return false;
 }
 
-bool CThumbExtractor::DoWork()
+bool CThumbExtractor::CanExtract(const CFileItem &item)
 {
-  if (m_item.IsLiveTV()
-  ||  URIUtils::IsUPnP(m_item.GetPath())
-  ||  m_item.IsDAAP()
-  ||  m_item.IsDVD()
-  ||  m_item.IsDiscImage()
-  ||  m_item.IsDVDFile(false, true)
-  ||  m_item.IsInternetStream()
-  ||  m_item.IsDiscStub()
-  ||  m_item.IsPlayList())
+  if (item.IsLiveTV()
+  ||  URIUtils::IsUPnP(item.GetPath())
+  ||  item.IsDAAP()
+  ||  item.IsDVD()
+  ||  item.IsDiscImage()
+  ||  item.IsDVDFile(false, true)
+  ||  item.IsInternetStream()
+  ||  item.IsDiscStub()
+  ||  item.IsPlayList())
     return false;
 
-  if (URIUtils::IsRemote(m_item.GetPath()) && !URIUtils::IsOnLAN(m_item.GetPath()))
+  if (URIUtils::IsRemote(item.GetPath()) && !URIUtils::IsOnLAN(item.GetPath()))
   {
     // A quasi internet filesystem like webdav is generally fast enough for extracting stuff
-    if (!URIUtils::IsDAV(m_item.GetPath()))
+    if (!URIUtils::IsDAV(item.GetPath()))
       return false;
   }
 
+  return true;
+}
+
+bool CThumbExtractor::DoWork()
+{
+  if (!CanExtract(m_item))
+    return false;
+
   bool result=false;
   if (m_thumb)
   {
@@ -53,6 +53,12 @@ public:
 
   virtual bool operator==(const CJob* job) const;
 
+  /*!
+   \brief Whether stream details and thumbs can be extracted from the item.
+   Discs, streams and files on slow remote filesystems are skipped.
+   */
+  static bool CanExtract(const CFileItem &item);
+
   std::string m_target; ///< thumbpath
   std::string m_listpath; ///< path used in fileitem list
   CFileItem  m_item;
@@ -26,6 +26,7 @@
 #include "addons/AddonManager.h"
 #include "addons/PluginSource.h"
 #include "filesystem/PluginDirectory.h"
+#include "filesystem/DirectoryListingCache.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "GUIPassword.h"
 #include "Application.h"
@@ -96,6 +97,8 @@ CGUIMediaWindow::CGUIMediaWindow(int id, const char *xmlFile)
   m_iLastControl = -1;
   m_iSelectedItem = -1;
   m_canFilterAdvanced = false;
+  // browsing may show listings of network sources stored in an earlier session
+  m_rootDir.SetFlags(XFILE::DIR_FLAG_ALLOW_PROMPT | XFILE::DIR_FLAG_ALLOW_STORED);
 
   m_guiState.reset(CGUIViewState::GetViewState(GetID(), *m_vecItems));
 }
@@ -877,7 +880,10 @@ bool CGUIMediaWindow::Refresh(bool clearCache /* = false */)
     return false;
 
   if (clearCache)
+  {
     m_vecItems->RemoveDiscCache(GetID());
+    XFILE::CDirectoryListingCache::Get().ClearDirectory(strCurrentDirectory);
+  }
 
   // get the original number of items
   if (!Update(strCurrentDirectory, false))